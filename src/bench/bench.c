@@ -0,0 +1,406 @@
+/* bench/bench.c
+ *
+ * Performance regression harness: runs a fixed set of workloads several
+ * times each from fixed seeds, and writes the timings as JSON for
+ * compare-bench to check against a baseline
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "angband.h"
+#include "cave.h"
+#include "cmd-core.h"
+#include "cmd-journal.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-make.h"
+#include "obj-make.h"
+#include "player-birth.h"
+#include "player-util.h"
+#include "savefile.h"
+#include "test-utils.h"
+
+#define BENCH_JOURNAL "bench-play.jnl"
+#define BENCH_SAVE "bench-save"
+
+/* Times the scripted player is asked for commands */
+#define PLAY_FILLS 400
+
+/* Levels the allocation tables are sampled at, and samples per level */
+#define ALLOC_DEPTHS 100
+#define ALLOC_MON_SAMPLES 10
+#define ALLOC_OBJ_SAMPLES 200
+
+static int runs = 5;
+static int warmup = 1;
+static u32b seed = 0x5eed;
+static const char *only[16];
+static int n_only = 0;
+static bool quiet = false;
+static FILE *out;
+static int metrics;
+
+/**
+ * A workload: runs once, and gives back the milliseconds it took
+ */
+typedef double (*bench_fn)(void *data);
+
+static double msecs_since(clock_t start)
+{
+	return (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static int compare_msecs(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * The pc'th percentile of sorted timings, by nearest rank
+ */
+static double percentile(const double *msecs, int n, int pc)
+{
+	int rank = (pc * n + 99) / 100;
+
+	return msecs[MAX(rank, 1) - 1];
+}
+
+/**
+ * Whether the workload called name was asked for
+ */
+static bool wanted(const char *name)
+{
+	int i;
+
+	for (i = 0; i < n_only; i++)
+		if (prefix(name, only[i])) return true;
+	return !n_only;
+}
+
+/**
+ * Run a workload a few times to settle caches, then time it `runs` times
+ * and write out the spread of the timings
+ */
+static void bench_measure(const char *name, const char *work, bench_fn fn,
+						  void *data)
+{
+	double *msecs;
+	double median;
+	int i;
+
+	if (!wanted(name)) return;
+
+	for (i = 0; i < warmup; i++)
+		fn(data);
+
+	msecs = mem_zalloc(runs * sizeof(*msecs));
+	for (i = 0; i < runs; i++)
+		msecs[i] = fn(data);
+	sort(msecs, runs, sizeof(*msecs), compare_msecs);
+
+	median = (runs % 2) ? msecs[runs / 2] :
+		(msecs[runs / 2 - 1] + msecs[runs / 2]) / 2;
+	fprintf(out, "%s\n    \"%s\": { \"work\": \"%s\", \"median\": %.3f, "
+			"\"p10\": %.3f, \"p90\": %.3f, \"min\": %.3f, \"max\": %.3f }",
+			metrics++ ? "," : "", name, work, median,
+			percentile(msecs, runs, 10), percentile(msecs, runs, 90),
+			msecs[0], msecs[runs - 1]);
+	if (!quiet)
+		fprintf(stderr, "  %-24s %10.3fms  (%s)\n", name, median, work);
+
+	mem_free(msecs);
+}
+
+/**
+ * ------------------------------------------------------------------------
+ * The workloads
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Read all the gamedata
+ */
+static double bench_init(void *data)
+{
+	clock_t start;
+	double msec;
+
+	cleanup_angband();
+	set_file_paths();
+	start = clock();
+	init_angband();
+	msec = msecs_since(start);
+	return msec;
+}
+
+/**
+ * Put every artifact back in the pool, and throw away the stored town, so
+ * each level is built from the same start
+ */
+static void reset_levels(void)
+{
+	struct chunk *town = chunk_find_name("Town");
+	int i;
+
+	for (i = 0; i < z_info->a_max; i++)
+		a_info[i].created = false;
+	if (town) {
+		chunk_list_remove("Town");
+		cave_free(town);
+	}
+}
+
+/**
+ * Build levels with one profile at a few depths
+ */
+static double bench_generate(void *data)
+{
+	const struct cave_profile *profile = data;
+	static const int depths[] = { 5, 25, 50 };
+	struct gen_report report;
+	double msec = 0.0;
+	size_t i;
+
+	for (i = 0; i < N_ELEMENTS(depths); i++) {
+		int depth = streq(profile->name, "town") ? 0 : depths[i];
+		clock_t start;
+
+		Rand_state_init(seed + i);
+		reset_levels();
+		dungeon_change_level(player, depth);
+
+		memset(&report, 0, sizeof(report));
+		report.profile = profile;
+		gen_report = &report;
+		start = clock();
+		prepare_next_level(&cave, player);
+		msec += msecs_since(start);
+		gen_report = NULL;
+
+		/* The town is only built at one depth */
+		if (!depth) break;
+	}
+
+	return msec;
+}
+
+/**
+ * Stand in for the UI: go down the stairs, then wander about, sometimes
+ * resting a little
+ */
+static int play_fills;
+
+static errr scripted_get_cmd(cmd_context c)
+{
+	static const int dirs[] = { 2, 6, 6, 8, 3, 4, 7, 9, 1, 2, 8, 4 };
+
+	if (!play_fills++) {
+		cmdq_push(CMD_GO_DOWN);
+	} else if (!(play_fills % 7)) {
+		cmdq_push_repeat(CMD_HOLD, 3);
+	} else {
+		cmdq_push(CMD_WALK);
+		cmd_set_arg_direction(cmdq_peek(), "direction",
+							  dirs[play_fills % N_ELEMENTS(dirs)]);
+	}
+	return 0;
+}
+
+/**
+ * Record the scripted play once, so every run plays the same turns
+ */
+static bool record_play(void)
+{
+	errr (*old_hook)(cmd_context c) = cmd_get_hook;
+
+	square_set_feat(cave, player->grid, FEAT_MORE);
+	cmd_get_hook = scripted_get_cmd;
+	if (!journal_open(BENCH_JOURNAL)) return false;
+	while (play_fills < PLAY_FILLS && !player->is_dead &&
+		   player->upkeep->playing) {
+		cmdq_fill(CMD_GAME);
+		run_game_loop();
+	}
+	journal_close();
+	cmd_get_hook = old_hook;
+	return true;
+}
+
+/**
+ * Play the recorded turns
+ */
+static double bench_play(void *data)
+{
+	struct journal_report report;
+	clock_t start = clock();
+
+	if (!journal_replay(BENCH_JOURNAL, &report))
+		quit_fmt("The scripted play didn't replay: %s", report.error);
+	return msecs_since(start);
+}
+
+/**
+ * Save the game and load it again
+ */
+static double bench_savefile(void *data)
+{
+	clock_t start = clock();
+
+	if (!savefile_save(BENCH_SAVE) || !savefile_load(BENCH_SAVE, false))
+		quit("The savefile didn't save and load.");
+	return msecs_since(start);
+}
+
+/**
+ * Pick monsters and objects at every depth
+ */
+static double bench_alloc_monsters(void *data)
+{
+	clock_t start;
+	int i, j;
+
+	Rand_state_init(seed);
+	start = clock();
+	for (i = 1; i <= ALLOC_DEPTHS; i++)
+		for (j = 0; j < ALLOC_MON_SAMPLES; j++)
+			get_mon_num(i);
+	return msecs_since(start);
+}
+
+static double bench_alloc_objects(void *data)
+{
+	clock_t start;
+	int i, j;
+
+	Rand_state_init(seed);
+	start = clock();
+	for (i = 1; i <= ALLOC_DEPTHS; i++)
+		for (j = 0; j < ALLOC_OBJ_SAMPLES; j++)
+			get_obj_num(i, j % 8 == 0, 0);
+	return msecs_since(start);
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Setting up and running
+ * ------------------------------------------------------------------------ */
+
+static void println(const char *str)
+{
+	if (!quiet) fprintf(stderr, "%s\n", str);
+}
+
+/**
+ * Make a character from the fixed seed and put them in the town
+ */
+static void birth_character(void)
+{
+	Rand_quick = false;
+	Rand_state_init(seed);
+
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Bencher");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	player->upkeep->autosave = false;
+	prepare_next_level(&cave, player);
+	on_new_level();
+}
+
+static void usage(void)
+{
+	printf("Usage: bench [-rRUNS] [-wWARMUP] [-sSEED] [-pPREFIX] [-oFILE] [-q]\n"
+		   "\n"
+		   "  -rRUNS    Time each workload RUNS times (default: 5)\n"
+		   "  -wWARMUP  Run each workload WARMUP times first (default: 1)\n"
+		   "  -sSEED    Seed for the workloads (default: 0x5eed)\n"
+		   "  -pPREFIX  Only run the workloads whose names start with PREFIX; may\n"
+		   "            be given more than once\n"
+		   "  -oFILE    Write the JSON results to FILE, not standard output\n"
+		   "  -q        Don't show progress\n");
+	exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	const char *out_name = NULL;
+	char work[80];
+	int i;
+
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-r"))
+			runs = MAX(atoi(&argv[i][2]), 1);
+		else if (prefix(argv[i], "-w"))
+			warmup = MAX(atoi(&argv[i][2]), 0);
+		else if (prefix(argv[i], "-s"))
+			seed = strtoul(&argv[i][2], NULL, 0);
+		else if (prefix(argv[i], "-p") && n_only < (int) N_ELEMENTS(only))
+			only[n_only++] = &argv[i][2];
+		else if (prefix(argv[i], "-o"))
+			out_name = &argv[i][2];
+		else if (streq(argv[i], "-q"))
+			quiet = true;
+		else
+			usage();
+	}
+
+	out = out_name ? fopen(out_name, "w") : stdout;
+	if (!out) {
+		fprintf(stderr, "bench: couldn't open %s\n", out_name);
+		return 1;
+	}
+	plog_aux = println;
+
+	set_file_paths();
+	init_angband();
+	fprintf(out, "{\n  \"seed\": %lu,\n  \"runs\": %d,\n  \"metrics\": {",
+			(unsigned long) seed, runs);
+
+	bench_measure("init", "read all gamedata", bench_init, NULL);
+	birth_character();
+
+	/* Play from the town straight after birth, so what is played doesn't
+	 * depend on which other workloads were run */
+	if (wanted("play") || wanted("savefile")) {
+		if (!record_play()) quit("Couldn't record the scripted play.");
+		strnfmt(work, sizeof(work), "%d commands, %ld turns", play_fills,
+				(long) turn);
+		bench_measure("play", work, bench_play, NULL);
+		bench_measure("savefile", "save and load", bench_savefile, NULL);
+		file_delete(BENCH_JOURNAL);
+		file_delete(BENCH_SAVE);
+	}
+
+	for (i = 0; i < z_info->profile_max; i++) {
+		const struct cave_profile *profile = cave_profile_by_idx(i);
+		char name[40];
+
+		strnfmt(name, sizeof(name), "generate/%s", profile->name);
+		bench_measure(name, streq(profile->name, "town") ? "town level" :
+					  "levels at 5, 25, 50", bench_generate, (void *) profile);
+	}
+
+	strnfmt(work, sizeof(work), "%d samples at each of %d levels",
+			ALLOC_MON_SAMPLES, ALLOC_DEPTHS);
+	bench_measure("alloc/get_mon_num", work, bench_alloc_monsters, NULL);
+	strnfmt(work, sizeof(work), "%d samples at each of %d levels",
+			ALLOC_OBJ_SAMPLES, ALLOC_DEPTHS);
+	bench_measure("alloc/get_obj_num", work, bench_alloc_objects, NULL);
+
+	fprintf(out, "\n  }\n}\n");
+	if (out != stdout) fclose(out);
+
+	cleanup_angband();
+	return 0;
+}
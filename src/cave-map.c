@@ -172,6 +172,8 @@ void map_info(struct loc grid, struct grid_data *g)
 
 	/* Rare random hallucination on non-outer walls */
 	if (g->hallucinate && g->m_idx == 0 && g->first_kind == 0) {
+		int old_stream = Rand_stream_select(RNG_COSMETIC);
+
 		if (one_in_(128) && (int) g->f_idx != FEAT_PERM)
 			g->m_idx = 1;
 		else if (one_in_(128) && (int) g->f_idx != FEAT_PERM)
@@ -179,6 +181,7 @@ void map_info(struct loc grid, struct grid_data *g)
 			g->first_kind = k_info;
 		else
 			g->hallucinate = false;
+		Rand_stream_select(old_stream);
 	}
 
 	assert((int) g->f_idx <= FEAT_PASS_RUBBLE);
@@ -274,7 +277,7 @@ static void cave_light(struct point_set *ps)
 	/* Apply flag changes */
 	for (i = 0; i < ps->n; i++)	{
 		/* Perma-Light */
-		sqinfo_on(square(cave, ps->pts[i]).info, SQUARE_GLOW);
+		sqinfo_on(cave, ps->pts[i], SQUARE_GLOW);
 	}
 
 	/* Process the grids */
@@ -321,7 +324,7 @@ static void cave_unlight(struct point_set *ps)
 
 		/* Darken the grid... */
 		if (!square_isbright(cave, ps->pts[i])) {
-			sqinfo_off(square(cave, ps->pts[i]).info, SQUARE_GLOW);
+			sqinfo_off(cave, ps->pts[i], SQUARE_GLOW);
 		}
 
 		/* ...but dark-loving characters remember them */
@@ -425,7 +428,7 @@ void wiz_light(struct chunk *c, struct player *p, bool full)
 					struct loc a_grid = loc_sum(grid, ddgrid_ddd[i]);
 
 					/* Perma-light the grid */
-					sqinfo_on(square(c, a_grid).info, SQUARE_GLOW);
+					sqinfo_on(c, a_grid, SQUARE_GLOW);
 
 					/* Memorize normal features */
 					if (!square_isfloor(c, a_grid) || 
@@ -450,13 +453,8 @@ void wiz_light(struct chunk *c, struct player *p, bool full)
 	}
 
 	/* Unmark grids */
-	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			struct loc grid = loc(x, y);
-			if (!square_in_bounds(c, grid)) continue;
-			square_unmark(c, grid);
-		}
-	}
+	bitmap_rect_wipe(c->info[SQUARE_MARK], loc(1, 1),
+					 loc(c->width - 2, c->height - 2));
 
 	/* Fully update the visuals */
 	p->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
@@ -491,7 +489,7 @@ void wiz_dark(struct chunk *c, struct player *p, bool full)
 					struct loc a_grid = loc_sum(grid, ddgrid_ddd[i]);
 
 					/* Perma-darken the grid */
-					sqinfo_off(square(cave, a_grid).info, SQUARE_GLOW);
+					sqinfo_off(cave, a_grid, SQUARE_GLOW);
 
 					/* Memorize normal features */
 					if (!square_isfloor(c, a_grid) || 
@@ -516,13 +514,8 @@ void wiz_dark(struct chunk *c, struct player *p, bool full)
 	}
 
 	/* Unmark grids */
-	for (y = 1; y < c->height - 1; y++) {
-		for (x = 1; x < c->width - 1; x++) {
-			struct loc grid = loc(x, y);
-			if (!square_in_bounds(c, grid)) continue;
-			square_unmark(c, grid);
-		}
-	}
+	bitmap_rect_wipe(c->info[SQUARE_MARK], loc(1, 1),
+					 loc(c->width - 2, c->height - 2));
 
 	/* Fully update the visuals */
 	p->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
@@ -563,10 +556,10 @@ void cave_illuminate(struct chunk *c, bool daytime)
 
 			/* Only interesting grids at night */
 			if (daytime || !square_isfloor(c, grid)) {
-				sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+				sqinfo_on(c, grid, SQUARE_GLOW);
 				square_memorize(c, grid);
 			} else if (!square_isbright(c, grid)) {
-				sqinfo_off(square(c, grid).info, SQUARE_GLOW);
+				sqinfo_off(c, grid, SQUARE_GLOW);
 				square_forget(c, grid);
 			}
 		}
@@ -581,7 +574,7 @@ void cave_illuminate(struct chunk *c, bool daytime)
 				continue;
 			for (i = 0; i < 8; i++) {
 				struct loc a_grid = loc_sum(grid, ddgrid_ddd[i]);
-				sqinfo_on(square(c, a_grid).info, SQUARE_GLOW);
+				sqinfo_on(c, a_grid, SQUARE_GLOW);
 				square_memorize(c, a_grid);
 			}
 		}
@@ -415,7 +415,7 @@ bool square_isnotknown(struct chunk *c, struct loc grid) {
  */
 bool square_ismark(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_MARK);
+	return sqinfo_has(c, grid, SQUARE_MARK);
 }
 
 /**
@@ -423,7 +423,7 @@ bool square_ismark(struct chunk *c, struct loc grid) {
  */
 bool square_isglow(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_GLOW);
+	return sqinfo_has(c, grid, SQUARE_GLOW);
 }
 
 /**
@@ -433,7 +433,7 @@ bool square_isglow(struct chunk *c, struct loc grid) {
  */
 bool square_isvault(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_VAULT);
+	return sqinfo_has(c, grid, SQUARE_VAULT);
 }
 
 /**
@@ -441,7 +441,7 @@ bool square_isvault(struct chunk *c, struct loc grid) {
  */
 bool square_isroom(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_ROOM);
+	return sqinfo_has(c, grid, SQUARE_ROOM);
 }
 
 /**
@@ -449,7 +449,7 @@ bool square_isroom(struct chunk *c, struct loc grid) {
  */
 bool square_isseen(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_SEEN);
+	return sqinfo_has(c, grid, SQUARE_SEEN);
 }
 
 /**
@@ -457,7 +457,7 @@ bool square_isseen(struct chunk *c, struct loc grid) {
  */
 bool square_isview(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_VIEW);
+	return sqinfo_has(c, grid, SQUARE_VIEW);
 }
 
 /**
@@ -465,7 +465,7 @@ bool square_isview(struct chunk *c, struct loc grid) {
  */
 bool square_wasseen(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_WASSEEN);
+	return sqinfo_has(c, grid, SQUARE_WASSEEN);
 }
 
 /**
@@ -473,7 +473,7 @@ bool square_wasseen(struct chunk *c, struct loc grid) {
  */
 bool square_isfeel(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_FEEL);
+	return sqinfo_has(c, grid, SQUARE_FEEL);
 }
 
 /**
@@ -481,7 +481,7 @@ bool square_isfeel(struct chunk *c, struct loc grid) {
  */
 bool square_istrap(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_TRAP);
+	return sqinfo_has(c, grid, SQUARE_TRAP);
 }
 
 /**
@@ -489,7 +489,7 @@ bool square_istrap(struct chunk *c, struct loc grid) {
  */
 bool square_isinvis(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_INVIS);
+	return sqinfo_has(c, grid, SQUARE_INVIS);
 }
 
 /**
@@ -497,7 +497,7 @@ bool square_isinvis(struct chunk *c, struct loc grid) {
  */
 bool square_iswall_inner(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_WALL_INNER);
+	return sqinfo_has(c, grid, SQUARE_WALL_INNER);
 }
 
 /**
@@ -505,7 +505,7 @@ bool square_iswall_inner(struct chunk *c, struct loc grid) {
  */
 bool square_iswall_outer(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_WALL_OUTER);
+	return sqinfo_has(c, grid, SQUARE_WALL_OUTER);
 }
 
 /**
@@ -513,7 +513,7 @@ bool square_iswall_outer(struct chunk *c, struct loc grid) {
  */
 bool square_iswall_solid(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_WALL_SOLID);
+	return sqinfo_has(c, grid, SQUARE_WALL_SOLID);
 }
 
 /**
@@ -521,7 +521,7 @@ bool square_iswall_solid(struct chunk *c, struct loc grid) {
  */
 bool square_ismon_restrict(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_MON_RESTRICT);
+	return sqinfo_has(c, grid, SQUARE_MON_RESTRICT);
 }
 
 /**
@@ -529,7 +529,7 @@ bool square_ismon_restrict(struct chunk *c, struct loc grid) {
  */
 bool square_isno_teleport(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_NO_TELEPORT);
+	return sqinfo_has(c, grid, SQUARE_NO_TELEPORT);
 }
 
 /**
@@ -537,7 +537,7 @@ bool square_isno_teleport(struct chunk *c, struct loc grid) {
  */
 bool square_isno_map(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_NO_MAP);
+	return sqinfo_has(c, grid, SQUARE_NO_MAP);
 }
 
 /**
@@ -545,7 +545,7 @@ bool square_isno_map(struct chunk *c, struct loc grid) {
  */
 bool square_isno_esp(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_NO_ESP);
+	return sqinfo_has(c, grid, SQUARE_NO_ESP);
 }
 
 /**
@@ -553,7 +553,7 @@ bool square_isno_esp(struct chunk *c, struct loc grid) {
  */
 bool square_isproject(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_PROJECT);
+	return sqinfo_has(c, grid, SQUARE_PROJECT);
 }
 
 /**
@@ -561,7 +561,7 @@ bool square_isproject(struct chunk *c, struct loc grid) {
  */
 bool square_isdtrap(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_DTRAP);
+	return sqinfo_has(c, grid, SQUARE_DTRAP);
 }
 
 /**
@@ -569,7 +569,7 @@ bool square_isdtrap(struct chunk *c, struct loc grid) {
  */
 bool square_isno_stairs(struct chunk *c, struct loc grid) {
 	assert(square_in_bounds(c, grid));
-	return sqinfo_has(square(c, grid).info, SQUARE_NO_STAIRS);
+	return sqinfo_has(c, grid, SQUARE_NO_STAIRS);
 }
 
 
@@ -1092,6 +1092,37 @@ int square_num_walls_diagonal(struct chunk *c, struct loc grid)
     return k;
 }
 
+/**
+ * Gather the flags of a square from the flag planes into a bitflag set
+ * of size SQUARE_SIZE, for code that stores or compares whole flag sets
+ */
+void sqinfo_get(struct chunk *c, struct loc grid, bitflag *info)
+{
+	int flag;
+
+	assert(square_in_bounds(c, grid));
+	flag_wipe(info, SQUARE_SIZE);
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++)
+		if (sqinfo_has(c, grid, flag))
+			flag_on(info, SQUARE_SIZE, flag);
+}
+
+/**
+ * Scatter a bitflag set of size SQUARE_SIZE into the flag planes of a square
+ */
+void sqinfo_set(struct chunk *c, struct loc grid, const bitflag *info)
+{
+	int flag;
+
+	assert(square_in_bounds(c, grid));
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++) {
+		if (flag_has(info, SQUARE_SIZE, flag))
+			sqinfo_on(c, grid, flag);
+		else
+			sqinfo_off(c, grid, flag);
+	}
+}
+
 
 /**
  * Set the terrain type for a square.
@@ -1115,7 +1146,7 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 
 	/* Light bright terrain */
 	if (feat_is_bright(feat)) {
-		sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+		sqinfo_on(c, grid, SQUARE_GLOW);
 	}
 
 	/* Make the new terrain feel at home */
@@ -1128,9 +1159,9 @@ void square_set_feat(struct chunk *c, struct loc grid, int feat)
 		square_light_spot(c, grid);
 	} else {
 		/* Make sure no incorrect wall flags set for dungeon generation */
-		sqinfo_off(square(c, grid).info, SQUARE_WALL_INNER);
-		sqinfo_off(square(c, grid).info, SQUARE_WALL_OUTER);
-		sqinfo_off(square(c, grid).info, SQUARE_WALL_SOLID);
+		sqinfo_off(c, grid, SQUARE_WALL_INNER);
+		sqinfo_off(c, grid, SQUARE_WALL_OUTER);
+		sqinfo_off(c, grid, SQUARE_WALL_SOLID);
 	}
 }
 
@@ -1382,9 +1413,9 @@ void square_forget(struct chunk *c, struct loc grid) {
 }
 
 void square_mark(struct chunk *c, struct loc grid) {
-	sqinfo_on(square(c, grid).info, SQUARE_MARK);
+	sqinfo_on(c, grid, SQUARE_MARK);
 }
 
 void square_unmark(struct chunk *c, struct loc grid) {
-	sqinfo_off(square(c, grid).info, SQUARE_MARK);
+	sqinfo_off(c, grid, SQUARE_MARK);
 }
@@ -431,17 +431,10 @@ bool los(struct chunk *c, struct loc grid1, struct loc grid2)
  */
 static void mark_wasseen(struct chunk *c)
 {
-	int x, y;
 	/* Save the old "view" grids for later */
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			struct loc grid = loc(x, y);
-			if (square_isseen(c, grid))
-				sqinfo_on(square(c, grid).info, SQUARE_WASSEEN);
-			sqinfo_off(square(c, grid).info, SQUARE_VIEW);
-			sqinfo_off(square(c, grid).info, SQUARE_SEEN);
-		}
-	}
+	bitmap_copy(c->info[SQUARE_WASSEEN], c->info[SQUARE_SEEN]);
+	bitmap_wipe(c->info[SQUARE_VIEW]);
+	bitmap_wipe(c->info[SQUARE_SEEN]);
 }
 
 /**
@@ -538,9 +531,9 @@ static void become_viewable(struct chunk *c, struct loc grid, struct player *p,
 	if (square_isview(c, grid)) return;
 
 	/* Add the grid to the view, make seen if it's close enough to the player */
-	sqinfo_on(square(c, grid).info, SQUARE_VIEW);
+	sqinfo_on(c, grid, SQUARE_VIEW);
 	if (close)
-		sqinfo_on(square(c, grid).info, SQUARE_SEEN);
+		sqinfo_on(c, grid, SQUARE_SEEN);
 
 	/* Mark lit grids, and walls near to them, as seen */
 	if (square_islit(c, grid)) {
@@ -549,10 +542,10 @@ static void become_viewable(struct chunk *c, struct loc grid, struct player *p,
 			int xc = (x < p->grid.x) ? (x + 1) : (x > p->grid.x) ? (x - 1) : x;
 			int yc = (y < p->grid.y) ? (y + 1) : (y > p->grid.y) ? (y - 1) : y;
 			if (square_islit(c, loc(xc, yc))) {
-				sqinfo_on(square(c, grid).info, SQUARE_SEEN);
+				sqinfo_on(c, grid, SQUARE_SEEN);
 			}
 		} else {
-			sqinfo_on(square(c, grid).info, SQUARE_SEEN);
+			sqinfo_on(c, grid, SQUARE_SEEN);
 		}
 	}
 }
@@ -632,18 +625,15 @@ static void update_view_one(struct chunk *c, struct loc grid, struct player *p)
  */
 static void update_one(struct chunk *c, struct loc grid, int blind)
 {
-	/* Remove view if blind, check visible squares for traps */
-	if (blind) {
-		sqinfo_off(square(c, grid).info, SQUARE_SEEN);
-	} else if (square_isseen(c, grid)) {
+	/* Check visible squares for traps */
+	if (!blind && square_isseen(c, grid))
 		square_reveal_trap(c, grid, false, true);
-	}
 
 	/* Square went from unseen -> seen */
 	if (square_isseen(c, grid) && !square_wasseen(c, grid)) {
 		if (square_isfeel(c, grid)) {
 			c->feeling_squares++;
-			sqinfo_off(square(c, grid).info, SQUARE_FEEL);
+			sqinfo_off(c, grid, SQUARE_FEEL);
 			/* Don't display feeling if it will display for the new level */
 			if ((c->feeling_squares == z_info->feeling_need) &&
 				!player->upkeep->only_partial) {
@@ -659,8 +649,6 @@ static void update_one(struct chunk *c, struct loc grid, int blind)
 	/* Square went from seen -> unseen */
 	if (!square_isseen(c, grid) && square_wasseen(c, grid))
 		square_light_spot(c, grid);
-
-	sqinfo_off(square(c, grid).info, SQUARE_WASSEEN);
 }
 
 /**
@@ -674,10 +662,10 @@ void update_view(struct chunk *c, struct player *p)
 	mark_wasseen(c);
 
 	/* Assume we can view the player grid */
-	sqinfo_on(square(c, p->grid).info, SQUARE_VIEW);
+	sqinfo_on(c, p->grid, SQUARE_VIEW);
 	if (p->state.cur_light > 0 || square_isglow(c, p->grid) ||
 		player_has(p, PF_UNLIGHT))
-		sqinfo_on(square(c, p->grid).info, SQUARE_SEEN);
+		sqinfo_on(c, p->grid, SQUARE_SEEN);
 
 	/* Calculate light levels */
 	calc_light(c, p);
@@ -687,10 +675,17 @@ void update_view(struct chunk *c, struct player *p)
 		for (x = 0; x < c->width; x++)
 			update_view_one(c, loc(x, y), p);
 
+	/* Remove view if blind */
+	if (p->timed[TMD_BLIND])
+		bitmap_wipe(c->info[SQUARE_SEEN]);
+
 	/* Update each grid */
 	for (y = 0; y < c->height; y++)
 		for (x = 0; x < c->width; x++)
 			update_one(c, loc(x, y), p->timed[TMD_BLIND]);
+
+	/* The old view has been processed */
+	bitmap_wipe(c->info[SQUARE_WASSEEN]);
 }
 
 
@@ -337,28 +337,41 @@ void set_terrain(void)
 	FEAT_LAVA = lookup_feat("lava");
 }
 
+/**
+ * Size of the blocks a chunk's arena takes from the heap at a time; the grids
+ * are bigger than this, and get blocks of their own
+ */
+#define CHUNK_ARENA_BLOCK	16384
+
 /**
  * Allocate a new chunk of the world
  */
 struct chunk *cave_new(int height, int width) {
-	int y, x;
+	int y, flag;
 
 	struct chunk *c = mem_zalloc(sizeof *c);
+	struct square *squares;
+	u16b *noise, *scent;
+
 	c->height = height;
 	c->width = width;
-	c->feat_count = mem_zalloc((z_info->f_max + 1) * sizeof(int));
-
-	c->squares = mem_zalloc(c->height * sizeof(struct square*));
-	c->noise.grids = mem_zalloc(c->height * sizeof(u16b*));
-	c->scent.grids = mem_zalloc(c->height * sizeof(u16b*));
+	c->arena = mem_arena_new(CHUNK_ARENA_BLOCK);
+	c->feat_count = mem_arena_alloc(c->arena, (z_info->f_max + 1) * sizeof(int));
+
+	/* The grids are each one block, with pointers to the rows */
+	c->squares = mem_arena_alloc(c->arena, c->height * sizeof(struct square*));
+	c->noise.grids = mem_arena_alloc(c->arena, c->height * sizeof(u16b*));
+	c->scent.grids = mem_arena_alloc(c->arena, c->height * sizeof(u16b*));
+	squares = mem_arena_alloc(c->arena, height * width * sizeof(struct square));
+	noise = mem_arena_alloc(c->arena, height * width * sizeof(u16b));
+	scent = mem_arena_alloc(c->arena, height * width * sizeof(u16b));
 	for (y = 0; y < c->height; y++) {
-		c->squares[y] = mem_zalloc(c->width * sizeof(struct square));
-		for (x = 0; x < c->width; x++) {
-			c->squares[y][x].info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-		}
-		c->noise.grids[y] = mem_zalloc(c->width * sizeof(u16b));
-		c->scent.grids[y] = mem_zalloc(c->width * sizeof(u16b));
+		c->squares[y] = squares + y * width;
+		c->noise.grids[y] = noise + y * width;
+		c->scent.grids[y] = scent + y * width;
 	}
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++)
+		c->info[flag] = bitmap_new(c->height, c->width);
 
 	c->objects = mem_zalloc(OBJECT_LIST_SIZE * sizeof(struct object*));
 	c->obj_max = OBJECT_LIST_SIZE - 1;
@@ -378,32 +391,23 @@ struct chunk *cave_new(int height, int width) {
  * Free a chunk
  */
 void cave_free(struct chunk *c) {
-	int y, x;
+	int i, y, x, flag;
 
-	while (c->join) {
-		struct connector *current = c->join;
-		mem_free(current->info);
-		c->join = current->next;
-		mem_free(current);
-	}
-
-	for (y = 0; y < c->height; y++) {
-		for (x = 0; x < c->width; x++) {
-			mem_free(c->squares[y][x].info);
-			if (c->squares[y][x].trap)
-				square_free_trap(c, loc(x, y));
+	/* Objects are the only things on squares which can outlive the chunk */
+	for (y = 0; y < c->height; y++)
+		for (x = 0; x < c->width; x++)
 			if (c->squares[y][x].obj)
 				object_pile_free(c->squares[y][x].obj);
-		}
-		mem_free(c->squares[y]);
-		mem_free(c->noise.grids[y]);
-		mem_free(c->scent.grids[y]);
-	}
-	mem_free(c->squares);
-	mem_free(c->noise.grids);
-	mem_free(c->scent.grids);
 
-	mem_free(c->feat_count);
+	/* ...and so are the objects monsters carry */
+	for (i = 1; i < c->mon_max; i++)
+		if (c->monsters[i].held_obj)
+			object_pile_free(c->monsters[i].held_obj);
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++)
+		bitmap_free(c->info[flag]);
+
+	/* Grids, traps and connectors all go with the arena */
+	mem_arena_free(c->arena);
 	mem_free(c->objects);
 	mem_free(c->monsters);
 	mem_free(c->monster_groups);
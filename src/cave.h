@@ -21,6 +21,7 @@
 
 #include "z-type.h"
 #include "z-bitflag.h"
+#include "z-bitmap.h"
 
 struct player;
 struct monster;
@@ -65,22 +66,13 @@ enum
 
 #define SQUARE_SIZE                FLAG_SIZE(SQUARE_MAX)
 
-#define sqinfo_has(f, flag)        flag_has_dbg(f, SQUARE_SIZE, flag, #f, #flag)
-#define sqinfo_next(f, flag)       flag_next(f, SQUARE_SIZE, flag)
-#define sqinfo_is_empty(f)         flag_is_empty(f, SQUARE_SIZE)
-#define sqinfo_is_full(f)          flag_is_full(f, SQUARE_SIZE)
-#define sqinfo_is_inter(f1, f2)    flag_is_inter(f1, f2, SQUARE_SIZE)
-#define sqinfo_is_subset(f1, f2)   flag_is_subset(f1, f2, SQUARE_SIZE)
-#define sqinfo_is_equal(f1, f2)    flag_is_equal(f1, f2, SQUARE_SIZE)
-#define sqinfo_on(f, flag)         flag_on_dbg(f, SQUARE_SIZE, flag, #f, #flag)
-#define sqinfo_off(f, flag)        flag_off(f, SQUARE_SIZE, flag)
-#define sqinfo_wipe(f)             flag_wipe(f, SQUARE_SIZE)
-#define sqinfo_setall(f)           flag_setall(f, SQUARE_SIZE)
-#define sqinfo_negate(f)           flag_negate(f, SQUARE_SIZE)
-#define sqinfo_copy(f1, f2)        flag_copy(f1, f2, SQUARE_SIZE)
-#define sqinfo_union(f1, f2)       flag_union(f1, f2, SQUARE_SIZE)
-#define sqinfo_inter(f1, f2)       flag_inter(f1, f2, SQUARE_SIZE)
-#define sqinfo_diff(f1, f2)        flag_diff(f1, f2, SQUARE_SIZE)
+/**
+ * Square flags are held as one level-wide bit plane per flag (see
+ * chunk.info), so whole-level passes over a flag are word operations
+ */
+#define sqinfo_has(c, grid, flag)  bitmap_has((c)->info[flag], grid)
+#define sqinfo_on(c, grid, flag)   bitmap_on((c)->info[flag], grid)
+#define sqinfo_off(c, grid, flag)  bitmap_off((c)->info[flag], grid)
 
 
 /**
@@ -157,7 +149,6 @@ struct grid_data {
 
 struct square {
 	byte feat;
-	bitflag *info;
 	int light;
 	s16b mon;
 	struct object *obj;
@@ -192,6 +183,7 @@ struct chunk {
 	int *feat_count;
 
 	struct square **squares;
+	struct bitmap *info[SQUARE_MAX];	/**< Square flag planes, by flag */
 	struct heatmap noise;
 	struct heatmap scent;
 	struct loc decoy;
@@ -208,6 +200,9 @@ struct chunk {
 	struct monster_group **monster_groups;
 
 	struct connector *join;
+
+	struct mem_arena *arena;	/**< Memory which lasts as long as the chunk */
+	struct trap *spare_traps;	/**< Removed traps, for reuse */
 };
 
 /*** Feature Indexes (see "lib/gamedata/terrain.txt") ***/
@@ -244,9 +239,6 @@ extern int FEAT_LAVA;
 
 /* Current level */
 extern struct chunk *cave;
-/* Stored levels */
-extern struct chunk **chunk_list;
-extern u16b chunk_list_max;
 
 /* cave-view.c */
 int distance(struct loc grid1, struct loc grid2);
@@ -391,6 +383,8 @@ void square_sense_pile(struct chunk *c, struct loc grid);
 void square_know_pile(struct chunk *c, struct loc grid);
 int square_num_walls_adjacent(struct chunk *c, struct loc grid);
 int square_num_walls_diagonal(struct chunk *c, struct loc grid);
+void sqinfo_get(struct chunk *c, struct loc grid, bitflag *info);
+void sqinfo_set(struct chunk *c, struct loc grid, const bitflag *info);
 
 
 /* Feature placers */
@@ -453,6 +447,8 @@ int count_feats(struct loc *grid,
 				bool (*test)(struct chunk *c, struct loc grid), bool under);
 struct loc cave_find_decoy(struct chunk *c);
 void prepare_next_level(struct chunk **c, struct player *p);
+struct chunk *speculate_next_level(struct player *p);
+void discard_speculative_level(struct player *p);
 bool is_quest(int level);
 
 void cave_known(struct player *p);
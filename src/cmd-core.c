@@ -20,6 +20,7 @@
 #include "angband.h"
 #include "cmds.h"
 #include "cmd-core.h"
+#include "cmd-journal.h"
 #include "game-input.h"
 #include "obj-chest.h"
 #include "obj-desc.h"
@@ -153,6 +154,11 @@ static struct command cmd_queue[CMD_QUEUE_SIZE];
 static bool repeat_prev_allowed = false;
 static bool repeating = false;
 
+/**
+ * How many commands are being carried out, one inside another
+ */
+static int cmd_depth = 0;
+
 struct command *cmdq_peek(void)
 {
 	return &cmd_queue[prev_cmd_idx(cmd_head)];
@@ -228,11 +234,18 @@ void process_command(cmd_context ctx, struct command *cmd)
 
 	/* Actually execute the command function */
 	if (game_cmds[idx].fn) {
+		bool attacked = false;
+
+		cmd_depth++;
+
 		/* Occasional attack instead for bloodlust-affected characters */
-		if (randint0(200) < player->timed[TMD_BLOODLUST]) {
-			if (player_attack_random_monster(player)) return;
-		}
-		game_cmds[idx].fn(cmd);
+		if (randint0(200) < player->timed[TMD_BLOODLUST])
+			attacked = player_attack_random_monster(player);
+		if (!attacked)
+			game_cmds[idx].fn(cmd);
+
+		cmd_depth--;
+		if (attacked) return;
 	}
 
 	/* If the command hasn't changed nrepeats, count this execution. */
@@ -255,6 +268,10 @@ bool cmdq_pop(cmd_context c)
 		cmd = &cmd_queue[cmd_tail++];
 		if (cmd_tail == CMD_QUEUE_SIZE)
 			cmd_tail = 0;
+
+		/* Store commands come straight from the UI */
+		if (c == CMD_STORE)
+			journal_command(cmd, c);
 	} else {
 		/* Failure to get a command. */
 		return false;
@@ -265,6 +282,28 @@ bool cmdq_pop(cmd_context c)
 	return true;
 }
 
+/**
+ * Ask the UI for commands, and note the ones it queues in the journal.
+ */
+void cmdq_fill(cmd_context c)
+{
+	int i = cmd_head;
+
+	journal_wait();
+	cmd_get_hook(c);
+	for (; i != cmd_head; i = (i + 1) % CMD_QUEUE_SIZE)
+		journal_command(&cmd_queue[i], c);
+	journal_run();
+}
+
+/**
+ * Whether the game is in the middle of carrying out a command
+ */
+bool cmd_in_progress(void)
+{
+	return cmd_depth > 0;
+}
+
 /**
  * Inserts a command in the queue to be carried out, with the given
  * number of repeats.
@@ -327,6 +366,16 @@ void cmd_cancel_repeat(void)
 	}
 }
 
+/**
+ * Forget the commands waiting in the queue, and any repeats.
+ */
+void cmdq_flush(void)
+{
+	cmd_tail = cmd_head;
+	cmd_queue[prev_cmd_idx(cmd_tail)].nrepeats = 0;
+	repeating = false;
+}
+
 /**
  * Update the number of repeats pending for the current command.
  */
@@ -234,6 +234,16 @@ extern errr (*cmd_get_hook)(cmd_context c);
  */
 bool cmdq_pop(cmd_context c);
 
+/**
+ * Gets commands from the UI, by way of cmd_get_hook
+ */
+void cmdq_fill(cmd_context c);
+
+/**
+ * Whether a command is being carried out
+ */
+bool cmd_in_progress(void);
+
 /**
  * Insert commands in the queue.
  */
@@ -257,6 +267,11 @@ void cmdq_execute(cmd_context ctx);
  */
 void cmd_cancel_repeat(void);
 
+/**
+ * Forget the commands waiting in the queue, and any repeats.
+ */
+void cmdq_flush(void);
+
 /**
  * Update the number of repeats pending for the current command.
  */
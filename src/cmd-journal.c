@@ -0,0 +1,989 @@
+/**
+ * \file cmd-journal.c
+ * \brief Record the commands of a game, and replay them
+ *
+ * Copyright (c) 2026 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ *
+ * A journal starts with a savefile of the game as it was when the journal
+ * was opened, and the state of the RNG.  After that come records of what
+ * the UI gave the game: the commands it queued each time the game asked for
+ * some, the answers to questions asked by those commands, and the times the
+ * player cut short a repeated command.  Every so often there is a hash of
+ * the game's state, so that a replay can tell it is still on course.
+ *
+ * A replay loads the savefile and feeds the records back to the game, with
+ * no UI, so the game does exactly what it did the first time.  Things the
+ * UI changes directly rather than by commands, like options and ignore
+ * settings, are not recorded; the checkpoints will catch a replay that
+ * goes astray because of them.
+ */
+
+#include "angband.h"
+#include "cave.h"
+#include "cmd-journal.h"
+#include "game-event.h"
+#include "game-world.h"
+#include "init.h"
+#include "generate.h"
+#include "obj-pile.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+#include "player-util.h"
+#include "savefile.h"
+#include "store.h"
+#include "target.h"
+
+/**
+ * Start of every journal
+ */
+static const char journal_magic[4] = { 'A', 'J', 'N', 'L' };
+#define JOURNAL_VERSION 1
+
+/**
+ * Times the game runs between checkpoints
+ */
+#define JOURNAL_CHECK_RUNS 64
+
+/**
+ * The records in a journal
+ */
+enum journal_record {
+	JOURNAL_COMMAND = 'C',		/* A command from the UI */
+	JOURNAL_TARGET = 'T',		/* The UI changed the target */
+	JOURNAL_RUN = 'R',			/* The game ran until it needed input */
+	JOURNAL_ANSWER = 'A',		/* The answer to a question */
+	JOURNAL_INTERRUPT = 'I',	/* The player interrupted a repeat */
+	JOURNAL_SPECULATE = 'S',	/* The next level was built while idle */
+	JOURNAL_CHECKPOINT = 'H',	/* A hash of the game's state */
+	JOURNAL_END = 'E'
+};
+
+/**
+ * Where an object named in the journal is
+ */
+enum {
+	JOURNAL_OBJ_NONE = 0,
+	JOURNAL_OBJ_GEAR,
+	JOURNAL_OBJ_FLOOR,
+	JOURNAL_OBJ_STORE
+};
+
+/**
+ * The journal being recorded, if any
+ */
+static ang_file *journal_file;
+static u32b journal_runs;
+static u32b journal_checks;
+static struct target journal_target;
+static bool journal_target_set;
+
+/**
+ * How deep the game is in asking the UI questions
+ */
+static int journal_asking;
+
+/**
+ * The journal being replayed, if any
+ */
+static struct {
+	byte *buf;
+	size_t len;
+	size_t pos;
+	struct journal_report *report;
+} replay;
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Shared parts
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Read the whole of a file into memory, to be freed by the caller
+ */
+static byte *journal_slurp(const char *path, size_t *len)
+{
+	ang_file *f = file_open(path, MODE_READ, FTYPE_RAW);
+	size_t size = 4096;
+	byte *buf;
+	int n;
+
+	if (!f) return NULL;
+	buf = mem_alloc(size);
+	*len = 0;
+	while ((n = file_read(f, (char *) buf + *len, size - *len)) > 0) {
+		*len += n;
+		if (*len == size) {
+			size *= 2;
+			buf = mem_realloc(buf, size);
+		}
+	}
+	file_close(f);
+	return buf;
+}
+
+static u32b hash_int(u32b h, s32b v)
+{
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		h ^= ((u32b) v >> (i * 8)) & 0xff;
+		h *= 16777619;
+	}
+	return h;
+}
+
+/**
+ * Make a hash of the parts of the game's state that a replay going astray
+ * would soon change: the player, their gear, the monsters and the RNG
+ */
+u32b journal_state_hash(void)
+{
+	u32b h = 2166136261U;
+	struct object *obj;
+	int i, j;
+
+	h = hash_int(h, turn);
+	h = hash_int(h, player->depth);
+	h = hash_int(h, player->grid.x);
+	h = hash_int(h, player->grid.y);
+	h = hash_int(h, player->chp);
+	h = hash_int(h, player->csp);
+	h = hash_int(h, player->exp);
+	h = hash_int(h, player->au);
+	h = hash_int(h, player->energy);
+	h = hash_int(h, player->total_energy);
+	for (i = 0; i < TMD_MAX; i++)
+		h = hash_int(h, player->timed[i]);
+
+	for (obj = player->gear; obj; obj = obj->next) {
+		h = hash_int(h, obj->kind->kidx);
+		h = hash_int(h, obj->number);
+	}
+
+	if (cave) {
+		for (i = 1; i < cave_monster_max(cave); i++) {
+			struct monster *mon = cave_monster(cave, i);
+
+			if (!mon->race) continue;
+			h = hash_int(h, mon->race->ridx);
+			h = hash_int(h, mon->grid.x);
+			h = hash_int(h, mon->grid.y);
+			h = hash_int(h, mon->hp);
+		}
+	}
+
+	/* The display's stream of numbers can be used differently in a replay */
+	for (i = 0; i < RNG_MAX; i++) {
+		struct rand_stream_state s;
+
+		if (i == RNG_COSMETIC) continue;
+		Rand_stream_get(i, &s);
+		h = hash_int(h, s.state_i);
+		for (j = 0; j < RAND_DEG; j++)
+			h = hash_int(h, s.state[j]);
+	}
+
+	return h;
+}
+
+/**
+ * Find the nth object in a list
+ */
+static struct object *journal_nth(struct object *list, int n)
+{
+	while (list && n--)
+		list = list->next;
+	return list;
+}
+
+/**
+ * Find an object in a list, or its known version, giving its place
+ */
+static bool journal_find(struct object *list, const struct object *obj,
+						 int *n, bool *known)
+{
+	for (*n = 0; list; list = list->next, (*n)++) {
+		if (list == obj || (list->known && list->known == obj)) {
+			*known = (list != obj);
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Load a savefile over the game being played, and carry on from it.
+ *
+ * Not everything the game knows is in the savefile, so the game being
+ * recorded does this too, to be in the same state as a replay will be.
+ */
+static bool journal_load(const char *save)
+{
+	int i;
+
+	/* The monsters of the game being replaced no longer count, nor does
+	 * what its player was in the middle of or carrying */
+	for (i = 0; i < z_info->r_max; i++)
+		r_info[i].cur_num = 0;
+	player->upkeep->total_weight = 0;
+	player->upkeep->energy_use = 0;
+	player->upkeep->resting = 0;
+	player->upkeep->running = 0;
+	cmdq_flush();
+
+	if (!savefile_load(save, false)) return false;
+	if (!character_dungeon)
+		prepare_next_level(&cave, player);
+	on_new_level();
+	return true;
+}
+
+bool journal_recording(void)
+{
+	return journal_file != NULL;
+}
+
+bool journal_replaying(void)
+{
+	return replay.buf != NULL;
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Recording
+ * ------------------------------------------------------------------------ */
+
+static void put_byte(byte b)
+{
+	file_writec(journal_file, b);
+}
+
+static void put_u32b(u32b v)
+{
+	put_byte(v & 0xff);
+	put_byte((v >> 8) & 0xff);
+	put_byte((v >> 16) & 0xff);
+	put_byte((v >> 24) & 0xff);
+}
+
+/**
+ * Numbers are mostly small, so they are written seven bits at a time
+ */
+static void put_uvar(u32b v)
+{
+	while (v >= 0x80) {
+		put_byte((v & 0x7f) | 0x80);
+		v >>= 7;
+	}
+	put_byte(v);
+}
+
+static void put_svar(s32b v)
+{
+	put_uvar(((u32b) v << 1) ^ (u32b) -(v < 0));
+}
+
+static void put_string(const char *str)
+{
+	size_t len = strlen(str);
+
+	put_uvar(len);
+	file_write(journal_file, str, len);
+}
+
+static void put_target(bool set, const struct target *t)
+{
+	put_byte(set);
+	put_svar(t->midx);
+	put_svar(t->grid.x);
+	put_svar(t->grid.y);
+}
+
+/**
+ * Write where an object is, so a replay can find it again
+ */
+static void put_object(const struct object *obj)
+{
+	struct store *store = store_at(cave, player->grid);
+	int where = JOURNAL_OBJ_NONE, n = 0;
+	bool known = false;
+
+	if (!obj) {
+		put_byte(JOURNAL_OBJ_NONE);
+		return;
+	}
+
+	if (journal_find(player->gear, obj, &n, &known)) {
+		where = JOURNAL_OBJ_GEAR;
+	} else if (journal_find(square_object(cave, player->grid), obj, &n,
+							&known)) {
+		where = JOURNAL_OBJ_FLOOR;
+	} else if (store && journal_find(store->stock, obj, &n, &known)) {
+		where = JOURNAL_OBJ_STORE;
+	} else if (store && journal_find(store->stock_k, obj, &n, &known)) {
+		where = JOURNAL_OBJ_STORE;
+		known = true;
+	}
+
+	put_byte(where);
+	if (where != JOURNAL_OBJ_NONE) {
+		put_uvar(n);
+		put_byte(known);
+	}
+}
+
+static void put_checkpoint(void)
+{
+	put_byte(JOURNAL_CHECKPOINT);
+	put_uvar(journal_checks++);
+	put_u32b(journal_state_hash());
+}
+
+/**
+ * Start recording the game to a journal at `path`.
+ *
+ * This is done once the game has started and the player is on a level,
+ * and puts a savefile of the game at this point in the journal.
+ */
+bool journal_open(const char *path)
+{
+	char save[1024];
+	struct rand_state rng;
+	byte *data;
+	size_t len;
+	int i, j;
+
+	journal_close();
+
+	/* Keep the game as it is now, and start again from there */
+	strnfmt(save, sizeof(save), "%s.sav", path);
+	if (!savefile_save(save)) return false;
+	data = journal_slurp(save, &len);
+	if (data && !journal_load(save)) {
+		mem_free(data);
+		data = NULL;
+	}
+	file_delete(save);
+	if (!data) return false;
+
+	journal_file = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!journal_file) {
+		mem_free(data);
+		return false;
+	}
+
+	file_write(journal_file, journal_magic, sizeof(journal_magic));
+	put_byte(JOURNAL_VERSION);
+	put_uvar(len);
+	file_write(journal_file, (const char *) data, len);
+	mem_free(data);
+
+	Rand_state_save(&rng);
+	put_byte(rng.quick);
+	put_u32b(rng.value);
+	put_byte(rng.stream);
+	for (i = 0; i < RNG_MAX; i++) {
+		put_u32b(rng.streams[i].state_i);
+		for (j = 0; j < RAND_DEG; j++)
+			put_u32b(rng.streams[i].state[j]);
+		put_u32b(rng.streams[i].z0);
+		put_u32b(rng.streams[i].z1);
+		put_u32b(rng.streams[i].z2);
+	}
+
+	journal_runs = 0;
+	journal_checks = 0;
+	journal_asking = 0;
+	put_checkpoint();
+	return true;
+}
+
+/**
+ * Finish the journal being recorded, if any
+ */
+void journal_close(void)
+{
+	if (!journal_file) return;
+
+	put_checkpoint();
+	put_byte(JOURNAL_END);
+	file_close(journal_file);
+	journal_file = NULL;
+}
+
+/**
+ * Record a command from the UI, as it is about to be carried out
+ */
+void journal_command(struct command *cmd, cmd_context ctx)
+{
+	int i, n = 0;
+
+	if (!journal_file) return;
+
+	put_byte(JOURNAL_COMMAND);
+	put_byte(ctx);
+	put_uvar(cmd->code);
+	put_svar(cmd->nrepeats);
+
+	for (i = 0; i < CMD_MAX_ARGS; i++)
+		if (cmd->arg[i].name[0]) n++;
+	put_byte(n);
+
+	for (i = 0; i < CMD_MAX_ARGS; i++) {
+		struct cmd_arg *arg = &cmd->arg[i];
+
+		if (!arg->name[0]) continue;
+		put_string(arg->name);
+		put_byte(arg->type);
+		switch (arg->type) {
+			case arg_STRING:
+				put_string(arg->data.string ? arg->data.string : "");
+				break;
+			case arg_CHOICE:
+				put_svar(arg->data.choice);
+				break;
+			case arg_NUMBER:
+				put_svar(arg->data.number);
+				break;
+			case arg_DIRECTION:
+			case arg_TARGET:
+				put_svar(arg->data.direction);
+				break;
+			case arg_POINT:
+				put_svar(arg->data.point.x);
+				put_svar(arg->data.point.y);
+				break;
+			case arg_ITEM:
+				put_object(arg->data.obj);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Note what the UI could change while it is getting commands
+ */
+void journal_wait(void)
+{
+	if (!journal_file) return;
+	journal_target_set = target_get_state(&journal_target);
+}
+
+/**
+ * Record that the UI has queued its commands, and the game is to run
+ */
+void journal_run(void)
+{
+	struct target t;
+	bool set;
+
+	if (!journal_file) return;
+
+	set = target_get_state(&t);
+	if ((set != journal_target_set) ||
+		memcmp(&t, &journal_target, sizeof(t))) {
+		put_byte(JOURNAL_TARGET);
+		put_target(set, &t);
+	}
+
+	if (!(++journal_runs % JOURNAL_CHECK_RUNS))
+		put_checkpoint();
+	put_byte(JOURNAL_RUN);
+}
+
+/**
+ * Record that the player has stopped a repeated command
+ */
+void journal_interrupt(void)
+{
+	if (!journal_file) return;
+
+	put_byte(JOURNAL_INTERRUPT);
+	put_svar(turn);
+	put_uvar(player->total_energy);
+}
+
+/**
+ * Record that the next level has been built while the game was idle
+ */
+void journal_speculate(void)
+{
+	if (!journal_file) return;
+	put_byte(JOURNAL_SPECULATE);
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Replaying
+ * ------------------------------------------------------------------------ */
+
+/**
+ * Stop the replay with an error, keeping the first one
+ */
+static void replay_fail(const char *fmt, ...)
+{
+	va_list vp;
+
+	if (!replay.report->passed) return;
+	replay.report->passed = false;
+
+	va_start(vp, fmt);
+	vstrnfmt(replay.report->error, sizeof(replay.report->error), fmt, vp);
+	va_end(vp);
+
+	/* Let the game stop as soon as it can */
+	replay.pos = replay.len;
+}
+
+static bool replay_failed(void)
+{
+	return !replay.report->passed;
+}
+
+static byte take_byte(void)
+{
+	if (replay.pos >= replay.len) {
+		replay_fail("The journal ends early.");
+		return 0;
+	}
+	return replay.buf[replay.pos++];
+}
+
+static u32b take_u32b(void)
+{
+	u32b v = take_byte();
+
+	v |= (u32b) take_byte() << 8;
+	v |= (u32b) take_byte() << 16;
+	v |= (u32b) take_byte() << 24;
+	return v;
+}
+
+static u32b take_uvar(void)
+{
+	u32b v = 0;
+	int shift = 0;
+	byte b;
+
+	do {
+		b = take_byte();
+		v |= (u32b) (b & 0x7f) << shift;
+		shift += 7;
+	} while ((b & 0x80) && (shift < 35));
+	return v;
+}
+
+static s32b take_svar(void)
+{
+	u32b v = take_uvar();
+
+	return (s32b) (v >> 1) ^ -(s32b) (v & 1);
+}
+
+static void take_string(char *buf, size_t size)
+{
+	size_t len = take_uvar();
+
+	if ((len >= size) || (len > replay.len - replay.pos)) {
+		replay_fail("A string in the journal is too long.");
+		buf[0] = '\0';
+		return;
+	}
+	memcpy(buf, replay.buf + replay.pos, len);
+	buf[len] = '\0';
+	replay.pos += len;
+}
+
+static void take_target(void)
+{
+	struct target t;
+	bool set = take_byte() ? true : false;
+
+	t.midx = take_svar();
+	t.grid.x = take_svar();
+	t.grid.y = take_svar();
+	target_set_state(&t, set);
+}
+
+static struct object *take_object(void)
+{
+	struct store *store = store_at(cave, player->grid);
+	int where = take_byte();
+	struct object *obj = NULL;
+	int n;
+	bool known;
+
+	if (where == JOURNAL_OBJ_NONE) return NULL;
+	n = take_uvar();
+	known = take_byte() ? true : false;
+
+	if (where == JOURNAL_OBJ_GEAR) {
+		obj = journal_nth(player->gear, n);
+	} else if (where == JOURNAL_OBJ_FLOOR) {
+		obj = journal_nth(square_object(cave, player->grid), n);
+	} else if ((where == JOURNAL_OBJ_STORE) && store) {
+		obj = journal_nth(known ? store->stock_k : store->stock, n);
+		known = false;
+	}
+
+	if (!obj) {
+		replay_fail("An object in the journal can't be found.");
+		return NULL;
+	}
+	return known ? obj->known : obj;
+}
+
+/**
+ * Look at the next record without reading it
+ */
+static int replay_peek(void)
+{
+	return (replay.pos < replay.len) ? replay.buf[replay.pos] : EOF;
+}
+
+/**
+ * Read a command, giving its context
+ */
+static void take_command(struct command *cmd, cmd_context *ctx)
+{
+	int i, n;
+
+	memset(cmd, 0, sizeof(*cmd));
+	*ctx = take_byte();
+	cmd->code = take_uvar();
+	cmd->nrepeats = take_svar();
+	n = take_byte();
+
+	for (i = 0; i < n; i++) {
+		char name[sizeof(cmd->arg[0].name)];
+		char str[1024];
+		int x;
+
+		take_string(name, sizeof(name));
+		if (!name[0] || (i >= CMD_MAX_ARGS)) {
+			replay_fail("A command in the journal is mangled.");
+			return;
+		}
+
+		switch (take_byte()) {
+			case arg_STRING:
+				take_string(str, sizeof(str));
+				cmd_set_arg_string(cmd, name, str);
+				break;
+			case arg_CHOICE:
+				cmd_set_arg_choice(cmd, name, take_svar());
+				break;
+			case arg_NUMBER:
+				cmd_set_arg_number(cmd, name, take_svar());
+				break;
+			case arg_DIRECTION:
+				cmd_set_arg_direction(cmd, name, take_svar());
+				break;
+			case arg_TARGET:
+				cmd_set_arg_target(cmd, name, take_svar());
+				break;
+			case arg_POINT:
+				x = take_svar();
+				cmd_set_arg_point(cmd, name, x, take_svar());
+				break;
+			case arg_ITEM:
+				cmd_set_arg_item(cmd, name, take_object());
+				break;
+			default:
+				replay_fail("A command in the journal is mangled.");
+				return;
+		}
+	}
+
+	replay.report->commands++;
+}
+
+/**
+ * Read an answer of the given kind, or skip it if `a` is NULL
+ */
+static void take_answer(enum journal_ask kind, struct journal_answer *a)
+{
+	struct journal_answer skip;
+	char str[1024];
+
+	if (!a) {
+		memset(&skip, 0, sizeof(skip));
+		a = &skip;
+	}
+
+	a->result = take_svar();
+	a->value = take_svar();
+	if (kind == JOURNAL_ITEM)
+		a->obj = take_object();
+	if (kind == JOURNAL_STRING) {
+		take_string(str, sizeof(str));
+		if (a->buf) my_strcpy(a->buf, str, a->len);
+	}
+	if (kind == JOURNAL_AIM_DIR)
+		take_target();
+}
+
+/**
+ * Stop a repeated command where the player did
+ */
+static void replay_check_interrupt(game_event_type type,
+								   game_event_data *data, void *user)
+{
+	size_t pos = replay.pos;
+
+	if (replay_peek() != JOURNAL_INTERRUPT) return;
+	replay.pos++;
+	if ((take_svar() == turn) && (take_uvar() == player->total_energy))
+		disturb(player, 0);
+	else
+		replay.pos = pos;
+}
+
+static void replay_enter_store(game_event_type type, game_event_data *data,
+							   void *user);
+
+/**
+ * Carry out what the player did in a store
+ */
+static void replay_use_store(game_event_type type, game_event_data *data,
+							 void *user)
+{
+	while (!replay_failed()) {
+		struct command cmd;
+		cmd_context ctx;
+
+		if (replay_peek() == JOURNAL_ANSWER) {
+			/* The store's own questions are for the UI alone */
+			replay.pos++;
+			take_answer(take_byte(), NULL);
+		} else if ((replay_peek() == JOURNAL_COMMAND) &&
+				   (replay.pos + 1 < replay.len) &&
+				   (replay.buf[replay.pos + 1] == CMD_STORE)) {
+			replay.pos++;
+			take_command(&cmd, &ctx);
+			if (replay_failed()) break;
+			cmdq_push_copy(&cmd);
+			cmdq_pop(CMD_STORE);
+		} else {
+			break;
+		}
+	}
+}
+
+/**
+ * Leave a store, as the UI would
+ */
+static void replay_leave_store(game_event_type type, game_event_data *data,
+							   void *user)
+{
+	cmd_disable_repeat();
+	player->upkeep->update |= (PU_UPDATE_VIEW | PU_MONSTERS);
+
+	/* The handlers for stores go once they have been used */
+	event_add_handler(EVENT_ENTER_STORE, replay_enter_store, NULL);
+}
+
+static void replay_enter_store(game_event_type type, game_event_data *data,
+							   void *user)
+{
+	event_add_handler(EVENT_USE_STORE, replay_use_store, NULL);
+	event_add_handler(EVENT_LEAVE_STORE, replay_leave_store, NULL);
+}
+
+/**
+ * Answer a question the game asks during a command, from the journal when
+ * replaying.  Otherwise the question goes to the UI, and the answer must
+ * then be given to journal_answered().
+ */
+bool journal_ask(enum journal_ask kind, struct journal_answer *a)
+{
+	/* Only questions asked by commands themselves are in the journal */
+	if (!replay.buf || journal_asking || !cmd_in_progress()) {
+		journal_asking++;
+		return false;
+	}
+
+	if (replay_failed()) return true;
+
+	if ((replay_peek() != JOURNAL_ANSWER) ||
+		(replay.pos + 1 >= replay.len) ||
+		(replay.buf[replay.pos + 1] != kind)) {
+		replay_fail("The game asked a question the journal doesn't answer.");
+		return true;
+	}
+	replay.pos += 2;
+	take_answer(kind, a);
+	return true;
+}
+
+/**
+ * Record the UI's answer to a question, if the command asked it
+ */
+void journal_answered(enum journal_ask kind, const struct journal_answer *a)
+{
+	journal_asking--;
+	if (!journal_file || journal_asking || !cmd_in_progress()) return;
+
+	put_byte(JOURNAL_ANSWER);
+	put_byte(kind);
+	put_svar(a->result);
+	put_svar(a->value);
+	if (kind == JOURNAL_ITEM)
+		put_object(a->obj);
+	if (kind == JOURNAL_STRING)
+		put_string(a->result ? a->buf : "");
+	if (kind == JOURNAL_AIM_DIR) {
+		struct target t;
+		bool set = target_get_state(&t);
+		put_target(set, &t);
+	}
+}
+
+/**
+ * Replay the journal at `path`, starting from the savefile it holds, and
+ * fill in `report` with what happened.
+ *
+ * Returns whether the game did just what it did when the journal was made.
+ */
+bool journal_replay(const char *path, struct journal_report *report)
+{
+	char save[1024];
+	struct rand_state rng;
+	ang_file *f;
+	s32b start;
+	size_t len;
+	int i, j;
+
+	memset(report, 0, sizeof(*report));
+	report->passed = true;
+	replay.report = report;
+	replay.pos = 0;
+	replay.buf = journal_slurp(path, &replay.len);
+	if (!replay.buf) {
+		strnfmt(report->error, sizeof(report->error), "Couldn't read %s.",
+				path);
+		report->passed = false;
+		return false;
+	}
+
+	if ((replay.len < sizeof(journal_magic) + 1) ||
+		memcmp(replay.buf, journal_magic, sizeof(journal_magic)) ||
+		(replay.buf[sizeof(journal_magic)] != JOURNAL_VERSION)) {
+		replay_fail("%s is not a journal this game can replay.", path);
+		mem_free(replay.buf);
+		replay.buf = NULL;
+		return false;
+	}
+	replay.pos = sizeof(journal_magic) + 1;
+
+	/* Start the game as it was */
+	len = take_uvar();
+	strnfmt(save, sizeof(save), "%s.sav", path);
+	f = file_open(save, MODE_WRITE, FTYPE_SAVE);
+	if (!f || (len > replay.len - replay.pos) ||
+		!file_write(f, (const char *) replay.buf + replay.pos, len)) {
+		if (f) file_close(f);
+		replay_fail("Couldn't get the savefile from %s.", path);
+	} else {
+		file_close(f);
+		replay.pos += len;
+		if (!journal_load(save))
+			replay_fail("The savefile in %s doesn't load.", path);
+	}
+	file_delete(save);
+
+	rng.quick = take_byte() ? true : false;
+	rng.value = take_u32b();
+	rng.stream = take_byte();
+	for (i = 0; i < RNG_MAX; i++) {
+		rng.streams[i].state_i = take_u32b();
+		for (j = 0; j < RAND_DEG; j++)
+			rng.streams[i].state[j] = take_u32b();
+		rng.streams[i].z0 = take_u32b();
+		rng.streams[i].z1 = take_u32b();
+		rng.streams[i].z2 = take_u32b();
+	}
+
+	if (!replay_failed()) {
+		player->upkeep->autosave = false;
+		if ((rng.stream < 0) || (rng.stream >= RNG_MAX))
+			replay_fail("The RNG in the journal is mangled.");
+		else
+			Rand_state_restore(&rng);
+	}
+	start = turn;
+
+	event_add_handler(EVENT_CHECK_INTERRUPT, replay_check_interrupt, NULL);
+	event_add_handler(EVENT_ENTER_STORE, replay_enter_store, NULL);
+
+	while (!replay_failed() && (replay_peek() != EOF)) {
+		struct command cmd;
+		cmd_context ctx;
+		int record = take_byte();
+		u32b check;
+
+		switch (record) {
+			case JOURNAL_COMMAND:
+				take_command(&cmd, &ctx);
+				if (replay_failed()) break;
+				if (ctx != CMD_GAME)
+					replay_fail("Command %u is for somewhere else.",
+								report->commands);
+				else if (cmdq_push_copy(&cmd))
+					replay_fail("The command queue is full.");
+				break;
+			case JOURNAL_TARGET:
+				take_target();
+				break;
+			case JOURNAL_RUN:
+				if (player->is_dead || !player->upkeep->playing) {
+					replay_fail("The game ended before the journal did.");
+					break;
+				}
+				run_game_loop();
+				report->runs++;
+				break;
+			case JOURNAL_SPECULATE:
+				speculate_next_level(player);
+				break;
+			case JOURNAL_CHECKPOINT:
+				check = take_uvar();
+				if (take_u32b() != journal_state_hash())
+					replay_fail("Checkpoint %u doesn't match.", check);
+				else
+					report->checkpoints++;
+				break;
+			case JOURNAL_END:
+				replay.pos = replay.len;
+				break;
+			default:
+				replay_fail("Record '%c' turned up at the wrong time.",
+							record);
+				break;
+		}
+	}
+
+	event_remove_handler(EVENT_CHECK_INTERRUPT, replay_check_interrupt, NULL);
+	event_remove_handler(EVENT_ENTER_STORE, replay_enter_store, NULL);
+
+	report->turns = turn - start;
+	mem_free(replay.buf);
+	replay.buf = NULL;
+	return report->passed;
+}
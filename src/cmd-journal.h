@@ -0,0 +1,79 @@
+/**
+ * \file cmd-journal.h
+ * \brief Record the commands of a game, and replay them
+ *
+ * Copyright (c) 2026 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_CMD_JOURNAL_H
+#define INCLUDED_CMD_JOURNAL_H
+
+#include "cmd-core.h"
+
+/**
+ * The kinds of question the game can ask the UI in the middle of a command,
+ * whose answers are kept in the journal
+ */
+enum journal_ask {
+	JOURNAL_STRING = 0,
+	JOURNAL_QUANTITY,
+	JOURNAL_CHECK,
+	JOURNAL_COM,
+	JOURNAL_REP_DIR,
+	JOURNAL_AIM_DIR,
+	JOURNAL_SPELL,
+	JOURNAL_ITEM,
+	JOURNAL_CURSE
+};
+
+/**
+ * An answer from the UI, as given back by the game-input functions
+ */
+struct journal_answer {
+	int result;				/**< What the question returned */
+	int value;				/**< Direction, key or choice given back */
+	struct object *obj;		/**< Object chosen */
+	char *buf;				/**< String given back, and its size */
+	size_t len;
+};
+
+/**
+ * What a replay did
+ */
+struct journal_report {
+	u32b commands;			/**< Commands taken from the journal */
+	u32b runs;				/**< Times the game ran until it needed input */
+	u32b checkpoints;		/**< Checkpoints which matched */
+	s32b turns;				/**< Game turns played */
+	bool passed;			/**< Whether the whole journal replayed */
+	char error[120];		/**< Why not, if it didn't */
+};
+
+bool journal_open(const char *path);
+void journal_close(void);
+bool journal_recording(void);
+bool journal_replaying(void);
+u32b journal_state_hash(void);
+
+void journal_command(struct command *cmd, cmd_context ctx);
+void journal_wait(void);
+void journal_run(void);
+void journal_interrupt(void);
+void journal_speculate(void);
+bool journal_ask(enum journal_ask kind, struct journal_answer *a);
+void journal_answered(enum journal_ask kind, const struct journal_answer *a);
+
+bool journal_replay(const char *path, struct journal_report *report);
+
+#endif /* !INCLUDED_CMD_JOURNAL_H */
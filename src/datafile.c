@@ -25,6 +25,11 @@
 #include "init.h"
 #include "parser.h"
 
+#ifdef HAVE_PTHREAD_H
+# include <pthread.h>
+# include <unistd.h>
+#endif
+
 const char *parser_error_str[PARSE_ERROR_MAX] = {
 	#define PARSE_ERROR(a, b) b,
 	#include "list-parser-errors.h"
@@ -45,6 +50,53 @@ static void print_error(struct file_parser *fp, struct parser *p) {
 	quit_fmt("Parse error in %s line %d column %d.", fp->name, s.line, s.col);
 }
 
+/**
+ * Threads the parsers of a parser list are run on; with none, or where there
+ * are no threads, each is parsed and finished in turn.  Less than none means
+ * one for each processor, up to PARSER_THREADS_MAX, or none with only one.
+ */
+int parser_threads = -1;
+
+#ifdef HAVE_PTHREAD_H
+#define PARSER_THREADS_MAX 4
+
+/**
+ * A parser of a list being run on threads: how many of its needs are still
+ * to be finished, and what came of parsing its file
+ */
+struct parser_task {
+	struct parser_list *entry;
+	int waiting;
+	bool started;
+	bool parsed;
+	struct parser *p;
+	errr r;
+	char missing[80];
+};
+
+static struct parser_task *parser_tasks;
+static size_t parser_tasks_num;
+static pthread_mutex_t parser_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t parser_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t parser_parsed = PTHREAD_COND_INITIALIZER;
+static pthread_once_t parser_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t parser_key;
+
+static void parser_key_make(void)
+{
+	pthread_key_create(&parser_key, NULL);
+}
+
+/**
+ * The task being parsed on this thread, if any
+ */
+static struct parser_task *parser_task_current(void)
+{
+	pthread_once(&parser_key_once, parser_key_make);
+	return pthread_getspecific(parser_key);
+}
+#endif
+
 errr run_parser(struct file_parser *fp) {
 	struct parser *p = fp->init();
 	errr r;
@@ -62,6 +114,191 @@ errr run_parser(struct file_parser *fp) {
 	return r;
 }
 
+/**
+ * Tell the player a parser of a list is being run
+ */
+static void parser_list_announce(struct parser_list *entry)
+{
+	char *msg = string_make(format("Initializing %s...", entry->name));
+	event_signal_message(EVENT_INITSTATUS, 0, msg);
+	string_free(msg);
+}
+
+/**
+ * Whether a parser of a list needs the one called name to be finished first
+ */
+static bool parser_list_needs(const struct parser_list *entry,
+							  const char *name)
+{
+	size_t i;
+
+	for (i = 0; i < PARSER_NEEDS_MAX && entry->needs[i]; i++)
+		if (streq(entry->needs[i], name)) return true;
+	return false;
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * Parse the files of parsers whose needs are all finished, until every
+ * parser in the list has been started
+ */
+static void *parser_list_worker(void *unused)
+{
+	pthread_mutex_lock(&parser_lock);
+	while (true) {
+		struct parser_task *task = NULL;
+		bool left = false;
+		size_t i;
+
+		for (i = 0; i < parser_tasks_num && !task; i++) {
+			if (parser_tasks[i].started) continue;
+			left = true;
+			if (!parser_tasks[i].waiting)
+				task = &parser_tasks[i];
+		}
+		if (!left) break;
+		if (!task) {
+			pthread_cond_wait(&parser_ready, &parser_lock);
+			continue;
+		}
+		task->started = true;
+		pthread_mutex_unlock(&parser_lock);
+
+		pthread_setspecific(parser_key, task);
+		task->p = task->entry->parser->init();
+		if (task->p)
+			task->r = task->entry->parser->run(task->p);
+		pthread_setspecific(parser_key, NULL);
+
+		pthread_mutex_lock(&parser_lock);
+		task->parsed = true;
+		pthread_cond_broadcast(&parser_parsed);
+	}
+	pthread_mutex_unlock(&parser_lock);
+
+	return NULL;
+}
+
+/**
+ * Run a parser list with its files parsed on threads, and each parser
+ * finished on this thread in the order of the list, so the game data ends up
+ * the same, and any error is the same one, as when it is run in turn.
+ *
+ * Returns false if no threads could be had, in which case nothing is done.
+ */
+static bool run_parser_list_threaded(struct parser_list *pl, size_t n,
+									 int num)
+{
+	pthread_t *threads;
+	int started = 0;
+	size_t i, j;
+
+	num = MIN(num, (int) n);
+	threads = mem_zalloc(num * sizeof(*threads));
+
+	pthread_once(&parser_key_once, parser_key_make);
+	parser_tasks = mem_zalloc(n * sizeof(*parser_tasks));
+	parser_tasks_num = n;
+	for (i = 0; i < n; i++) {
+		parser_tasks[i].entry = &pl[i];
+		for (j = 0; j < PARSER_NEEDS_MAX && pl[i].needs[j]; j++) {
+			size_t k;
+
+			for (k = 0; k < i; k++)
+				if (streq(pl[k].name, pl[i].needs[j])) break;
+			if (k == i)
+				quit_fmt("Cannot initialize %s after %s.", pl[i].name,
+						 pl[i].needs[j]);
+			parser_tasks[i].waiting++;
+		}
+	}
+
+	while (started < num &&
+		   !pthread_create(&threads[started], NULL, parser_list_worker, NULL))
+		started++;
+	if (!started) {
+		mem_free(parser_tasks);
+		parser_tasks = NULL;
+		mem_free(threads);
+		return false;
+	}
+
+	for (i = 0; i < n; i++) {
+		struct parser_task *task = &parser_tasks[i];
+
+		parser_list_announce(&pl[i]);
+		pthread_mutex_lock(&parser_lock);
+		while (!task->parsed)
+			pthread_cond_wait(&parser_parsed, &parser_lock);
+		pthread_mutex_unlock(&parser_lock);
+
+		/* Commit the results, just as run_parser() would have */
+		if (task->missing[0])
+			quit_fmt("Cannot open '%s.txt'", task->missing);
+		if (!task->p)
+			quit_fmt("Cannot initialize %s.", pl[i].name);
+		if (task->r) {
+			print_error(pl[i].parser, task->p);
+			quit_fmt("Cannot initialize %s.", pl[i].name);
+		}
+		if (pl[i].parser->finish(task->p)) {
+			print_error(pl[i].parser, task->p);
+			quit_fmt("Cannot initialize %s.", pl[i].name);
+		}
+
+		/* Let the parsers which were waiting for this one go */
+		pthread_mutex_lock(&parser_lock);
+		for (j = i + 1; j < n; j++)
+			if (parser_list_needs(&pl[j], pl[i].name))
+				parser_tasks[j].waiting--;
+		pthread_cond_broadcast(&parser_ready);
+		pthread_mutex_unlock(&parser_lock);
+	}
+
+	while (started)
+		pthread_join(threads[--started], NULL);
+	mem_free(parser_tasks);
+	parser_tasks = NULL;
+	parser_tasks_num = 0;
+	mem_free(threads);
+	return true;
+}
+#endif
+
+/**
+ * Run a list of parsers, quitting if any of them fails.
+ *
+ * Where there are threads, the files of parsers which don't need each other
+ * are parsed at the same time; MEM_TALLY and MEM_TRACK count allocations
+ * without locking, so they keep to one thread.
+ */
+void run_parser_list(struct parser_list *pl, size_t n)
+{
+	size_t i;
+
+#ifdef HAVE_PTHREAD_H
+	int threads = parser_threads;
+
+	if (threads < 0) {
+		long cpus = 1;
+
+#ifdef _SC_NPROCESSORS_ONLN
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+		threads = cpus > 1 ? MIN(cpus, PARSER_THREADS_MAX) : 0;
+	}
+	if (threads > 0 && !(mem_flags & (MEM_TALLY | MEM_TRACK)) &&
+		run_parser_list_threaded(pl, n, threads))
+		return;
+#endif
+
+	for (i = 0; i < n; i++) {
+		parser_list_announce(&pl[i]);
+		if (run_parser(pl[i].parser))
+			quit_fmt("Cannot initialize %s.", pl[i].name);
+	}
+}
+
 /**
  * The basic file parsing function.  Attempt to load filename through
  * parser and perform a quit if the file is not found.
@@ -69,8 +306,18 @@ errr run_parser(struct file_parser *fp) {
 errr parse_file_quit_not_found(struct parser *p, const char *filename) {
 	errr parse_err = parse_file(p, filename);
 
-	if (parse_err == PARSE_ERROR_NO_FILE_FOUND)
-		quit(format("Cannot open '%s.txt'", filename));
+	if (parse_err == PARSE_ERROR_NO_FILE_FOUND) {
+#ifdef HAVE_PTHREAD_H
+		struct parser_task *task = parser_task_current();
+
+		/* Leave quitting to the thread which started the parsing */
+		if (task) {
+			my_strcpy(task->missing, filename, sizeof(task->missing));
+			return parse_err;
+		}
+#endif
+		quit_fmt("Cannot open '%s.txt'", filename);
+	}
 
 	return parse_err;
 }
@@ -81,18 +328,18 @@ errr parse_file_quit_not_found(struct parser *p, const char *filename) {
 errr parse_file(struct parser *p, const char *filename) {
 	char path[1024];
 	char buf[1024];
+	char name[80];
 	ang_file *fh;
 	errr r = 0;
 
 	/* The player can put a customised file in the user directory */
-	path_build(path, sizeof(path), ANGBAND_DIR_USER, format("%s.txt",
-															filename));
+	strnfmt(name, sizeof(name), "%s.txt", filename);
+	path_build(path, sizeof(path), ANGBAND_DIR_USER, name);
 	fh = file_open(path, MODE_READ, FTYPE_TEXT);
 
 	/* If no custom file, just load the standard one */
 	if (!fh) {
-		path_build(path, sizeof(path), ANGBAND_DIR_GAMEDATA,
-				   format("%s.txt", filename));
+		path_build(path, sizeof(path), ANGBAND_DIR_GAMEDATA, name);
 		fh = file_open(path, MODE_READ, FTYPE_TEXT);
 	}
 
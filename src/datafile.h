@@ -30,9 +30,27 @@ struct file_parser {
 	void (*cleanup)(void);
 };
 
+/**
+ * Most parsers in a parser_list entry's needs
+ */
+#define PARSER_NEEDS_MAX 10
+
+/**
+ * A parser run as one of a list by run_parser_list(): the name it is shown
+ * to the player by, and the names of the parsers earlier in the list whose
+ * results it reads, which have to be finished before it can start
+ */
+struct parser_list {
+	const char *name;
+	struct file_parser *parser;
+	const char *needs[PARSER_NEEDS_MAX];
+};
+
 extern const char *parser_error_str[PARSE_ERROR_MAX];
+extern int parser_threads;
 
 errr run_parser(struct file_parser *fp);
+void run_parser_list(struct parser_list *pl, size_t n);
 errr parse_file_quit_not_found(struct parser *p, const char *filename);
 errr parse_file(struct parser *p, const char *filename);
 void cleanup_parser(struct file_parser *fp);
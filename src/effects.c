@@ -1691,11 +1691,18 @@ bool effect_handler_DETECT_TRAPS(effect_handler_context_t *context)
 					detect = true;
 				}
 			}
-			/* Mark as trap-detected */
-			sqinfo_on(square(cave, loc(x, y)).info, SQUARE_DTRAP);
 		}
 	}
 
+	/* Mark the scanned area as trap-detected */
+	y1 = MAX(y1, 1);
+	x1 = MAX(x1, 1);
+	y2 = MIN(y2, cave->height - 1);
+	x2 = MIN(x2, cave->width - 1);
+	if ((y1 < y2) && (x1 < x2))
+		bitmap_rect_setall(cave->info[SQUARE_DTRAP], loc(x1, y1),
+						   loc(x2 - 1, y2 - 1));
+
 	/* Describe */
 	if (detect)
 		msg("You sense the presence of traps!");
@@ -2882,7 +2889,7 @@ bool effect_handler_TELEPORT(effect_handler_context_t *context)
 	monster_swap(start, spots->grid);
 
 	/* Clear any projection marker to prevent double processing */
-	sqinfo_off(square(cave, spots->grid).info, SQUARE_PROJECT);
+	sqinfo_off(cave, spots->grid, SQUARE_PROJECT);
 
 	/* Lots of updates after monster_swap */
 	handle_stuff(player);
@@ -3000,7 +3007,7 @@ bool effect_handler_TELEPORT_TO(effect_handler_context_t *context)
 	monster_swap(start, land);
 
 	/* Clear any projection marker to prevent double processing */
-	sqinfo_off(square(cave, land).info, SQUARE_PROJECT);
+	sqinfo_off(cave, land, SQUARE_PROJECT);
 
 	/* Lots of updates after monster_swap */
 	handle_stuff(player);
@@ -3202,14 +3209,14 @@ bool effect_handler_DESTRUCTION(effect_handler_context_t *context)
 			if (k > r) continue;
 
 			/* Lose room and vault */
-			sqinfo_off(square(cave, grid).info, SQUARE_ROOM);
-			sqinfo_off(square(cave, grid).info, SQUARE_VAULT);
+			sqinfo_off(cave, grid, SQUARE_ROOM);
+			sqinfo_off(cave, grid, SQUARE_VAULT);
 
 			/* Forget completely */
 			if (!square_isbright(cave, grid)) {
-				sqinfo_off(square(cave, grid).info, SQUARE_GLOW);
+				sqinfo_off(cave, grid, SQUARE_GLOW);
 			}
-			sqinfo_off(square(cave, grid).info, SQUARE_SEEN);
+			sqinfo_off(cave, grid, SQUARE_SEEN);
 			square_forget(cave, grid);
 			square_light_spot(cave, grid);
 
@@ -3339,14 +3346,14 @@ bool effect_handler_EARTHQUAKE(effect_handler_context_t *context)
 			if (distance(centre, grid) > r) continue;
 
 			/* Lose room and vault */
-			sqinfo_off(square(cave, grid).info, SQUARE_ROOM);
-			sqinfo_off(square(cave, grid).info, SQUARE_VAULT);
+			sqinfo_off(cave, grid, SQUARE_ROOM);
+			sqinfo_off(cave, grid, SQUARE_VAULT);
 
 			/* Forget completely */
 			if (!square_isbright(cave, grid)) {
-				sqinfo_off(square(cave, grid).info, SQUARE_GLOW);
+				sqinfo_off(cave, grid, SQUARE_GLOW);
 			}
-			sqinfo_off(square(cave, grid).info, SQUARE_SEEN);
+			sqinfo_off(cave, grid, SQUARE_SEEN);
 			square_forget(cave, grid);
 			square_light_spot(cave, grid);
 
@@ -5144,15 +5151,52 @@ static const char *effect_names[] = {
 void free_effect(struct effect *source)
 {
 	struct effect *e = source, *e_next;
+	bool packed = source && source->packed;
+
 	while (e) {
 		e_next = e->next;
 		dice_free(e->dice);
 		if (e->msg) {
 			string_free(e->msg);
 		}
-		mem_free(e);
+		if (!packed)
+			mem_free(e);
 		e = e_next;
 	}
+
+	/* A packed chain is all one allocation */
+	if (packed)
+		mem_free(source);
+}
+
+/**
+ * Pack an effect chain into one block of memory, in order, so that running
+ * it walks through neighbouring memory; this is done once the data files
+ * are parsed, and the old nodes are freed.
+ *
+ * \param source the effects being packed
+ * \return the packed chain, to be used in place of the source
+ */
+struct effect *effect_pack(struct effect *source)
+{
+	struct effect *packed, *e, *e_next;
+	int n = 0, i = 0;
+
+	for (e = source; e; e = e->next)
+		n++;
+	if (n < 2 || source->packed)
+		return source;
+
+	packed = mem_zalloc(n * sizeof(*packed));
+	for (e = source; e; e = e_next, i++) {
+		e_next = e->next;
+		packed[i] = *e;
+		packed[i].packed = true;
+		packed[i].next = e_next ? &packed[i + 1] : NULL;
+		mem_free(e);
+	}
+
+	return packed;
 }
 
 bool effect_valid(const struct effect *effect)
@@ -5433,6 +5477,71 @@ bool effect_do(struct effect *effect,
 	return completed;
 }
 
+/**
+ * The number of dice strings effect_simple() remembers, and the longest
+ * string it will remember
+ */
+#define SIMPLE_DICE_CACHE 32
+#define SIMPLE_DICE_LEN 24
+
+/**
+ * Dice strings used by effect_simple(), with their parsed dice, so that
+ * each call doesn't have to parse its string again
+ */
+static struct {
+	char string[SIMPLE_DICE_LEN];
+	dice_t *dice;
+} simple_dice[SIMPLE_DICE_CACHE];
+
+/**
+ * Get the dice for a dice string from the cache, parsing them into the
+ * string's slot if they aren't there; long strings get new dice, which the
+ * caller must free.
+ */
+static dice_t *simple_dice_get(const char *dice_string, bool *cached)
+{
+	u32b hash = 5381;
+	const char *c;
+	int slot;
+
+	*cached = strlen(dice_string) < SIMPLE_DICE_LEN;
+	if (!*cached) {
+		dice_t *dice = dice_new();
+		dice_parse_string(dice, dice_string);
+		return dice;
+	}
+
+	for (c = dice_string; *c; c++)
+		hash = hash * 33 + (byte) *c;
+	slot = hash % SIMPLE_DICE_CACHE;
+
+	if (!simple_dice[slot].dice) {
+		simple_dice[slot].dice = dice_new();
+	} else if (streq(simple_dice[slot].string, dice_string)) {
+		return simple_dice[slot].dice;
+	}
+
+	my_strcpy(simple_dice[slot].string, dice_string, SIMPLE_DICE_LEN);
+	dice_parse_string(simple_dice[slot].dice, dice_string);
+	return simple_dice[slot].dice;
+}
+
+static void cleanup_simple_dice(void)
+{
+	int i;
+
+	for (i = 0; i < SIMPLE_DICE_CACHE; i++) {
+		dice_free(simple_dice[i].dice);
+		simple_dice[i].dice = NULL;
+	}
+}
+
+struct init_module effects_module = {
+	.name = "effects",
+	.init = NULL,
+	.cleanup = cleanup_simple_dice
+};
+
 /**
  * Perform a single effect with a simple dice string and parameters
  * Calling with ident a valid pointer will (depending on effect) give success
@@ -5451,12 +5560,12 @@ void effect_simple(int index,
 	struct effect effect;
 	int dir = DIR_TARGET;
 	bool dummy_ident = false;
+	bool cached;
 
 	/* Set all the values */
 	memset(&effect, 0, sizeof(effect));
 	effect.index = index;
-	effect.dice = dice_new();
-	dice_parse_string(effect.dice, dice_string);
+	effect.dice = simple_dice_get(dice_string, &cached);
 	effect.subtype = subtype;
 	effect.radius = radius;
 	effect.other = other;
@@ -5473,5 +5582,6 @@ void effect_simple(int index,
 	}
 
 	effect_do(&effect, origin, NULL, ident, true, dir, 0, 0);
-	dice_free(effect.dice);
+	if (!cached)
+		dice_free(effect.dice);
 }
@@ -35,6 +35,7 @@ typedef enum
 /*** Functions ***/
 
 void free_effect(struct effect *source);
+struct effect *effect_pack(struct effect *source);
 bool effect_valid(const struct effect *effect);
 bool effect_aim(const struct effect *effect);
 const char *effect_info(const struct effect *effect);
@@ -18,6 +18,7 @@
 
 #include "angband.h"
 #include "cmd-core.h"
+#include "cmd-journal.h"
 #include "game-input.h"
 
 bool (*get_string_hook)(const char *prompt, char *buf, size_t len);
@@ -48,11 +49,16 @@ bool (*map_is_visible_hook)(void);
  */
 bool get_string(const char *prompt, char *buf, size_t len)
 {
+	struct journal_answer a = { 0, 0, NULL, buf, len };
+
+	if (journal_ask(JOURNAL_STRING, &a))
+		return a.result;
+
 	/* Ask the UI for it */
 	if (get_string_hook)
-		return get_string_hook(prompt, buf, len);
-	else
-		return false;
+		a.result = get_string_hook(prompt, buf, len);
+	journal_answered(JOURNAL_STRING, &a);
+	return a.result;
 }
 
 /**
@@ -64,11 +70,16 @@ bool get_string(const char *prompt, char *buf, size_t len)
  */
 int get_quantity(const char *prompt, int max)
 {
+	struct journal_answer a = { 0, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_QUANTITY, &a))
+		return a.result;
+
 	/* Ask the UI for it */
 	if (get_quantity_hook)
-		return get_quantity_hook(prompt, max);
-	else
-		return 0;
+		a.result = get_quantity_hook(prompt, max);
+	journal_answered(JOURNAL_QUANTITY, &a);
+	return a.result;
 }
 
 /**
@@ -82,11 +93,16 @@ int get_quantity(const char *prompt, int max)
  */
 bool get_check(const char *prompt)
 {
+	struct journal_answer a = { 0, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_CHECK, &a))
+		return a.result;
+
 	/* Ask the UI for it */
 	if (get_check_hook)
-		return get_check_hook(prompt);
-	else
-		return false;
+		a.result = get_check_hook(prompt);
+	journal_answered(JOURNAL_CHECK, &a);
+	return a.result;
 }
 
 /**
@@ -98,11 +114,19 @@ bool get_check(const char *prompt)
  */
 bool get_com(const char *prompt, char *command)
 {
+	struct journal_answer a = { 0, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_COM, &a)) {
+		if (a.result) *command = (char) a.value;
+		return a.result;
+	}
+
 	/* Ask the UI for it */
 	if (get_com_hook)
-		return get_com_hook(prompt, command);
-	else
-		return false;
+		a.result = get_com_hook(prompt, command);
+	if (a.result) a.value = *command;
+	journal_answered(JOURNAL_COM, &a);
+	return a.result;
 }
 
 
@@ -115,11 +139,19 @@ bool get_com(const char *prompt, char *command)
  */
 bool get_rep_dir(int *dir, bool allow_none)
 {
+	struct journal_answer a = { 0, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_REP_DIR, &a)) {
+		if (a.result) *dir = a.value;
+		return a.result;
+	}
+
 	/* Ask the UI for it */
 	if (get_rep_dir_hook)
-		return get_rep_dir_hook(dir, allow_none);
-	else
-		return false;
+		a.result = get_rep_dir_hook(dir, allow_none);
+	if (a.result) a.value = *dir;
+	journal_answered(JOURNAL_REP_DIR, &a);
+	return a.result;
 }
 
 /**
@@ -130,11 +162,20 @@ bool get_rep_dir(int *dir, bool allow_none)
  */
 bool get_aim_dir(int *dir)
 {
+	struct journal_answer a = { 0, 0, NULL, NULL, 0 };
+
+	/* The journal keeps the target too, as the UI may have changed it */
+	if (journal_ask(JOURNAL_AIM_DIR, &a)) {
+		if (a.result) *dir = a.value;
+		return a.result;
+	}
+
 	/* Ask the UI for it */
 	if (get_aim_dir_hook)
-		return get_aim_dir_hook(dir);
-	else
-		return false;
+		a.result = get_aim_dir_hook(dir);
+	if (a.result) a.value = *dir;
+	journal_answered(JOURNAL_AIM_DIR, &a);
+	return a.result;
 }
 
 /**
@@ -143,11 +184,16 @@ bool get_aim_dir(int *dir)
 int get_spell_from_book(const char *verb, struct object *book,
 		const char *error, bool (*spell_filter)(int spell))
 {
+	struct journal_answer a = { -1, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_SPELL, &a))
+		return a.result;
+
 	/* Ask the UI for it */
 	if (get_spell_from_book_hook)
-		return get_spell_from_book_hook(verb, book, error, spell_filter);
-	else
-		return -1;
+		a.result = get_spell_from_book_hook(verb, book, error, spell_filter);
+	journal_answered(JOURNAL_SPELL, &a);
+	return a.result;
 }
 
 /**
@@ -157,11 +203,16 @@ int get_spell(const char *verb, item_tester book_filter,
 						cmd_code cmd, const char *error,
 						bool (*spell_filter)(int spell))
 {
+	struct journal_answer a = { -1, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_SPELL, &a))
+		return a.result;
+
 	/* Ask the UI for it */
 	if (get_spell_hook)
-		return get_spell_hook(verb, book_filter, cmd, error, spell_filter);
-	else
-		return -1;
+		a.result = get_spell_hook(verb, book_filter, cmd, error, spell_filter);
+	journal_answered(JOURNAL_SPELL, &a);
+	return a.result;
 }
 
 /**
@@ -182,11 +233,19 @@ int get_spell(const char *verb, item_tester book_filter,
 bool get_item(struct object **choice, const char *pmt, const char *str,
 			  cmd_code cmd, item_tester tester, int mode)
 {
+	struct journal_answer a = { 0, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_ITEM, &a)) {
+		if (a.result) *choice = a.obj;
+		return a.result;
+	}
+
 	/* Ask the UI for it */
 	if (get_item_hook)
-		return get_item_hook(choice, pmt, str, cmd, tester, mode);
-	else
-		return false;
+		a.result = get_item_hook(choice, pmt, str, cmd, tester, mode);
+	if (a.result) a.obj = *choice;
+	journal_answered(JOURNAL_ITEM, &a);
+	return a.result;
 }
 
 /**
@@ -194,11 +253,19 @@ bool get_item(struct object **choice, const char *pmt, const char *str,
  */
 bool get_curse(int *choice, struct object *obj, char *dice_string)
 {
+	struct journal_answer a = { 0, 0, NULL, NULL, 0 };
+
+	if (journal_ask(JOURNAL_CURSE, &a)) {
+		if (a.result) *choice = a.value;
+		return a.result;
+	}
+
 	/* Ask the UI for it */
 	if (get_curse_hook)
-		return get_curse_hook(choice, obj, dice_string);
-	else
-		return false;
+		a.result = get_curse_hook(choice, obj, dice_string);
+	if (a.result) a.value = *choice;
+	journal_answered(JOURNAL_CURSE, &a);
+	return a.result;
 }
 
 /**
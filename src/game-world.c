@@ -372,7 +372,7 @@ static void decrease_timeouts(void)
  * mazes.  Monsters have a hearing value, which is the largest sound value
  * they can detect.
  */
-static void make_noise(struct player *p)
+void make_noise(struct player *p)
 {
 	struct loc next = p->grid;
 	int y, x, d;
@@ -86,7 +86,7 @@ static bool square_is_granite_with_flag(struct chunk *c, struct loc grid,
 										int flag)
 {
 	if (square(c, grid).feat != FEAT_GRANITE) return false;
-	if (!sqinfo_has(square(c, grid).info, flag)) return false;
+	if (!sqinfo_has(c, grid, flag)) return false;
 
 	return true;
 }
@@ -446,9 +446,7 @@ struct chunk *classic_gen(struct player *p, int min_height, int min_width) {
     dun->col_blocks = c->width / dun->block_wid;
 
     /* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
-	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+	dun->room_map = bitmap_new(dun->row_blocks, dun->col_blocks);
 
     /* Initialize the block table */
     blocks_tried = mem_zalloc(dun->row_blocks * sizeof(bool*));
@@ -521,12 +519,10 @@ struct chunk *classic_gen(struct player *p, int min_height, int min_width) {
 		}
     }
 
-	for (i = 0; i < dun->row_blocks; i++){
+	for (i = 0; i < dun->row_blocks; i++)
 		mem_free(blocks_tried[i]);
-		mem_free(dun->room_map[i]);
-	}
 	mem_free(blocks_tried);
-	mem_free(dun->room_map);
+	bitmap_free(dun->room_map);
 
     /* Generate permanent walls around the edge of the generated area */
     draw_rectangle(c, 0, 0, c->height - 1, c->width - 1, 
@@ -720,7 +716,7 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 			struct loc diag = next_grid(grid, DIR_SE);
 			sets[k_local] = k_local;
 			square_set_feat(c, diag, FEAT_FLOOR);
-			if (lit) sqinfo_on(square(c, diag).info, SQUARE_GLOW);
+			if (lit) sqinfo_on(c, diag, SQUARE_GLOW);
 		}
     }
 
@@ -751,7 +747,7 @@ struct chunk *labyrinth_chunk(int depth, int h, int w, bool lit, bool soft)
 			int sb = sets[b];
 			square_set_feat(c, next_grid(grid, DIR_SE), FEAT_FLOOR);
 			if (lit) {
-				sqinfo_on(square(c, next_grid(grid, DIR_SE)).info, SQUARE_GLOW);
+				sqinfo_on(c, next_grid(grid, DIR_SE), SQUARE_GLOW);
 			}
 			for (k = 0; k < n; k++) {
 				if (sets[k] == sb) sets[k] = sa;
@@ -874,268 +870,214 @@ struct chunk *labyrinth_gen(struct player *p, int min_height, int min_width) {
 /* ---------------- CAVERNS ---------------------- */
 
 /**
- * Initialize the dungeon array, with a random percentage of squares open.
- * \param c is the current chunk
+ * Initialize a cavern's wall bitmap, with a random percentage of squares open.
+ * \param walls is the bitmap, with a bit on for each wall
+ * \param solid has a bit on for each wall marked SQUARE_WALL_SOLID
  * \param density is the percentage of floors we are aiming for
  */
-static void init_cavern(struct chunk *c, int density) {
-    int h = c->height;
-    int w = c->width;
+static void init_cavern(struct bitmap *walls, struct bitmap *solid,
+						int density) {
+    int h = walls->height;
+    int w = walls->width;
     int size = h * w;
-	
+
     int count = (size * density) / 100;
 
     /* Fill the entire chunk with rock */
-    fill_rectangle(c, 0, 0, h - 1, w - 1, FEAT_GRANITE, SQUARE_WALL_SOLID);
-	
+    bitmap_setall(walls);
+
     while (count > 0) {
 		struct loc grid = loc(randint1(w - 2), randint1(h - 2));
-		if (square_isrock(c, grid)) {
-			square_set_feat(c, grid, FEAT_FLOOR);
+		if (bitmap_has(walls, grid)) {
+			bitmap_off(walls, grid);
 			count--;
 		}
     }
+
+    bitmap_copy(solid, walls);
 }
 
 /**
- * Return the number of walls (0-8) adjacent to this square.
- * \param c is the current chunk
- * \param y are the co-ordinates
- * \param x are the co-ordinates
+ * Add three bit-sliced one bit numbers, giving a sum and carry bit for each
+ * of the 64 squares in a word
  */
-static int count_adj_walls(struct chunk *c, struct loc grid) {
-    int d;
-    int count = 0;
-
-    for (d = 0; d < 8; d++) {
-		if (square_isfloor(c, loc_sum(grid, ddgrid_ddd[d]))) continue;
-		count++;
-	}
-
-    return count;
-}
+#define FULL_ADD(a, b, c, sum, carry) \
+	do { \
+		bitmap_word ab_ = (a) ^ (b); \
+		(sum) = ab_ ^ (c); \
+		(carry) = ((a) & (b)) | (ab_ & (c)); \
+	} while (0)
 
 /**
- * Run a single pass of the cellular automata rules (4,5) on the dungeon.
- * \param c is the chunk being mutated
+ * Run a single pass of the cellular automata rules (4,5) on a cavern's walls.
+ *
+ * Each word of a row is handled at once: the eight neighbours of 64 squares
+ * are added as bit-sliced counters, so a square becomes wall on 6 or more
+ * walls around it and floor on 3 or fewer.  The edges are left alone.
+ * \param walls is the current wall bitmap, replaced by the mutated one
+ * \param spare is a bitmap of the same size to build the result in
+ * \param solid is set to the squares which were made wall by this pass
  */
-static void mutate_cavern(struct chunk *c) {
-	struct loc grid;
-    int h = c->height;
-    int w = c->width;
-
-    int *temp = mem_zalloc(h * w * sizeof(int));
-
-    for (grid.y = 1; grid.y < h - 1; grid.y++) {
-		for (grid.x = 1; grid.x < w - 1; grid.x++) {
-			int count = count_adj_walls(c, grid);
-			if (count > 5)
-				temp[grid_to_i(grid, w)] = FEAT_GRANITE;
-			else if (count < 4)
-				temp[grid_to_i(grid, w)] = FEAT_FLOOR;
-			else
-				temp[grid_to_i(grid, w)] = square(c, grid).feat;
-		}
-    }
+static void mutate_cavern(struct bitmap **walls, struct bitmap **spare,
+						  struct bitmap *solid) {
+	struct bitmap *old = *walls, *new = *spare;
+	int h = old->height;
+	int w = old->width;
+	int stride = old->stride;
+	int y, x, k;
+	bitmap_word *inside = mem_zalloc(stride * sizeof(bitmap_word));
+
+	/* Mark which bits of a row are inside the edges */
+	for (x = 1; x < w - 1; x++)
+		inside[BITMAP_OFFSET(x)] |= BITMAP_BINARY(x);
+
+	/* The top and bottom rows never change */
+	bitmap_row_copy(new, old, 0, 0, w - 1);
+	bitmap_row_copy(new, old, h - 1, 0, w - 1);
+
+	for (y = 1; y < h - 1; y++) {
+		const bitmap_word *rows[3];
+		bitmap_word *out = bitmap_row(new, y);
+		bitmap_word *solid_out = bitmap_row(solid, y);
+
+		rows[0] = bitmap_row(old, y - 1);
+		rows[1] = bitmap_row(old, y);
+		rows[2] = bitmap_row(old, y + 1);
+
+		for (k = 0; k < stride; k++) {
+			bitmap_word n[8], s1, s2, s3, sa, ca, sb, cb, sc, cc, cd, ts, tc,
+				ce, ge6, le3;
+			int r, i = 0;
+
+			/* The squares to the west, east, and (for the rows above and
+			 * below) directly north or south of each square */
+			for (r = 0; r < 3; r++) {
+				bitmap_word word = rows[r][k];
+				bitmap_word before = k > 0 ? rows[r][k - 1] : 0;
+				bitmap_word after = k < stride - 1 ? rows[r][k + 1] : 0;
+
+				n[i++] = (word << 1) | (before >> (BITMAP_WORD_BITS - 1));
+				n[i++] = (word >> 1) | (after << (BITMAP_WORD_BITS - 1));
+				if (r != 1) n[i++] = word;
+			}
 
-    for (grid.y = 1; grid.y < h - 1; grid.y++) {
-		for (grid.x = 1; grid.x < w - 1; grid.x++) {
-			if (temp[grid_to_i(grid, w)] == FEAT_GRANITE)
-				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
-			else
-				square_set_feat(c, grid, temp[grid_to_i(grid, w)]);
+			/* Add up the eight neighbours, giving bits s3..s1 of a four bit
+			 * count; the units bit doesn't matter to the rules */
+			FULL_ADD(n[0], n[1], n[2], sa, ca);
+			FULL_ADD(n[3], n[4], n[5], sb, cb);
+			sc = n[6] ^ n[7];
+			cc = n[6] & n[7];
+			cd = (sa & sb) | ((sa ^ sb) & sc);
+			FULL_ADD(ca, cb, cc, ts, tc);
+			s1 = ts ^ cd;
+			ce = ts & cd;
+			s2 = tc ^ ce;
+			s3 = tc & ce;
+
+			/* Apply the rules inside the edges */
+			ge6 = s3 | (s2 & s1);
+			le3 = ~(s3 | s2);
+			out[k] = (rows[1][k] & ~inside[k]) |
+				(inside[k] & (ge6 | (rows[1][k] & ~le3)));
+			solid_out[k] = (solid_out[k] & ~inside[k]) | (inside[k] & ge6);
 		}
-    }
+	}
 
-    mem_free(temp);
+	mem_free(inside);
+	*walls = new;
+	*spare = old;
 }
 
 /**
- * Fill an int[] with a single value.
- * \param data is the array
- * \param value is what it's being filled with
- * \param size is the array length
+ * Write a finished cavern's walls and floors into the chunk.
+ * \param c is the current chunk
+ * \param walls is the wall bitmap
+ * \param solid has a bit on for each wall marked SQUARE_WALL_SOLID
  */
-static void array_filler(int data[], int value, int size) {
-    int i;
-    for (i = 0; i < size; i++) data[i] = value;
+static void commit_cavern(struct chunk *c, struct bitmap *walls,
+						  struct bitmap *solid) {
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < c->height; grid.y++)
+		for (grid.x = 0; grid.x < c->width; grid.x++)
+			square_set_feat(c, grid, bitmap_has(walls, grid) ?
+							FEAT_GRANITE : FEAT_FLOOR);
+
+	bitmap_copy(c->info[SQUARE_WALL_SOLID], solid);
 }
 
 /**
- * Determine if we need to worry about coloring a point, or can ignore it.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param y are the co-ordinates
- * \param x are the co-ordinates
+ * Squares which count as open when joining up the regions of a level
  */
-static int ignore_point(struct chunk *c, int colors[], struct loc grid) {
-    int n = grid_to_i(grid, c->width);
-
-    if (!square_in_bounds(c, grid)) return true;
-    if (colors[n]) return true;
-    if (square_ispassable(c, grid)) return false;
-    if (square_isdoor(c, grid)) return false;
-    return true;
+static bool square_isjoinable(struct chunk *c, struct loc grid) {
+    return square_ispassable(c, grid) || square_isdoor(c, grid);
 }
 
 /**
- * Color a particular point, and all adjacent points.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param grid is the location
- * \param color is the color we are coloring
- * \param diagonal controls whether we can progress diagonally
+ * Find which region a grid is now part of, allowing for merged regions.
+ * \param r is the labelled regions
+ * \param merged is the region each region has been merged into (or itself)
+ * \param n is the grid index
  */
-static void build_color_point(struct chunk *c, int colors[], int counts[],
-							  struct loc grid, int color, bool diagonal) {
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-    struct queue *queue = q_new(size);
-
-    int *added = mem_zalloc(size * sizeof(int));
-
-    array_filler(added, 0, size);
-
-    q_push_int(queue, grid_to_i(grid, w));
-
-    counts[color] = 0;
-
-    while (q_len(queue) > 0) {
-		int i;
-		struct loc grid1;
-		int n1 = q_pop_int(queue);
-
-		i_to_grid(n1, w, &grid1);
-
-		if (ignore_point(c, colors, grid1)) continue;
+static int region_now(struct cave_regions *r, int merged[], int n) {
+    int color = r->label[n];
 
-		colors[n1] = color;
-		counts[color]++;
-
-		for (i = 0; i < (diagonal ? 8 : 4); i++) {
-			struct loc grid2 = loc_sum(grid1, ddgrid_ddd[i]);
-			int n2 = grid_to_i(grid2, w);
-			if (ignore_point(c, colors, grid2)) continue;
-			if (added[n2]) continue;
-
-			q_push_int(queue, n2);
-			added[n2] = 1;
-		}
-    }
-
-    mem_free(added);
-    q_free(queue);
+    if (!color) return 0;
+    while (merged[color] != color) {
+		merged[color] = merged[merged[color]];
+		color = merged[color];
+	}
+    return color;
 }
 
 /**
- * Create a color for each "NESW contiguous" region of the dungeon.
- * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param diagonal controls whether we can progress diagonally
+ * Start keeping track of merges between regions.
+ * \param r is the labelled regions
+ * \return an array of the region each region has been merged into
  */
-static void build_colors(struct chunk *c, int colors[], int counts[], bool diagonal) {
-    int y, x;
-    int h = c->height;
-    int w = c->width;
-    int color = 1;
+static int *region_merges(struct cave_regions *r) {
+    int i;
+    int *merged = mem_zalloc((r->count + 1) * sizeof(int));
 
-    for (y = 0; y < h; y++) {
-		for (x = 0; x < w; x++) {
-			if (ignore_point(c, colors, loc(x, y))) continue;
-			build_color_point(c, colors, counts, loc(x, y), color, diagonal);
-			color++;
-		}
-    }
+    for (i = 0; i <= r->count; i++) merged[i] = i;
+    return merged;
 }
 
 /**
  * Find and delete all small (<9 square) open regions.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the labelled regions
  */
-static void clear_small_regions(struct chunk *c, int colors[], int counts[]) {
+static void clear_small_regions(struct chunk *c, struct cave_regions *r) {
     int i, y, x;
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-
-    int *deleted = mem_zalloc(size * sizeof(int));
-    array_filler(deleted, 0, size);
-
-    for (i = 0; i < size; i++) {
-		if (counts[i] < 9) {
-			deleted[i] = 1;
-			counts[i] = 0;
-		}
-    }
 
     for (y = 1; y < c->height - 1; y++) {
 		for (x = 1; x < c->width - 1; x++) {
 			struct loc grid = loc(x, y);
-			i = grid_to_i(grid, w);
+			i = grid_to_i(grid, c->width);
 
-			if (!deleted[colors[i]]) continue;
+			if (r->label[i] && r->size[r->label[i]] >= 9) continue;
 
-			colors[i] = 0;
+			r->label[i] = 0;
 			set_marked_granite(c, grid, SQUARE_WALL_SOLID);
 		}
     }
-    mem_free(deleted);
-}
-
-/**
- * Return the number of colors which have active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int count_colors(int counts[], int size) {
-    int i;
-    int num = 0;
-    for (i = 0; i < size; i++) if (counts[i] > 0) num++;
-    return num;
-}
 
-/**
- * Return the first color which has one or more active cells.
- * \param counts is the array of current color counts
- * \param size is the total area
- */
-static int first_color(int counts[], int size) {
-    int i;
-    for (i = 0; i < size; i++) if (counts[i] > 0) return i;
-    return -1;
-}
-
-/**
- * Find all cells of 'fromcolor' and repaint them to 'tocolor'.
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
- * \param from is the color to change
- * \param to is the color to change to
- * \param size is the total area
- */
-static void fix_colors(int colors[], int counts[], int from, int to, int size) {
-    int i;
-    for (i = 0; i < size; i++) if (colors[i] == from) colors[i] = to;
-    counts[to] += counts[from];
-    counts[from] = 0;
+    for (i = 1; i <= r->count; i++)
+		if (r->size[i] < 9) r->size[i] = 0;
 }
 
 /**
  * Create a tunnel connecting a region to one of its nearest neighbors.
  * Set new_color = -1 for any neighbour, the required color for a specific one
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the labelled regions
+ * \param merged is the region each region has been merged into
  * \param color is the color of the region we want to connect
  * \param new_color is the color of the region we want to connect to (if used)
  */
-static void join_region(struct chunk *c, int colors[], int counts[], int color,
-	int new_color)
+static void join_region(struct chunk *c, struct cave_regions *r, int merged[],
+						int color, int new_color)
 {
     int i;
     int h = c->height;
@@ -1148,12 +1090,12 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     /* Allocate an array to keep track of handled squares, and which square
      * we reached them from.
      */
-    int *previous = mem_zalloc(size * sizeof(int));
-    array_filler(previous, -1, size);
+    int *previous = mem_alloc(size * sizeof(int));
+    for (i = 0; i < size; i++) previous[i] = -1;
 
     /* Push all squares of the given color onto the queue */
     for (i = 0; i < size; i++) {
-		if (colors[i] == color) {
+		if (region_now(r, merged, i) == color) {
 			q_push_int(queue, i);
 			previous[i] = i;
 		}
@@ -1163,7 +1105,7 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
     while (q_len(queue) > 0) {
 		/* Get the current square and its color */
 		int n1 = q_pop_int(queue);
-		int color2 = colors[n1];
+		int color2 = region_now(r, merged, n1);
 
 		/* If we're not looking for a specific color, any new one will do */
 		if ((new_color == -1) && color2 && (color2 != color))
@@ -1172,18 +1114,22 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 		/* See if we've reached a square with a new color */
 		if (color2 == new_color) {
 			/* Step backward through the path, turning stone to tunnel */
-			while (colors[n1] != color) {
+			while (region_now(r, merged, n1) != color) {
 				struct loc grid;
 				i_to_grid(n1, w, &grid);
-				colors[n1] = color;
+				r->label[n1] = color;
 				if (!square_isperm(c, grid) && !square_isvault(c, grid)) {
 					square_set_feat(c, grid, FEAT_FLOOR);
 				}
 				n1 = previous[n1];
 			}
 
-			/* Update the color mapping to combine the two colors */
-			fix_colors(colors, counts, color2, color, size);
+			/* Combine the two colors */
+			if (color2 != color) {
+				merged[color2] = color;
+				r->size[color] += r->size[color2];
+			}
+			r->size[color2] = 0;
 
 			/* We're done now */
 			break;
@@ -1220,23 +1166,24 @@ static void join_region(struct chunk *c, int colors[], int counts[], int color,
 /**
  * Start connecting regions, stopping when the cave is entirely connected.
  * \param c is the current chunk
- * \param colors is the array of current point colors
- * \param counts is the array of current color counts
+ * \param r is the labelled regions
  */
-static void join_regions(struct chunk *c, int colors[], int counts[]) {
-    int h = c->height;
-    int w = c->width;
-    int size = h * w;
-    int num = count_colors(counts, size);
+static void join_regions(struct chunk *c, struct cave_regions *r) {
+    int i, num = 0;
+    int *merged = region_merges(r);
+
+    for (i = 1; i <= r->count; i++)
+		if (r->size[i] > 0) num++;
 
-    /* While we have multiple colors (i.e. disconnected regions), join one of
-     * the regions to another one.
+    /* While we have multiple colors (i.e. disconnected regions), join the
+     * first remaining one to another one.
      */
-    while (num > 1) {
-		int color = first_color(counts, size);
-		join_region(c, colors, counts, color, -1);
-		num--;
+    for (i = 1; num > 1; num--) {
+		while (!r->size[i]) i++;
+		join_region(c, r, merged, i, -1);
     }
+
+    mem_free(merged);
 }
 
 
@@ -1244,19 +1191,14 @@ static void join_regions(struct chunk *c, int colors[], int counts[]) {
  * Make sure that all the regions of the dungeon are connected.
  * \param c is the current chunk
  *
- * This function colors each connected region of the dungeon, then uses that
+ * This function labels each connected region of the dungeon, then uses that
  * information to join them into one conected region.
  */
 void ensure_connectedness(struct chunk *c) {
-    int size = c->height * c->width;
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
-
-    build_colors(c, colors, counts, true);
-    join_regions(c, colors, counts);
+    struct cave_regions *r = cave_regions_new(c, square_isjoinable, true);
 
-    mem_free(colors);
-    mem_free(counts);
+    join_regions(c, r);
+    cave_regions_free(r);
 }
 
 
@@ -1276,10 +1218,13 @@ struct chunk *cavern_chunk(int depth, int h, int w)
     int density = rand_range(25, 40);
     int times = rand_range(3, 6);
 
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
-
     int tries;
+	struct cave_regions *regions;
+
+	/* The cavern is worked out on bitmaps, and only then put in the chunk */
+	struct bitmap *walls = bitmap_new(h, w);
+	struct bitmap *spare = bitmap_new(h, w);
+	struct bitmap *solid = bitmap_new(h, w);
 
 	struct chunk *c = cave_new(h, w);
 	c->depth = depth;
@@ -1289,33 +1234,40 @@ struct chunk *cavern_chunk(int depth, int h, int w)
 
 	/* Start trying to build caverns */
 	for (tries = 0; tries < MAX_CAVERN_TRIES; tries++) {
+		int floors;
+
 		/* Build a random cavern and mutate it a number of times */
-		init_cavern(c, density);
-		for (i = 0; i < times; i++) mutate_cavern(c);
+		init_cavern(walls, solid, density);
+		for (i = 0; i < times; i++) mutate_cavern(&walls, &spare, solid);
 
 		/* If there are enough open squares then we're done */
-		if (c->feat_count[FEAT_FLOOR] >= limit) {
-			ROOM_LOG("cavern ok (%d vs %d)", c->feat_count[FEAT_FLOOR], limit);
+		floors = size - bitmap_count(walls);
+		if (floors >= limit) {
+			ROOM_LOG("cavern ok (%d vs %d)", floors, limit);
 			break;
 		}
-		ROOM_LOG("cavern failed--try again (%d vs %d)",
-				 c->feat_count[FEAT_FLOOR], limit);
+		ROOM_LOG("cavern failed--try again (%d vs %d)", floors, limit);
 	}
 
 	/* If we couldn't make a big enough cavern then fail */
 	if (tries == MAX_CAVERN_TRIES) {
-		mem_free(colors);
-		mem_free(counts);
+		bitmap_free(walls);
+		bitmap_free(spare);
+		bitmap_free(solid);
 		cave_free(c);
 		return NULL;
 	}
 
-	build_colors(c, colors, counts, false);
-	clear_small_regions(c, colors, counts);
-	join_regions(c, colors, counts);
+	commit_cavern(c, walls, solid);
+	bitmap_free(walls);
+	bitmap_free(spare);
+	bitmap_free(solid);
 
-    mem_free(colors);
-    mem_free(counts);
+	/* Remove the smallest pieces, and join up the rest */
+	regions = cave_regions_new(c, square_isjoinable, false);
+	clear_small_regions(c, regions);
+	join_regions(c, regions);
+	cave_regions_free(regions);
 
 	return c;
 }
@@ -1454,7 +1406,7 @@ static void town_gen_layout(struct chunk *c, struct player *p)
 	for (grid.y = 1; grid.y < c->height - 1; grid.y++) {
 		for (grid.x = 1; grid.x < c->width - 1; grid.x++) {
 			if (square_isfloor(c, grid))
-				sqinfo_off(square(c, grid).info, SQUARE_ROOM);
+				sqinfo_off(c, grid, SQUARE_ROOM);
 			else if (!square_isperm(c, grid) && !square_isfiery(c, grid))
 				square_set_feat(c, grid, FEAT_PERM);
 		}
@@ -1551,6 +1503,7 @@ struct chunk *town_gen(struct player *p, int min_height, int min_width)
 		if (!chunk_copy(c_new, c_old, 0, 0, 0, 0))
 			quit_fmt("chunk_copy() level bounds failed!");
 		chunk_list_remove("Town");
+		cave_free(c_old);
 
 		/* Find the stairs (lame) */
 		for (grid.y = 0; grid.y < c_new->height; grid.y++) {
@@ -1618,9 +1571,7 @@ struct chunk *modified_chunk(int depth, int height, int width)
     dun->col_blocks = c->width / dun->block_wid;
 
     /* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
-	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+	dun->room_map = bitmap_new(dun->row_blocks, dun->col_blocks);
 
     /* No rooms yet, pits or otherwise. */
     dun->pit_num = 0;
@@ -1673,9 +1624,7 @@ struct chunk *modified_chunk(int depth, int height, int width)
 		}
     }
 
-	for (i = 0; i < dun->row_blocks; i++)
-		mem_free(dun->room_map[i]);
-	mem_free(dun->room_map);
+	bitmap_free(dun->room_map);
 
     /* Hack -- Scramble the room order */
     for (i = 0; i < dun->cent_n; i++) {
@@ -1784,12 +1733,12 @@ struct chunk *modified_gen(struct player *p, int min_height, int min_width) {
 		build_streamer(c, FEAT_QUARTZ, dun->profile->str.qc);
 
     /* Place 3 or 4 down stairs near some walls */
-	if (!OPT(p, birth_levels_persist) || !chunk_find_adjacent(p, false)) {
+	if (!OPT(p, birth_levels_persist) || !chunk_exists_adjacent(p, false)) {
 		alloc_stairs(c, FEAT_MORE, rand_range(3, 4));
 	}
 
     /* Place 1 or 2 up stairs near some walls */
-	if (!OPT(p, birth_levels_persist) || !chunk_find_adjacent(p, true)) {
+	if (!OPT(p, birth_levels_persist) || !chunk_exists_adjacent(p, true)) {
 		alloc_stairs(c, FEAT_LESS, rand_range(1, 2));
 	}
 
@@ -1867,9 +1816,7 @@ struct chunk *moria_chunk(int depth, int height, int width)
     dun->col_blocks = c->width / dun->block_wid;
 
     /* Initialize the room table */
-	dun->room_map = mem_zalloc(dun->row_blocks * sizeof(bool*));
-	for (i = 0; i < dun->row_blocks; i++)
-		dun->room_map[i] = mem_zalloc(dun->col_blocks * sizeof(bool));
+	dun->room_map = bitmap_new(dun->row_blocks, dun->col_blocks);
 
     /* No rooms yet, pits or otherwise. */
     dun->pit_num = 0;
@@ -1904,9 +1851,7 @@ struct chunk *moria_chunk(int depth, int height, int width)
 		}
     }
 
-	for (i = 0; i < dun->row_blocks; i++)
-		mem_free(dun->room_map[i]);
-	mem_free(dun->room_map);
+	bitmap_free(dun->room_map);
 
     /* Hack -- Scramble the room order */
     for (i = 0; i < dun->cent_n; i++) {
@@ -2085,32 +2030,29 @@ struct chunk *vault_chunk(struct player *p)
 void connect_caverns(struct chunk *c, struct loc floor[])
 {
 	int i;
-    int size = c->height * c->width;
-    int *colors = mem_zalloc(size * sizeof(int));
-    int *counts = mem_zalloc(size * sizeof(int));
+	struct cave_regions *r = cave_regions_new(c, square_isjoinable, true);
+	int *merged = region_merges(r);
 	int color_of_floor[4];
 
-	/* Color the regions, find which cavern is which color */
-    build_colors(c, colors, counts, true);
+	/* Find which cavern is which color */
 	for (i = 0; i < 4; i++) {
 		int spot = grid_to_i(floor[i], c->width);
-		color_of_floor[i] = colors[spot];
+		color_of_floor[i] = region_now(r, merged, spot);
 	}
 
 	/* Join left and upper, right and lower */
-	join_region(c, colors, counts, color_of_floor[0], color_of_floor[1]);
-	join_region(c, colors, counts, color_of_floor[2], color_of_floor[3]);
+	join_region(c, r, merged, color_of_floor[0], color_of_floor[1]);
+	join_region(c, r, merged, color_of_floor[2], color_of_floor[3]);
 
-	/* Redo the colors, join the two big caverns */
-    build_colors(c, colors, counts, true);
+	/* Join the two big caverns */
 	for (i = 1; i < 3; i++) {
 		int spot = grid_to_i(floor[i], c->width);
-		color_of_floor[i] = colors[spot];
+		color_of_floor[i] = region_now(r, merged, spot);
 	}
-	join_region(c, colors, counts, color_of_floor[1], color_of_floor[2]);
+	join_region(c, r, merged, color_of_floor[1], color_of_floor[2]);
 
-    mem_free(colors);
-    mem_free(counts);
+	mem_free(merged);
+	cave_regions_free(r);
 }
 /**
  * Generate a hard centre level - a greater vault surrounded by caverns
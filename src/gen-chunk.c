@@ -28,13 +28,53 @@
 #include "game-world.h"
 #include "generate.h"
 #include "init.h"
+#include "mon-group.h"
 #include "mon-make.h"
+#include "obj-pile.h"
 #include "obj-util.h"
+#include "player.h"
+#include "savefile.h"
 #include "trap.h"
 
+/**
+ * Stored chunks are kept as savefile records (see savefile_pack_chunk()),
+ * which are many times smaller than the chunks themselves, in a list which
+ * is also hashed by name.  A chunk asked for by name is rebuilt from its
+ * record and kept alongside it until chunk_list_pack() is called, so the
+ * pointers handed out stay good until then.  Chunks found in the list are
+ * for looking at; to change one, remove it and add it again.
+ *
+ * Once the records in memory pass CHUNK_MEMORY_MAX bytes, those of the
+ * chunks stored longest ago are moved out to a spill file in the save
+ * directory, and read back in when wanted.  Records of chunks which have
+ * since been removed leave dead space in the spill file; once there is more
+ * of that than of live records, the file is written afresh without it.
+ */
 #define CHUNK_LIST_INCR 10
-struct chunk **chunk_list;     /**< list of pointers to saved chunks */
-u16b chunk_list_max = 0;      /**< current max actual chunk index */
+#define CHUNK_HASH_SIZE 256
+#define CHUNK_MEMORY_MAX (1024 * 1024)
+
+struct chunk_entry {
+	char *name;
+	u32b hash;
+	int depth;
+	struct chunk *c;		/**< rebuilt chunk, if any */
+	byte *data;				/**< savefile record, if in memory */
+	u32b len;				/**< length of the record */
+	long spill;				/**< offset of the record in the spill file, or -1 */
+	u32b stamp;				/**< when the chunk was stored */
+	struct chunk_entry *hash_next;
+};
+
+static struct chunk_entry **chunk_list;		/**< stored chunks, in order */
+static u16b chunk_list_max = 0;				/**< number of stored chunks */
+static struct chunk_entry *chunk_hash[CHUNK_HASH_SIZE];
+static u32b chunk_stamp = 0;
+static size_t chunk_memory = 0;				/**< bytes of records in memory */
+static size_t chunk_memory_max = CHUNK_MEMORY_MAX;
+static char chunk_spill_path[1024];
+static long chunk_spill_size = 0;
+static long chunk_spill_dead = 0;			/**< bytes of removed records */
 
 /**
  * Write the terrain info of a chunk to memory and return a pointer to it
@@ -44,7 +84,7 @@ u16b chunk_list_max = 0;      /**< current max actual chunk index */
  */
 struct chunk *chunk_write(struct chunk *c)
 {
-	int x, y;
+	int x, y, flag;
 
 	struct chunk *new = cave_new(c->height, c->width);
 
@@ -53,81 +93,363 @@ struct chunk *chunk_write(struct chunk *c)
 		for (x = 0; x < new->width; x++) {
 			/* Terrain */
 			new->squares[y][x].feat = square(c, loc(x, y)).feat;
-			sqinfo_copy(square(new, loc(x, y)).info, square(c, loc(x, y)).info);
 		}
 	}
 
+	/* Square flags */
+	for (flag = FLAG_START; flag < SQUARE_MAX; flag++)
+		bitmap_copy(new->info[flag], c->info[flag]);
+
 	return new;
 }
 
 /**
- * Add an entry to the chunk list - any problems with the length of this will
- * be more in the memory used by the chunks themselves rather than the list
- * \param c the chunk being added to the list
+ * Free a pile of objects belonging to a stored chunk, taking them out of its
+ * object list
  */
-void chunk_list_add(struct chunk *c)
+static void chunk_pile_free(struct chunk *c, struct object *obj)
+{
+	while (obj) {
+		struct object *next = obj->next;
+
+		if (obj->oidx < c->obj_max && c->objects[obj->oidx] == obj)
+			c->objects[obj->oidx] = NULL;
+		object_free(obj);
+		obj = next;
+	}
+}
+
+/**
+ * Free a stored chunk and everything on it.  Its monsters and objects live
+ * on in its record, so race counts, artifacts and the current level's object
+ * lists are left alone.
+ */
+static void chunk_release(struct chunk *c)
+{
+	int i, y, x;
+
+	/* Objects held by monsters */
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		chunk_pile_free(c, mon->held_obj);
+		mon->held_obj = NULL;
+	}
+
+	/* Objects on the floor */
+	for (y = 0; y < c->height; y++) {
+		for (x = 0; x < c->width; x++) {
+			chunk_pile_free(c, c->squares[y][x].obj);
+			c->squares[y][x].obj = NULL;
+		}
+	}
+
+	/* Objects anywhere else */
+	for (i = 0; i < c->obj_max; i++)
+		if (c->objects[i])
+			object_free(c->objects[i]);
+
+	/* Monster groups */
+	for (i = 1; i < z_info->level_monster_max; i++)
+		if (c->monster_groups[i])
+			monster_group_free(c, c->monster_groups[i]);
+
+	cave_free(c);
+}
+
+/**
+ * Hash a chunk name
+ */
+static u32b chunk_name_hash(const char *name)
+{
+	u32b hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + (byte) *name++;
+	return hash;
+}
+
+/**
+ * Find the entry for a stored chunk
+ */
+static struct chunk_entry *chunk_entry_find(const char *name)
+{
+	u32b hash = chunk_name_hash(name);
+	struct chunk_entry *e = chunk_hash[hash % CHUNK_HASH_SIZE];
+
+	for (; e; e = e->hash_next)
+		if ((e->hash == hash) && streq(e->name, name))
+			return e;
+
+	return NULL;
+}
+
+/**
+ * Read a spilled record back from the spill file into a new buffer
+ */
+static byte *chunk_spill_read(struct chunk_entry *e)
 {
-	int newsize = (chunk_list_max + CHUNK_LIST_INCR) *	sizeof(struct chunk *);
+	ang_file *f = file_open(chunk_spill_path, MODE_READ, FTYPE_RAW);
+	byte *data = mem_alloc(e->len);
+
+	if (!f || !file_skip(f, e->spill) ||
+		(file_read(f, (char *) data, e->len) != (int) e->len)) {
+		mem_free(data);
+		data = NULL;
+	}
+	if (f) file_close(f);
+	return data;
+}
+
+/**
+ * Write the spill file afresh with only the records still in the list
+ */
+static void chunk_spill_compact(void)
+{
+	char path[1024];
+	ang_file *f;
+	long *spill, size = 0;
+	int i;
+
+	/* Nothing left out there at all */
+	if (chunk_spill_dead == chunk_spill_size) {
+		file_delete(chunk_spill_path);
+		chunk_spill_size = 0;
+		chunk_spill_dead = 0;
+		return;
+	}
+
+	/* Copy the live records to a new file, keeping the old one if that
+	 * fails */
+	strnfmt(path, sizeof(path), "%s.new", chunk_spill_path);
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	if (!f) return;
+	spill = mem_zalloc(chunk_list_max * sizeof(*spill));
+	for (i = 0; i < chunk_list_max; i++) {
+		struct chunk_entry *e = chunk_list[i];
+		byte *data;
+		bool written;
+
+		if (e->spill < 0) continue;
+		data = e->data ? e->data : chunk_spill_read(e);
+		written = data && file_write(f, (char *) data, e->len);
+		if (data != e->data)
+			mem_free(data);
+		if (!written) break;
+		spill[i] = size;
+		size += e->len;
+	}
+	file_close(f);
+	if ((i < chunk_list_max) || !file_move(path, chunk_spill_path)) {
+		file_delete(path);
+		mem_free(spill);
+		return;
+	}
+
+	for (i = 0; i < chunk_list_max; i++)
+		if (chunk_list[i]->spill >= 0)
+			chunk_list[i]->spill = spill[i];
+	mem_free(spill);
+	chunk_spill_size = size;
+	chunk_spill_dead = 0;
+}
+
+/**
+ * Move the records of the chunks stored longest ago out to the spill file,
+ * until those left in memory fit
+ */
+static void chunk_spill(void)
+{
+	while (chunk_memory > chunk_memory_max) {
+		struct chunk_entry *oldest = NULL;
+		int i;
+
+		for (i = 0; i < chunk_list_max; i++) {
+			struct chunk_entry *e = chunk_list[i];
+			if (!e->data || e->c) continue;
+			if (!oldest || (e->stamp < oldest->stamp))
+				oldest = e;
+		}
+		if (!oldest) return;
+
+		/* Records are only written out once */
+		if (oldest->spill < 0) {
+			ang_file *f;
+
+			if (!chunk_spill_path[0]) {
+				char name[80];
+
+				player_safe_name(name, sizeof(name), player->full_name, true);
+				my_strcat(name, ".levels", sizeof(name));
+				path_build(chunk_spill_path, sizeof(chunk_spill_path),
+						   ANGBAND_DIR_SAVE, name);
+			}
+
+			f = file_open(chunk_spill_path,
+						  chunk_spill_size ? MODE_APPEND : MODE_WRITE,
+						  FTYPE_RAW);
+
+			/* Keep it in memory if it can't go anywhere else */
+			if (!f || !file_write(f, (char *) oldest->data, oldest->len)) {
+				if (f) file_close(f);
+				return;
+			}
+			file_close(f);
+			oldest->spill = chunk_spill_size;
+			chunk_spill_size += oldest->len;
+		}
+
+		mem_free(oldest->data);
+		oldest->data = NULL;
+		chunk_memory -= oldest->len;
+	}
+}
+
+/**
+ * Make a new entry at the end of the chunk list
+ */
+static struct chunk_entry *chunk_entry_new(const char *name, int depth)
+{
+	int newsize = (chunk_list_max + CHUNK_LIST_INCR) *
+		sizeof(struct chunk_entry *);
+	struct chunk_entry *e = mem_zalloc(sizeof(*e)), **link;
 
 	/* Lengthen the list if necessary */
 	if (chunk_list_max == 0)
 		chunk_list = mem_zalloc(newsize);
 	else if ((chunk_list_max % CHUNK_LIST_INCR) == 0)
-		chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
+		chunk_list = mem_realloc(chunk_list, newsize);
+
+	e->name = string_make(name);
+	e->hash = chunk_name_hash(e->name);
+	e->depth = depth;
+	e->spill = -1;
+	e->stamp = ++chunk_stamp;
+
+	/* Later chunks of the same name go after earlier ones */
+	link = &chunk_hash[e->hash % CHUNK_HASH_SIZE];
+	while (*link)
+		link = &(*link)->hash_next;
+	*link = e;
 
 	/* Add the new one */
-	chunk_list[chunk_list_max++] = c;
+	chunk_list[chunk_list_max++] = e;
+	return e;
+}
+
+/**
+ * Add an entry to the chunk list - the chunk is kept as it is until the next
+ * chunk_list_pack()
+ * \param c the chunk being added to the list
+ */
+void chunk_list_add(struct chunk *c)
+{
+	chunk_entry_new(c->name, c->depth)->c = c;
+}
+
+/**
+ * Add an entry to the chunk list for a chunk record read from a savefile;
+ * the list takes over the record's memory
+ */
+void chunk_list_add_record(const char *name, int depth, byte *data, u32b len)
+{
+	struct chunk_entry *e = chunk_entry_new(name, depth);
+
+	e->data = data;
+	e->len = len;
+	chunk_memory += len;
 }
 
 /**
- * Remove an entry from the chunk list, return whether it was found
+ * Remove an entry from the chunk list, return whether it was found.  A
+ * chunk found with chunk_find_name() now belongs to the caller.
  * \param name the name of the chunk being removed from the list
  * \return whether it was found; success means it was successfully removed
  */
 bool chunk_list_remove(char *name)
 {
-	int i, j;
-	int newsize = 0;
+	struct chunk_entry *e = chunk_entry_find(name), **link;
+	int i;
 
-	for (i = 0; i < chunk_list_max; i++) {
-		/* Find the match */
-		if (!strcmp(name, chunk_list[i]->name)) {
-			/* Copy all the succeeding ones back one */
-			for (j = i + 1; j < chunk_list_max; j++)
-				chunk_list[j - 1] = chunk_list[j];
-
-			/* Destroy the last one, and shorten the list */
-			/* Don't do this for now - may be unnecessary, as chunk list never
-			 * really gets shorter */
-			//if ((chunk_list_max % CHUNK_LIST_INCR) == 0)
-			//	newsize = (chunk_list_max - CHUNK_LIST_INCR) *	
-			//		sizeof(struct chunk *);
-			chunk_list_max--;
-			chunk_list[chunk_list_max] = NULL;
-			if (newsize)
-				chunk_list = (struct chunk **) mem_realloc(chunk_list, newsize);
-
-			return true;
-		}
+	if (!e) return false;
+
+	/* Take it out of the hash */
+	link = &chunk_hash[e->hash % CHUNK_HASH_SIZE];
+	while (*link != e)
+		link = &(*link)->hash_next;
+	*link = e->hash_next;
+
+	/* Copy all the succeeding ones back one */
+	for (i = 0; chunk_list[i] != e; i++) ;
+	for (i++; i < chunk_list_max; i++)
+		chunk_list[i - 1] = chunk_list[i];
+	chunk_list_max--;
+	chunk_list[chunk_list_max] = NULL;
+
+	if (e->data) {
+		mem_free(e->data);
+		chunk_memory -= e->len;
 	}
 
-	return false;
+	/* Its record in the spill file is dead now */
+	if (e->spill >= 0) {
+		chunk_spill_dead += e->len;
+		if (chunk_spill_dead > chunk_spill_size - chunk_spill_dead)
+			chunk_spill_compact();
+	}
+	string_free(e->name);
+	mem_free(e);
+	return true;
 }
 
 /**
- * Find a chunk by name
+ * Find a chunk by name, rebuilding it from its record if need be.  A record
+ * which can't be read back or rebuilt is dropped, and the level is lost; its
+ * monsters can't be known, so they stay counted as alive.
  * \param name the name of the chunk being sought
- * \return the pointer to the chunk
+ * \return the pointer to the chunk, or NULL if it isn't there
  */
 struct chunk *chunk_find_name(char *name)
 {
-	int i;
+	struct chunk_entry *e = chunk_entry_find(name);
+
+	if (!e) return NULL;
+	if (!e->c) {
+		if (!e->data) {
+			e->data = chunk_spill_read(e);
+			if (e->data)
+				chunk_memory += e->len;
+		}
+		if (e->data)
+			e->c = savefile_unpack_chunk(e->data, e->len);
+		if (!e->c) {
+			msg("The stored level %s is broken, and has been lost.", name);
+			chunk_list_remove(e->name);
+			return NULL;
+		}
+	}
 
-	for (i = 0; i < chunk_list_max; i++)
-		if (!strcmp(name, chunk_list[i]->name))
-			return chunk_list[i];
+	return e->c;
+}
 
-	return NULL;
+/**
+ * Check whether a chunk of the given name is stored, without rebuilding it
+ * from its record
+ */
+bool chunk_exists_name(const char *name)
+{
+	return chunk_entry_find(name) != NULL;
+}
+
+/**
+ * Check whether a chunk is stored above or below the current player depth,
+ * without rebuilding it from its record
+ */
+bool chunk_exists_adjacent(struct player *p, bool above)
+{
+	int depth = above ? p->depth - 1 : p->depth + 1;
+	struct level *lev = level_by_depth(depth);
+
+	return lev && chunk_entry_find(lev->name);
 }
 
 /**
@@ -140,11 +462,143 @@ bool chunk_find(struct chunk *c)
 	int i;
 
 	for (i = 0; i < chunk_list_max; i++)
-		if (c == chunk_list[i]) return true;
+		if (c == chunk_list[i]->c) return true;
 
 	return false;
 }
 
+/**
+ * Get the number of stored chunks
+ */
+int chunk_list_count(void)
+{
+	return chunk_list_max;
+}
+
+/**
+ * Get the name and depth of the chunk at place `i` in the list
+ */
+const char *chunk_list_name(int i)
+{
+	return chunk_list[i]->name;
+}
+
+int chunk_list_depth(int i)
+{
+	return chunk_list[i]->depth;
+}
+
+/**
+ * Check whether a chunk of the given depth has been stored
+ */
+bool chunk_list_has_depth(int depth)
+{
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++)
+		if (chunk_list[i]->depth == depth) return true;
+
+	return false;
+}
+
+/**
+ * Turn every chunk in the list back into just its record, and spill records
+ * to disk if they take too much memory.  Any pointer to a stored chunk is
+ * bad after this.
+ */
+void chunk_list_pack(void)
+{
+	int i;
+
+	/* Write every record before freeing anything, as objects on a level
+	 * point at their known versions on the known level */
+	for (i = 0; i < chunk_list_max; i++) {
+		struct chunk_entry *e = chunk_list[i];
+		if (e->c && !e->data && (e->spill < 0)) {
+			e->data = savefile_pack_chunk(e->c, &e->len);
+			chunk_memory += e->len;
+		}
+	}
+
+	for (i = 0; i < chunk_list_max; i++) {
+		struct chunk_entry *e = chunk_list[i];
+		if (e->c) {
+			chunk_release(e->c);
+			e->c = NULL;
+		}
+	}
+
+	chunk_spill();
+}
+
+/**
+ * Get the savefile record of the chunk at place `i` in the list; it must be
+ * given back with chunk_list_data_done()
+ */
+byte *chunk_list_data(int i, u32b *len)
+{
+	struct chunk_entry *e = chunk_list[i];
+
+	if (!e->data && (e->spill < 0)) {
+		e->data = savefile_pack_chunk(e->c, &e->len);
+		chunk_memory += e->len;
+	}
+
+	*len = e->len;
+	return e->data ? e->data : chunk_spill_read(e);
+}
+
+void chunk_list_data_done(int i, byte *data)
+{
+	if (data != chunk_list[i]->data)
+		mem_free(data);
+}
+
+/**
+ * Set how many bytes of records may stay in memory (0 for the default)
+ */
+void chunk_list_set_memory(size_t bytes)
+{
+	chunk_memory_max = bytes ? bytes : CHUNK_MEMORY_MAX;
+	chunk_spill();
+}
+
+/**
+ * Get how many bytes of records are in memory
+ */
+size_t chunk_list_memory(void)
+{
+	return chunk_memory;
+}
+
+/**
+ * Free all stored chunks, and remove the spill file
+ */
+void chunk_list_free(void)
+{
+	int i;
+
+	for (i = 0; i < chunk_list_max; i++) {
+		struct chunk_entry *e = chunk_list[i];
+		if (e->c)
+			chunk_release(e->c);
+		mem_free(e->data);
+		string_free(e->name);
+		mem_free(e);
+	}
+	mem_free(chunk_list);
+	chunk_list = NULL;
+	chunk_list_max = 0;
+	memset(chunk_hash, 0, sizeof(chunk_hash));
+	chunk_memory = 0;
+
+	if (chunk_spill_path[0])
+		file_delete(chunk_spill_path);
+	chunk_spill_path[0] = '\0';
+	chunk_spill_size = 0;
+	chunk_spill_dead = 0;
+}
+
 /**
  * Find the saved chunk above or below the current player depth
  */
@@ -210,6 +664,7 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 	int i, max_group_id = 0;
 	int y, x;
 	int h = source->height, w = source->width;
+	bitflag info[SQUARE_SIZE];
 
 	/* Check bounds */
 	if (rotate % 1) {
@@ -230,8 +685,8 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 
 			/* Terrain */
 			dest->squares[dest_y][dest_x].feat = square(source, loc(x, y)).feat;
-			sqinfo_copy(square(dest, loc(dest_x, dest_y)).info,
-						square(source, loc(x, y)).info);
+			sqinfo_get(source, loc(x, y), info);
+			sqinfo_set(dest, loc(dest_x, dest_y), info);
 
 			/* Dungeon objects */
 			if (square_object(source, loc(x, y))) {
@@ -271,21 +726,27 @@ bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 				dest_mon->midx = idx;
 				dest_mon->grid = loc(dest_x, dest_y);
 
-				/* Held objects */
-				if (source_mon->held_obj)
-					dest_mon->held_obj = source_mon->held_obj;
+				/* Held objects go with the monster */
+				source_mon->held_obj = NULL;
 			}
 
-			/* Traps */
+			/* Traps, which have to move to the destination's arena */
 			if (square(source, loc(x, y)).trap) {
 				struct trap *trap = square(source, loc(x, y)).trap;
-				dest->squares[dest_y][dest_x].trap = trap;
+				struct trap **last = &dest->squares[dest_y][dest_x].trap;
 
 				/* Traverse the trap list */
 				while (trap) {
-					/* Adjust location */
-					trap->grid = loc(dest_x, dest_y);
-					trap = trap->next;
+					struct trap *next = trap->next;
+
+					/* Copy, and adjust location */
+					*last = trap_new(dest);
+					memcpy(*last, trap, sizeof(*trap));
+					(*last)->grid = loc(dest_x, dest_y);
+					(*last)->next = NULL;
+					last = &(*last)->next;
+					trap_free(source, trap);
+					trap = next;
 				}
 				source->squares[y][x].trap = NULL;
 			}
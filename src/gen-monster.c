@@ -264,24 +264,20 @@ void spread_monsters(struct chunk *c, const char *type, int depth, int num,
  * get expensive), we handle monsters of a specified race separately.
  *
  * \param c the current chunk being generated
- * \param racial_symbol the allowable monster_base symbols
+ * \param layout the vault layout, which lists the racial symbols and where
+ * they are
  * \param vault_type the type of vault, which affects monster selection depth
- * \param data the vault text description, which contains the racial symbol
- * \param y1 the limits of the vault
- * \param y2 the limits of the vault
- * \param x1 the limits of the vault
- * \param x2 the limits of the vault
+ * \param top_left the top left corner of the vault
  */
-void get_vault_monsters(struct chunk *c, char racial_symbol[], char *vault_type,
-						const char *data, int y1, int y2, int x1, int x2)
+void get_vault_monsters(struct chunk *c, const struct template_layout *layout,
+						char *vault_type, struct loc top_left)
 {
-    int i, y, x, depth;
-    const char *t;
+    int i, j, depth;
 
-    for (i = 0; racial_symbol[i] != '\0'; i++) {
+    for (i = 0; layout->races[i] != '\0'; i++) {
 		/* Require correct race, allow uniques. */
 		allow_unique = true;
-		my_strcpy(base_d_char, format("%c", racial_symbol[i]),
+		my_strcpy(base_d_char, format("%c", layout->races[i]),
 				  sizeof(base_d_char));
 
 		/* Determine level of monster */
@@ -303,14 +299,12 @@ void get_vault_monsters(struct chunk *c, char racial_symbol[], char *vault_type,
 
 
 		/* Place the monsters */
-		for (t = data, y = y1; y <= y2; y++) {
-			for (x = x1; x <= x2; x++, t++) {
-				if (*t == racial_symbol[i]) {
-					/* Place a monster */
-					pick_and_place_monster(c, loc(x, y), depth, false,
-										   false, ORIGIN_DROP_SPECIAL);
-				}
-			}
+		for (j = layout->race_start[i]; j < layout->race_start[i + 1]; j++) {
+			const struct template_spot *spot = &layout->racial[j];
+			struct loc grid = loc(top_left.x + spot->x, top_left.y + spot->y);
+
+			pick_and_place_monster(c, grid, depth, false, false,
+								   ORIGIN_DROP_SPECIAL);
 		}
     }
 
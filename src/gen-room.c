@@ -43,6 +43,96 @@
 #include "z-queue.h"
 #include "z-type.h"
 
+/**
+ * ------------------------------------------------------------------------
+ * Template layouts
+ * ------------------------------------------------------------------------ */
+/**
+ * Vault characters which stand for monsters or objects, placed once all the
+ * vault's terrain is down
+ */
+const char *vault_contents = "0123456789~$]|=\"!?_-,";
+
+/**
+ * Find which squares of a template need something done to them when it is
+ * built.
+ * \param text the template text, one row after another
+ * \param height the template dimensions
+ * \param width the template dimensions
+ * \param contents characters to list again as contents, or NULL for none
+ * \return the layout
+ */
+struct template_layout *template_layout_new(const char *text, int height,
+											int width, const char *contents)
+{
+	struct template_layout *layout = mem_zalloc(sizeof(*layout));
+	int size = text ? MIN((int) strlen(text), height * width) : 0;
+	int placed[30] = { 0 };
+	int i, r, n_races = 0;
+
+	/* Count everything up, and note the monster symbols in order */
+	for (i = 0; i < size; i++) {
+		char code = text[i];
+
+		if (code == ' ') continue;
+		layout->n_squares++;
+		if (contents && strchr(contents, code))
+			layout->n_contents++;
+
+		/* Most alphabetic characters signify monster races */
+		if (isalpha((unsigned char) code) && (code != 'x') && (code != 'X')) {
+			char *known = strchr(layout->races, code);
+			if (known) {
+				layout->race_start[known - layout->races + 1]++;
+			} else if (n_races < 30) {
+				layout->races[n_races++] = code;
+				layout->race_start[n_races]++;
+			}
+		}
+	}
+	for (r = 1; r <= n_races; r++)
+		layout->race_start[r] += layout->race_start[r - 1];
+
+	layout->squares = mem_zalloc(MAX(layout->n_squares, 1) *
+								 sizeof(struct template_spot));
+	layout->contents = mem_zalloc(MAX(layout->n_contents, 1) *
+								  sizeof(struct template_spot));
+	layout->racial = mem_zalloc(MAX(layout->race_start[n_races], 1) *
+								sizeof(struct template_spot));
+
+	/* Fill in the squares, keeping each list in text order */
+	layout->n_squares = layout->n_contents = 0;
+	for (i = 0; i < size; i++) {
+		struct template_spot spot = { i / width, i % width, text[i] };
+		char *known;
+
+		if (spot.code == ' ') continue;
+		layout->squares[layout->n_squares++] = spot;
+		if (contents && strchr(contents, spot.code))
+			layout->contents[layout->n_contents++] = spot;
+		known = strchr(layout->races, spot.code);
+		if (known) {
+			r = known - layout->races;
+			layout->racial[layout->race_start[r] + placed[r]++] = spot;
+		}
+	}
+
+	return layout;
+}
+
+/**
+ * Free a template layout
+ */
+void template_layout_free(struct template_layout *layout)
+{
+	if (!layout) return;
+	mem_free(layout->squares);
+	mem_free(layout->contents);
+	mem_free(layout->racial);
+	mem_free(layout);
+}
+
+
 /**
  * ------------------------------------------------------------------------
  * Selection of random templates
@@ -110,9 +200,9 @@ static void generate_room(struct chunk *c, int y1, int x1, int y2, int x2,
 	struct loc grid;
 	for (grid.y = y1; grid.y <= y2; grid.y++)
 		for (grid.x = x1; grid.x <= x2; grid.x++) {
-			sqinfo_on(square(c, grid).info, SQUARE_ROOM);
+			sqinfo_on(c, grid, SQUARE_ROOM);
 			if (light)
-				sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+				sqinfo_on(c, grid, SQUARE_GLOW);
 		}
 }
 
@@ -130,7 +220,7 @@ void generate_mark(struct chunk *c, int y1, int x1, int y2, int x2, int flag)
 	struct loc grid;
 	for (grid.y = y1; grid.y <= y2; grid.y++) {
 		for (grid.x = x1; grid.x <= x2; grid.x++) {
-			sqinfo_on(square(c, grid).info, flag);
+			sqinfo_on(c, grid, flag);
 		}
 	}
 }
@@ -205,10 +295,10 @@ static void fill_xrange(struct chunk *c, int y, int x1, int x2, int feat,
 	for (x = x1; x <= x2; x++) {
 		struct loc grid = loc(x, y);
 		square_set_feat(c, grid, feat);
-		sqinfo_on(square(c, grid).info, SQUARE_ROOM);
-		if (flag) sqinfo_on(square(c, grid).info, flag);
+		sqinfo_on(c, grid, SQUARE_ROOM);
+		if (flag) sqinfo_on(c, grid, flag);
 		if (light)
-			sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+			sqinfo_on(c, grid, SQUARE_GLOW);
 	}
 }
 
@@ -229,10 +319,10 @@ static void fill_yrange(struct chunk *c, int x, int y1, int y2, int feat,
 	for (y = y1; y <= y2; y++) {
 		struct loc grid = loc(x, y);
 		square_set_feat(c, grid, feat);
-		sqinfo_on(square(c, grid).info, SQUARE_ROOM);
-		if (flag) sqinfo_on(square(c, grid).info, flag);
+		sqinfo_on(c, grid, SQUARE_ROOM);
+		if (flag) sqinfo_on(c, grid, flag);
 		if (light)
-			sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+			sqinfo_on(c, grid, SQUARE_GLOW);
 	}
 }
 
@@ -660,15 +750,15 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 							square_set_feat(c, grid, feat);
 
 							if (feat_is_floor(feat)) {
-								sqinfo_on(square(c, grid).info, SQUARE_ROOM);
+								sqinfo_on(c, grid, SQUARE_ROOM);
 							} else {
-								sqinfo_off(square(c, grid).info, SQUARE_ROOM);
+								sqinfo_off(c, grid, SQUARE_ROOM);
 							}
 
 							if (light) {
-								sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+								sqinfo_on(c, grid, SQUARE_GLOW);
 							} else if (!square_isbright(c, grid)) {
-								sqinfo_off(square(c, grid).info, SQUARE_GLOW);
+								sqinfo_off(c, grid, SQUARE_GLOW);
 							}
 						}
 
@@ -688,7 +778,7 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 
 							/* Light grid. */
 							if (light)
-								sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+								sqinfo_on(c, grid, SQUARE_GLOW);
 						}
 					}
 
@@ -716,12 +806,12 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 						struct loc grid1 = loc_sum(grid, ddgrid_ddd[d]);
 
 						/* Join to room, forbid stairs */
-						sqinfo_on(square(c, grid1).info, SQUARE_ROOM);
-						sqinfo_on(square(c, grid1).info, SQUARE_NO_STAIRS);
+						sqinfo_on(c, grid1, SQUARE_ROOM);
+						sqinfo_on(c, grid1, SQUARE_NO_STAIRS);
 
 						/* Illuminate if requested. */
 						if (light)
-							sqinfo_on(square(c, grid1).info, SQUARE_GLOW);
+							sqinfo_on(c, grid1, SQUARE_GLOW);
 
 						/* Look for dungeon granite. */
 						if (square(c, grid1).feat == FEAT_GRANITE) {
@@ -862,8 +952,6 @@ static bool find_space(struct loc *centre, int height, int width)
 	int i;
 	int by, bx, by1, bx1, by2, bx2;
 
-	bool filled;
-
 	/* Find out how many blocks we need. */
 	int blocks_high = 1 + ((height - 1) / dun->block_hgt);
 	int blocks_wide = 1 + ((width - 1) / dun->block_wid);
@@ -898,8 +986,9 @@ static bool find_space(struct loc *centre, int height, int width)
 				dun->cent_n++;
 			}
 
-			/* Reserve a block, marked with the room index */
-			dun->room_map[by][bx] = dun->cent_n;
+			/* Reserve a block */
+			if ((by < dun->row_blocks) && (bx < dun->col_blocks))
+				bitmap_on(dun->room_map, loc(bx, by));
 
 			/* Success. */
 			return (true);
@@ -908,8 +997,6 @@ static bool find_space(struct loc *centre, int height, int width)
 
 	/* We'll allow twenty-five guesses. */
 	for (i = 0; i < 25; i++) {
-		filled = false;
-
 		/* Pick a top left block at random */
 		by1 = randint0(dun->row_blocks);
 		bx1 = randint0(dun->col_blocks);
@@ -922,16 +1009,9 @@ static bool find_space(struct loc *centre, int height, int width)
 		if (by1 < 0 || by2 >= dun->row_blocks) continue;
 		if (bx1 < 0 || bx2 >= dun->col_blocks) continue;
 
-		/* Verify open space */
-		for (by = by1; by <= by2; by++) {
-			for (bx = bx1; bx <= bx2; bx++) {
-				if (dun->room_map[by][bx])
-					filled = true;
-			}
-		}
-
 		/* If space filled, try again. */
-		if (filled)	continue;
+		if (bitmap_rect_count(dun->room_map, loc(bx1, by1), loc(bx2, by2)))
+			continue;
 
 		/* Get the location of the room */
 		centre->y = ((by1 + by2 + 1) * dun->block_hgt) / 2;
@@ -944,11 +1024,7 @@ static bool find_space(struct loc *centre, int height, int width)
 		}
 
 		/* Reserve some blocks */
-		for (by = by1; by <= by2; by++) {
-			for (bx = bx1; bx <= bx2; bx++) {
-				dun->room_map[by][bx] = true;
-			}
-		}
+		bitmap_rect_setall(dun->room_map, loc(bx1, by1), loc(bx2, by2));
 
 		/* Success. */
 		return (true);
@@ -965,15 +1041,15 @@ static bool find_space(struct loc *centre, int height, int width)
  * \param ymax the room dimensions
  * \param xmax the room dimensions
  * \param doors the door position
- * \param data the room template text description
+ * \param layout the room template layout
  * \param tval the object type for any included objects
  * \return success
  */
 static bool build_room_template(struct chunk *c, struct loc centre, int ymax,
-								int xmax, int doors, const char *data, int tval)
+								int xmax, int doors,
+								const struct template_layout *layout, int tval)
 {
-	int dx, dy, rnddoors, doorpos;
-	const char *t;
+	int i, rnddoors, doorpos;
 	bool rndwalls, light;
 	
 
@@ -996,117 +1072,114 @@ static bool build_room_template(struct chunk *c, struct loc centre, int ymax,
 	}
 
 	/* Place dungeon features and objects */
-	for (t = data, dy = 0; dy < ymax && *t; dy++) {
-		for (dx = 0; dx < xmax && *t; dx++, t++) {
-			/* Extract the location */
-			struct loc grid = loc(centre.x - (xmax / 2) + dx,
-								  centre.y - (ymax / 2) + dy);
-
-			/* Skip non-grids */
-			if (*t == ' ') continue;
-
-			/* Lay down a floor */
-			square_set_feat(c, grid, FEAT_FLOOR);
-
-			/* Debugging assertion */
-			assert(square_isempty(c, grid));
-
-			/* Analyze the grid */
-			switch (*t) {
-			case '%': set_marked_granite(c, grid, SQUARE_WALL_OUTER); break;
-			case '#': set_marked_granite(c, grid, SQUARE_WALL_SOLID); break;
-			case '+': place_closed_door(c, grid); break;
-			case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
-			case 'x': {
-
-				/* If optional walls are generated, put a wall in this square */
-				if (rndwalls)
-					set_marked_granite(c, grid, SQUARE_WALL_SOLID);
-				break;
-			}
-			case '(': {
+	for (i = 0; i < layout->n_squares; i++) {
+		const struct template_spot *spot = &layout->squares[i];
+
+		/* Extract the location */
+		struct loc grid = loc(centre.x - (xmax / 2) + spot->x,
+							  centre.y - (ymax / 2) + spot->y);
+
+		/* Lay down a floor */
+		square_set_feat(c, grid, FEAT_FLOOR);
+
+		/* Debugging assertion */
+		assert(square_isempty(c, grid));
+
+		/* Analyze the grid */
+		switch (spot->code) {
+		case '%': set_marked_granite(c, grid, SQUARE_WALL_OUTER); break;
+		case '#': set_marked_granite(c, grid, SQUARE_WALL_SOLID); break;
+		case '+': place_closed_door(c, grid); break;
+		case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
+		case 'x': {
+
+			/* If optional walls are generated, put a wall in this square */
+			if (rndwalls)
+				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+			break;
+		}
+		case '(': {
 
-				/* If optional walls are generated, put a door in this square */
-				if (rndwalls)
-					place_secret_door(c, grid);
-				break;
-			}
-			case ')': {
-				/* If no optional walls generated, put a door in this square */
-				if (!rndwalls)
-					place_secret_door(c, grid);
-				else
-					set_marked_granite(c, grid, SQUARE_WALL_SOLID);
-				break;
-			}
-			case '8': {
+			/* If optional walls are generated, put a door in this square */
+			if (rndwalls)
+				place_secret_door(c, grid);
+			break;
+		}
+		case ')': {
+			/* If no optional walls generated, put a door in this square */
+			if (!rndwalls)
+				place_secret_door(c, grid);
+			else
+				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+			break;
+		}
+		case '8': {
 
-				/* Put something nice in this square
-				 * Object (80%) or Stairs (20%) */
-				if ((randint0(100) < 80) || OPT(player, birth_levels_persist))
-					place_object(c, grid, c->depth, false, false,
-								 ORIGIN_SPECIAL, 0);
-				else
-					place_random_stairs(c, grid);
+			/* Put something nice in this square
+			 * Object (80%) or Stairs (20%) */
+			if ((randint0(100) < 80) || OPT(player, birth_levels_persist))
+				place_object(c, grid, c->depth, false, false,
+							 ORIGIN_SPECIAL, 0);
+			else
+				place_random_stairs(c, grid);
 
-				/* Some monsters to guard it */
-				vault_monsters(c, grid, c->depth + 2, randint0(2) + 3);
+			/* Some monsters to guard it */
+			vault_monsters(c, grid, c->depth + 2, randint0(2) + 3);
 
-				break;
-			}
-			case '9': {
-				/* Create some interesting stuff nearby */
-				struct loc off2 = loc(2, -2);
-				struct loc off3 = loc(3, 3);
-
-				/* A few monsters */
-				vault_monsters(c, loc_diff(grid, off3), c->depth + randint0(2),
-							   randint1(2));
-				vault_monsters(c, loc_sum(grid, off3), c->depth + randint0(2),
-							   randint1(2));
-
-				/* And maybe a bit of treasure */
-				if (one_in_(2))
-					vault_objects(c, loc_sum(grid, off2), c->depth,
-								  1 + randint0(2));
-
-				if (one_in_(2))
-					vault_objects(c, loc_diff(grid, off2), c->depth,
-								  1 + randint0(2));
+			break;
+		}
+		case '9': {
+			/* Create some interesting stuff nearby */
+			struct loc off2 = loc(2, -2);
+			struct loc off3 = loc(3, 3);
 
-				break;
+			/* A few monsters */
+			vault_monsters(c, loc_diff(grid, off3), c->depth + randint0(2),
+						   randint1(2));
+			vault_monsters(c, loc_sum(grid, off3), c->depth + randint0(2),
+						   randint1(2));
 
-			}
-			case '[': {
-				
-				/* Place an object of the template's specified tval */
-				place_object(c, grid, c->depth, false, false, ORIGIN_SPECIAL,
-							 tval);
-				break;
-			}
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6': {
-				/* Check if this is chosen random door position */
-				doorpos = (int) (*t - '0');
-
-				if (doorpos == rnddoors)
-					place_secret_door(c, grid);
-				else
-					set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+			/* And maybe a bit of treasure */
+			if (one_in_(2))
+				vault_objects(c, loc_sum(grid, off2), c->depth,
+							  1 + randint0(2));
 
-				break;
-			}
-			}
+			if (one_in_(2))
+				vault_objects(c, loc_diff(grid, off2), c->depth,
+							  1 + randint0(2));
 
-			/* Part of a room */
-			sqinfo_on(square(c, grid).info, SQUARE_ROOM);
-			if (light)
-				sqinfo_on(square(c, grid).info, SQUARE_GLOW);
+			break;
+
+		}
+		case '[': {
+			
+			/* Place an object of the template's specified tval */
+			place_object(c, grid, c->depth, false, false, ORIGIN_SPECIAL,
+						 tval);
+			break;
+		}
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6': {
+			/* Check if this is chosen random door position */
+			doorpos = (int) (spot->code - '0');
+
+			if (doorpos == rnddoors)
+				place_secret_door(c, grid);
+			else
+				set_marked_granite(c, grid, SQUARE_WALL_SOLID);
+
+			break;
+		}
 		}
+
+		/* Part of a room */
+		sqinfo_on(c, grid, SQUARE_ROOM);
+		if (light)
+			sqinfo_on(c, grid, SQUARE_GLOW);
 	}
 
 	return true;
@@ -1129,7 +1202,7 @@ static bool build_room_template_type(struct chunk *c, struct loc centre,
 
 	/* Build the room */
 	if (!build_room_template(c, centre, room->hgt, room->wid, room->dor,
-							 room->text, room->tval))
+							 room->layout, room->tval))
 		return false;
 
 	ROOM_LOG("Room template (%s)", room->name);
@@ -1146,11 +1219,9 @@ static bool build_room_template_type(struct chunk *c, struct loc centre,
  */
 bool build_vault(struct chunk *c, struct loc centre, struct vault *v)
 {
-	const char *data = v->text;
+	const struct template_layout *layout = v->layout;
 	int y1, x1, y2, x2;
-	int x, y, races_local = 0;
-	const char *t;
-	char racial_symbol[30] = "";
+	int i;
 	bool icky;
 
 	assert(c);
@@ -1171,236 +1242,218 @@ bool build_vault(struct chunk *c, struct loc centre, struct vault *v)
 	generate_mark(c, y1, x1, y2, x2, SQUARE_MON_RESTRICT);
 
 	/* Place dungeon features and objects */
-	for (t = data, y = y1; y <= y2 && *t; y++) {
-		for (x = x1; x <= x2 && *t; x++, t++) {
-			struct loc grid = loc(x, y);
-			/* Skip non-grids */
-			if (*t == ' ') continue;
-
-			/* Lay down a floor */
-			square_set_feat(c, grid, FEAT_FLOOR);
-
-			/* Debugging assertion */
-			assert(square_isempty(c, grid));
-
-			/* By default vault squares are marked icky */
-			icky = true;
-
-			/* Analyze the grid */
-			switch (*t) {
-			case '%': {
-				/* In this case, the square isn't really part of the
-				 * vault, but rather is part of the "door step" to the
-				 * vault. We don't mark it icky so that the tunneling
-				 * code knows its allowed to remove this wall. */
-				set_marked_granite(c, grid, SQUARE_WALL_OUTER);
-				icky = false;
-				break;
-			}
-				/* Inner granite wall */
-			case '#': set_marked_granite(c, grid, SQUARE_WALL_INNER); break;
-				/* Permanent wall */
-			case '@': square_set_feat(c, grid, FEAT_PERM); break;
-				/* Gold seam */
-			case '*': {
-				square_set_feat(c, grid, one_in_(2) ? FEAT_MAGMA_K :
-								FEAT_QUARTZ_K);
-				break;
-			}
-				/* Rubble */
-			case ':': {
-				square_set_feat(c, grid, one_in_(2) ? FEAT_PASS_RUBBLE :
-								FEAT_RUBBLE);
-				break;
-			}
-				/* Secret door */
-			case '+': place_secret_door(c, grid); break;
-				/* Trap */
-			case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
-				/* Treasure or a trap */
-			case '&': {
-				if (randint0(100) < 75) {
-					place_object(c, grid, c->depth, false, false, ORIGIN_VAULT,
-								 0);
-				} else if (one_in_(4)) {
-					place_trap(c, grid, -1, c->depth);
-				}
-				break;
-			}
-				/* Stairs */
-			case '<': {
-				if (OPT(player, birth_levels_persist)) break;
-				square_set_feat(c, grid, FEAT_LESS); break;
-			}
-			case '>': {
-				if (OPT(player, birth_levels_persist)) break;
-				/* No down stairs at bottom or on quests */
-				if (is_quest(c->depth) || c->depth >= z_info->max_depth - 1)
-					square_set_feat(c, grid, FEAT_LESS);
-				else
-					square_set_feat(c, grid, FEAT_MORE);
-				break;
-			}
-				/* Lava */
-			case '`': square_set_feat(c, grid, FEAT_LAVA); break;
-				/* Included to allow simple inclusion of FA vaults */
-			case '/': /*square_set_feat(c, grid, FEAT_WATER)*/; break;
-			case ';': /*square_set_feat(c, grid, FEAT_TREE)*/; break;
+	for (i = 0; i < layout->n_squares; i++) {
+		const struct template_spot *spot = &layout->squares[i];
+		struct loc grid = loc(x1 + spot->x, y1 + spot->y);
+
+		/* Lay down a floor */
+		square_set_feat(c, grid, FEAT_FLOOR);
+
+		/* Debugging assertion */
+		assert(square_isempty(c, grid));
+
+		/* By default vault squares are marked icky */
+		icky = true;
+
+		/* Analyze the grid */
+		switch (spot->code) {
+		case '%': {
+			/* In this case, the square isn't really part of the
+			 * vault, but rather is part of the "door step" to the
+			 * vault. We don't mark it icky so that the tunneling
+			 * code knows its allowed to remove this wall. */
+			set_marked_granite(c, grid, SQUARE_WALL_OUTER);
+			icky = false;
+			break;
+		}
+			/* Inner granite wall */
+		case '#': set_marked_granite(c, grid, SQUARE_WALL_INNER); break;
+			/* Permanent wall */
+		case '@': square_set_feat(c, grid, FEAT_PERM); break;
+			/* Gold seam */
+		case '*': {
+			square_set_feat(c, grid, one_in_(2) ? FEAT_MAGMA_K :
+							FEAT_QUARTZ_K);
+			break;
+		}
+			/* Rubble */
+		case ':': {
+			square_set_feat(c, grid, one_in_(2) ? FEAT_PASS_RUBBLE :
+							FEAT_RUBBLE);
+			break;
+		}
+			/* Secret door */
+		case '+': place_secret_door(c, grid); break;
+			/* Trap */
+		case '^': if (one_in_(4)) place_trap(c, grid, -1, c->depth); break;
+			/* Treasure or a trap */
+		case '&': {
+			if (randint0(100) < 75) {
+				place_object(c, grid, c->depth, false, false, ORIGIN_VAULT,
+							 0);
+			} else if (one_in_(4)) {
+				place_trap(c, grid, -1, c->depth);
 			}
-
-			/* Part of a vault */
-			sqinfo_on(square(c, grid).info, SQUARE_ROOM);
-			if (icky) sqinfo_on(square(c, grid).info, SQUARE_VAULT);
+			break;
+		}
+			/* Stairs */
+		case '<': {
+			if (OPT(player, birth_levels_persist)) break;
+			square_set_feat(c, grid, FEAT_LESS); break;
 		}
+		case '>': {
+			if (OPT(player, birth_levels_persist)) break;
+			/* No down stairs at bottom or on quests */
+			if (is_quest(c->depth) || c->depth >= z_info->max_depth - 1)
+				square_set_feat(c, grid, FEAT_LESS);
+			else
+				square_set_feat(c, grid, FEAT_MORE);
+			break;
+		}
+			/* Lava */
+		case '`': square_set_feat(c, grid, FEAT_LAVA); break;
+			/* Included to allow simple inclusion of FA vaults */
+		case '/': /*square_set_feat(c, grid, FEAT_WATER)*/; break;
+		case ';': /*square_set_feat(c, grid, FEAT_TREE)*/; break;
+		}
+
+		/* Part of a vault */
+		sqinfo_on(c, grid, SQUARE_ROOM);
+		if (icky) sqinfo_on(c, grid, SQUARE_VAULT);
 	}
 
 
 	/* Place regular dungeon monsters and objects */
-	for (t = data, y = y1; y <= y2 && *t; y++) {
-		for (x = x1; x <= x2 && *t; x++, t++) {
-			struct loc grid = loc(x, y);
-			/* Hack -- skip "non-grids" */
-			if (*t == ' ') continue;
-
-			/* Most alphabetic characters signify monster races. */
-			if (isalpha(*t) && (*t != 'x') && (*t != 'X')) {
-				/* If the symbol is not yet stored, ... */
-				if (!strchr(racial_symbol, *t)) {
-					/* ... store it for later processing. */
-					if (races_local < 30)
-						racial_symbol[races_local++] = *t;
-				}
-			}
+	for (i = 0; i < layout->n_contents; i++) {
+		const struct template_spot *spot = &layout->contents[i];
+		struct loc grid = loc(x1 + spot->x, y1 + spot->y);
 
-			/* Otherwise, analyze the symbol */
-			else
-				switch (*t) {
-					/* An ordinary monster, object (sometimes good), or trap. */
-				case '1': {
-					if (one_in_(2)) {
-						pick_and_place_monster(c, grid, c->depth , true, true,
-											   ORIGIN_DROP_VAULT);
-					} else if (one_in_(2)) {
-						place_object(c, grid, c->depth,
-									 one_in_(8) ? true : false, false,
-									 ORIGIN_VAULT, 0);
-					} else if (one_in_(4)) {
-						place_trap(c, grid, -1, c->depth);
-					}
-					break;
-				}
-					/* Slightly out of depth monster. */
-				case '2': pick_and_place_monster(c, grid, c->depth + 5, true,
-												 true, ORIGIN_DROP_VAULT);
-					break;
-					/* Slightly out of depth object. */
-				case '3': place_object(c, grid, c->depth + 3, false, false, 
-									   ORIGIN_VAULT, 0); break;
-					/* Monster and/or object */
-				case '4': {
-					if (one_in_(2))
-						pick_and_place_monster(c, grid, c->depth + 3, true, 
-											   true, ORIGIN_DROP_VAULT);
-					if (one_in_(2))
-						place_object(c, grid, c->depth + 7, false, false,
-									 ORIGIN_VAULT, 0);
-					break;
-				}
-					/* Out of depth object. */
-				case '5': place_object(c, grid, c->depth + 7, false, false,
-									   ORIGIN_VAULT, 0); break;
-					/* Out of depth monster. */
-				case '6': pick_and_place_monster(c, grid, c->depth + 11, true,
-												 true, ORIGIN_DROP_VAULT);
-					break;
-					/* Very out of depth object. */
-				case '7': place_object(c, grid, c->depth + 15, false, false,
-									   ORIGIN_VAULT, 0); break;
-					/* Very out of depth monster. */
-				case '0': pick_and_place_monster(c, grid, c->depth + 20, true,
-												 true, ORIGIN_DROP_VAULT);
-					break;
-					/* Meaner monster, plus treasure */
-				case '9': {
-					pick_and_place_monster(c, grid, c->depth + 9, true, true,
-										   ORIGIN_DROP_VAULT);
-					place_object(c, grid, c->depth + 7, true, false,
-								 ORIGIN_VAULT, 0);
-					break;
-				}
-					/* Nasty monster and treasure */
-				case '8': {
-					pick_and_place_monster(c, grid, c->depth + 40, true, true,
-										   ORIGIN_DROP_VAULT);
-					place_object(c, grid, c->depth + 20, true, true,
-								 ORIGIN_VAULT, 0);
-					break;
-				}
-					/* A chest. */
-				case '~': place_object(c, grid, c->depth + 5, false, false,
-									   ORIGIN_VAULT, TV_CHEST); break;
-					/* Treasure. */
-				case '$': place_gold(c, grid, c->depth, ORIGIN_VAULT);break;
-					/* Armour. */
-				case ']': {
-					int	tval = 0, temp = one_in_(3) ? randint1(9) : randint1(8);
-					switch (temp) {
-					case 1: tval = TV_BOOTS; break;
-					case 2: tval = TV_GLOVES; break;
-					case 3: tval = TV_HELM; break;
-					case 4: tval = TV_CROWN; break;
-					case 5: tval = TV_SHIELD; break;
-					case 6: tval = TV_CLOAK; break;
-					case 7: tval = TV_SOFT_ARMOR; break;
-					case 8: tval = TV_HARD_ARMOR; break;
-					case 9: tval = TV_DRAG_ARMOR; break;
-					}
-					place_object(c, grid, c->depth + 3, true, false,
-								 ORIGIN_VAULT, tval);
-					break;
-				}
-					/* Weapon. */
-				case '|': {
-					int	tval = 0, temp = randint1(4);
-					switch (temp) {
-					case 1: tval = TV_SWORD; break;
-					case 2: tval = TV_POLEARM; break;
-					case 3: tval = TV_HAFTED; break;
-					case 4: tval = TV_BOW; break;
-					}
-					place_object(c, grid, c->depth + 3, true, false,
-								 ORIGIN_VAULT, tval);
-					break;
-				}
-					/* Ring. */
-				case '=': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_RING); break;
-					/* Amulet. */
-				case '"': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_AMULET); break;
-					/* Potion. */
-				case '!': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_POTION); break;
-					/* Scroll. */
-				case '?': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_SCROLL); break;
-					/* Staff. */
-				case '_': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_STAFF); break;
-					/* Wand or rod. */
-				case '-': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT,
-									   one_in_(2) ? TV_WAND : TV_ROD);
-					break;
-					/* Food or mushroom. */
-				case ',': place_object(c, grid, c->depth + 3, one_in_(4), false,
-									   ORIGIN_VAULT, TV_FOOD); break;
-				}
+		switch (spot->code) {
+			/* An ordinary monster, object (sometimes good), or trap. */
+		case '1': {
+			if (one_in_(2)) {
+				pick_and_place_monster(c, grid, c->depth , true, true,
+									   ORIGIN_DROP_VAULT);
+			} else if (one_in_(2)) {
+				place_object(c, grid, c->depth,
+							 one_in_(8) ? true : false, false,
+							 ORIGIN_VAULT, 0);
+			} else if (one_in_(4)) {
+				place_trap(c, grid, -1, c->depth);
+			}
+			break;
+		}
+			/* Slightly out of depth monster. */
+		case '2': pick_and_place_monster(c, grid, c->depth + 5, true,
+										 true, ORIGIN_DROP_VAULT);
+			break;
+			/* Slightly out of depth object. */
+		case '3': place_object(c, grid, c->depth + 3, false, false, 
+							   ORIGIN_VAULT, 0); break;
+			/* Monster and/or object */
+		case '4': {
+			if (one_in_(2))
+				pick_and_place_monster(c, grid, c->depth + 3, true, 
+									   true, ORIGIN_DROP_VAULT);
+			if (one_in_(2))
+				place_object(c, grid, c->depth + 7, false, false,
+							 ORIGIN_VAULT, 0);
+			break;
+		}
+			/* Out of depth object. */
+		case '5': place_object(c, grid, c->depth + 7, false, false,
+							   ORIGIN_VAULT, 0); break;
+			/* Out of depth monster. */
+		case '6': pick_and_place_monster(c, grid, c->depth + 11, true,
+										 true, ORIGIN_DROP_VAULT);
+			break;
+			/* Very out of depth object. */
+		case '7': place_object(c, grid, c->depth + 15, false, false,
+							   ORIGIN_VAULT, 0); break;
+			/* Very out of depth monster. */
+		case '0': pick_and_place_monster(c, grid, c->depth + 20, true,
+										 true, ORIGIN_DROP_VAULT);
+			break;
+			/* Meaner monster, plus treasure */
+		case '9': {
+			pick_and_place_monster(c, grid, c->depth + 9, true, true,
+								   ORIGIN_DROP_VAULT);
+			place_object(c, grid, c->depth + 7, true, false,
+						 ORIGIN_VAULT, 0);
+			break;
+		}
+			/* Nasty monster and treasure */
+		case '8': {
+			pick_and_place_monster(c, grid, c->depth + 40, true, true,
+								   ORIGIN_DROP_VAULT);
+			place_object(c, grid, c->depth + 20, true, true,
+						 ORIGIN_VAULT, 0);
+			break;
+		}
+			/* A chest. */
+		case '~': place_object(c, grid, c->depth + 5, false, false,
+							   ORIGIN_VAULT, TV_CHEST); break;
+			/* Treasure. */
+		case '$': place_gold(c, grid, c->depth, ORIGIN_VAULT);break;
+			/* Armour. */
+		case ']': {
+			int	tval = 0, temp = one_in_(3) ? randint1(9) : randint1(8);
+			switch (temp) {
+			case 1: tval = TV_BOOTS; break;
+			case 2: tval = TV_GLOVES; break;
+			case 3: tval = TV_HELM; break;
+			case 4: tval = TV_CROWN; break;
+			case 5: tval = TV_SHIELD; break;
+			case 6: tval = TV_CLOAK; break;
+			case 7: tval = TV_SOFT_ARMOR; break;
+			case 8: tval = TV_HARD_ARMOR; break;
+			case 9: tval = TV_DRAG_ARMOR; break;
+			}
+			place_object(c, grid, c->depth + 3, true, false,
+						 ORIGIN_VAULT, tval);
+			break;
+		}
+			/* Weapon. */
+		case '|': {
+			int	tval = 0, temp = randint1(4);
+			switch (temp) {
+			case 1: tval = TV_SWORD; break;
+			case 2: tval = TV_POLEARM; break;
+			case 3: tval = TV_HAFTED; break;
+			case 4: tval = TV_BOW; break;
+			}
+			place_object(c, grid, c->depth + 3, true, false,
+						 ORIGIN_VAULT, tval);
+			break;
+		}
+			/* Ring. */
+		case '=': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_RING); break;
+			/* Amulet. */
+		case '"': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_AMULET); break;
+			/* Potion. */
+		case '!': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_POTION); break;
+			/* Scroll. */
+		case '?': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_SCROLL); break;
+			/* Staff. */
+		case '_': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_STAFF); break;
+			/* Wand or rod. */
+		case '-': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT,
+							   one_in_(2) ? TV_WAND : TV_ROD);
+			break;
+			/* Food or mushroom. */
+		case ',': place_object(c, grid, c->depth + 3, one_in_(4), false,
+							   ORIGIN_VAULT, TV_FOOD); break;
 		}
 	}
 
 	/* Place specified monsters */
-	get_vault_monsters(c, racial_symbol, v->typ, data, y1, y2, x1, x2);
+	get_vault_monsters(c, layout, v->typ, loc(x1, y1));
 
 	return true;
 }
@@ -2960,11 +3013,11 @@ bool build_room_of_chambers(struct chunk *c, struct loc centre, int rating)
 					if (!square_in_bounds(c, grid1)) continue;
 
 					/* Turn into room, forbid stairs. */
-					sqinfo_on(square(c, grid1).info, SQUARE_ROOM);
-					sqinfo_on(square(c, grid1).info, SQUARE_NO_STAIRS);
+					sqinfo_on(c, grid1, SQUARE_ROOM);
+					sqinfo_on(c, grid1, SQUARE_NO_STAIRS);
 
 					/* Illuminate if requested. */
-					if (light) sqinfo_on(square(c, grid1).info, SQUARE_GLOW);
+					if (light) sqinfo_on(c, grid1, SQUARE_GLOW);
 				}
 			}
 		}
@@ -3121,7 +3174,6 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 	int bx2 = bx0 + profile.width / dun->block_wid;
 
 	struct loc centre;
-	int by, bx;
 
 	/* Enforce the room profile's minimum depth */
 	if (c->depth < profile.level) return false;
@@ -3143,13 +3195,9 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 		if (by1 < 0 || by2 >= dun->row_blocks) return false;
 		if (bx1 < 0 || bx2 >= dun->col_blocks) return false;
 
-		/* Verify open space */
-		for (by = by1; by <= by2; by++) {
-			for (bx = bx1; bx <= bx2; bx++) {
-				/* previous rooms prevent new ones */
-				if (dun->room_map[by][bx]) return false;
-			}
-		}
+		/* Verify open space; previous rooms prevent new ones */
+		if (bitmap_rect_count(dun->room_map, loc(bx1, by1), loc(bx2, by2)))
+			return false;
 
 		/* Get the location of the room */
 		centre = loc(((bx1 + bx2 + 1) * dun->block_wid) / 2,
@@ -3165,11 +3213,9 @@ bool room_build(struct chunk *c, int by0, int bx0, struct room_profile profile,
 		}
 
 		/* Reserve some blocks */
-		for (by = by1; by < by2; by++) {
-			for (bx = bx1; bx < bx2; bx++) {
-				dun->room_map[by][bx] = true;
-			}
-		}
+		if ((by1 < by2) && (bx1 < bx2))
+			bitmap_rect_setall(dun->room_map, loc(bx1, by1),
+							   loc(bx2 - 1, by2 - 1));
 	}
 
 	/* Count pit/nests rooms */
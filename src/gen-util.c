@@ -147,6 +147,37 @@ void shuffle(int *arr, int n)
 }
 
 
+/**
+ * Scratch space for cave_find_in_range(), kept between calls.  It holds the
+ * shuffled order of the squares being searched, but only where the shuffle
+ * has actually moved something; entries not stamped by the current search
+ * stand for themselves, so the space never needs clearing.
+ */
+static struct {
+	int *squares;
+	u32b *stamps;
+	int size;
+	u32b stamp;
+} find_order;
+
+/**
+ * Get the square at a place in the current search order
+ */
+static int find_order_get(int i)
+{
+	return find_order.stamps[i] == find_order.stamp ? find_order.squares[i] : i;
+}
+
+/**
+ * Free the scratch space used for searching for squares
+ */
+void cave_find_cleanup(void)
+{
+	mem_free(find_order.squares);
+	mem_free(find_order.stamps);
+	memset(&find_order, 0, sizeof(find_order));
+}
+
 /**
  * Locate a square in a rectangle which satisfies the given predicate.
  *
@@ -165,24 +196,35 @@ static bool cave_find_in_range(struct chunk *c, struct loc *grid,
     int i, n = diff.y * diff.x;
     bool found = false;
 
-    /* Allocate the squares, and randomize their order */
-    int *squares = mem_alloc(n * sizeof(int));
-    for (i = 0; i < n; i++) squares[i] = i;
+	/* Make sure there's room to shuffle the squares */
+	if (n > find_order.size) {
+		find_order.squares = mem_realloc(find_order.squares, n * sizeof(int));
+		find_order.stamps = mem_realloc(find_order.stamps, n * sizeof(u32b));
+		memset(find_order.stamps + find_order.size, 0,
+			   (n - find_order.size) * sizeof(u32b));
+		find_order.size = n;
+	}
+
+	/* Start a new order, with every square in its own place */
+	if (!++find_order.stamp) {
+		memset(find_order.stamps, 0, find_order.size * sizeof(u32b));
+		find_order.stamp = 1;
+	}
 
     /* Test each square in (random) order for openness */
     for (i = 0; i < n && !found; i++) {
 		int j = randint0(n - i) + i;
-		int k = squares[j];
-		squares[j] = squares[i];
-		squares[i] = k;
+		int k = find_order_get(j);
+
+		/* Swap; place i is never looked at again, so isn't written */
+		find_order.squares[j] = find_order_get(i);
+		find_order.stamps[j] = find_order.stamp;
 
 		grid->y = (k / diff.x) + top_left.y;
 		grid->x = (k % diff.x) + top_left.x;
 		if (pred(c, *grid)) found = true;
     }
 
-	mem_free(squares);
-
     /* Return whether we found an empty square or not. */
     return found;
 }
@@ -249,6 +291,179 @@ bool find_nearby_grid(struct chunk *c, struct loc *grid, struct loc centre,
 }
 
 
+/**
+ * A horizontal run of squares in a row, used while labelling regions
+ */
+struct region_run {
+	int y, x1, x2;		/*!< Row and first and last column */
+	int label;			/*!< Provisional label */
+};
+
+/**
+ * Find the representative of a provisional label, halving the path to it
+ */
+static int region_find(int *parent, int label)
+{
+	while (parent[label] != label) {
+		parent[label] = parent[parent[label]];
+		label = parent[label];
+	}
+	return label;
+}
+
+/**
+ * Merge the sets of two provisional labels, keeping the lower as the root
+ */
+static void region_union(int *parent, int a, int b)
+{
+	a = region_find(parent, a);
+	b = region_find(parent, b);
+	if (a < b)
+		parent[b] = a;
+	else if (b < a)
+		parent[a] = b;
+}
+
+/**
+ * Label the connected regions of the squares satisfying a predicate.
+ *
+ * The predicate is looked at once per square to make a bitmap.  Then the
+ * first pass splits each row of the bitmap into runs, gives each run a
+ * provisional label and unites it with the runs it touches in the row above;
+ * the second pass numbers the resulting sets in the order their first square
+ * is met scanning row by row, and writes the labels out.
+ * \param c current chunk
+ * \param pred the squares to divide into regions
+ * \param diagonal whether squares touching only at corners are connected
+ * \return the regions, to be freed with cave_regions_free()
+ */
+struct cave_regions *cave_regions_new(struct chunk *c, square_predicate pred,
+									  bool diagonal)
+{
+	struct cave_regions *r = mem_zalloc(sizeof(*r));
+	struct bitmap *open = bitmap_new(c->height, c->width);
+	struct region_run *runs = mem_zalloc(((c->width + 1) / 2 + 1) * c->height
+										 * sizeof(*runs));
+	int *parent, *final;
+	int n = 0, above = 0, above_end = 0, reach = diagonal ? 1 : 0, i;
+	struct loc grid;
+
+	r->height = c->height;
+	r->width = c->width;
+	r->label = mem_zalloc(c->height * c->width * sizeof(int));
+
+	for (grid.y = 0; grid.y < c->height; grid.y++)
+		for (grid.x = 0; grid.x < c->width; grid.x++)
+			if (pred(c, grid)) bitmap_on(open, grid);
+
+	/* First pass: find the runs, and join them to those above */
+	parent = mem_zalloc(((c->width + 1) / 2 + 1) * c->height * sizeof(int));
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		int start = n, x = bitmap_row_next(open, grid.y, 0, true);
+
+		while (x < c->width) {
+			struct region_run *run = &runs[n];
+			int j;
+
+			run->y = grid.y;
+			run->x1 = x;
+			run->x2 = bitmap_row_next(open, grid.y, x, false) - 1;
+			run->label = n;
+			parent[n] = n;
+
+			/* Runs above which end too far left can't touch later runs */
+			while (above < above_end && runs[above].x2 + reach < run->x1)
+				above++;
+			for (j = above; j < above_end; j++) {
+				if (runs[j].x1 > run->x2 + reach) break;
+				region_union(parent, runs[j].label, n);
+			}
+
+			n++;
+			x = bitmap_row_next(open, grid.y, run->x2 + 1, true);
+		}
+
+		above = start;
+		above_end = n;
+	}
+
+	/* Second pass: number the regions and label the squares */
+	final = mem_zalloc((n + 1) * sizeof(int));
+	r->size = mem_zalloc((n + 1) * sizeof(int));
+	for (i = 0; i < n; i++) {
+		int root = region_find(parent, runs[i].label);
+		int *label = r->label + runs[i].y * c->width;
+		int x;
+
+		if (!final[root]) final[root] = ++r->count;
+		for (x = runs[i].x1; x <= runs[i].x2; x++)
+			label[x] = final[root];
+		r->size[final[root]] += runs[i].x2 - runs[i].x1 + 1;
+	}
+
+	mem_free(final);
+	mem_free(parent);
+	mem_free(runs);
+	bitmap_free(open);
+	return r;
+}
+
+/**
+ * Free regions made by cave_regions_new()
+ */
+void cave_regions_free(struct cave_regions *r)
+{
+	if (!r) return;
+	mem_free(r->label);
+	mem_free(r->size);
+	mem_free(r);
+}
+
+/**
+ * Get the region of a grid, or 0 if the grid is in none
+ */
+int cave_region(const struct cave_regions *r, struct loc grid)
+{
+	return r->label[grid_to_i(grid, r->width)];
+}
+
+/**
+ * Squares which could be walked or dug through
+ */
+static bool square_isnotperm(struct chunk *c, struct loc grid)
+{
+	return !square_isperm(c, grid);
+}
+
+/**
+ * Check that the player can get to a down staircase, if the level should
+ * have one; walls are allowed in the way as long as they can be dug
+ * \param c is the current chunk
+ * \param grid is where the player starts
+ */
+bool cave_stairs_reachable(struct chunk *c, struct loc grid)
+{
+	struct cave_regions *r;
+	int home, i, size = c->height * c->width;
+	bool found = false;
+
+	/* Bottom and quest levels have no down stairs */
+	if (is_quest(c->depth) || c->depth >= z_info->max_depth - 1) return true;
+
+	r = cave_regions_new(c, square_isnotperm, true);
+	home = cave_region(r, grid);
+	for (i = 0; home && !found && (i < size); i++) {
+		struct loc stairs;
+		if (r->label[i] != home) continue;
+		i_to_grid(i, c->width, &stairs);
+		found = square_isdownstairs(c, stairs);
+	}
+	cave_regions_free(r);
+
+	return found;
+}
+
+
 /**
  * Given two points, pick a valid cardinal direction from one to the other.
  * \param offset found offset direction from grid 1 to grid2
@@ -29,6 +29,7 @@
 
 #include "angband.h"
 #include "cave.h"
+#include "cmd-journal.h"
 #include "datafile.h"
 #include "game-event.h"
 #include "game-input.h"
@@ -57,6 +58,16 @@ struct vault *vaults;
 static struct cave_profile *cave_profiles;
 struct dun_data *dun;
 struct room_template *room_templates;
+struct gen_report *gen_report;
+
+/**
+ * Descriptions of the reasons for restarting generation, by gen_failure
+ */
+const char *gen_failure_names[] = {
+	"builder failed",
+	"too many monsters",
+	"unreachable stairs"
+};
 
 static const struct {
 	const char *name;
@@ -422,8 +433,14 @@ static errr run_parse_room(struct parser *p) {
 }
 
 static errr finish_parse_room(struct parser *p) {
+	struct room_template *t;
+
 	room_templates = parser_priv(p);
 	parser_destroy(p);
+
+	/* Lay the templates out ready for building */
+	for (t = room_templates; t; t = t->next)
+		t->layout = template_layout_new(t->text, t->hgt, t->wid, NULL);
 	return 0;
 }
 
@@ -434,6 +451,7 @@ static void cleanup_room(void)
 		next = t->next;
 		mem_free(t->name);
 		mem_free(t->text);
+		template_layout_free(t->layout);
 		mem_free(t);
 	}
 }
@@ -569,8 +587,15 @@ static errr run_parse_vault(struct parser *p) {
 }
 
 static errr finish_parse_vault(struct parser *p) {
+	struct vault *v;
+
 	vaults = parser_priv(p);
 	parser_destroy(p);
+
+	/* Lay the vaults out ready for building */
+	for (v = vaults; v; v = v->next)
+		v->layout = template_layout_new(v->text, v->hgt, v->wid,
+										vault_contents);
 	return 0;
 }
 
@@ -582,6 +607,7 @@ static void cleanup_vault(void)
 		mem_free(v->name);
 		mem_free(v->typ);
 		mem_free(v->text);
+		template_layout_free(v->layout);
 		mem_free(v);
 	}
 }
@@ -594,24 +620,17 @@ static struct file_parser vault_parser = {
 	cleanup_vault
 };
 
+/**
+ * The template parsers, none of which needs any of the others
+ */
+static struct parser_list template_parsers[] = {
+	{ "dungeon profiles", &profile_parser, { NULL } },
+	{ "room templates", &room_parser, { NULL } },
+	{ "vaults", &vault_parser, { NULL } }
+};
+
 static void run_template_parser(void) {
-	/* Initialize room info */
-	event_signal_message(EVENT_INITSTATUS, 0,
-						 "Initializing arrays... (dungeon profiles)");
-	if (run_parser(&profile_parser))
-		quit("Cannot initialize dungeon profiles");
-
-	/* Initialize room info */
-	event_signal_message(EVENT_INITSTATUS, 0,
-						 "Initializing arrays... (room templates)");
-	if (run_parser(&room_parser))
-		quit("Cannot initialize room templates");
-
-	/* Initialize vault info */
-	event_signal_message(EVENT_INITSTATUS, 0,
-						 "Initializing arrays... (vaults)");
-	if (run_parser(&vault_parser))
-		quit("Cannot initialize vaults");
+	run_parser_list(template_parsers, N_ELEMENTS(template_parsers));
 }
 
 
@@ -623,6 +642,7 @@ static void cleanup_template_parser(void)
 	cleanup_parser(&profile_parser);
 	cleanup_parser(&room_parser);
 	cleanup_parser(&vault_parser);
+	cave_find_cleanup();
 }
 
 
@@ -649,7 +669,7 @@ static void place_feeling(struct chunk *c)
 				continue;
 
 			/* Set the cave square appropriately */
-			sqinfo_on(square(c, grid).info, SQUARE_FEEL);
+			sqinfo_on(c, grid, SQUARE_FEEL);
 			
 			break;
 		}
@@ -765,6 +785,15 @@ const struct cave_profile *find_cave_profile(char *name)
 	return NULL;
 }
 
+/**
+ * Get a cave_profile by its index, or NULL if there is no such profile
+ */
+const struct cave_profile *cave_profile_by_idx(int idx)
+{
+	if (idx < 0 || idx >= z_info->profile_max) return NULL;
+	return &cave_profiles[idx];
+}
+
 /**
  * Choose a cave profile
  * \param p is the player
@@ -933,9 +962,20 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 	int i, tries = 0;
 	struct chunk *chunk = NULL;
 
+	/* Levels are made from their own stream of random numbers */
+	int old_stream = Rand_stream_select(RNG_GEN);
+
+	/* Start a fresh report */
+	if (gen_report) {
+		gen_report->gave_up = false;
+		gen_report->tries = 0;
+		memset(gen_report->failures, 0, sizeof(gen_report->failures));
+	}
+
 	/* Arena levels handled separately */
 	if (p->upkeep->arena_level) {
 		/* Generate level */
+		if (gen_report) gen_report->tries = 1;
 		chunk = arena_gen(p, height, width);
 
 		/* Allocate new known level, light it if requested */
@@ -951,6 +991,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 		wiz_light(chunk, p, false);
 		chunk->turn = turn;
 
+		Rand_stream_select(old_stream);
 		return chunk;
 	}
 
@@ -960,6 +1001,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 		struct dun_data dun_body;
 
 		error = NULL;
+		if (gen_report) gen_report->tries++;
 
 		/* Mark the dungeon as being unready (to avoid artifact loss, etc) */
 		character_dungeon = false;
@@ -977,11 +1019,24 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 			get_join_info(p, dun);
 		}
 
-		/* Choose a profile and build the level */
-		dun->profile = choose_profile(p);
+		/* Choose a profile (unless one is being forced) and build the level */
+		if (gen_report && gen_report->profile)
+			dun->profile = gen_report->profile;
+		else
+			dun->profile = choose_profile(p);
 		chunk = dun->profile->builder(p, height, width);
 		if (!chunk) {
 			error = "Failed to find builder";
+			if (gen_report) {
+				gen_report->failures[GEN_FAIL_BUILDER]++;
+
+				/* A forced profile that never works falls back to the
+				 * normal choice for the second half of the tries */
+				if (gen_report->profile && tries == 49) {
+					gen_report->profile = NULL;
+					gen_report->gave_up = true;
+				}
+			}
 			mem_free(dun->join);
 			mem_free(dun->cent);
 			mem_free(dun->door);
@@ -1010,25 +1065,25 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 			}
 		}
 
-		/* Clear generation flags, add connecting info */
+		/* Clear generation flags */
+		bitmap_wipe(chunk->info[SQUARE_WALL_INNER]);
+		bitmap_wipe(chunk->info[SQUARE_WALL_OUTER]);
+		bitmap_wipe(chunk->info[SQUARE_WALL_SOLID]);
+		bitmap_wipe(chunk->info[SQUARE_MON_RESTRICT]);
+
+		/* Add connecting info */
 		for (y = 0; y < chunk->height; y++) {
 			for (x = 0; x < chunk->width; x++) {
 				struct loc grid = loc(x, y);
 
-				sqinfo_off(square(chunk, grid).info, SQUARE_WALL_INNER);
-				sqinfo_off(square(chunk, grid).info, SQUARE_WALL_OUTER);
-				sqinfo_off(square(chunk, grid).info, SQUARE_WALL_SOLID);
-				sqinfo_off(square(chunk, grid).info, SQUARE_MON_RESTRICT);
-
 				if (square_isstairs(chunk, grid)) {
-					size_t n;
-					struct connector *new = mem_zalloc(sizeof *new);
+					struct connector *new = mem_arena_alloc(chunk->arena,
+															sizeof *new);
 					new->grid = grid;
 					new->feat = square_feat(chunk, grid)->fidx;
-					new->info = mem_zalloc(SQUARE_SIZE * sizeof(bitflag));
-					for (n = 0; n < SQUARE_SIZE; n++) {
-						new->info[n] = square(chunk, grid).info[n];
-					}
+					new->info = mem_arena_alloc(chunk->arena,
+												SQUARE_SIZE * sizeof(bitflag));
+					sqinfo_get(chunk, grid, new->info);
 					new->next = chunk->join;
 					chunk->join = new;
 				}
@@ -1036,8 +1091,13 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 		}
 
 		/* Regenerate levels that overflow their maxima */
-		if (cave_monster_max(chunk) >= z_info->level_monster_max)
+		if (cave_monster_max(chunk) >= z_info->level_monster_max) {
 			error = "too many monsters";
+			if (gen_report) gen_report->failures[GEN_FAIL_MONSTERS]++;
+		} else if (!cave_stairs_reachable(chunk, p->grid)) {
+			error = "unreachable stairs";
+			if (gen_report) gen_report->failures[GEN_FAIL_CONNECTIVITY]++;
+		}
 
 		if (error) {
 			if (OPT(p, cheat_room)) {
@@ -1081,6 +1141,7 @@ static struct chunk *cave_generate(struct player *p, int height, int width)
 
 	chunk->turn = turn;
 
+	Rand_stream_select(old_stream);
 	return chunk;
 }
 
@@ -1160,6 +1221,216 @@ static void sanitize_player_loc(struct chunk *c, struct player *p)
 	p->grid.y = vy;
 }
 
+/**
+ * ------------------------------------------------------------------------
+ * Speculative level generation
+ *
+ * While the game waits for a command from a player standing on a staircase,
+ * the level that staircase leads to can be built ahead of time and simply
+ * handed over when the stairs are taken.  The level is made with its own
+ * RNG stream and into its own chunk, so nothing the player can see depends
+ * on whether it was made.  Uniques and artifacts placed on it are released
+ * again as soon as it is built, and only claimed back when it is adopted;
+ * if any of them have turned up elsewhere by then, the level is thrown away
+ * and a fresh one generated as usual.
+ * ------------------------------------------------------------------------ */
+/**
+ * A level built ahead of time, and what it was built for
+ */
+struct speculative_level {
+	struct chunk *level;	/**< The level itself */
+	struct chunk *known;	/**< The player's (empty) memory of it */
+	struct loc grid;		/**< Where the player was placed */
+	int depth;				/**< Depth it was built for */
+	bool up_stair;			/**< Stair creation asked for when built */
+	bool down_stair;
+};
+
+static struct speculative_level speculative;
+
+/**
+ * Claim (or release) the uniques and artifacts on a level built ahead of
+ * time.  Claiming fails, changing nothing, if any of them are already in
+ * the game.
+ */
+static bool speculative_reserve(struct chunk *c, bool claim)
+{
+	int i;
+
+	/* Check first, so that a failed claim leaves no trace */
+	if (claim) {
+		for (i = 1; i < cave_monster_max(c); i++) {
+			struct monster *mon = cave_monster(c, i);
+			if (!mon->race) continue;
+			if (rf_has(mon->race->flags, RF_UNIQUE) &&
+				(mon->race->cur_num >= mon->race->max_num))
+				return false;
+		}
+		for (i = 1; i < c->obj_max; i++) {
+			struct object *obj = c->objects[i];
+			if (obj && obj->artifact && obj->artifact->created)
+				return false;
+		}
+	}
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (!mon->race) continue;
+		mon->race->cur_num += claim ? 1 : -1;
+	}
+	for (i = 1; i < c->obj_max; i++) {
+		struct object *obj = c->objects[i];
+		if (obj && obj->artifact)
+			obj->artifact->created = claim;
+	}
+
+	return true;
+}
+
+/**
+ * Throw away any level built ahead of time
+ */
+void discard_speculative_level(struct player *p)
+{
+	struct chunk *c = speculative.level;
+	int i;
+
+	if (!c) return;
+
+	/* Nothing on the level is claimed; count its monsters back in for
+	 * wipe_mon_list(), and keep its artifacts away from the real ones */
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (mon->race)
+			mon->race->cur_num++;
+	}
+	for (i = 1; i < c->obj_max; i++)
+		if (c->objects[i])
+			c->objects[i]->artifact = NULL;
+
+	cave_clear(c, p);
+	cave_free(speculative.known);
+	memset(&speculative, 0, sizeof(speculative));
+}
+
+/**
+ * Build the level the staircase under the player leads to, if that is
+ * worth doing and has not already been done.
+ *
+ * This is meant to be called while the game is idle, waiting for a
+ * command.  Returns the level waiting to be adopted, if there is one.
+ */
+struct chunk *speculate_next_level(struct player *p)
+{
+	struct rand_state game_rng;
+	struct chunk *old_known = p->cave;
+	struct loc old_grid = p->grid;
+	int old_depth = p->depth;
+	bool old_up = p->upkeep->create_up_stair;
+	bool old_down = p->upkeep->create_down_stair;
+	int depth;
+	bool up, down;
+
+	/* Only when asked for, and only for ordinary one-off levels */
+	if (!OPT(p, speculative_levels)) return NULL;
+	if (!character_dungeon || !cave || p->is_dead) return NULL;
+	if (p->upkeep->generate_level || p->upkeep->arena_level) return NULL;
+	if (p->upkeep->light_level) return NULL;
+	if (OPT(p, birth_levels_persist)) return NULL;
+
+	/* Cheat messages would give the level away */
+	if (OPT(p, cheat_hear) || OPT(p, cheat_room)) return NULL;
+
+	/* Work out where the stairs go, as the stair commands do */
+	if (square_isdownstairs(cave, p->grid)) {
+		if (p->depth == z_info->max_depth - 1) return NULL;
+		if (OPT(p, birth_force_descend))
+			depth = dungeon_get_next_level(p->max_depth, 1);
+		else
+			depth = dungeon_get_next_level(p->depth, 1);
+		up = true;
+		down = false;
+	} else if (square_isupstairs(cave, p->grid)) {
+		if (OPT(p, birth_force_descend)) return NULL;
+		depth = dungeon_get_next_level(p->depth, -1);
+		if (depth == p->depth) return NULL;
+		up = false;
+		down = true;
+	} else {
+		return NULL;
+	}
+
+	/* The town is quick to make, and has its own seed */
+	if (!depth) return NULL;
+
+	/* Already done */
+	if (speculative.level && (speculative.depth == depth) &&
+		(speculative.up_stair == up) && (speculative.down_stair == down))
+		return speculative.level;
+	discard_speculative_level(p);
+
+	/* Build the level as if the player had arrived, on a separate stream */
+	Rand_state_save(&game_rng);
+	Rand_quick = false;
+	Rand_state_init(seed_flavor ^ (u32b) turn ^ ((u32b) depth << 16));
+	p->depth = depth;
+	p->upkeep->create_up_stair = up;
+	p->upkeep->create_down_stair = down;
+
+	speculative.level = cave_generate(p, 0, 0);
+	speculative.known = p->cave;
+	speculative.grid = p->grid;
+	speculative.depth = depth;
+	speculative.up_stair = up;
+	speculative.down_stair = down;
+
+	/* Put everything back */
+	p->cave = old_known;
+	p->grid = old_grid;
+	p->depth = old_depth;
+	p->upkeep->create_up_stair = old_up;
+	p->upkeep->create_down_stair = old_down;
+	character_dungeon = true;
+	Rand_state_restore(&game_rng);
+
+	/* The level doesn't exist yet as far as the game is concerned */
+	speculative_reserve(speculative.level, false);
+
+	/* Whether it was built can change the game, so a replay builds it too */
+	journal_speculate();
+
+	return speculative.level;
+}
+
+/**
+ * Take over a level built ahead of time, if it was built for the level the
+ * player is now entering and its uniques and artifacts are still free.
+ */
+static struct chunk *adopt_speculative_level(struct player *p)
+{
+	struct chunk *c = speculative.level;
+
+	if (!c) return NULL;
+	if ((speculative.depth != p->depth) ||
+		(speculative.up_stair != p->upkeep->create_up_stair) ||
+		(speculative.down_stair != p->upkeep->create_down_stair) ||
+		p->upkeep->arena_level || p->upkeep->light_level ||
+		!speculative_reserve(c, true)) {
+		discard_speculative_level(p);
+		return NULL;
+	}
+
+	/* Arrive where the level was built to put the player */
+	p->cave = speculative.known;
+	p->grid = speculative.grid;
+	p->upkeep->create_down_stair = false;
+	p->upkeep->create_up_stair = false;
+	c->turn = turn;
+
+	memset(&speculative, 0, sizeof(speculative));
+	return c;
+}
+
 /**
  * Prepare the level the player is about to enter, either by generating
  * or reloading
@@ -1191,7 +1462,7 @@ void prepare_next_level(struct chunk **c, struct player *p)
 			}
 		} else {
 			/* Save the town */
-			if (!((*c)->depth) && !chunk_find_name("Town")) {
+			if (!((*c)->depth) && !chunk_exists_name("Town")) {
 				cave_store(*c, false, false);
 			}
 
@@ -1234,15 +1505,30 @@ void prepare_next_level(struct chunk **c, struct player *p)
 	/* Prepare the new level */
 	if (persist) {
 		char *name = level_by_depth(p->depth)->name;
+		char known_name[80];
 		struct chunk *old_level = chunk_find_name(name);
+		struct chunk *old_known = NULL;
+
+		/* A level is no use without the player's memory of it, nor the
+		 * memory without the level; if either was broken, both go, and a
+		 * new level is made */
+		strnfmt(known_name, sizeof(known_name), "%s known", name);
+		if (old_level && (old_level != cave)) {
+			old_known = chunk_find_name(known_name);
+			if (!old_known) {
+				chunk_list_remove(name);
+				wipe_mon_list(old_level, p);
+				cave_free(old_level);
+				old_level = NULL;
+			}
+		} else if (!old_level) {
+			chunk_list_remove(known_name);
+		}
 
 		/* If we found an old level, load the known level and assign */
 		if (old_level && (old_level != cave)) {
 			int i;
 			bool arena = (*c)->name && streq((*c)->name, "arena");
-			char *known_name = format("%s known", name);
-			struct chunk *old_known = chunk_find_name(known_name);
-			assert(old_known);
 
 			/* Assign the new ones */
 			*c = old_level;
@@ -1347,8 +1633,10 @@ void prepare_next_level(struct chunk **c, struct player *p)
 			*c = cave_generate(p, min_height, min_width);
 		}
 	} else {
-		/* Generate a new level */
-		*c = cave_generate(p, 0, 0);
+		/* Use a level built ahead of time, or generate a new one */
+		*c = adopt_speculative_level(p);
+		if (!*c)
+			*c = cave_generate(p, 0, 0);
 	}
 
 	/* Know the town */
@@ -1356,6 +1644,9 @@ void prepare_next_level(struct chunk **c, struct player *p)
 		cave_known(p);
 	}
 
+	/* Put stored levels, old and just looked at, back into stored form */
+	chunk_list_pack();
+
 	/* The dungeon is ready */
 	character_dungeon = true;
 }
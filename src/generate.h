@@ -120,8 +120,8 @@ struct dun_data {
     int row_blocks;
     int col_blocks;
 
-    /*!< Array of which blocks are used */
-    bool **room_map;
+    /*!< Which blocks are used */
+    struct bitmap *room_map;
 
     /*!< Number of pits/nests on the level */
     int pit_num;
@@ -201,6 +201,31 @@ struct room_profile {
 };
 
 
+/**
+ * A square of a room or vault template which has something on it
+ */
+struct template_spot {
+    byte y;			/*!< Row, counting down from the top of the template */
+    byte x;			/*!< Column, counting right from the left edge */
+    char code;			/*!< Template character */
+};
+
+/**
+ * A room or vault template boiled down at startup to the squares that matter,
+ * so that building it needn't go through the text character by character
+ */
+struct template_layout {
+    struct template_spot *squares;	/*!< All non-blank squares */
+    int n_squares;
+
+    struct template_spot *contents;	/*!< Squares with contents codes */
+    int n_contents;
+
+    char races[31];			/*!< Monster symbols, as first met */
+    struct template_spot *racial;	/*!< Squares of each symbol in turn */
+    int race_start[31];			/*!< Start of each symbol's squares */
+};
+
 /*
  * Information about vault generation
  */
@@ -209,6 +234,7 @@ struct vault {
 
     char *name;         /*!< Vault name */
     char *text;         /*!< Grid by grid description of vault layout */
+    struct template_layout *layout;	/*!< The text, ready for placement */
 
     char *typ;			/*!< Vault type */
 
@@ -231,6 +257,7 @@ struct room_template {
 
     char *name;         /*!< Room name */
     char *text;         /*!< Grid by grid description of room layout */
+    struct template_layout *layout;	/*!< The text, ready for placement */
 
     byte typ;			/*!< Room type */
 
@@ -242,15 +269,55 @@ struct room_template {
     byte tval;			/*!< tval for objects in this room */
 };
 
+/**
+ * The connected regions of the squares of a chunk which satisfy some
+ * predicate, as found by cave_regions_new()
+ */
+struct cave_regions {
+	int height, width;	/*!< Size of the chunk */
+	int *label;			/*!< Region of each grid by grid_to_i(), 0 for none */
+	int count;			/*!< Number of regions, labelled from 1 */
+	int *size;			/*!< Number of squares in each region, by label */
+};
+
+/**
+ * Reasons for cave_generate() to throw a level away and start again
+ */
+enum gen_failure {
+	GEN_FAIL_BUILDER,	/*!< The profile's builder gave up */
+	GEN_FAIL_MONSTERS,	/*!< Too many monsters */
+	GEN_FAIL_CONNECTIVITY,	/*!< No way to the down stairs */
+
+	GEN_FAIL_MAX
+};
+
+/**
+ * What cave_generate() did while building the last level; this is only
+ * filled in if gen_report is set, which the generation benchmark does
+ */
+struct gen_report {
+	const struct cave_profile *profile;	/*!< Profile to force, or NULL */
+	bool gave_up;			/*!< The forced profile never built a level */
+	int tries;				/*!< Builds started for the last level */
+	int failures[GEN_FAIL_MAX];	/*!< Restarts for the last level, by reason */
+};
+
 extern struct dun_data *dun;
 extern struct vault *vaults;
 extern struct room_template *room_templates;
+extern struct gen_report *gen_report;
+extern const char *gen_failure_names[];
+
+/* generate.c */
+const struct cave_profile *find_cave_profile(char *name);
+const struct cave_profile *cave_profile_by_idx(int idx);
 
 /* gen-cave.c */
 struct chunk *town_gen(struct player *p, int min_height, int min_width);
 struct chunk *classic_gen(struct player *p, int min_height, int min_width);
 struct chunk *labyrinth_gen(struct player *p, int min_height, int min_width);
 void ensure_connectedness(struct chunk *c);
+struct chunk *cavern_chunk(int depth, int h, int w);
 struct chunk *cavern_gen(struct player *p, int min_height, int min_width);
 struct chunk *modified_gen(struct player *p, int min_height, int min_width);
 struct chunk *moria_gen(struct player *p, int min_height, int min_width);
@@ -262,9 +329,22 @@ struct chunk *arena_gen(struct player *p, int min_height, int min_width);
 /* gen-chunk.c */
 struct chunk *chunk_write(struct chunk *c);
 void chunk_list_add(struct chunk *c);
+void chunk_list_add_record(const char *name, int depth, byte *data, u32b len);
 bool chunk_list_remove(char *name);
 struct chunk *chunk_find_name(char *name);
+bool chunk_exists_name(const char *name);
+bool chunk_exists_adjacent(struct player *p, bool above);
 bool chunk_find(struct chunk *c);
+int chunk_list_count(void);
+const char *chunk_list_name(int i);
+int chunk_list_depth(int i);
+bool chunk_list_has_depth(int depth);
+void chunk_list_pack(void);
+byte *chunk_list_data(int i, u32b *len);
+void chunk_list_data_done(int i, byte *data);
+void chunk_list_set_memory(size_t bytes);
+size_t chunk_list_memory(void);
+void chunk_list_free(void);
 struct chunk *chunk_find_adjacent(struct player *p, bool above);
 bool chunk_copy(struct chunk *dest, struct chunk *source, int y0, int x0,
 				int rotate, bool reflect);
@@ -283,6 +363,10 @@ extern bool generate_starburst_room(struct chunk *c, int y1, int x1, int y2,
 									int x2, bool light, int feat, 
 									bool special_ok);
 
+struct template_layout *template_layout_new(const char *text, int height,
+											int width, const char *contents);
+void template_layout_free(struct template_layout *layout);
+extern const char *vault_contents;
 struct vault *random_vault(int depth, const char *typ);
 bool build_vault(struct chunk *c, struct loc centre, struct vault *v);
 
@@ -314,12 +398,18 @@ extern byte get_angle_to_grid[41][41];
 int grid_to_i(struct loc grid, int w);
 void i_to_grid(int i, int w, struct loc *grid);
 void shuffle(int *arr, int n);
+void cave_find_cleanup(void);
 bool cave_find(struct chunk *c, struct loc *grid, square_predicate pred);
 bool find_empty(struct chunk *c, struct loc *grid);
 bool find_empty_range(struct chunk *c, struct loc *grid, struct loc top_left,
 					  struct loc bottom_right);
 bool find_nearby_grid(struct chunk *c, struct loc *grid, struct loc centre,
 					  int yd, int xd);
+struct cave_regions *cave_regions_new(struct chunk *c, square_predicate pred,
+									  bool diagonal);
+void cave_regions_free(struct cave_regions *r);
+int cave_region(const struct cave_regions *r, struct loc grid);
+bool cave_stairs_reachable(struct chunk *c, struct loc grid);
 void correct_dir(struct loc *offset, struct loc grid1, struct loc grid2);
 void rand_dir(struct loc *offset);
 void new_player_spot(struct chunk *c, struct player *p);
@@ -341,8 +431,8 @@ bool alloc_object(struct chunk *c, int set, int typ, int depth, byte origin);
 bool mon_restrict(const char *monster_type, int depth, bool unique_ok);
 void spread_monsters(struct chunk *c, const char *type, int depth, int num, 
 					 int y0, int x0, int dy, int dx, byte origin);
-void get_vault_monsters(struct chunk *c, char racial_symbol[], char *vault_type,
-						const char *data, int y1, int y2, int x1, int x2);
+void get_vault_monsters(struct chunk *c, const struct template_layout *layout,
+						char *vault_type, struct loc top_left);
 void get_chamber_monsters(struct chunk *c, int y1, int x1, int y2, int x2, char *name, int area);
 
 
@@ -1004,7 +1004,7 @@ static enum parser_error parse_trap_visibility(struct parser *p) {
 static enum parser_error parse_trap_flags(struct parser *p) {
     char *flags;
     struct trap_kind *t = parser_priv(p);
-    char *s;
+    char *s, *state;
 
     if (!t)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
@@ -1013,13 +1013,13 @@ static enum parser_error parse_trap_flags(struct parser *p) {
 		return PARSE_ERROR_NONE;
     flags = string_make(parser_getstr(p, "flags"));
 
-    s = strtok(flags, " |");
+    s = my_strtok(flags, " |", &state);
     while (s) {
 		if (grab_flag(t->flags, TRF_SIZE, trap_flags, s)) {
 			mem_free(flags);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
     }
 
     mem_free(flags);
@@ -1263,17 +1263,17 @@ static enum parser_error parse_trap_expr_xtra(struct parser *p) {
 static enum parser_error parse_trap_save_flags(struct parser *p) {
     struct trap_kind *t = parser_priv(p);
 	char *s = string_make(parser_getstr(p, "flags"));
-	char *u;
+	char *u, *state;
 	assert(t);
 
-	u = strtok(s, " |");
+	u = my_strtok(s, " |", &state);
 	while (u) {
 		bool found = false;
 		if (!grab_flag(t->save_flags, OF_SIZE, list_obj_flag_names, u))
 			found = true;
 		if (!found)
 			break;
-		u = strtok(NULL, " |");
+		u = my_strtok(NULL, " |", &state);
 	}
 	mem_free(s);
 	return u ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -1367,6 +1367,8 @@ static errr finish_parse_trap(struct parser *p) {
 
 		memcpy(&trap_info[tidx], t, sizeof(*t));
 		trap_info[tidx].tidx = tidx;
+		trap_info[tidx].effect = effect_pack(trap_info[tidx].effect);
+		trap_info[tidx].effect_xtra = effect_pack(trap_info[tidx].effect_xtra);
 		if (tidx < z_info->trap_max - 1)
 			trap_info[tidx].next = &trap_info[tidx + 1];
 		else
@@ -1467,7 +1469,7 @@ static enum parser_error parse_feat_priority(struct parser *p) {
 static enum parser_error parse_feat_flags(struct parser *p) {
 	char *flags;
 	struct feature *f = parser_priv(p);
-	char *s;
+	char *s, *state;
 
 	if (!f)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
@@ -1476,14 +1478,14 @@ static enum parser_error parse_feat_flags(struct parser *p) {
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
 
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(f->flags, TF_SIZE, terrain_flags, s)) {
 			mem_free(flags);
 			quit_fmt("bad f-flag: %s", s);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
@@ -2036,18 +2038,18 @@ static enum parser_error parse_p_race_weight(struct parser *p) {
 static enum parser_error parse_p_race_obj_flags(struct parser *p) {
 	struct player_race *r = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!r)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(r->flags, OF_SIZE, list_obj_flag_names, s))
 			break;
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	mem_free(flags);
 	return s ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -2056,18 +2058,18 @@ static enum parser_error parse_p_race_obj_flags(struct parser *p) {
 static enum parser_error parse_p_race_play_flags(struct parser *p) {
 	struct player_race *r = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!r)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(r->pflags, PF_SIZE, player_info_flags, s))
 			break;
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	mem_free(flags);
 	return s ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -2076,12 +2078,12 @@ static enum parser_error parse_p_race_play_flags(struct parser *p) {
 static enum parser_error parse_p_race_values(struct parser *p) {
 	struct player_race *r = parser_priv(p);
 	char *s;
-	char *t;
+	char *t, *state;
 
 	if (!r)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	s = string_make(parser_getstr(p, "values"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 
 	while (t) {
 		int value = 0;
@@ -2094,7 +2096,7 @@ static enum parser_error parse_p_race_values(struct parser *p) {
 		if (!found)
 			break;
 
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(s);
@@ -2358,18 +2360,18 @@ static enum parser_error parse_shape_skill_dig(struct parser *p) {
 static enum parser_error parse_shape_obj_flags(struct parser *p) {
 	struct player_shape *shape = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!shape)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(shape->flags, OF_SIZE, list_obj_flag_names, s))
 			break;
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	mem_free(flags);
 	return s ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -2378,18 +2380,18 @@ static enum parser_error parse_shape_obj_flags(struct parser *p) {
 static enum parser_error parse_shape_play_flags(struct parser *p) {
 	struct player_shape *shape = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!shape)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(shape->pflags, PF_SIZE, player_info_flags, s))
 			break;
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	mem_free(flags);
 	return s ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -2398,12 +2400,12 @@ static enum parser_error parse_shape_play_flags(struct parser *p) {
 static enum parser_error parse_shape_values(struct parser *p) {
 	struct player_shape *shape = parser_priv(p);
 	char *s;
-	char *t;
+	char *t, *state;
 
 	if (!shape)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	s = string_make(parser_getstr(p, "values"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 
 	while (t) {
 		int value = 0;
@@ -2418,7 +2420,7 @@ static enum parser_error parse_shape_values(struct parser *p) {
 		if (!found)
 			break;
 
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(s);
@@ -2604,7 +2606,11 @@ static errr run_parse_shape(struct parser *p) {
 }
 
 static errr finish_parse_shape(struct parser *p) {
+	struct player_shape *shape;
+
 	shapes = parser_priv(p);
+	for (shape = shapes; shape; shape = shape->next)
+		shape->effect = effect_pack(shape->effect);
 	parser_destroy(p);
 	return 0;
 }
@@ -2846,18 +2852,18 @@ static enum parser_error parse_class_equip(struct parser *p) {
 static enum parser_error parse_class_obj_flags(struct parser *p) {
 	struct player_class *c = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!c)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(c->flags, OF_SIZE, list_obj_flag_names, s))
 			break;
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
@@ -2867,18 +2873,18 @@ static enum parser_error parse_class_obj_flags(struct parser *p) {
 static enum parser_error parse_class_play_flags(struct parser *p) {
 	struct player_class *c = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!c)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(c->pflags, PF_SIZE, player_info_flags, s))
 			break;
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
@@ -3191,12 +3197,19 @@ static errr run_parse_class(struct parser *p) {
 
 static errr finish_parse_class(struct parser *p) {
 	struct player_class *c;
-	int num = 0;
+	int num = 0, i, j;
 	classes = parser_priv(p);
 	for (c = classes; c; c = c->next) num++;
 	for (c = classes; c; c = c->next, num--) {
 		assert(num);
 		c->cidx = num - 1;
+
+		/* Pack the spell effects for casting */
+		for (i = 0; i < c->magic.num_books; i++) {
+			struct class_book *book = &c->magic.books[i];
+			for (j = 0; j < book->num_spells; j++)
+				book->spells[j].effect = effect_pack(book->spells[j].effect);
+		}
 	}
 	parser_destroy(p);
 	return 0;
@@ -3405,46 +3418,57 @@ static struct file_parser hints_parser = {
 
 /**
  * A list of all the above parsers, plus those found in mon-init.c and
- * obj-init.c
+ * obj-init.c, with the parsers whose results each one looks at while it is
+ * reading its file.  Effects look up timed effects, summons and shapes for
+ * their subtypes, and anything which looks up object kinds has to wait for
+ * the classes and the artifacts, which add kinds of their own.
  */
-static struct {
-	const char *name;
-	struct file_parser *parser;
-} pl[] = {
-	{ "world", &world_parser },
-	{ "projections", &projection_parser },
-	{ "timed effects", &player_timed_parser },
-	{ "features", &feat_parser },
-	{ "object bases", &object_base_parser },
-	{ "slays", &slay_parser },
-	{ "brands", &brand_parser },
-	{ "monster pain messages", &pain_parser },
-	{ "monster bases", &mon_base_parser },
-	{ "summons", &summon_parser },
-	{ "curses", &curse_parser },
-	{ "objects", &object_parser },
-	{ "activations", &act_parser },
-	{ "ego-items", &ego_parser },
-	{ "history charts", &history_parser },
-	{ "bodies", &body_parser },
-	{ "player races", &p_race_parser },
-	{ "magic_realms", &realm_parser },
-	{ "player shapes", &shape_parser },
-	{ "player classes", &class_parser },
-	{ "artifacts", &artifact_parser },
-	{ "object properties", &object_property_parser },
-	{ "object power calculations", &object_power_parser },
-	{ "blow methods", &meth_parser },
-	{ "blow effects", &eff_parser },
-	{ "monster spells", &mon_spell_parser },
-	{ "monsters", &monster_parser },
-	{ "monster pits" , &pit_parser },
-	{ "monster lore" , &lore_parser },
-	{ "traps", &trap_parser },
-	{ "quests", &quests_parser },
-	{ "flavours", &flavor_parser },
-	{ "hints", &hints_parser },
-	{ "random names", &names_parser }
+static struct parser_list pl[] = {
+	{ "world", &world_parser, { NULL } },
+	{ "projections", &projection_parser, { NULL } },
+	{ "timed effects", &player_timed_parser, { NULL } },
+	{ "features", &feat_parser, { NULL } },
+	{ "object bases", &object_base_parser, { NULL } },
+	{ "slays", &slay_parser, { NULL } },
+	{ "brands", &brand_parser, { NULL } },
+	{ "monster pain messages", &pain_parser, { NULL } },
+	{ "monster bases", &mon_base_parser, { "monster pain messages" } },
+	{ "summons", &summon_parser, { "monster bases" } },
+	{ "curses", &curse_parser, { "timed effects", "summons" } },
+	{ "objects", &object_parser,
+	  { "timed effects", "object bases", "slays", "brands", "summons",
+		"curses" } },
+	{ "activations", &act_parser, { "timed effects", "summons" } },
+	{ "ego-items", &ego_parser,
+	  { "timed effects", "slays", "brands", "summons", "curses",
+		"objects" } },
+	{ "history charts", &history_parser, { NULL } },
+	{ "bodies", &body_parser, { NULL } },
+	{ "player races", &p_race_parser, { "history charts" } },
+	{ "magic_realms", &realm_parser, { NULL } },
+	{ "player shapes", &shape_parser, { "timed effects", "summons" } },
+	{ "player classes", &class_parser,
+	  { "timed effects", "summons", "objects", "ego-items", "magic_realms",
+		"player shapes" } },
+	{ "artifacts", &artifact_parser,
+	  { "slays", "brands", "curses", "activations", "player classes" } },
+	{ "object properties", &object_property_parser, { NULL } },
+	{ "object power calculations", &object_power_parser, { "artifacts" } },
+	{ "blow methods", &meth_parser, { NULL } },
+	{ "blow effects", &eff_parser, { NULL } },
+	{ "monster spells", &mon_spell_parser,
+	  { "timed effects", "summons", "player shapes" } },
+	{ "monsters", &monster_parser,
+	  { "monster bases", "blow methods", "blow effects", "monster spells",
+		"artifacts" } },
+	{ "monster pits" , &pit_parser, { "monsters" } },
+	{ "monster lore" , &lore_parser, { "monsters" } },
+	{ "traps", &trap_parser,
+	  { "timed effects", "summons", "player shapes" } },
+	{ "quests", &quests_parser, { "monsters" } },
+	{ "flavours", &flavor_parser, { "artifacts" } },
+	{ "hints", &hints_parser, { NULL } },
+	{ "random names", &names_parser, { NULL } }
 };
 
 /**
@@ -3456,15 +3480,7 @@ static struct {
  */
 void init_arrays(void)
 {
-	unsigned int i;
-
-	for (i = 0; i < N_ELEMENTS(pl); i++) {
-		char *msg = string_make(format("Initializing %s...", pl[i].name));
-		event_signal_message(EVENT_INITSTATUS, 0, msg);
-		string_free(msg);
-		if (run_parser(pl[i].parser))
-			quit_fmt("Cannot initialize %s.", pl[i].name);
-	}
+	run_parser_list(pl, N_ELEMENTS(pl));
 }
 
 /**
@@ -3497,6 +3513,7 @@ extern struct init_module player_module;
 extern struct init_module store_module;
 extern struct init_module messages_module;
 extern struct init_module options_module;
+extern struct init_module effects_module;
 
 static struct init_module *modules[] = {
 	&z_quark_module,
@@ -3510,6 +3527,7 @@ static struct init_module *modules[] = {
 	&mon_make_module,
 	&store_module,
 	&options_module,
+	&effects_module,
 	NULL
 };
 
@@ -3554,12 +3572,26 @@ bool init_angband(void)
 	return true;
 }
 
+/**
+ * Write one line of the MEM_TRACK report
+ */
+static void mem_track_line(const char *line, void *data)
+{
+	file_putf((ang_file *) data, "%s\n", line);
+}
+
 /**
  * Free all the stuff initialised in init_angband()
  */
 void cleanup_angband(void)
 {
+	char track_path[1024] = "";
 	int i;
+
+	/* Free any level built ahead of time, while its races still exist */
+	if (player)
+		discard_speculative_level(player);
+
 	for (i = 0; modules[i]; i++)
 		if (modules[i]->cleanup)
 			modules[i]->cleanup();
@@ -3567,9 +3599,7 @@ void cleanup_angband(void)
 	event_remove_all_handlers();
 
 	/* Free the chunk list */
-	for (i = 0; i < chunk_list_max; i++)
-		cave_free(chunk_list[i]);
-	mem_free(chunk_list);
+	chunk_list_free();
 
 	/* Free the main cave */
 	if (cave) {
@@ -3580,22 +3610,54 @@ void cleanup_angband(void)
 	monster_list_finalize();
 	object_list_finalize();
 
+	/* Every object is gone now, so give back the memory they lived in */
+	object_slabs_free();
+
 	cleanup_game_constants();
 
 	/* Free the format() buffer */
 	vformat_kill();
 
-	/* Free the directories */
+	/* Decide where the memory report goes while the user directory is known */
+	if ((mem_flags & MEM_TRACK) && ANGBAND_DIR_USER)
+		path_build(track_path, sizeof(track_path), ANGBAND_DIR_USER,
+				   "mem-track.txt");
+
+	/* Free the directories, so the game can be set up again after this */
 	string_free(ANGBAND_DIR_GAMEDATA);
+	ANGBAND_DIR_GAMEDATA = NULL;
 	string_free(ANGBAND_DIR_CUSTOMIZE);
+	ANGBAND_DIR_CUSTOMIZE = NULL;
 	string_free(ANGBAND_DIR_HELP);
+	ANGBAND_DIR_HELP = NULL;
 	string_free(ANGBAND_DIR_SCREENS);
+	ANGBAND_DIR_SCREENS = NULL;
 	string_free(ANGBAND_DIR_FONTS);
+	ANGBAND_DIR_FONTS = NULL;
 	string_free(ANGBAND_DIR_TILES);
+	ANGBAND_DIR_TILES = NULL;
 	string_free(ANGBAND_DIR_SOUNDS);
+	ANGBAND_DIR_SOUNDS = NULL;
 	string_free(ANGBAND_DIR_ICONS);
+	ANGBAND_DIR_ICONS = NULL;
 	string_free(ANGBAND_DIR_USER);
+	ANGBAND_DIR_USER = NULL;
 	string_free(ANGBAND_DIR_SAVE);
+	ANGBAND_DIR_SAVE = NULL;
 	string_free(ANGBAND_DIR_SCORES);
+	ANGBAND_DIR_SCORES = NULL;
 	string_free(ANGBAND_DIR_INFO);
+	ANGBAND_DIR_INFO = NULL;
+
+	/* Report on memory still allocated, and where it was all allocated */
+	if (track_path[0]) {
+		ang_file *f;
+
+		mem_flags &= ~MEM_TRACK;
+		f = file_open(track_path, MODE_WRITE, FTYPE_TEXT);
+		if (f) {
+			mem_track_report(mem_track_line, f, 40);
+			file_close(f);
+		}
+	}
 }
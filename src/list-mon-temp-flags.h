@@ -14,3 +14,5 @@ MFLAG(CAMOUFLAGE,"Player doesn't know this is a monster")
 MFLAG(AWARE,	"Monster is aware of the player")
 MFLAG(HANDLED,	"Monster has been processed this turn")
 MFLAG(TRACKING,	"Monster is tracking the player by sound or scent")
+MFLAG(GRID_VIEW,	"Monster's grid was in view when it was last updated")
+MFLAG(GRID_SEEN,	"Monster's grid was seen when it was last updated")
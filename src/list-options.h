@@ -2,7 +2,7 @@
  * \file list-options.h
  * \brief options
  *
- * Currently, if there are more than 21 of any option type, the later ones
+ * Currently, if there are more than 22 of any option type, the later ones
  * will be ignored
  * Cheat options need to be followed by corresponding score options
  */
@@ -53,6 +53,8 @@ OP(notify_recharge,       "Notify on object recharge",
 INTERFACE, false)
 OP(effective_speed,       "Show effective speed as multiplier",
 INTERFACE, false)
+OP(speculative_levels,    "Generate the next level while waiting on stairs",
+INTERFACE, false)
 OP(cheat_hear,            "Cheat: Peek into monster creation",
 CHEAT, false)
 OP(score_hear,            "Score: Peek into monster creation",
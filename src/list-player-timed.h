@@ -9,53 +9,53 @@
  */
 
 /* symbol		flag_redraw						flag_update */
-TMD(FAST,		PR_STATUS,						PU_BONUS)
-TMD(SLOW,		PR_STATUS,								PU_BONUS)
+TMD(FAST,		PR_STATUS,						PU_TIMED)
+TMD(SLOW,		PR_STATUS,								PU_TIMED)
 TMD(BLIND,		PR_MAP,							PU_UPDATE_VIEW | PU_MONSTERS) 
-TMD(PARALYZED,	PR_STATUS,						PU_BONUS)
-TMD(CONFUSED,	PR_STATUS,						PU_BONUS)
-TMD(AFRAID,		PR_STATUS,						PU_BONUS)
-TMD(IMAGE,		PR_MAP | PR_MONLIST | PR_ITEMLIST,	PU_BONUS)
-TMD(POISONED,	PR_STATUS,						PU_BONUS)
-TMD(CUT,		PR_STATUS,						PU_BONUS)
-TMD(STUN,		PR_STATUS,						PU_BONUS)
-TMD(PROTEVIL,	PR_STATUS,						PU_BONUS)
-TMD(INVULN,		PR_STATUS,						PU_BONUS)
-TMD(HERO,		PR_STATUS,						PU_BONUS)
-TMD(SHERO,		PR_STATUS,						PU_BONUS)
-TMD(SHIELD,		PR_STATUS,						PU_BONUS)
-TMD(BLESSED,	PR_STATUS,						PU_BONUS)
-TMD(SINVIS,		PR_STATUS,						PU_BONUS | PU_MONSTERS)
-TMD(SINFRA,		PR_STATUS,						PU_BONUS | PU_MONSTERS)
-TMD(OPP_ACID,	PR_STATUS,						PU_BONUS)
-TMD(OPP_ELEC,	PR_STATUS,						PU_BONUS)
-TMD(OPP_FIRE,	PR_STATUS,						PU_BONUS)
-TMD(OPP_COLD,	PR_STATUS,						PU_BONUS)
-TMD(OPP_POIS,	PR_STATUS,						PU_BONUS)
-TMD(OPP_CONF,	PR_STATUS,						PU_BONUS)
-TMD(AMNESIA,	PR_STATUS,						PU_BONUS)
-TMD(TELEPATHY,	PR_STATUS,						PU_BONUS)
-TMD(STONESKIN,	PR_STATUS,						PU_BONUS)
-TMD(TERROR,		PR_STATUS,						PU_BONUS)
-TMD(SPRINT,		PR_STATUS,						PU_BONUS)
-TMD(BOLD,		PR_STATUS,						PU_BONUS)
-TMD(SCRAMBLE,   PR_STATUS,		   				PU_BONUS)
-TMD(TRAPSAFE,	PR_STATUS,						PU_BONUS)
-TMD(FASTCAST,	PR_STATUS,						PU_BONUS)
-TMD(ATT_ACID,	PR_STATUS,						PU_BONUS)
-TMD(ATT_ELEC,	PR_STATUS,						PU_BONUS)
-TMD(ATT_FIRE,	PR_STATUS,						PU_BONUS)
-TMD(ATT_COLD,	PR_STATUS,						PU_BONUS)
-TMD(ATT_POIS,	PR_STATUS,						PU_BONUS)
-TMD(ATT_CONF,	PR_STATUS,						PU_BONUS)
-TMD(ATT_EVIL,	PR_STATUS,						PU_BONUS)
-TMD(ATT_DEMON,	PR_STATUS,						PU_BONUS)
-TMD(ATT_VAMP,	PR_STATUS,						PU_BONUS)
-TMD(HEAL,		PR_STATUS,						PU_BONUS)
-TMD(COMMAND,	PR_STATUS,						PU_BONUS)
-TMD(ATT_RUN,	PR_STATUS,						PU_BONUS)
-TMD(SCENTLESS,	PR_STATUS,						PU_BONUS)
-TMD(POWERSHOT,	PR_STATUS,						PU_BONUS)
-TMD(POWERBLOW,	PR_STATUS,						PU_BONUS)
-TMD(BLOODLUST,	PR_STATUS,						PU_BONUS)
-TMD(BLACKBREATH,PR_STATUS,						PU_BONUS)
+TMD(PARALYZED,	PR_STATUS,						PU_TIMED)
+TMD(CONFUSED,	PR_STATUS,						PU_TIMED)
+TMD(AFRAID,		PR_STATUS,						PU_TIMED)
+TMD(IMAGE,		PR_MAP | PR_MONLIST | PR_ITEMLIST,	PU_TIMED)
+TMD(POISONED,	PR_STATUS,						PU_TIMED)
+TMD(CUT,		PR_STATUS,						PU_TIMED)
+TMD(STUN,		PR_STATUS,						PU_TIMED)
+TMD(PROTEVIL,	PR_STATUS,						PU_TIMED)
+TMD(INVULN,		PR_STATUS,						PU_TIMED)
+TMD(HERO,		PR_STATUS,						PU_TIMED)
+TMD(SHERO,		PR_STATUS,						PU_TIMED)
+TMD(SHIELD,		PR_STATUS,						PU_TIMED)
+TMD(BLESSED,	PR_STATUS,						PU_TIMED)
+TMD(SINVIS,		PR_STATUS,						PU_TIMED | PU_MONSTERS)
+TMD(SINFRA,		PR_STATUS,						PU_TIMED | PU_MONSTERS)
+TMD(OPP_ACID,	PR_STATUS,						PU_TIMED)
+TMD(OPP_ELEC,	PR_STATUS,						PU_TIMED)
+TMD(OPP_FIRE,	PR_STATUS,						PU_TIMED)
+TMD(OPP_COLD,	PR_STATUS,						PU_TIMED)
+TMD(OPP_POIS,	PR_STATUS,						PU_TIMED)
+TMD(OPP_CONF,	PR_STATUS,						PU_TIMED)
+TMD(AMNESIA,	PR_STATUS,						PU_TIMED)
+TMD(TELEPATHY,	PR_STATUS,						PU_TIMED)
+TMD(STONESKIN,	PR_STATUS,						PU_TIMED)
+TMD(TERROR,		PR_STATUS,						PU_TIMED)
+TMD(SPRINT,		PR_STATUS,						PU_TIMED)
+TMD(BOLD,		PR_STATUS,						PU_TIMED)
+TMD(SCRAMBLE,   PR_STATUS,		   				PU_TIMED)
+TMD(TRAPSAFE,	PR_STATUS,						PU_TIMED)
+TMD(FASTCAST,	PR_STATUS,						PU_TIMED)
+TMD(ATT_ACID,	PR_STATUS,						PU_TIMED)
+TMD(ATT_ELEC,	PR_STATUS,						PU_TIMED)
+TMD(ATT_FIRE,	PR_STATUS,						PU_TIMED)
+TMD(ATT_COLD,	PR_STATUS,						PU_TIMED)
+TMD(ATT_POIS,	PR_STATUS,						PU_TIMED)
+TMD(ATT_CONF,	PR_STATUS,						PU_TIMED)
+TMD(ATT_EVIL,	PR_STATUS,						PU_TIMED)
+TMD(ATT_DEMON,	PR_STATUS,						PU_TIMED)
+TMD(ATT_VAMP,	PR_STATUS,						PU_TIMED)
+TMD(HEAL,		PR_STATUS,						PU_TIMED)
+TMD(COMMAND,	PR_STATUS,						PU_TIMED)
+TMD(ATT_RUN,	PR_STATUS,						PU_TIMED)
+TMD(SCENTLESS,	PR_STATUS,						PU_TIMED)
+TMD(POWERSHOT,	PR_STATUS,						PU_TIMED)
+TMD(POWERBLOW,	PR_STATUS,						PU_TIMED)
+TMD(BLOODLUST,	PR_STATUS,						PU_TIMED)
+TMD(BLACKBREATH,PR_STATUS,						PU_TIMED)
@@ -374,7 +374,7 @@ static void rd_trap(struct trap *trap)
  * 32 + 5 bytes saved, so we'll read an extra 27 bytes at the end which won't
  * be used.
  */
-int rd_randomizer(void)
+int rd_randomizer_1(void)
 {
 	int i;
 	u32b noop;
@@ -403,6 +403,48 @@ int rd_randomizer(void)
 
 	Rand_quick = false;
 
+	/* Give the streams this savefile didn't have seeds of their own */
+	for (i = 1; i < RNG_MAX; i++)
+		Rand_stream_init(i, STATE[i % RAND_DEG] ^ Rand_value);
+
+	return 0;
+}
+
+/**
+ * Read RNG state, for each stream of the complex RNG
+ */
+int rd_randomizer(void)
+{
+	int i, j;
+	byte streams;
+
+	/* current value for the simple RNG */
+	rd_u32b(&Rand_value);
+
+	rd_byte(&streams);
+	for (j = 0; j < streams; j++) {
+		struct rand_stream_state s;
+
+		/* state index, for safety kept below RAND_DEG */
+		rd_u32b(&s.state_i);
+		s.state_i = s.state_i % RAND_DEG;
+
+		/* RNG variables */
+		rd_u32b(&s.z0);
+		rd_u32b(&s.z1);
+		rd_u32b(&s.z2);
+
+		/* RNG state */
+		for (i = 0; i < RAND_DEG; i++)
+			rd_u32b(&s.state[i]);
+
+		/* Streams this version doesn't have are dropped */
+		if (j < RNG_MAX)
+			Rand_stream_set(j, &s);
+	}
+
+	Rand_quick = false;
+
 	return 0;
 }
 
@@ -1136,6 +1178,14 @@ int rd_gear(void)
 {
 	struct object *obj, *known_obj;
 
+	/* This replaces anything carried in an earlier game */
+	if (player->gear) {
+		object_pile_free(player->gear);
+		object_pile_free(player->gear_k);
+		player->gear = player->gear_k = NULL;
+		player->upkeep->object = NULL;
+	}
+
 	/* Get real gear */
 	if (rd_gear_aux(rd_item, &player->gear))
 		return -1;
@@ -1257,7 +1307,7 @@ static int rd_dungeon_aux(struct chunk **c)
 	c1 = cave_new(height, width);
 	c1->name = string_make(name);
 
-    /* Run length decoding of cave->squares[y][x].info */
+    /* Run length decoding of the square flags, a flag byte at a time */
 	for (n = 0; n < square_size; n++) {
 		/* Load the dungeon data */
 		for (x = y = 0; y < c1->height; ) {
@@ -1267,8 +1317,15 @@ static int rd_dungeon_aux(struct chunk **c)
 
 			/* Apply the RLE info */
 			for (i = count; i > 0; i--) {
+				int flag, bit;
+
 				/* Extract "info" */
-				c1->squares[y][x].info[n] = tmp8u;
+				for (bit = 0; bit < (int) FLAG_WIDTH; bit++) {
+					flag = FLAG_START + n * FLAG_WIDTH + bit;
+					if (flag >= SQUARE_MAX) break;
+					if (tmp8u & FLAG_BINARY(flag))
+						sqinfo_on(c1, loc(x, y), flag);
+				}
 
 				/* Advance/Wrap */
 				if (++x >= c1->width) {
@@ -1317,8 +1374,10 @@ static int rd_dungeon_aux(struct chunk **c)
 		rd_byte(&tmp8u);
 		while (tmp8u != 0xff) {
 			size_t n;
-			struct connector *current = mem_zalloc(sizeof *current);
-			current->info = mem_zalloc(square_size * sizeof(bitflag));
+			struct connector *current = mem_arena_alloc(c1->arena,
+														sizeof *current);
+			current->info = mem_arena_alloc(c1->arena,
+											square_size * sizeof(bitflag));
 			current->grid.x = tmp8u;
 			rd_byte(&tmp8u);
 			current->grid.y = tmp8u;
@@ -1430,7 +1489,7 @@ static int rd_traps_aux(struct chunk *c)
 
 	/* Read traps until one has no location */
 	while (true) {
-		trap = mem_zalloc(sizeof(*trap));
+		trap = trap_new(c);
 		rd_trap(trap);
 		grid = trap->grid;
 		if (loc_is_zero(grid))
@@ -1448,7 +1507,7 @@ static int rd_traps_aux(struct chunk *c)
 		}
 	}
 
-	mem_free(trap);
+	trap_free(c, trap);
 	return 0;
 }
 
@@ -1474,6 +1533,17 @@ int rd_dungeon(void)
 		return (0);
 	}
 
+	/* This replaces the level from any earlier game */
+	if (cave) {
+		wipe_mon_list(cave, player);
+		cave_free(cave);
+		cave = NULL;
+	}
+	if (player->cave) {
+		cave_free(player->cave);
+		player->cave = NULL;
+	}
+
 	if (rd_dungeon_aux(&cave))
 		return 1;
 
@@ -1553,13 +1623,69 @@ int rd_traps(void)
 }
 
 /**
- * Read the chunk list
+ * Read one chunk of the chunk list
  */
-int rd_chunks(void)
+static int rd_chunk(struct chunk **c)
+{
+	/* Read the dungeon */
+	if (rd_dungeon_aux(c))
+		return -1;
+
+	/* Read the objects */
+	if (rd_objects_aux(rd_item, *c))
+		return -1;
+
+	/* Read the monsters */
+	if (rd_monsters_aux(*c))
+		return -1;
+
+	/* Read traps */
+	if (rd_traps_aux(*c))
+		return -1;
+
+	/* Read other chunk info */
+	if (OPT(player, birth_levels_persist)) {
+		char buf[80];
+		int i;
+		byte tmp8u;
+		u16b tmp16u;
+
+		rd_string(buf, sizeof(buf));
+		string_free((*c)->name);
+		(*c)->name = string_make(buf);
+		rd_s32b(&(*c)->turn);
+		rd_u16b(&tmp16u);
+		(*c)->depth = tmp16u;
+		rd_byte(&(*c)->feeling);
+		rd_u32b(&(*c)->obj_rating);
+		rd_u32b(&(*c)->mon_rating);
+		rd_byte(&tmp8u);
+		(*c)->good_item  = tmp8u ? true : false;
+		rd_u16b(&tmp16u);
+		(*c)->height = tmp16u;
+		rd_u16b(&tmp16u);
+		(*c)->width = tmp16u;
+		rd_u16b(&(*c)->feeling_squares);
+		for (i = 0; i < z_info->f_max + 1; i++) {
+			rd_u16b(&tmp16u);
+			(*c)->feat_count[i] = tmp16u;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Read the chunk list from savefiles where it is a plain list of chunks
+ */
+int rd_chunks_1(void)
 {
 	int j;
 	u16b chunk_max;
 
+	/* These replace any levels stored from an earlier game */
+	chunk_list_free();
+
 	if (player->is_dead)
 		return 0;
 
@@ -1567,54 +1693,100 @@ int rd_chunks(void)
 	for (j = 0; j < chunk_max; j++) {
 		struct chunk *c;
 
-		/* Read the dungeon */
-		if (rd_dungeon_aux(&c))
+		if (rd_chunk(&c))
 			return -1;
+		chunk_list_add(c);
+	}
 
-		/* Read the objects */
-		if (rd_objects_aux(rd_item, c))
-			return -1;
+	/* Keep them in stored form until they are wanted */
+	chunk_list_pack();
 
-		/* Read the monsters */
-		if (rd_monsters_aux(c))
-			return -1;
+	return 0;
+}
 
-		/* Read traps */
-		if (rd_traps_aux(c))
-			return -1;
+/**
+ * Read a chunk stored during play by savefile_pack_chunk(); it was written
+ * by this version, so the sizes are the current ones rather than whatever
+ * the savefile had
+ */
+int rd_packed_chunk(struct chunk **c)
+{
+	byte sizes[9] = { square_size, obj_mod_max, of_size, elem_max,
+					  brand_max, slay_max, curse_max, mflag_size, trf_size };
+	int err;
+
+	square_size = SQUARE_SIZE;
+	obj_mod_max = OBJ_MOD_MAX;
+	of_size = OF_SIZE;
+	elem_max = ELEM_MAX;
+	brand_max = z_info->brand_max;
+	slay_max = z_info->slay_max;
+	curse_max = z_info->curse_max;
+	mflag_size = MFLAG_SIZE;
+
+	err = rd_chunk(c);
+
+	square_size = sizes[0];
+	obj_mod_max = sizes[1];
+	of_size = sizes[2];
+	elem_max = sizes[3];
+	brand_max = sizes[4];
+	slay_max = sizes[5];
+	curse_max = sizes[6];
+	mflag_size = sizes[7];
+	trf_size = sizes[8];
+
+	return err;
+}
 
+/**
+ * Read the chunk list.  Chunks written with the sizes this version uses are
+ * kept as they are, and only rebuilt if they are asked for; others have to
+ * be rebuilt now, while the savefile's sizes are known.
+ */
+int rd_chunks(void)
+{
+	int j;
+	u16b chunk_max;
+	bool current = (square_size == SQUARE_SIZE) &&
+		(obj_mod_max == OBJ_MOD_MAX) && (of_size == OF_SIZE) &&
+		(elem_max == ELEM_MAX) && (brand_max == z_info->brand_max) &&
+		(slay_max == z_info->slay_max) && (curse_max == z_info->curse_max) &&
+		(mflag_size == MFLAG_SIZE);
 
-		/* Read other chunk info */
-		if (OPT(player, birth_levels_persist)) {
-			char buf[80];
-			int i;
-			byte tmp8u;
-			u16b tmp16u;
+	/* These replace any levels stored from an earlier game */
+	chunk_list_free();
 
-			rd_string(buf, sizeof(buf));
-			c->name = string_make(buf);
-			rd_s32b(&c->turn);
-			rd_u16b(&tmp16u);
-			c->depth = tmp16u;
-			rd_byte(&c->feeling);
-			rd_u32b(&c->obj_rating);
-			rd_u32b(&c->mon_rating);
-			rd_byte(&tmp8u);
-			c->good_item  = tmp8u ? true : false;
-			rd_u16b(&tmp16u);
-			c->height = tmp16u;
-			rd_u16b(&tmp16u);
-			c->width = tmp16u;
-			rd_u16b(&c->feeling_squares);
-			for (i = 0; i < z_info->f_max + 1; i++) {
-				rd_u16b(&tmp16u);
-				c->feat_count[i] = tmp16u;
-			}
-		}
+	if (player->is_dead)
+		return 0;
 
-		chunk_list_add(c);
+	rd_u16b(&chunk_max);
+	for (j = 0; j < chunk_max; j++) {
+		char name[80];
+		u16b depth;
+		u32b len;
+
+		rd_string(name, sizeof(name));
+		rd_u16b(&depth);
+		rd_u32b(&len);
+
+		if (current) {
+			byte *data = mem_alloc(len);
+
+			rd_bytes(data, len);
+			chunk_list_add_record(name, depth, data, len);
+		} else {
+			struct chunk *c;
+
+			if (rd_chunk(&c))
+				return -1;
+			chunk_list_add(c);
+		}
 	}
 
+	/* Keep them in stored form until they are wanted */
+	chunk_list_pack();
+
 	return 0;
 }
 
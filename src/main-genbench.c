@@ -0,0 +1,509 @@
+/**
+ * \file main-genbench.c
+ * \brief Pseudo-UI for benchmarking level generation (borrows from main-stats.c)
+ *
+ * Copyright (c) 2026 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_GENBENCH
+
+#include "cave.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "main.h"
+#include "obj-util.h"
+#include "player-birth.h"
+#include "player-history.h"
+#include "player-util.h"
+#include "store.h"
+#include <time.h>
+
+/**
+ * Name given to the arena, which is built by hand rather than by a profile
+ */
+#define ARENA_NAME "arena"
+
+static u32b num_runs = 10;
+static int max_depth = 99;
+static int depth_step = 10;
+static u32b base_seed = 0x5eed;
+static const char *only_profile = NULL;
+static bool json = false;
+static bool quiet = false;
+static const char *out_name = NULL;
+static int running_genbench = 0;
+
+/**
+ * Everything measured for one profile at one depth
+ */
+struct bench_result {
+	const char *profile;
+	int depth;
+	u32b levels;			/**< Levels built by the profile itself */
+	u32b gave_up;			/**< Runs where the profile never built a level */
+	u32b skipped;			/**< Runs with nothing to measure */
+	double *msecs;			/**< Time taken by each level built */
+	u32b tries;				/**< Builds started, over all levels */
+	u32b failures[GEN_FAIL_MAX];	/**< Restarts by reason */
+	long peak_bytes;		/**< Most memory needed by a single level */
+	long arena_bytes;		/**< Most memory held by a level's arena */
+	u32b disconnected;		/**< Levels with unreachable open areas */
+	u32b no_stairs;			/**< Levels where no down staircase is reachable */
+};
+
+/* Copied from main-stats.c */
+static void generate_player_for_genbench(void)
+{
+	OPT(player, birth_stacking) = true;
+	OPT(player, auto_more) = true;
+
+	player->wizard = 1;
+
+	player->race = races;
+	player->class = classes;
+	player->max_lev = player->lev = 1;
+	player->expfact = player->race->r_exp + player->class->c_exp;
+	player->hitdie = player->race->r_mhp + player->class->c_mhp;
+	player->mhp = player->chp = 2000;
+	player->player_hp[0] = player->hitdie;
+	player->ht = player->ht_birth = 66;
+	player->wt = player->wt_birth = 150;
+	player->age = 14;
+	player->history = get_history(player->race->history);
+}
+
+static void initialize_character(void)
+{
+	Rand_quick = false;
+	Rand_state_init(base_seed);
+
+	player_init(player);
+	generate_player_for_genbench();
+
+	seed_flavor = randint0(0x10000000);
+	seed_randart = randint0(0x10000000);
+
+	store_reset();
+	flavor_init();
+	player->upkeep->playing = true;
+	player->upkeep->autosave = false;
+	prepare_next_level(&cave, player);
+}
+
+/**
+ * Put every artifact back in the pool so each run sees the same ones
+ */
+static void reset_artifacts(void)
+{
+	int i;
+
+	for (i = 0; i < z_info->a_max; i++)
+		a_info[i].created = false;
+}
+
+/**
+ * Throw away the stored town, so the next town level is built from scratch
+ */
+static void forget_town(void)
+{
+	struct chunk *town = chunk_find_name("Town");
+
+	if (town) {
+		chunk_list_remove("Town");
+		cave_free(town);
+	}
+}
+
+/**
+ * Squares the player could walk through, given time to open or dig
+ */
+static bool square_isroute(struct chunk *c, struct loc grid)
+{
+	return square_ispassable(c, grid) || square_isdoor(c, grid) ||
+		square_isrubble(c, grid);
+}
+
+/**
+ * Label the level's open areas, and note whether any open square outside
+ * a vault, or every down staircase, is cut off from the player
+ */
+static void check_connectivity(struct chunk *c, struct bench_result *res)
+{
+	struct cave_regions *r = cave_regions_new(c, square_isroute, true);
+	int home = cave_region(r, player->grid);
+	bool disconnected = false, stairs = false;
+	struct loc grid;
+
+	for (grid.y = 0; grid.y < c->height; grid.y++) {
+		for (grid.x = 0; grid.x < c->width; grid.x++) {
+			if (!square_isroute(c, grid)) continue;
+			if (cave_region(r, grid) == home) {
+				if (square_isdownstairs(c, grid)) stairs = true;
+			} else if (!square_isvault(c, grid)) {
+				disconnected = true;
+			}
+		}
+	}
+
+	if (disconnected) res->disconnected++;
+	if (!stairs && !player->upkeep->arena_level &&
+		c->depth < z_info->max_depth - 1)
+		res->no_stairs++;
+
+	cave_regions_free(r);
+}
+
+/**
+ * Build one level with the given profile (NULL meaning the arena), and
+ * measure it
+ */
+static void bench_level(const struct cave_profile *profile, int depth,
+						u32b seed, struct bench_result *res)
+{
+	struct gen_report report;
+	bool arena = !profile;
+	clock_t start;
+	double msec;
+	long peak;
+	int i;
+
+	memset(&report, 0, sizeof(report));
+	Rand_state_init(seed);
+	reset_artifacts();
+
+	if (arena) {
+		struct monster *mon = NULL;
+
+		/* Go to an ordinary level, and pick a monster to fight */
+		dungeon_change_level(player, depth);
+		prepare_next_level(&cave, player);
+		for (i = 1; i < cave_monster_max(cave); i++) {
+			if (cave_monster(cave, i)->race) {
+				mon = cave_monster(cave, i);
+				break;
+			}
+		}
+		if (!mon) {
+			res->skipped++;
+			return;
+		}
+		player->upkeep->health_who = mon;
+		player->upkeep->arena_level = true;
+	} else {
+		if (!depth) forget_town();
+		dungeon_change_level(player, depth);
+		report.profile = profile;
+	}
+
+	/* Build the level */
+	gen_report = &report;
+	mem_tally_reset();
+	mem_flags |= MEM_TALLY;
+	start = clock();
+	prepare_next_level(&cave, player);
+	msec = (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+	mem_flags &= ~MEM_TALLY;
+	peak = mem_tally_peak();
+	gen_report = NULL;
+
+	/* Record the results */
+	res->tries += report.tries;
+	for (i = 0; i < GEN_FAIL_MAX; i++)
+		res->failures[i] += report.failures[i];
+	if (report.gave_up) {
+		res->gave_up++;
+	} else {
+		res->msecs[res->levels++] = msec;
+		res->peak_bytes = MAX(res->peak_bytes, peak);
+		res->arena_bytes = MAX(res->arena_bytes,
+							   (long) mem_arena_held(cave->arena));
+		check_connectivity(cave, res);
+	}
+
+	/* Go back from the arena, leaving the monster alive for next time */
+	if (arena) {
+		prepare_next_level(&cave, player);
+		player->upkeep->arena_level = false;
+		player->upkeep->health_who = NULL;
+	}
+}
+
+static int compare_msecs(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * Nearest-rank percentile of a sorted list of times
+ */
+static double percentile(const double *msecs, u32b n, int pc)
+{
+	u32b rank;
+
+	if (!n) return 0.0;
+	rank = (n * pc + 99) / 100;
+	return msecs[rank ? rank - 1 : 0];
+}
+
+static void write_header(FILE *f)
+{
+	int i;
+
+	if (json) {
+		fprintf(f, "[\n");
+		return;
+	}
+
+	fprintf(f, "profile,depth,levels,gave_up,skipped,p50_ms,p90_ms,p99_ms,"
+			  "max_ms,tries");
+	for (i = 0; i < GEN_FAIL_MAX; i++) {
+		char name[40];
+		size_t j;
+
+		my_strcpy(name, gen_failure_names[i], sizeof(name));
+		for (j = 0; name[j]; j++)
+			if (name[j] == ' ') name[j] = '_';
+		fprintf(f, ",restarts_%s", name);
+	}
+	fprintf(f, ",peak_bytes,arena_bytes,disconnected,no_stairs\n");
+}
+
+static void write_result(FILE *f, struct bench_result *res, bool first)
+{
+	double p50, p90, p99, max;
+	int i;
+
+	qsort(res->msecs, res->levels, sizeof(double), compare_msecs);
+	p50 = percentile(res->msecs, res->levels, 50);
+	p90 = percentile(res->msecs, res->levels, 90);
+	p99 = percentile(res->msecs, res->levels, 99);
+	max = percentile(res->msecs, res->levels, 100);
+
+	if (json) {
+		fprintf(f, "%s  {\"profile\": \"%s\", \"depth\": %d, \"levels\": %lu, "
+				  "\"gave_up\": %lu, \"skipped\": %lu, \"p50_ms\": %.3f, "
+				  "\"p90_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f, "
+				  "\"tries\": %lu, \"restarts\": {", first ? "" : ",\n",
+				  res->profile, res->depth, (unsigned long) res->levels,
+				  (unsigned long) res->gave_up, (unsigned long) res->skipped,
+				  p50, p90, p99, max, (unsigned long) res->tries);
+		for (i = 0; i < GEN_FAIL_MAX; i++)
+			fprintf(f, "%s\"%s\": %lu", i ? ", " : "",
+					  gen_failure_names[i], (unsigned long) res->failures[i]);
+		fprintf(f, "}, \"peak_bytes\": %ld, \"arena_bytes\": %ld, "
+				  "\"disconnected\": %lu, \"no_stairs\": %lu}",
+				  res->peak_bytes, res->arena_bytes,
+				  (unsigned long) res->disconnected,
+				  (unsigned long) res->no_stairs);
+		return;
+	}
+
+	fprintf(f, "%s,%d,%lu,%lu,%lu,%.3f,%.3f,%.3f,%.3f,%lu", res->profile,
+			  res->depth, (unsigned long) res->levels,
+			  (unsigned long) res->gave_up, (unsigned long) res->skipped,
+			  p50, p90, p99, max, (unsigned long) res->tries);
+	for (i = 0; i < GEN_FAIL_MAX; i++)
+		fprintf(f, ",%lu", (unsigned long) res->failures[i]);
+	fprintf(f, ",%ld,%ld,%lu,%lu\n", res->peak_bytes, res->arena_bytes,
+			  (unsigned long) res->disconnected,
+			  (unsigned long) res->no_stairs);
+}
+
+/**
+ * Benchmark one profile (NULL meaning the arena) at one depth
+ */
+static void bench_depth(FILE *f, const struct cave_profile *profile,
+						int idx, int depth, bool first)
+{
+	struct bench_result res;
+	u32b run;
+
+	memset(&res, 0, sizeof(res));
+	res.profile = profile ? profile->name : ARENA_NAME;
+	res.depth = depth;
+	res.msecs = mem_zalloc(num_runs * sizeof(double));
+
+	if (!quiet) {
+		fprintf(stderr, "%s, depth %d\n", res.profile, depth);
+		fflush(stderr);
+	}
+
+	/* Each run's seed depends only on what it is measuring */
+	for (run = 0; run < num_runs; run++)
+		bench_level(profile, depth,
+					base_seed ^ ((u32b) idx << 24) ^ ((u32b) depth << 16) ^ run,
+					&res);
+
+	write_result(f, &res, first);
+	mem_free(res.msecs);
+}
+
+static errr run_genbench(void)
+{
+	FILE *f;
+	bool first = true;
+	int idx, depth;
+
+	if (out_name) {
+		f = fopen(out_name, "w");
+		if (!f) quit_fmt("Couldn't open %s for writing!", out_name);
+	} else {
+		f = stdout;
+	}
+
+	max_depth = MIN(max_depth, z_info->max_depth - 1);
+	initialize_character();
+	write_header(f);
+
+	/* Every profile, then the arena */
+	for (idx = 0; idx <= z_info->profile_max; idx++) {
+		const struct cave_profile *profile = cave_profile_by_idx(idx);
+		const char *name = profile ? profile->name : ARENA_NAME;
+
+		if (only_profile && !streq(only_profile, name)) continue;
+
+		/* The town only exists at the surface */
+		if (profile && streq(profile->name, "town")) {
+			bench_depth(f, profile, idx, 0, first);
+			first = false;
+			continue;
+		}
+
+		for (depth = 1; depth <= max_depth; depth += depth_step) {
+			bench_depth(f, profile, idx, depth, first);
+			first = false;
+		}
+	}
+
+	if (json) fprintf(f, "\n]\n");
+	if (f != stdout) fclose(f);
+
+	cleanup_angband();
+	quit(NULL);
+	exit(0);
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+
+static errr term_xtra_genbench(int n, int v) {
+	if (n != TERM_XTRA_EVENT || running_genbench) return 0;
+	running_genbench = 1;
+	return run_genbench();
+}
+
+static errr term_curs_genbench(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_genbench(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_genbench(int x, int y, int n, int a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = true;
+	t->never_frosh = true;
+
+	t->xtra_hook = term_xtra_genbench;
+	t->curs_hook = term_curs_genbench;
+	t->wipe_hook = term_wipe_genbench;
+	t->text_hook = term_text_genbench;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_genbench[] = "Level generation benchmark, subopts -n(# of runs) -d(eepest) -i(nterval) -s(eed) -p(rofile) -j(son) -o(utput) -q(uiet)";
+
+/**
+ * Usage:
+ *
+ * angband -mgenbench -- [-nNN] [-dNN] [-iNN] [-sNNNN] [-pNAME] [-j] [-oFILE]
+ *                       [-q]
+ *
+ *   -nNN    Build NN levels per profile and depth (default: 10)
+ *   -dNN    Deepest level to build (default: 99)
+ *   -iNN    Build every NN levels from 1 down (default: 10)
+ *   -sNNNN  Base random seed (default: 0x5eed)
+ *   -pNAME  Only benchmark the named profile, or "arena"
+ *   -j      Write JSON rather than CSV
+ *   -oFILE  Write to FILE rather than standard output
+ *   -q      Quiet mode (turn off progress messages)
+ */
+errr init_genbench(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (prefix(argv[i], "-n")) {
+			num_runs = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
+		if (prefix(argv[i], "-d")) {
+			max_depth = atoi(&argv[i][2]);
+			continue;
+		}
+		if (prefix(argv[i], "-i")) {
+			depth_step = MAX(atoi(&argv[i][2]), 1);
+			continue;
+		}
+		if (prefix(argv[i], "-s")) {
+			base_seed = strtoul(&argv[i][2], NULL, 0);
+			continue;
+		}
+		if (prefix(argv[i], "-p")) {
+			only_profile = &argv[i][2];
+			continue;
+		}
+		if (streq(argv[i], "-j")) {
+			json = true;
+			continue;
+		}
+		if (prefix(argv[i], "-o")) {
+			out_name = &argv[i][2];
+			continue;
+		}
+		if (streq(argv[i], "-q")) {
+			quiet = true;
+			continue;
+		}
+		printf("init-genbench: bad argument '%s'\n", argv[i]);
+	}
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_GENBENCH */
@@ -0,0 +1,156 @@
+/**
+ * \file main-replay.c
+ * \brief Pseudo-UI for replaying a journal of a game (borrows from
+ * main-genbench.c)
+ *
+ * Copyright (c) 2026 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "angband.h"
+
+#ifdef USE_REPLAY
+
+#include "cmd-journal.h"
+#include "game-input.h"
+#include "init.h"
+#include "main.h"
+#include "ui-game.h"
+#include <time.h>
+
+static const char *journal_name = NULL;
+static bool quiet = false;
+static int running_replay = 0;
+
+static errr run_replay(void)
+{
+	struct journal_report report;
+	clock_t start = clock();
+	double msecs;
+	bool passed;
+
+	/* Nothing is on screen, but the game must see as if the map were */
+	map_is_visible_hook = NULL;
+
+	/* Nothing is to be saved over the player's own savefile */
+	path_build(savefile, sizeof(savefile), ANGBAND_DIR_USER, "replay.sav");
+
+	passed = journal_replay(journal_name, &report);
+	msecs = (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+	if (!quiet || !passed) {
+		printf("journal: %s\n", journal_name);
+		printf("commands: %u\n", report.commands);
+		printf("runs: %u\n", report.runs);
+		printf("checkpoints: %u\n", report.checkpoints);
+		printf("turns: %ld\n", (long) report.turns);
+		printf("time: %.1fms\n", msecs);
+		if (msecs > 0)
+			printf("turns/s: %.0f\n", report.turns * 1000.0 / msecs);
+	}
+
+	cleanup_angband();
+	if (!passed) quit_fmt("Replay failed: %s", report.error);
+	quit(NULL);
+	exit(0);
+}
+
+typedef struct term_data term_data;
+struct term_data {
+	term t;
+};
+
+static term_data td;
+
+static errr term_xtra_replay(int n, int v) {
+	if (n != TERM_XTRA_EVENT) return 0;
+
+	/* Anything waiting for a key during the replay gets escape */
+	if (running_replay) {
+		if (v) Term_keypress(ESCAPE, 0);
+		return 0;
+	}
+
+	running_replay = 1;
+	return run_replay();
+}
+
+static errr term_curs_replay(int x, int y) {
+	return 0;
+}
+
+static errr term_wipe_replay(int x, int y, int n) {
+	return 0;
+}
+
+static errr term_text_replay(int x, int y, int n, int a, const wchar_t *s) {
+	return 0;
+}
+
+static void term_data_link(int i) {
+	term *t = &td.t;
+
+	term_init(t, 80, 24, 256);
+
+	/* Ignore some actions for efficiency and safety */
+	t->never_bored = true;
+	t->never_frosh = true;
+
+	t->xtra_hook = term_xtra_replay;
+	t->curs_hook = term_curs_replay;
+	t->wipe_hook = term_wipe_replay;
+	t->text_hook = term_text_replay;
+
+	t->data = &td;
+
+	Term_activate(t);
+
+	angband_term[i] = t;
+}
+
+const char help_replay[] = "Replay a journal made with -j, subopts [-q(uiet)] FILE";
+
+/**
+ * Usage:
+ *
+ * angband -mreplay -- [-q] FILE
+ *
+ *   -q      Quiet mode (only report a replay which fails)
+ *   FILE    The journal to replay
+ *
+ * The exit status is non-zero if the game didn't do what the journal says
+ * it did.
+ */
+errr init_replay(int argc, char *argv[]) {
+	int i;
+
+	/* Skip over argv[0] */
+	for (i = 1; i < argc; i++) {
+		if (streq(argv[i], "-q")) {
+			quiet = true;
+			continue;
+		}
+		if (argv[i][0] != '-' && !journal_name) {
+			journal_name = argv[i];
+			continue;
+		}
+		printf("init-replay: bad argument '%s'\n", argv[i]);
+	}
+
+	if (!journal_name) quit("init-replay: no journal to replay");
+
+	term_data_link(0);
+	return 0;
+}
+
+#endif /* USE_REPLAY */
@@ -74,6 +74,14 @@ static const struct module modules[] =
 #ifdef USE_STATS
 	{ "stats", help_stats, init_stats },
 #endif /* USE_STATS */
+
+#ifdef USE_GENBENCH
+	{ "genbench", help_genbench, init_genbench },
+#endif /* USE_GENBENCH */
+
+#ifdef USE_REPLAY
+	{ "replay", help_replay, init_replay },
+#endif /* USE_REPLAY */
 };
 
 /**
@@ -286,10 +294,20 @@ static void debug_opt(const char *arg) {
 		mem_flags |= MEM_POISON_ALLOC;
 	else if (streq(arg, "mem-poison-free"))
 		mem_flags |= MEM_POISON_FREE;
-	else {
+	else if (streq(arg, "mem-track"))
+		mem_flags |= MEM_TRACK;
+	else if (prefix(arg, "mem-track-sample")) {
+		const char *rate = arg + strlen("mem-track-sample");
+		mem_flags |= MEM_TRACK;
+		mem_track_sample(*rate == '=' ? atoi(rate + 1) : 64);
+	} else {
 		puts("Debug flags:");
 		puts("  mem-poison-alloc: Poison all memory allocations");
 		puts("   mem-poison-free: Poison all freed memory");
+		puts("         mem-track: Count allocations by where they are made,");
+		puts("                    and report them in mem-track.txt at exit");
+		puts("mem-track-sample[=N]: As mem-track, for about one allocation "
+			 "in N (64)");
 		exit(0);
 	}
 }
@@ -397,6 +415,11 @@ int main(int argc, char *argv[])
 				arg_force_name = true;
 				break;
 
+			case 'j':
+				if (!*arg) goto usage;
+				my_strcpy(arg_journal, arg, sizeof(arg_journal));
+				continue;
+
 			case 'm':
 				if (!*arg) goto usage;
 				mstr = arg;
@@ -431,6 +454,7 @@ int main(int argc, char *argv[])
 				puts("  -g             Request graphics mode");
 				puts("  -x<opt>        Debug options; see -xhelp");
 				puts("  -u<who>        Use your <who> savefile");
+				puts("  -j<file>       Record a journal of the game to <file>");
 				puts("  -d<dir>=<path> Override a specific directory with <path>. <path> can be:");
 				for (i = 0; i < (int)N_ELEMENTS(change_path_values); i++) {
 #ifdef SETGID
@@ -83,82 +83,58 @@ static bool monster_can_cast(struct monster *mon, bool innate)
 }
 
 /**
- * Remove the "bad" spells from a spell list
+ * Check whether a spell would be wasted in the monster's present situation
  */
-static void remove_bad_spells(struct monster *mon, bitflag f[RSF_SIZE])
+static bool spell_is_useless(struct monster *mon, int index)
 {
-	bitflag f2[RSF_SIZE];
+	switch (index) {
+		/* Don't heal if full */
+		case RSF_HEAL: return mon->hp >= mon->maxhp;
 
-	/* Take working copy of spell flags */
-	rsf_copy(f2, f);
+		/* Don't heal others if no injuries */
+		case RSF_HEAL_KIN: return !find_any_nearby_injured_kin(cave, mon);
 
-	/* Don't heal if full */
-	if (mon->hp >= mon->maxhp) {
-		rsf_off(f2, RSF_HEAL);
-	}
-
-	/* Don't heal others if no injuries */
-	if (rsf_has(f2, RSF_HEAL_KIN) && !find_any_nearby_injured_kin(cave, mon)) {
-		rsf_off(f2, RSF_HEAL_KIN);
-	}
+		/* Don't haste if hasted with time remaining */
+		case RSF_HASTE: return mon->m_timed[MON_TMD_FAST] > 10;
 
-	/* Don't haste if hasted with time remaining */
-	if (mon->m_timed[MON_TMD_FAST] > 10) {
-		rsf_off(f2, RSF_HASTE);
-	}
+		/* Don't teleport to if the player is already next to us */
+		case RSF_TELE_TO: return mon->cdis == 1;
 
-	/* Don't teleport to if the player is already next to us */
-	if (mon->cdis == 1) {
-		rsf_off(f2, RSF_TELE_TO);
-	}
-
-	/* Don't use the lash effect if the player is too far away */
-	if (mon->cdis > 2) {
-		rsf_off(f2, RSF_WHIP);
-	}
-	if (mon->cdis > 3) {
-		rsf_off(f2, RSF_SPIT);
+		/* Don't use the lash effect if the player is too far away */
+		case RSF_WHIP: return mon->cdis > 2;
+		case RSF_SPIT: return mon->cdis > 3;
 	}
 
-	/* Update acquired knowledge */
-	if (OPT(player, birth_ai_learn)) {
-		size_t i;
-		bitflag ai_flags[OF_SIZE], ai_pflags[PF_SIZE];
-		struct element_info el[ELEM_MAX];
-		bool know_something = false;
-
-		/* Occasionally forget player status */
-		if (one_in_(100)) {
-			of_wipe(mon->known_pstate.flags);
-			pf_wipe(mon->known_pstate.pflags);
-			for (i = 0; i < ELEM_MAX; i++)
-				mon->known_pstate.el_info[i].res_level = 0;
-		}
+	return false;
+}
 
-		/* Use the memorized info */
-		of_wipe(ai_flags);
-		pf_wipe(ai_pflags);
-		of_copy(ai_flags, mon->known_pstate.flags);
-		pf_copy(ai_pflags, mon->known_pstate.pflags);
-		if (!of_is_empty(ai_flags) || !pf_is_empty(ai_pflags)) {
-			know_something = true;
-		}
+/**
+ * Check whether the monster has learnt anything about the player which might
+ * rule out spells
+ */
+static bool monster_knows_player(struct monster *mon)
+{
+	size_t i;
 
-		for (i = 0; i < ELEM_MAX; i++) {
-			el[i].res_level = mon->known_pstate.el_info[i].res_level;
-			if (el[i].res_level != 0) {
-				know_something = true;
-			}
-		}
+	if (!OPT(player, birth_ai_learn)) return false;
 
-		/* Cancel out certain flags based on knowledge */
-		if (know_something) {
-			unset_spells(f2, ai_flags, ai_pflags, el, mon);
-		}
+	/* Occasionally forget player status */
+	if (one_in_(100)) {
+		of_wipe(mon->known_pstate.flags);
+		pf_wipe(mon->known_pstate.pflags);
+		for (i = 0; i < ELEM_MAX; i++)
+			mon->known_pstate.el_info[i].res_level = 0;
 	}
 
-	/* Use working copy of spell flags */
-	rsf_copy(f, f2);
+	/* Use the memorized info */
+	if (!of_is_empty(mon->known_pstate.flags) ||
+		!pf_is_empty(mon->known_pstate.pflags))
+		return true;
+	for (i = 0; i < ELEM_MAX; i++)
+		if (mon->known_pstate.el_info[i].res_level != 0)
+			return true;
+
+	return false;
 }
 
 
@@ -290,9 +266,15 @@ static int monster_spell_failrate(struct monster *mon)
  */
 bool make_ranged_attack(struct monster *mon)
 {
-	struct monster_lore *lore = get_lore(mon->race);
+	const struct monster_race *race = mon->race;
+	struct monster_lore *lore = get_lore(race);
+	struct player_state *known = &mon->known_pstate;
 	int thrown_spell, failrate;
-	bitflag f[RSF_SIZE];
+	const byte *cat;
+	byte spells[RSF_MAX];
+	bool skip[MSC_MAX] = { false };
+	bool learn = false;
+	int c, i, num = 0;
 	char m_name[80];
 	bool seen = (player->timed[TMD_BLIND] == 0) && monster_is_visible(mon);
 	bool innate = false;
@@ -307,39 +289,51 @@ bool make_ranged_attack(struct monster *mon)
 		}
 	}
 
-	/* Extract the racial spell flags */
-	rsf_copy(f, mon->race->spell_flags);
+	/* Look only at the half of the race's spells being cast from */
+	cat = race->spell_cat[innate ? 0 : 1];
 
 	/* Smart monsters can use "desperate" spells */
 	if (monster_is_smart(mon) && mon->hp < mon->maxhp / 10 && one_in_(2)) {
-		ignore_spells(f, RST_DAMAGE);
+		skip[MSC_BOLT] = skip[MSC_BREATH] = skip[MSC_DAMAGE] = true;
 	}
 
 	/* Non-stupid monsters do some filtering */
 	if (!monster_is_stupid(mon)) {
-		/* Remove the "ineffective" spells */
-		remove_bad_spells(mon, f);
+		learn = monster_knows_player(mon);
 
 		/* Check for a clean bolt shot */
-		if (test_spells(f, RST_BOLT) &&
+		if (!skip[MSC_BOLT] && (cat[MSC_BOLT] < cat[MSC_BOLT + 1]) &&
 			!projectable(cave, mon->grid, player->grid, PROJECT_STOP)) {
-			ignore_spells(f, RST_BOLT);
+			skip[MSC_BOLT] = true;
 		}
 
-		/* Check for a possible summon */
-		if (!summon_possible(mon->grid)) {
-			ignore_spells(f, RST_SUMMON);
+		/* Check for a possible summon, if there is one to make */
+		if ((cat[MSC_SUMMON] < cat[MSC_SUMMON + 1]) &&
+			!summon_possible(mon->grid)) {
+			skip[MSC_SUMMON] = true;
 		}
 	}
 
-	/* No spells left */
-	if (rsf_is_empty(f)) return false;
+	/* Gather the spells left, removing the "ineffective" ones */
+	for (c = 0; c < MSC_MAX; c++) {
+		if (skip[c]) continue;
+		for (i = cat[c]; i < cat[c + 1]; i++) {
+			int index = race->spells[i];
+			if (!monster_is_stupid(mon) && spell_is_useless(mon, index))
+				continue;
+			if (learn && mon_spell_is_resisted(index, known->flags,
+											   known->pflags, known->el_info,
+											   mon))
+				continue;
+			spells[num++] = index;
+		}
+	}
 
-	/* Choose a spell to cast */
-	thrown_spell = choose_attack_spell(f, innate, !innate);
+	/* No spells left */
+	if (num == 0) return false;
 
-	/* Abort if no spell was chosen */
-	if (!thrown_spell) return false;
+	/* Pick one at random */
+	thrown_spell = spells[randint0(num)];
 
 	/* There will be at least an attempt now, so get the monster's name */
 	monster_desc(m_name, sizeof(m_name), mon, MDESC_STANDARD);
@@ -911,7 +911,11 @@ static errr run_parse_mon_spell(struct parser *p) {
 }
 
 static errr finish_parse_mon_spell(struct parser *p) {
+	struct monster_spell *s;
+
 	monster_spells = parser_priv(p);
+	for (s = monster_spells; s; s = s->next)
+		s->effect = effect_pack(s->effect);
 	parser_destroy(p);
 	return 0;
 }
@@ -992,21 +996,21 @@ static enum parser_error parse_mon_base_pain(struct parser *p) {
 static enum parser_error parse_mon_base_flags(struct parser *p) {
 	struct monster_base *rb = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!rb)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(rb->flags, RF_SIZE, r_info_flags, s)) {
 			mem_free(flags);
 			quit_fmt("bad f-flag: %s", s);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
@@ -1259,21 +1263,21 @@ static enum parser_error parse_monster_blow(struct parser *p) {
 static enum parser_error parse_monster_flags(struct parser *p) {
 	struct monster_race *r = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!r)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(r->flags, RF_SIZE, r_info_flags, s)) {
 			mem_free(flags);
 			quit_fmt("bad f2-flag: %s", s);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
@@ -1283,21 +1287,21 @@ static enum parser_error parse_monster_flags(struct parser *p) {
 static enum parser_error parse_monster_flags_off(struct parser *p) {
 	struct monster_race *r = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!r)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (remove_flag(r->flags, RF_SIZE, r_info_flags, s)) {
 			mem_free(flags);
 			quit_fmt("bad mf-flag: %s", s);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
@@ -1351,20 +1355,20 @@ static enum parser_error parse_monster_spell_power(struct parser *p) {
 static enum parser_error parse_monster_spells(struct parser *p) {
 	struct monster_race *r = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 	int ret = PARSE_ERROR_NONE;
 
 	if (!r)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	flags = string_make(parser_getstr(p, "spells"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(r->spell_flags, RSF_SIZE, r_info_spell_flags, s)) {
 			quit_fmt("bad spell flag: %s", s);
 			ret = PARSE_ERROR_INVALID_FLAG;
 			break;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	/* Add the "base monster" flags to the monster */
@@ -1595,9 +1599,38 @@ static errr run_parse_monster(struct parser *p) {
 	return parse_file_quit_not_found(p, "monster");
 }
 
+/**
+ * Hash a race name, ignoring case as lookup_monster() does
+ */
+static u32b race_name_hash(const char *name)
+{
+	u32b hash = 5381;
+
+	while (*name)
+		hash = hash * 33 + (byte) tolower((unsigned char) *name++);
+	return hash;
+}
+
+/**
+ * Find a race by name in a table made by finish_parse_monster(); names with
+ * no exact match get lookup_monster()'s closest match instead
+ */
+static struct monster_race *lookup_race_name(struct monster_race **names,
+											 size_t size, const char *name)
+{
+	size_t h = race_name_hash(name) % size;
+
+	for (; names[h]; h = (h + 1) % size)
+		if (!my_stricmp(names[h]->name, name))
+			return names[h];
+
+	return lookup_monster(name);
+}
+
 static errr finish_parse_monster(struct parser *p) {
 	struct monster_race *r, *n;
-	size_t i;
+	struct monster_race **names;
+	size_t i, names_size;
 	int ridx;
 
 	/* Scan the list for the max id and max blows */
@@ -1662,10 +1695,28 @@ static errr finish_parse_monster(struct parser *p) {
 		}
 		r_info[ridx].blow = b_new;
 
+		/* Spells */
+		mon_spell_table_build(&r_info[ridx]);
+
 		mem_free(r);
 	}
 	z_info->r_max += 1;
 
+	/* Index the races by name, the first of any with the same name winning */
+	names_size = 2 * z_info->r_max;
+	names = mem_zalloc(names_size * sizeof(*names));
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_race *race = &r_info[i];
+		size_t h;
+
+		if (!race->name) continue;
+		h = race_name_hash(race->name) % names_size;
+		while (names[h] && my_stricmp(names[h]->name, race->name))
+			h = (h + 1) % names_size;
+		if (!names[h])
+			names[h] = race;
+	}
+
 	/* Convert friend and shape names into race pointers */
 	for (i = 0; i < z_info->r_max; i++) {
 		struct monster_race *race = &r_info[i];
@@ -1675,7 +1726,7 @@ static errr finish_parse_monster(struct parser *p) {
 			if (!my_stricmp(f->name, "same")) {
 				f->race = race;
 			} else {
-				f->race = lookup_monster(f->name);
+				f->race = lookup_race_name(names, names_size, f->name);
 			}
 			if (!f->race) {
 				quit_fmt("Couldn't find friend named '%s' for monster '%s'",
@@ -1685,7 +1736,7 @@ static errr finish_parse_monster(struct parser *p) {
 		}
 		for (s = race->shapes; s; s = s->next) {
 			if (!s->base) {
-				s->race = lookup_monster(s->name);
+				s->race = lookup_race_name(names, names_size, s->name);
 				if (!s->race) {
 					quit_fmt("Couldn't find shape named '%s' for monster '%s'",
 							 s->name, race->name);
@@ -1694,6 +1745,7 @@ static errr finish_parse_monster(struct parser *p) {
 			string_free(s->name);
 		}
 	}
+	mem_free(names);
 
 	/* Allocate space for the monster lore */
 	l_list = mem_zalloc(z_info->r_max * sizeof(struct monster_lore));
@@ -1753,6 +1805,7 @@ static void cleanup_monster(void)
 		string_free(r->text);
 		string_free(r->name);
 		mem_free(r->blow);
+		mem_free(r->spells);
 	}
 
 	mem_free(r_info);
@@ -1870,20 +1923,20 @@ static enum parser_error parse_pit_color(struct parser *p) {
 static enum parser_error parse_pit_flags_req(struct parser *p) {
 	struct pit_profile *pit = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!pit)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(pit->flags, RF_SIZE, r_info_flags, s)) {
 			mem_free(flags);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	
 	mem_free(flags);
@@ -1893,20 +1946,20 @@ static enum parser_error parse_pit_flags_req(struct parser *p) {
 static enum parser_error parse_pit_flags_ban(struct parser *p) {
 	struct pit_profile *pit = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!pit)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(pit->forbidden_flags, RF_SIZE, r_info_flags, s)) {
 			mem_free(flags);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	
 	mem_free(flags);
@@ -1928,20 +1981,20 @@ static enum parser_error parse_pit_innate_freq(struct parser *p) {
 static enum parser_error parse_pit_spell_req(struct parser *p) {
 	struct pit_profile *pit = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!pit)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "spells"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "spells"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(pit->spell_flags, RSF_SIZE, r_info_spell_flags, s)) {
 			mem_free(flags);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	
 	mem_free(flags);
@@ -1951,20 +2004,20 @@ static enum parser_error parse_pit_spell_req(struct parser *p) {
 static enum parser_error parse_pit_spell_ban(struct parser *p) {
 	struct pit_profile *pit = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!pit)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "spells"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "spells"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		if (grab_flag(pit->forbidden_spell_flags, RSF_SIZE, r_info_spell_flags, s)) {
 			mem_free(flags);
 			return PARSE_ERROR_INVALID_FLAG;
 		}
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 	
 	mem_free(flags);
@@ -2164,17 +2217,17 @@ static enum parser_error parse_lore_blow(struct parser *p) {
 static enum parser_error parse_lore_flags(struct parser *p) {
 	struct monster_lore *l = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 
 	if (!l)
 		return PARSE_ERROR_NONE;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		(void) grab_flag(l->flags, RF_SIZE, r_info_flags, s);
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
@@ -2184,16 +2237,16 @@ static enum parser_error parse_lore_flags(struct parser *p) {
 static enum parser_error parse_lore_spells(struct parser *p) {
 	struct monster_lore *l = parser_priv(p);
 	char *flags;
-	char *s;
+	char *s, *state;
 	int ret = PARSE_ERROR_NONE;
 
 	if (!l)
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "spells"));
-	s = strtok(flags, " |");
+	s = my_strtok(flags, " |", &state);
 	while (s) {
 		(void) grab_flag(l->spell_flags, RSF_SIZE, r_info_spell_flags, s);
-		s = strtok(NULL, " |");
+		s = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(flags);
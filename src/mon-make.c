@@ -722,8 +722,8 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 				continue;
 			}
 
-			/* Allocate by hand, prep, apply magic */
-			obj = mem_zalloc(sizeof(*obj));
+			/* Allocate, prep, apply magic */
+			obj = object_new();
 			object_prep(obj, kind, 100, RANDOMISE);
 			obj->artifact = art;
 			copy_artifact_data(obj, obj->artifact);
@@ -740,8 +740,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 				any = true;
 			} else {
 				obj->artifact->created = false;
-				object_wipe(obj);
-				mem_free(obj);
+				object_free(obj);
 			}
 		}
 	}
@@ -753,8 +752,8 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 
 		/* Specified by tval or by kind */
 		if (drop->kind) {
-			/* Allocate by hand, prep, apply magic */
-			obj = mem_zalloc(sizeof(*obj));
+			/* Allocate, prep, apply magic */
+			obj = object_new();
 			object_prep(obj, drop->kind, level, RANDOMISE);
 			apply_magic(obj, level, true, good, great, extra_roll);
 		} else {
@@ -777,8 +776,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 		if (monster_carry(c, mon, obj)) {
 			any = true;
 		} else {
-			object_wipe(obj);
-			mem_free(obj);
+			object_free(obj);
 		}
 	}
 
@@ -801,8 +799,7 @@ static bool mon_create_drop(struct chunk *c, struct monster *mon, byte origin)
 			any = true;
 		} else {
 			obj->artifact->created = false;
-			object_wipe(obj);
-			mem_free(obj);
+			object_free(obj);
 		}
 	}
 
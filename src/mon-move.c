@@ -480,6 +480,7 @@ static bool get_move_advance(struct chunk *c, struct monster *mon, bool *track)
 static bool get_move_find_safety(struct chunk *c, struct monster *mon)
 {
 	int i, dy, dx, d, dis, gdis = 0;
+	int noise = c->noise.grids[mon->grid.y][mon->grid.x];
 
 	const int *y_offsets;
 	const int *x_offsets;
@@ -505,8 +506,7 @@ static bool get_move_find_safety(struct chunk *c, struct monster *mon)
 			if (!square_ispassable(c, grid)) continue;
 
 			/* Ignore too-distant grids */
-			if (c->noise.grids[grid.y][grid.x] >
-				c->noise.grids[mon->grid.y][mon->grid.x] + 2 * d)
+			if (c->noise.grids[grid.y][grid.x] > noise + 2 * d)
 				continue;
 
 			/* Ignore damaging terrain if they can't handle it */
@@ -576,17 +576,18 @@ static bool get_move_find_hiding(struct chunk *c, struct monster *mon)
 			/* Skip occupied locations */
 			if (!square_isempty(c, grid)) continue;
 
-			/* Check for hidden, available grid */
-			if (!square_isview(c, grid) &&
-				projectable(c, mon->grid, grid, PROJECT_STOP)) {
-				/* Calculate distance from player */
-				dis = distance(grid, player->grid);
+			/* Skip grids the player can see */
+			if (square_isview(c, grid)) continue;
 
-				/* Remember if closer than previous */
-				if (dis < gdis && dis >= min) {
-					best = grid;
-					gdis = dis;
-				}
+			/* Calculate distance from player, and skip grids no closer
+			 * than the best so far, or too close */
+			dis = distance(grid, player->grid);
+			if (dis >= gdis || dis < min) continue;
+
+			/* Only then check the grid can be reached, which is costly */
+			if (projectable(c, mon->grid, grid, PROJECT_STOP)) {
+				best = grid;
+				gdis = dis;
 			}
 		}
 
@@ -1322,6 +1323,7 @@ static void monster_turn(struct chunk *c, struct monster *mon)
 	bool stagger = false;
 	bool tracking = false;
 	char m_name[80];
+	int old_stream;
 
 	/* Get the monster name */
 	monster_desc(m_name, sizeof(m_name), mon, MDESC_CAPITAL | MDESC_IND_HID);
@@ -1429,7 +1431,9 @@ static void monster_turn(struct chunk *c, struct monster *mon)
 				continue;
 
 			/* Otherwise, attack the player */
+			old_stream = Rand_stream_select(RNG_COMBAT);
 			make_attack_normal(mon, player);
+			Rand_stream_select(old_stream);
 
 			did_something = true;
 			break;
@@ -1689,6 +1693,9 @@ void process_monsters(struct chunk *c, int minimum_energy)
 	/* Only process some things every so often */
 	bool regen = false;
 
+	/* Monsters decide what to do from their own stream of random numbers */
+	int old_stream = Rand_stream_select(RNG_MONSTER);
+
 	/* Regenerate hitpoints and mana every 100 game turns */
 	if (turn % 100 == 0)
 		regen = true;
@@ -1758,12 +1765,16 @@ void process_monsters(struct chunk *c, int minimum_energy)
 
 			/* Monster is no longer current */
 			c->mon_current = -1;
+
+			/* Its turn may have changed how it looks to the player; other
+			 * monsters only need updating if their grids' view changes,
+			 * which update_stuff() sees to */
+			if (mon->race)
+				update_mon(mon, c, false);
 		}
 	}
 
-	/* Update monster visibility after this */
-	/* XXX This may not be necessary */
-	player->upkeep->update |= PU_MONSTERS;
+	Rand_stream_select(old_stream);
 }
 
 /**
@@ -65,8 +65,9 @@ bool monster_is_destroyed(const struct monster *mon)
  */
 bool monster_passes_walls(const struct monster *mon)
 {
-	return flags_test(mon->race->flags, RF_SIZE, RF_PASS_WALL, RF_KILL_WALL,
-					  RF_SMASH_WALL, FLAG_END);
+	return rf_has(mon->race->flags, RF_PASS_WALL) ||
+		rf_has(mon->race->flags, RF_KILL_WALL) ||
+		rf_has(mon->race->flags, RF_SMASH_WALL);
 }
 
 /**
@@ -175,10 +176,7 @@ bool monster_has_spells(const struct monster *mon)
  */
 bool monster_breathes(const struct monster *mon)
 {
-	bitflag breaths[RSF_SIZE];
-	create_mon_spell_mask(breaths, RST_BREATH, RST_NONE);
-	rsf_inter(breaths, mon->race->spell_flags);
-	return rsf_is_empty(breaths) ? false : true;
+	return (mon->race->spell_types & RST_BREATH) ? true : false;
 }
 
 /**
@@ -186,10 +184,7 @@ bool monster_breathes(const struct monster *mon)
  */
 bool monster_has_innate_spells(const struct monster *mon)
 {
-	bitflag innate_spells[RSF_SIZE];
-	create_mon_spell_mask(innate_spells, RST_INNATE, RST_NONE);
-	rsf_inter(innate_spells, mon->race->spell_flags);
-	return rsf_is_empty(innate_spells) ? false : true;
+	return mon->race->num_innate > 0;
 }
 
 /**
@@ -197,11 +192,7 @@ bool monster_has_innate_spells(const struct monster *mon)
  */
 bool monster_has_non_innate_spells(const struct monster *mon)
 {
-	bitflag innate_spells[RSF_SIZE], mon_spells[RSF_SIZE];
-	create_mon_spell_mask(innate_spells, RST_INNATE, RST_NONE);
-	rsf_copy(mon_spells, mon->race->spell_flags);
-	rsf_diff(mon_spells, innate_spells);
-	return rsf_is_empty(mon_spells) ? false : true;
+	return mon->race->num_spells > mon->race->num_innate;
 }
 
 /**
@@ -209,10 +200,7 @@ bool monster_has_non_innate_spells(const struct monster *mon)
  */
 bool monster_loves_archery(const struct monster *mon)
 {
-	bitflag shooting[RSF_SIZE];
-	create_mon_spell_mask(shooting, RST_ARCHERY, RST_NONE);
-	rsf_inter(shooting, mon->race->spell_flags);
-	if (rsf_is_empty(shooting)) return false;
+	if (!(mon->race->spell_types & RST_ARCHERY)) return false;
 	return (mon->race->freq_innate < 4) ? true : false;
 }
 
@@ -311,6 +311,88 @@ bool mon_spell_is_innate(int index)
 	return mon_spell_types[index].type & (RST_INNATE);
 }
 
+/**
+ * Get the category a spell is kept under in a race's table of spells
+ */
+int mon_spell_category(int index)
+{
+	int type = mon_spell_types[index].type;
+
+	if (type & RST_BOLT) return MSC_BOLT;
+	if (type & RST_BREATH) return MSC_BREATH;
+	if (type & (RST_BALL | RST_DIRECT)) return MSC_DAMAGE;
+	if (type & RST_SUMMON) return MSC_SUMMON;
+	if (type & (RST_HEAL | RST_HEAL_OTHER)) return MSC_HEAL;
+	if (type & RST_ESCAPE) return MSC_ESCAPE;
+	return MSC_OTHER;
+}
+
+/**
+ * Build a race's table of spells from its spell flags, so that choosing a
+ * spell only looks at the spells the race has, and whole categories of them
+ * can be passed over at once.  Innate spells come first; each half is split
+ * into categories, and each category is in spell index order.
+ *
+ * \param race is the monster race whose table is built
+ */
+void mon_spell_table_build(struct monster_race *race)
+{
+	int i, pass, cat;
+
+	mem_free(race->spells);
+	race->spells = mem_zalloc(RSF_MAX * sizeof(*race->spells));
+	race->num_innate = race->num_spells = 0;
+	race->spell_types = 0;
+
+	for (pass = 0; pass < 2; pass++) {
+		for (cat = 0; cat < MSC_MAX; cat++) {
+			race->spell_cat[pass][cat] = race->num_spells;
+			for (i = rsf_next(race->spell_flags, FLAG_START); i != FLAG_END;
+				 i = rsf_next(race->spell_flags, i + 1)) {
+				if (mon_spell_is_innate(i) != (pass == 0)) continue;
+				if (mon_spell_category(i) != cat) continue;
+				race->spells[race->num_spells++] = i;
+				race->spell_types |= mon_spell_types[i].type;
+			}
+		}
+		race->spell_cat[pass][MSC_MAX] = race->num_spells;
+		if (pass == 0)
+			race->num_innate = race->num_spells;
+	}
+}
+
+/**
+ * Get the mask of all spells having any of the given types.
+ *
+ * The mask for each single type is built from mon_spell_types[] on first
+ * use, so a combination of types costs a few word-wide unions rather than a
+ * scan of the whole spell table.
+ *
+ * \param f is the flag array we're filling
+ * \param types is the spell type(s) we're looking for
+ */
+static void spell_type_mask(bitflag *f, int types)
+{
+	static bitflag masks[16][RSF_SIZE];
+	static bool built = false;
+	size_t bit;
+
+	if (!built) {
+		const struct mon_spell_info *info;
+
+		for (info = mon_spell_types; info->index < RSF_MAX; info++)
+			for (bit = 0; bit < N_ELEMENTS(masks); bit++)
+				if (info->type & (1 << bit))
+					rsf_on(masks[bit], info->index);
+		built = true;
+	}
+
+	rsf_wipe(f);
+	for (bit = 0; bit < N_ELEMENTS(masks); bit++)
+		if (types & (1 << bit))
+			rsf_union(f, masks[bit]);
+}
+
 /**
  * Test a spell bitflag for a type of spell.
  * Returns true if any desired type is among the flagset
@@ -318,15 +400,12 @@ bool mon_spell_is_innate(int index)
  * \param f is the set of spell flags we're testing
  * \param types is the spell type(s) we're looking for
  */
-bool test_spells(bitflag *f, int types)
+bool test_spells(const bitflag *f, int types)
 {
-	const struct mon_spell_info *info;
-
-	for (info = mon_spell_types; info->index < RSF_MAX; info++)
-		if (rsf_has(f, info->index) && (info->type & types))
-			return true;
+	bitflag mask[RSF_SIZE];
 
-	return false;
+	spell_type_mask(mask, types);
+	return rsf_is_inter(f, mask);
 }
 
 /**
@@ -337,68 +416,62 @@ bool test_spells(bitflag *f, int types)
  */
 void ignore_spells(bitflag *f, int types)
 {
-	const struct mon_spell_info *info;
+	bitflag mask[RSF_SIZE];
 
-	for (info = mon_spell_types; info->index < RSF_MAX; info++)
-		if (rsf_has(f, info->index) && (info->type & types))
-			rsf_off(f, info->index);
+	spell_type_mask(mask, types);
+	rsf_diff(f, mask);
 }
 
 /**
- * Turn off spells with a side effect or a proj_type that is resisted by
+ * Check whether a spell has a side effect or a proj_type that is resisted by
  * something in flags, subject to intelligence and chance.
  *
- * \param spells is the set of spells we're pruning
+ * \param index is the spell we're testing
  * \param flags is the set of object flags we're testing
  * \param pflags is the set of player flags we're testing
  * \param el is what we know about the monster's elemental resists
- * \param race is the monster type we're operating on
+ * \param mon is the monster we're operating on
  */
-void unset_spells(bitflag *spells, bitflag *flags, bitflag *pflags,
-				  struct element_info *el, const struct monster *mon)
+bool mon_spell_is_resisted(int index, bitflag *flags, bitflag *pflags,
+						   struct element_info *el,
+						   const struct monster *mon)
 {
-	const struct mon_spell_info *info;
 	bool smart = monster_is_smart(mon);
+	const struct mon_spell_info *info = &mon_spell_types[index];
+	const struct monster_spell *spell = monster_spell_by_index(index);
+	const struct effect *effect;
 
-	for (info = mon_spell_types; info->index < RSF_MAX; info++) {
-		const struct monster_spell *spell = monster_spell_by_index(info->index);
-		const struct effect *effect;
+	/* Ignore missing spells */
+	if (!spell) return false;
 
-		/* Ignore missing spells */
-		if (!spell) continue;
-		if (!rsf_has(spells, info->index)) continue;
+	/* Get the effect */
+	effect = spell->effect;
 
-		/* Get the effect */
-		effect = spell->effect;
+	/* First we test the elemental spells */
+	if (info->type & (RST_BOLT | RST_BALL | RST_BREATH)) {
+		int element = effect->subtype;
+		int learn_chance = el[element].res_level * (smart ? 50 : 25);
+		return randint0(100) < learn_chance;
+	}
 
-		/* First we test the elemental spells */
-		if (info->type & (RST_BOLT | RST_BALL | RST_BREATH)) {
-			int element = effect->subtype;
-			int learn_chance = el[element].res_level * (smart ? 50 : 25);
-			if (randint0(100) < learn_chance) {
-				rsf_off(spells, info->index);
-			}
-		} else {
-			/* Now others with resisted effects */
-			while (effect) {
-				/* Timed effects */
-				if ((smart || !one_in_(3)) &&
-						effect->index == EF_TIMED_INC &&
-						of_has(flags, timed_effects[effect->subtype].fail))
-					break;
+	/* Now others with resisted effects */
+	while (effect) {
+		/* Timed effects */
+		if ((smart || !one_in_(3)) &&
+				effect->index == EF_TIMED_INC &&
+				of_has(flags, timed_effects[effect->subtype].fail))
+			return true;
 
-				/* Mana drain */
-				if ((smart || one_in_(2)) &&
-						effect->index == EF_DRAIN_MANA &&
-						pf_has(pflags, PF_NO_MANA))
-					break;
+		/* Mana drain */
+		if ((smart || one_in_(2)) &&
+				effect->index == EF_DRAIN_MANA &&
+				pf_has(pflags, PF_NO_MANA))
+			return true;
 
-				effect = effect->next;
-			}
-			if (effect)
-				rsf_off(spells, info->index);
-		}
+		effect = effect->next;
 	}
+
+	return false;
 }
 
 /**
@@ -486,26 +559,18 @@ static int mon_spell_dam(int index, int hp, const struct monster_race *race,
  */
 void create_mon_spell_mask(bitflag *f, ...)
 {
-	const struct mon_spell_info *rs;
-	int i;
+	int i, types = RST_NONE;
 	va_list args;
 
-	rsf_wipe(f);
-
 	va_start(args, f);
 
 	/* Process each type in the va_args */
-    for (i = va_arg(args, int); i != RST_NONE; i = va_arg(args, int)) {
-		for (rs = mon_spell_types; rs->index < RSF_MAX; rs++) {
-			if (rs->type & i) {
-				rsf_on(f, rs->index);
-			}
-		}
-	}
+    for (i = va_arg(args, int); i != RST_NONE; i = va_arg(args, int))
+		types |= i;
 
 	va_end(args);
 
-	return;
+	spell_type_mask(f, types);
 }
 
 const char *mon_spell_lore_description(int index,
@@ -70,11 +70,14 @@ enum mon_spell_type {
 int breath_dam(int element, int hp);
 const struct monster_spell *monster_spell_by_index(int index);
 void do_mon_spell(int index, struct monster *mon, bool seen);
-bool test_spells(bitflag *f, int types);
+bool test_spells(const bitflag *f, int types);
 void ignore_spells(bitflag *f, int types);
-void unset_spells(bitflag *spells, bitflag *flags, bitflag *pflags,
-				  struct element_info *el, const struct monster *mon);
+bool mon_spell_is_resisted(int index, bitflag *flags, bitflag *pflags,
+						   struct element_info *el,
+						   const struct monster *mon);
 bool mon_spell_is_innate(int index);
+int mon_spell_category(int index);
+void mon_spell_table_build(struct monster_race *race);
 void create_mon_spell_mask(bitflag *f, ...);
 const char *mon_spell_lore_description(int index,
 									   const struct monster_race *race);
@@ -190,7 +190,7 @@ static void path_analyse(struct chunk *c, struct loc grid)
 	for (i = 0; i < path_n - 1; ++i) {
 		/* Forget grids which would block los */
 		if (square_iswall(player->cave, path_g[i])) {
-			sqinfo_off(square(c, path_g[i]).info, SQUARE_SEEN);
+			sqinfo_off(c, path_g[i], SQUARE_SEEN);
 			square_forget(c, path_g[i]);
 			square_light_spot(c, path_g[i]);
 		}
@@ -282,6 +282,16 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 	}
 
 	lore = get_lore(mon->race);
+
+	/* Remember how the grid looks, for update_monsters_view() */
+	if (square_isview(c, mon->grid))
+		mflag_on(mon->mflag, MFLAG_GRID_VIEW);
+	else
+		mflag_off(mon->mflag, MFLAG_GRID_VIEW);
+	if (square_isseen(c, mon->grid))
+		mflag_on(mon->mflag, MFLAG_GRID_SEEN);
+	else
+		mflag_off(mon->mflag, MFLAG_GRID_SEEN);
 	
 	/* Compute distance, or just use the current one */
 	if (full) {
@@ -369,8 +379,10 @@ void update_mon(struct monster *mon, struct chunk *c, bool full)
 	if (flag) {
 		/* Learn about the monster's mind */
 		if (telepathy_ok) {
-			flags_set(lore->flags, RF_SIZE, RF_EMPTY_MIND, RF_WEIRD_MIND,
-					  RF_SMART, RF_STUPID, FLAG_END);
+			rf_on(lore->flags, RF_EMPTY_MIND);
+			rf_on(lore->flags, RF_WEIRD_MIND);
+			rf_on(lore->flags, RF_SMART);
+			rf_on(lore->flags, RF_STUPID);
 		}
 
 		/* It was previously unseen */
@@ -461,6 +473,60 @@ void update_monsters(bool full)
 	}
 }
 
+/**
+ * Updates the monsters whose grids have come into or gone out of view, or
+ * been lit or darkened, since they were last updated; this is all that
+ * changes for monsters that haven't moved when the view is updated.
+ */
+void update_monsters_view(struct chunk *c)
+{
+	int i;
+
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+
+		if (!mon->race) continue;
+		if (square_isview(c, mon->grid) !=
+			mflag_has(mon->mflag, MFLAG_GRID_VIEW) ||
+			square_isseen(c, mon->grid) !=
+			mflag_has(mon->mflag, MFLAG_GRID_SEEN))
+			update_mon(mon, c, false);
+	}
+}
+
+/**
+ * Debugging aid: if set, update_stuff() checks after its updates that the
+ * monsters are as a full update_monsters() would leave them, and counts those
+ * that weren't in update_monsters_missed.
+ */
+bool update_monsters_debug = false;
+int update_monsters_missed = 0;
+
+/**
+ * Update all the monsters as PU_MONSTERS does, returning how many of them
+ * it changed.
+ */
+int update_monsters_check(void)
+{
+	int i, changed = 0;
+
+	for (i = 1; i < cave_monster_max(cave); i++) {
+		struct monster *mon = cave_monster(cave, i);
+		bool visible, view;
+
+		if (!mon->race) continue;
+		visible = monster_is_visible(mon);
+		view = monster_is_in_view(mon);
+
+		update_mon(mon, cave, false);
+		if (visible != monster_is_visible(mon) ||
+			view != monster_is_in_view(mon))
+			changed++;
+	}
+
+	return changed;
+}
+
 
 /**
  * Add the given object to the given monster's inventory.
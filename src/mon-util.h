@@ -29,6 +29,10 @@ struct monster_base *lookup_monster_base(const char *name);
 bool match_monster_bases(const struct monster_base *base, ...);
 void update_mon(struct monster *mon, struct chunk *c, bool full);
 void update_monsters(bool full);
+void update_monsters_view(struct chunk *c);
+extern bool update_monsters_debug;
+extern int update_monsters_missed;
+int update_monsters_check(void);
 bool monster_carry(struct chunk *c, struct monster *mon, struct object *obj);
 void monster_swap(struct loc grid1, struct loc grid2);
 void monster_wake(struct monster *mon, bool notify, int aware_chance);
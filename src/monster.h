@@ -128,6 +128,21 @@ enum
 
 #define RSF_SIZE               FLAG_SIZE(RSF_MAX)
 
+/**
+ * Categories of monster spells, in the order they are kept in a race's
+ * table of spells
+ */
+enum monster_spell_cat {
+	MSC_BOLT,
+	MSC_BREATH,
+	MSC_DAMAGE,		/* Other damaging spells: balls, beams, direct */
+	MSC_SUMMON,
+	MSC_HEAL,
+	MSC_ESCAPE,
+	MSC_OTHER,
+	MSC_MAX
+};
+
 
 /** Structures **/
 
@@ -334,6 +349,15 @@ struct monster_race {
 	bitflag flags[RF_SIZE];         /* Flags */
 	bitflag spell_flags[RSF_SIZE];  /* Spell flags */
 
+	byte *spells;			/* The spells in spell_flags, innate ones first,
+							 * and each of those halves by category */
+	byte spell_cat[2][MSC_MAX + 1];	/* Where each category starts in the
+									 * innate and other halves; the last
+									 * entry is where the half ends */
+	int num_innate;			/* Number of innate spells */
+	int num_spells;			/* Number of spells */
+	int spell_types;		/* All the types (RST_*) of the spells */
+
 	struct monster_blow *blow; /* Melee blows */
 
 	int level;				/* Level of creature */
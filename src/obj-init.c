@@ -148,7 +148,7 @@ static enum parser_error write_dummy_object_record(struct artifact *art, const c
 	dummy->base = &kb_info[dummy->tval];
 
 	/* Make the name and index */
-	my_strcpy(mod_name, format("& %s~", name), sizeof(mod_name));
+	strnfmt(mod_name, sizeof(mod_name), "& %s~", name);
 	dummy->name = string_make(mod_name);
 	dummy->kidx = z_info->k_max - 1;
 	dummy->level = art->level;
@@ -539,7 +539,7 @@ static enum parser_error parse_object_base_max_stack(struct parser *p) {
 
 static enum parser_error parse_object_base_flags(struct parser *p) {
 	struct object_base *kb;
-	char *s, *t;
+	char *s, *t, *state;
 
 	struct kb_parsedata *d = parser_priv(p);
 	assert(d);
@@ -548,7 +548,7 @@ static enum parser_error parse_object_base_flags(struct parser *p) {
 	assert(kb);
 
 	s = string_make(parser_getstr(p, "flags"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 	while (t) {
 		bool found = false;
 		if (!grab_flag(kb->flags, OF_SIZE, obj_flags, t))
@@ -559,7 +559,7 @@ static enum parser_error parse_object_base_flags(struct parser *p) {
 			found = true;
 		if (!found)
 			break;
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 	mem_free(s);
 
@@ -971,10 +971,10 @@ static enum parser_error parse_curse_combat(struct parser *p) {
 static enum parser_error parse_curse_flags(struct parser *p) {
 	struct curse *curse = parser_priv(p);
 	char *s = string_make(parser_getstr(p, "flags"));
-	char *t;
+	char *t, *state;
 	assert(curse);
 
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 	while (t) {
 		bool found = false;
 		if (!grab_flag(curse->obj->flags, OF_SIZE, obj_flags, t))
@@ -983,7 +983,7 @@ static enum parser_error parse_curse_flags(struct parser *p) {
 			found = true;
 		if (!found)
 			break;
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 	mem_free(s);
 	return t ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -992,11 +992,11 @@ static enum parser_error parse_curse_flags(struct parser *p) {
 static enum parser_error parse_curse_values(struct parser *p) {
 	struct curse *curse = parser_priv(p);
 	char *s;
-	char *t;
+	char *t, *state;
 	assert(curse);
 
 	s = string_make(parser_getstr(p, "values"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 
 	while (t) {
 		int value = 0;
@@ -1013,7 +1013,7 @@ static enum parser_error parse_curse_values(struct parser *p) {
 		if (!found)
 			break;
 
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(s);
@@ -1172,17 +1172,17 @@ static enum parser_error parse_curse_conflict(struct parser *p) {
 static enum parser_error parse_curse_conflict_flags(struct parser *p) {
 	struct curse *curse = parser_priv(p);
 	char *s = string_make(parser_getstr(p, "flags"));
-	char *t;
+	char *t, *state;
 	assert(curse);
 
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 	while (t) {
 		bool found = false;
 		if (!grab_flag(curse->conflict_flags, OF_SIZE, obj_flags, t))
 			found = true;
 		if (!found)
 			break;
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 	mem_free(s);
 	return t ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -1230,6 +1230,9 @@ static errr finish_parse_curse(struct parser *p) {
 		memcpy(&curses[count], curse, sizeof(*curse));
 		next = curse->next;
 		curses[count].next = NULL;
+		if (curses[count].obj)
+			curses[count].obj->effect =
+				effect_pack(curses[count].obj->effect);
 
 		mem_free(curse);
 	}
@@ -1248,7 +1251,7 @@ static void cleanup_curse(void)
 		mem_free(curses[idx].desc);
 		if (curses[idx].obj) {
 			mem_free(curses[idx].obj->known->effect_msg);
-			mem_free(curses[idx].obj->known);
+			object_free(curses[idx].obj->known);
 			free_effect(curses[idx].obj->effect);
 			mem_free(curses[idx].obj->effect_msg);
 			mem_free(curses[idx].obj);
@@ -1466,6 +1469,7 @@ static errr finish_parse_act(struct parser *p) {
 	for (act = parser_priv(p); act; act = next, count++) {
 		memcpy(&activations[count], act, sizeof(*act));
 		activations[count].index = count;
+		activations[count].effect = effect_pack(activations[count].effect);
 		next = act->next;
 		if (next)
 			activations[count].next = &activations[count + 1];
@@ -1614,10 +1618,10 @@ static enum parser_error parse_object_pile(struct parser *p) {
 static enum parser_error parse_object_flags(struct parser *p) {
 	struct object_kind *k = parser_priv(p);
 	char *s = string_make(parser_getstr(p, "flags"));
-	char *t;
+	char *t, *state;
 	assert(k);
 
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 	while (t) {
 		bool found = false;
 		if (!grab_flag(k->flags, OF_SIZE, obj_flags, t))
@@ -1628,7 +1632,7 @@ static enum parser_error parse_object_flags(struct parser *p) {
 			found = true;
 		if (!found)
 			break;
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 	mem_free(s);
 	return t ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -1792,11 +1796,11 @@ static enum parser_error parse_object_pval(struct parser *p) {
 static enum parser_error parse_object_values(struct parser *p) {
 	struct object_kind *k = parser_priv(p);
 	char *s;
-	char *t;
+	char *t, *state;
 	assert(k);
 
 	s = string_make(parser_getstr(p, "values"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 
 	while (t) {
 		int value = 0;
@@ -1811,7 +1815,7 @@ static enum parser_error parse_object_values(struct parser *p) {
 		if (!found)
 			break;
 
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(s);
@@ -1929,6 +1933,9 @@ static errr finish_parse_object(struct parser *p) {
 		/* Add base kind flags to kind kind flags */
 		kf_union(k_info[kidx].kind_flags, kb_info[k->tval].kind_flags);
 
+		/* Pack the effects for running */
+		k_info[kidx].effect = effect_pack(k_info[kidx].effect);
+
 		next = k->next;
 		if (kidx < z_info->k_max - 1)
 			k_info[kidx].next = &k_info[kidx + 1];
@@ -2150,14 +2157,14 @@ static enum parser_error parse_ego_time(struct parser *p) {
 static enum parser_error parse_ego_flags(struct parser *p) {
 	struct ego_item *e = parser_priv(p);
 	char *flags;
-	char *t;
+	char *t, *state;
 
 	if (!e)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	t = strtok(flags, " |");
+	t = my_strtok(flags, " |", &state);
 	while (t) {
 		bool found = false;
 		if (!grab_flag(e->flags, OF_SIZE, obj_flags, t))
@@ -2168,7 +2175,7 @@ static enum parser_error parse_ego_flags(struct parser *p) {
 			found = true;
 		if (!found)
 			break;
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 	mem_free(flags);
 	return t ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -2177,18 +2184,18 @@ static enum parser_error parse_ego_flags(struct parser *p) {
 static enum parser_error parse_ego_flags_off(struct parser *p) {
 	struct ego_item *e = parser_priv(p);
 	char *flags;
-	char *t;
+	char *t, *state;
 
 	if (!e)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	flags = string_make(parser_getstr(p, "flags"));
-	t = strtok(flags, " |");
+	t = my_strtok(flags, " |", &state);
 	while (t) {
 		if (grab_flag(e->flags_off, OF_SIZE, obj_flags, t))
 			return PARSE_ERROR_INVALID_FLAG;
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 	mem_free(flags);
 	return PARSE_ERROR_NONE;
@@ -2197,7 +2204,7 @@ static enum parser_error parse_ego_flags_off(struct parser *p) {
 static enum parser_error parse_ego_values(struct parser *p) {
 	struct ego_item *e = parser_priv(p);
 	char *s; 
-	char *t;
+	char *t, *state;
 
 	if (!e)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
@@ -2205,7 +2212,7 @@ static enum parser_error parse_ego_values(struct parser *p) {
 		return PARSE_ERROR_MISSING_FIELD;
 
 	s = string_make(parser_getstr(p, "values"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 
 	while (t) {
 		bool found = false;
@@ -2220,7 +2227,7 @@ static enum parser_error parse_ego_values(struct parser *p) {
 		if (!found)
 			break;
 
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(s);
@@ -2230,7 +2237,7 @@ static enum parser_error parse_ego_values(struct parser *p) {
 static enum parser_error parse_ego_min_val(struct parser *p) {
 	struct ego_item *e = parser_priv(p);
 	char *s; 
-	char *t;
+	char *t, *state;
 
 	if (!e)
 		return PARSE_ERROR_MISSING_RECORD_HEADER;
@@ -2238,7 +2245,7 @@ static enum parser_error parse_ego_min_val(struct parser *p) {
 		return PARSE_ERROR_MISSING_FIELD;
 
 	s = string_make(parser_getstr(p, "min_values"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 
 	while (t) {
 		bool found = false;
@@ -2247,7 +2254,7 @@ static enum parser_error parse_ego_min_val(struct parser *p) {
 		if (!found)
 			break;
 
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(s);
@@ -2369,6 +2376,7 @@ static errr finish_parse_ego(struct parser *p) {
 
 		memcpy(&e_info[eidx], e, sizeof(*e));
 		e_info[eidx].eidx = eidx;
+		e_info[eidx].effect = effect_pack(e_info[eidx].effect);
 		n = e->next;
 		if (eidx < z_info->e_max - 1)
 			e_info[eidx].next = &e_info[eidx + 1];
@@ -2530,14 +2538,14 @@ static enum parser_error parse_artifact_power(struct parser *p) {
 static enum parser_error parse_artifact_flags(struct parser *p) {
 	struct artifact *a = parser_priv(p);
 	char *s;
-	char *t;
+	char *t, *state;
 	assert(a);
 
 	if (!parser_hasval(p, "flags"))
 		return PARSE_ERROR_NONE;
 	s = string_make(parser_getstr(p, "flags"));
 
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 	while (t) {
 		bool found = false;
 		if (!grab_flag(a->flags, OF_SIZE, obj_flags, t))
@@ -2546,7 +2554,7 @@ static enum parser_error parse_artifact_flags(struct parser *p) {
 			found = true;
 		if (!found)
 			break;
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 	mem_free(s);
 	return t ? PARSE_ERROR_INVALID_FLAG : PARSE_ERROR_NONE;
@@ -2595,11 +2603,11 @@ static enum parser_error parse_artifact_msg(struct parser *p) {
 static enum parser_error parse_artifact_values(struct parser *p) {
 	struct artifact *a = parser_priv(p);
 	char *s; 
-	char *t;
+	char *t, *state;
 	assert(a);
 
 	s = string_make(parser_getstr(p, "values"));
-	t = strtok(s, " |");
+	t = my_strtok(s, " |", &state);
 
 	while (t) {
 		bool found = false;
@@ -2614,7 +2622,7 @@ static enum parser_error parse_artifact_values(struct parser *p) {
 		if (!found)
 			break;
 
-		t = strtok(NULL, " |");
+		t = my_strtok(NULL, " |", &state);
 	}
 
 	mem_free(s);
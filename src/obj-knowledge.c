@@ -1005,6 +1005,10 @@ void player_know_object(struct player *p, struct object *obj)
 	if (!obj->known) return;
 	if (obj->kind != obj->known->kind) return;
 
+	/* Knowledge of worn items feeds into the known bonuses */
+	if (object_is_equipped(p->body, obj))
+		p->upkeep->update |= (PU_BONUS);
+
 	/* Distant objects just get base properties */
 	if (obj->kind && !(obj->known->notice & OBJ_NOTICE_ASSESSED)) {
 		object_set_base_known(obj);
@@ -1160,6 +1164,7 @@ void update_player_object_knowledge(struct player *p)
 	if (cave)
 		autoinscribe_ground();
 	autoinscribe_pack();
+	p->upkeep->update |= (PU_BONUS);
 	event_signal(EVENT_INVENTORY);
 	event_signal(EVENT_EQUIPMENT);
 }
@@ -2219,6 +2224,7 @@ void object_flavor_aware(struct object *obj)
 	if (kind_is_ignored_unaware(obj->kind))
 		kind_ignore_when_aware(obj->kind);
 	player->upkeep->notice |= PN_IGNORE;
+	player->upkeep->update |= (PU_BONUS);
 
 	/* Update player objects */
 	for (obj1 = player->gear; obj1; obj1 = obj1->next)
@@ -277,12 +277,55 @@ bool pile_contains(const struct object *top, const struct object *obj)
 	return false;
 }
 
+/**
+ * Objects come from slabs of many objects at a time.  Freed objects go on a
+ * free list, linked through their next field, and are handed out again before
+ * any new slab is made; slabs are only given back at shutdown.
+ */
+#define OBJECT_SLAB_SIZE	256
+
+/* Most objects listed when some are never freed */
+#define OBJECT_LEAKS_SHOWN	20
+
+struct object_slab {
+	struct object_slab *next;
+	struct object objects[OBJECT_SLAB_SIZE];
+};
+
+static struct object_slab *object_slabs;
+static struct object *object_free_list;
+static struct object_alloc_stats object_stats;
+
 /**
  * Create a new object and return it
  */
 struct object *object_new(void)
 {
-	return mem_zalloc(sizeof(struct object));
+	struct object *obj = object_free_list;
+
+	if (!obj) {
+		struct object_slab *slab = mem_alloc(sizeof(*slab));
+		int i;
+
+		/* Put the new slab's objects on the free list, in order */
+		for (i = OBJECT_SLAB_SIZE - 1; i >= 0; i--) {
+			slab->objects[i].next = object_free_list;
+			object_free_list = &slab->objects[i];
+		}
+		slab->next = object_slabs;
+		object_slabs = slab;
+		object_stats.slabs++;
+		obj = object_free_list;
+	}
+
+	object_free_list = obj->next;
+	memset(obj, 0, sizeof(*obj));
+
+	object_stats.made++;
+	object_stats.live++;
+	if (object_stats.live > object_stats.peak)
+		object_stats.peak = object_stats.live;
+	return obj;
 }
 
 /**
@@ -295,7 +338,92 @@ void object_free(struct object *obj)
 	mem_free(obj->slays);
 	mem_free(obj->brands);
 	mem_free(obj->curses);
-	mem_free(obj);
+
+	/* Make any later use of the object stand out */
+	if (mem_flags & MEM_POISON_FREE)
+		memset(obj, 0xCD, sizeof(*obj));
+
+	obj->next = object_free_list;
+	object_free_list = obj;
+	object_stats.live--;
+}
+
+/**
+ * Get the counts of objects made and still live, and of slabs used
+ */
+void object_alloc_stats(struct object_alloc_stats *stats)
+{
+	*stats = object_stats;
+}
+
+/**
+ * Start counting the most live objects at once from now
+ */
+void object_alloc_reset_peak(void)
+{
+	object_stats.peak = object_stats.live;
+}
+
+/**
+ * Names of the object origins, for reporting leaks
+ */
+static const char *origin_names[] = {
+	#define ORIGIN(a, b, c) #a,
+	#include "list-origins.h"
+	#undef ORIGIN
+};
+
+/**
+ * Give back all the object slabs.  Every object should have been freed by
+ * now; any which weren't are reported with their type and origin, to help
+ * find where they came from, and go with the slabs.  The object kinds may
+ * be gone by now, so only what is in the objects themselves is used.
+ * \return the number of objects which were never freed
+ */
+long object_slabs_free(void)
+{
+	long leaked = object_stats.live;
+
+	if (leaked) {
+		struct object_slab *slab;
+		struct object *obj = object_free_list;
+		int i, shown = 0;
+
+		plog_fmt("%ld object%s never freed:", leaked, PLURAL(leaked));
+
+		/* Free objects are made to point back at themselves, which no
+		 * object in a pile does, so the rest stand out */
+		while (obj) {
+			struct object *next = obj->next;
+			obj->prev = obj;
+			obj = next;
+		}
+		for (slab = object_slabs; slab; slab = slab->next) {
+			for (i = 0; i < OBJECT_SLAB_SIZE; i++) {
+				obj = &slab->objects[i];
+				if (obj->prev == obj) continue;
+				if (shown++ == OBJECT_LEAKS_SHOWN) {
+					plog_fmt("  ...and %ld more", leaked - OBJECT_LEAKS_SHOWN);
+					break;
+				}
+				plog_fmt("  %s (sval %d), origin %s at depth %d",
+						 tval_find_name(obj->tval), obj->sval,
+						 obj->origin < ORIGIN_MAX ?
+						 origin_names[obj->origin] : "unknown",
+						 obj->origin_depth);
+			}
+			if (i < OBJECT_SLAB_SIZE) break;
+		}
+	}
+
+	while (object_slabs) {
+		struct object_slab *next = object_slabs->next;
+		mem_free(object_slabs);
+		object_slabs = next;
+	}
+	object_free_list = NULL;
+	memset(&object_stats, 0, sizeof(object_stats));
+	return leaked;
 }
 
 /**
@@ -36,6 +36,16 @@ typedef enum
 	OSTACK_QUIVER  = 0x20  /* Quiver */
 } object_stack_t;
 
+/**
+ * Counts kept by the object allocator
+ */
+struct object_alloc_stats {
+	long made;		/* Objects handed out by object_new() ever */
+	long live;		/* Objects not yet given back to object_free() */
+	long peak;		/* Most objects live at once */
+	int slabs;		/* Slabs of objects in use */
+};
+
 /**
  * Modes for floor scanning by scan_floor()
  */
@@ -50,6 +60,9 @@ typedef enum
 
 struct object *object_new(void);
 void object_free(struct object *obj);
+void object_alloc_stats(struct object_alloc_stats *stats);
+void object_alloc_reset_peak(void);
+long object_slabs_free(void);
 void object_delete(struct object **obj_address);
 void object_pile_free(struct object *obj);
 
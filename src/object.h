@@ -59,6 +59,7 @@ struct effect {
 	int radius;		/**< Radius of the effect (if it has one) */
 	int other;		/**< Extra parameter to be passed to the handler */
 	char *msg;		/**< Message for deth or whatever */
+	bool packed;	/**< Chain was packed into one block by effect_pack() */
 };
 
 /**
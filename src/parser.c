@@ -33,8 +33,15 @@
  * Each hook has a list of specs, which are essentially named formal parameters;
  * when we run a particular hook across a line, each spec in the hook is
  * assigned a value.
+ *
+ * Hooks are also kept in a small hash table keyed on their directive, so
+ * finding the hook for a line doesn't mean comparing against every directive.
+ * The values for a line go in an array in spec order, and string values point
+ * into the parser's copy of the line rather than being copied again.
  */
 
+#define PARSER_HOOK_HASH 64
+
 enum {
 	PARSE_T_NONE = 0,
 	PARSE_T_INT = 2,
@@ -53,7 +60,8 @@ struct parser_spec {
 };
 
 struct parser_value {
-	struct parser_spec spec;
+	const char *name;
+	int type;
 	union {
 		wchar_t cval;
 		int ival;
@@ -67,6 +75,9 @@ struct parser_hook {
 	struct parser_hook *next;
 	enum parser_error (*func)(struct parser *p);
 	char *dir;
+	u32b hash;
+	struct parser_hook *hash_next;
+	int nspecs;
 	struct parser_spec *fhead;
 	struct parser_spec *ftail;
 };
@@ -77,8 +88,11 @@ struct parser {
 	unsigned int colno;
 	char errmsg[1024];
 	struct parser_hook *hooks;
-	struct parser_value *fhead;
-	struct parser_value *ftail;
+	struct parser_hook *hook_table[PARSER_HOOK_HASH];
+	struct parser_value *vals;
+	int nvals;
+	int vals_max;
+	char *cline;
 	void *priv;
 };
 
@@ -90,26 +104,28 @@ struct parser *parser_new(void) {
 	return p;
 }
 
+static u32b hook_hash(const char *dir) {
+	u32b hash = 5381;
+	while (*dir)
+		hash = hash * 33 + (byte) *dir++;
+	return hash;
+}
+
 static struct parser_hook *findhook(struct parser *p, const char *dir) {
-	struct parser_hook *h = p->hooks;
+	u32b hash = hook_hash(dir);
+	struct parser_hook *h = p->hook_table[hash % PARSER_HOOK_HASH];
 	while (h) {
-		if (!strcmp(h->dir, dir))
+		if (h->hash == hash && !strcmp(h->dir, dir))
 			break;
-		h = h->next;
+		h = h->hash_next;
 	}
 	return h;
 }
 
 static void parser_freeold(struct parser *p) {
-	struct parser_value *v;
-	while (p->fhead) {
-		int t = p->fhead->spec.type & ~PARSE_T_OPT;
-		v = (struct parser_value *)p->fhead->spec.next;
-		if (t == PARSE_T_SYM || t == PARSE_T_STR)
-			mem_free(p->fhead->u.sval);
-		mem_free(p->fhead);
-		p->fhead = v;
-	}
+	p->nvals = 0;
+	mem_free(p->cline);
+	p->cline = NULL;
 }
 
 static bool parse_random(const char *str, random_value *bonus) {
@@ -204,7 +220,7 @@ static bool parse_random(const char *str, random_value *bonus) {
  */
 enum parser_error parser_parse(struct parser *p, const char *line) {
 	char *cline;
-	char *tok;
+	char *tok, *state;
 	struct parser_hook *h;
 	struct parser_spec *s;
 	struct parser_value *v;
@@ -217,8 +233,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 
 	p->lineno++;
 	p->colno = 1;
-	p->fhead = NULL;
-	p->ftail = NULL;
 
 	/* Ignore empty lines and comments. */
 	while (*line && (isspace(*line)))
@@ -226,11 +240,11 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!*line || *line == '#')
 		return PARSE_ERROR_NONE;
 
-	cline = string_make(line);
+	/* The line is kept until the next one, for the string values */
+	cline = p->cline = string_make(line);
 
-	tok = strtok(cline, ":");
+	tok = my_strtok(cline, ":", &state);
 	if (!tok) {
-		mem_free(cline);
 		p->error = PARSE_ERROR_MISSING_FIELD;
 		return PARSE_ERROR_MISSING_FIELD;
 	}
@@ -239,7 +253,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 	if (!h) {
 		my_strcpy(p->errmsg, tok, sizeof(p->errmsg));
 		p->error = PARSE_ERROR_UNDEFINED_DIRECTIVE;
-		mem_free(cline);
 		return PARSE_ERROR_UNDEFINED_DIRECTIVE;
 	}
 
@@ -255,39 +268,35 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		 * at all (i.e., they consume the remainder of the line) */
 		if (t == PARSE_T_INT || t == PARSE_T_SYM || t == PARSE_T_RAND ||
 			t == PARSE_T_UINT) {
-			tok = strtok(sp, ":");
+			tok = my_strtok(sp, ":", &state);
 			sp = NULL;
 		} else if (t == PARSE_T_CHAR) {
-			tok = strtok(sp, "");
+			tok = my_strtok(sp, "", &state);
 			if (tok)
 				sp = tok + 2;
 		} else {
-			tok = strtok(sp, "");
+			tok = my_strtok(sp, "", &state);
 			sp = NULL;
 		}
 		if (!tok) {
 			if (!(s->type & PARSE_T_OPT)) {
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_MISSING_FIELD;
-				mem_free(cline);
 				return PARSE_ERROR_MISSING_FIELD;
 			}
 			break;
 		}
 
-		/* Allocate a value node. */
-		v = mem_alloc(sizeof *v);
-		v->spec.next = NULL;
-		v->spec.type = s->type;
-		v->spec.name = s->name;
+		/* Take the next value slot; it only counts once it is parsed. */
+		v = &p->vals[p->nvals];
+		v->type = s->type;
+		v->name = s->name;
 
 		/* Parse out its value. */
 		if (t == PARSE_T_INT) {
 			char *z = NULL;
 			v->u.ival = strtol(tok, &z, 0);
 			if (z == tok) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -296,8 +305,6 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 			char *z = NULL;
 			v->u.uval = strtoul(tok, &z, 0);
 			if (z == tok || *tok == '-') {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_NUMBER;
 				return PARSE_ERROR_NOT_NUMBER;
@@ -305,27 +312,18 @@ enum parser_error parser_parse(struct parser *p, const char *line) {
 		} else if (t == PARSE_T_CHAR) {
 			text_mbstowcs(&v->u.cval, tok, 1);
 		} else if (t == PARSE_T_SYM || t == PARSE_T_STR) {
-			v->u.sval = string_make(tok);
+			v->u.sval = tok;
 		} else if (t == PARSE_T_RAND) {
 			if (!parse_random(tok, &v->u.rval)) {
-				mem_free(v);
-				mem_free(cline);
 				my_strcpy(p->errmsg, s->name, sizeof(p->errmsg));
 				p->error = PARSE_ERROR_NOT_RANDOM;
 				return PARSE_ERROR_NOT_RANDOM;
 			}
 		}
 
-		/* Link it into the value list. */
-		if (!p->fhead)
-			p->fhead = v;
-		else
-			p->ftail->spec.next = &v->spec;
-		p->ftail = v;
+		p->nvals++;
 	}
 
-	mem_free(cline);
-
 	p->error = h->func(p);
 	return p->error;
 }
@@ -390,11 +388,12 @@ void parser_destroy(struct parser *p) {
 		mem_free(p->hooks);
 		p->hooks = h;
 	}
+	mem_free(p->vals);
 	mem_free(p);
 }
 
 static errr parse_specs(struct parser_hook *h, char *fmt) {
-	char *name ;
+	char *name, *state;
 	char *stype = NULL;
 	int type;
 	struct parser_spec *s;
@@ -402,20 +401,21 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 	assert(h);
 	assert(fmt);
 
-	name = strtok(fmt, " ");
+	name = my_strtok(fmt, " ", &state);
 	if (!name)
 		return -EINVAL;
 	h->dir = string_make(name);
+	h->nspecs = 0;
 	h->fhead = NULL;
 	h->ftail = NULL;
 	while (name) {
 		/* Lack of a type is legal; that means we're at the end of the line. */
-		stype = strtok(NULL, " ");
+		stype = my_strtok(NULL, " ", &state);
 		if (!stype)
 			break;
 
 		/* Lack of a name, on the other hand... */
-		name = strtok(NULL, " ");
+		name = my_strtok(NULL, " ", &state);
 		if (!name) {
 			clean_specs(h);
 			return -EINVAL;
@@ -448,6 +448,7 @@ static errr parse_specs(struct parser_hook *h, char *fmt) {
 		else
 			h->fhead = s;
 		h->ftail = s;
+		h->nspecs++;
 	}
 
 	return 0;
@@ -489,6 +490,17 @@ errr parser_reg(struct parser *p, const char *fmt,
 
 	p->hooks = h;
 	mem_free(cfmt);
+
+	/* Later hooks come first in their bucket, so they supersede earlier ones */
+	h->hash = hook_hash(h->dir);
+	h->hash_next = p->hook_table[h->hash % PARSER_HOOK_HASH];
+	p->hook_table[h->hash % PARSER_HOOK_HASH] = h;
+
+	/* Make sure there is room for this hook's values */
+	if (h->nspecs > p->vals_max) {
+		p->vals_max = h->nspecs;
+		p->vals = mem_realloc(p->vals, p->vals_max * sizeof(*p->vals));
+	}
 	return 0;
 }
 
@@ -505,18 +517,19 @@ enum parser_error ignored(struct parser *p) {
  * Used to test for presence of optional values.
  */
 bool parser_hasval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name))
+	int i;
+	for (i = 0; i < p->nvals; i++) {
+		if (p->vals[i].name[0] == name[0] && !strcmp(p->vals[i].name, name))
 			return true;
 	}
 	return false;
 }
 
 static struct parser_value *parser_getval(struct parser *p, const char *name) {
-	struct parser_value *v;
-	for (v = p->fhead; v; v = (struct parser_value *)v->spec.next) {
-		if (!strcmp(v->spec.name, name)) {
+	int i;
+	for (i = 0; i < p->nvals; i++) {
+		struct parser_value *v = &p->vals[i];
+		if (v->name[0] == name[0] && !strcmp(v->name, name)) {
 			return v;
 		}
 	}
@@ -529,7 +542,7 @@ static struct parser_value *parser_getval(struct parser *p, const char *name) {
  */
 const char *parser_getsym(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_SYM);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_SYM);
 	return v->u.sval;
 }
 
@@ -538,7 +551,7 @@ const char *parser_getsym(struct parser *p, const char *name) {
  */
 int parser_getint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_INT);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_INT);
 	return v->u.ival;
 }
 
@@ -547,7 +560,7 @@ int parser_getint(struct parser *p, const char *name) {
  */
 unsigned int parser_getuint(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_UINT);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_UINT);
 	return v->u.uval;
 }
 
@@ -556,7 +569,7 @@ unsigned int parser_getuint(struct parser *p, const char *name) {
  */
 const char *parser_getstr(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_STR);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_STR);
 	return v->u.sval;
 }
 
@@ -565,7 +578,7 @@ const char *parser_getstr(struct parser *p, const char *name) {
  */
 struct random parser_getrand(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_RAND);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_RAND);
 	return v->u.rval;
 }
 
@@ -574,7 +587,7 @@ struct random parser_getrand(struct parser *p, const char *name) {
  */
 wchar_t parser_getchar(struct parser *p, const char *name) {
 	struct parser_value *v = parser_getval(p, name);
-	assert((v->spec.type & ~PARSE_T_OPT) == PARSE_T_CHAR);
+	assert((v->type & ~PARSE_T_OPT) == PARSE_T_CHAR);
 	return v->u.cval;
 }
 
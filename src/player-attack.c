@@ -673,6 +673,7 @@ void py_attack(struct player *p, struct loc grid)
 	int blows = 0;
 	bool fear = false;
 	struct monster *mon = square_monster(cave, grid);
+	int old_stream;
 
 	/* Disturb the player */
 	disturb(p, 0);
@@ -680,11 +681,17 @@ void py_attack(struct player *p, struct loc grid)
 	/* Initialize the energy used */
 	p->upkeep->energy_use = 0;
 
+	/* Fights use their own stream of random numbers */
+	old_stream = Rand_stream_select(RNG_COMBAT);
+
 	/* Player attempts a shield bash if they can, and if monster is visible
 	 * and not too pathetic */
 	if (player_has(p, PF_SHIELD_BASH) && monster_is_visible(mon) &&
 		(mon->race->level > p->lev / 2)) {
-		if (attempt_shield_bash(p, mon, &fear, &blows)) return;
+		if (attempt_shield_bash(p, mon, &fear, &blows)) {
+			Rand_stream_select(old_stream);
+			return;
+		}
 	}
 
 	/* Attack until energy runs out or enemy dies. We limit energy use to 100
@@ -696,6 +703,7 @@ void py_attack(struct player *p, struct loc grid)
 			stop) break;
 		blows++;
 	}
+	Rand_stream_select(old_stream);
 
 	/* Hack - delay fear messages */
 	if (fear && monster_is_visible(mon)) {
@@ -741,6 +749,7 @@ static void ranged_helper(struct player *p,	struct object *obj, int dir,
 
 	struct object *missile;
 	int pierce = 1;
+	int old_stream;
 
 	/* Check for target validity */
 	if ((dir == DIR_TARGET) && target_okay()) {
@@ -776,6 +785,9 @@ static void ranged_helper(struct player *p,	struct object *obj, int dir,
 	/* Hack -- Handle stuff */
 	handle_stuff(p);
 
+	/* Fights use their own stream of random numbers */
+	old_stream = Rand_stream_select(RNG_COMBAT);
+
 	/* Project along the path */
 	for (i = 0; i < path_n; ++i) {
 		struct monster *mon = NULL;
@@ -875,6 +887,7 @@ static void ranged_helper(struct player *p,	struct object *obj, int dir,
 		if (!(square_isprojectable(cave, path_g[i]))) 
 			break;
 	}
+	Rand_stream_select(old_stream);
 
 	/* Get the missile */
 	if (object_is_carried(p, obj))
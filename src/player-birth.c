@@ -386,19 +386,22 @@ void player_init(struct player *p)
 	struct player_options opts_save = p->opts;
 
 	if (p->upkeep) {
+		discard_speculative_level(p);
+
 		if (p->upkeep->inven)
 			mem_free(p->upkeep->inven);
 		if (p->upkeep->quiver)
 			mem_free(p->upkeep->quiver);
+		mem_free(p->upkeep->slot_bonus);
 		mem_free(p->upkeep);
 	}
 	if (p->timed)
 		mem_free(p->timed);
-	if (p->obj_k) {
-		mem_free(p->obj_k->brands);
-		mem_free(p->obj_k->slays);
-		mem_free(p->obj_k->curses);
-		mem_free(p->obj_k);
+	if (p->obj_k)
+		object_free(p->obj_k);
+	if (p->gear) {
+		object_pile_free(p->gear);
+		object_pile_free(p->gear_k);
 	}
 
 	/* Wipe the player */
@@ -439,7 +442,7 @@ void player_init(struct player *p)
 	p->upkeep->quiver = mem_zalloc(z_info->quiver_size *
 								   sizeof(struct object *));
 	p->timed = mem_zalloc(TMD_MAX * sizeof(s16b));
-	p->obj_k = mem_zalloc(sizeof(struct object));
+	p->obj_k = object_new();
 	p->obj_k->brands = mem_zalloc(z_info->brand_max * sizeof(bool));
 	p->obj_k->slays = mem_zalloc(z_info->slay_max * sizeof(bool));
 	p->obj_k->curses = mem_zalloc(z_info->curse_max *
@@ -1742,6 +1742,187 @@ static void calc_shapechange(struct player_state *state,
 
 }
 
+/**
+ * What one equipment slot - the object in it, and the curse objects
+ * attached to that object - adds to the player's state.
+ *
+ * Everything here is combined into the state by sums, maxima and flag
+ * unions, so the slots can be worked out separately (and remembered)
+ * and still give exactly what a single pass over the equipment would.
+ */
+struct slot_bonus {
+	bool valid;					/**< Whether a cached entry is usable */
+	const struct object *obj;	/**< The object the entry was made for */
+
+	bitflag flags[OF_SIZE];
+	int stat_add[STAT_MAX];
+	int skills[SKILL_MAX];
+	int see_infra;
+	int speed;
+	int dam_red;
+	int extra_blows;
+	int extra_shots;
+	int extra_might;
+	int extra_moves;
+	int res_level[ELEM_MAX];	/**< Best level, or -1 (below any base) */
+	bool vuln;
+	int ac;
+	int to_a;
+	int to_h;
+	int to_d;
+};
+
+/**
+ * Work out the contribution of the object in a slot and its curses
+ */
+static void calc_slot_bonus(struct player *p, int slot, struct object *obj,
+							bool known_only, struct slot_bonus *sb)
+{
+	int j, index = 0;
+	struct curse_data *curse = obj ? obj->curses : NULL;
+	bitflag f[OF_SIZE];
+
+	memset(sb, 0, sizeof(*sb));
+	for (j = 0; j < ELEM_MAX; j++)
+		sb->res_level[j] = -1;
+
+	while (obj) {
+		int dig = 0;
+
+		/* Extract the item flags */
+		if (known_only) {
+			object_flags_known(obj, f);
+		} else {
+			object_flags(obj, f);
+		}
+		of_union(sb->flags, f);
+
+		/* Apply modifiers */
+		sb->stat_add[STAT_STR] += obj->modifiers[OBJ_MOD_STR]
+			* p->obj_k->modifiers[OBJ_MOD_STR];
+		sb->stat_add[STAT_INT] += obj->modifiers[OBJ_MOD_INT]
+			* p->obj_k->modifiers[OBJ_MOD_INT];
+		sb->stat_add[STAT_WIS] += obj->modifiers[OBJ_MOD_WIS]
+			* p->obj_k->modifiers[OBJ_MOD_WIS];
+		sb->stat_add[STAT_DEX] += obj->modifiers[OBJ_MOD_DEX]
+			* p->obj_k->modifiers[OBJ_MOD_DEX];
+		sb->stat_add[STAT_CON] += obj->modifiers[OBJ_MOD_CON]
+			* p->obj_k->modifiers[OBJ_MOD_CON];
+		sb->skills[SKILL_STEALTH] += obj->modifiers[OBJ_MOD_STEALTH]
+			* p->obj_k->modifiers[OBJ_MOD_STEALTH];
+		sb->skills[SKILL_SEARCH] += (obj->modifiers[OBJ_MOD_SEARCH] * 5)
+			* p->obj_k->modifiers[OBJ_MOD_SEARCH];
+
+		sb->see_infra += obj->modifiers[OBJ_MOD_INFRA]
+			* p->obj_k->modifiers[OBJ_MOD_INFRA];
+		if (tval_is_digger(obj)) {
+			if (of_has(obj->flags, OF_DIG_1))
+				dig = 1;
+			else if (of_has(obj->flags, OF_DIG_2))
+				dig = 2;
+			else if (of_has(obj->flags, OF_DIG_3))
+				dig = 3;
+		}
+		dig += obj->modifiers[OBJ_MOD_TUNNEL]
+			* p->obj_k->modifiers[OBJ_MOD_TUNNEL];
+		sb->skills[SKILL_DIGGING] += (dig * 20);
+		sb->speed += obj->modifiers[OBJ_MOD_SPEED]
+			* p->obj_k->modifiers[OBJ_MOD_SPEED];
+		sb->dam_red += obj->modifiers[OBJ_MOD_DAM_RED]
+			* p->obj_k->modifiers[OBJ_MOD_DAM_RED];
+		sb->extra_blows += obj->modifiers[OBJ_MOD_BLOWS]
+			* p->obj_k->modifiers[OBJ_MOD_BLOWS];
+		sb->extra_shots += obj->modifiers[OBJ_MOD_SHOTS]
+			* p->obj_k->modifiers[OBJ_MOD_SHOTS];
+		sb->extra_might += obj->modifiers[OBJ_MOD_MIGHT]
+			* p->obj_k->modifiers[OBJ_MOD_MIGHT];
+		sb->extra_moves += obj->modifiers[OBJ_MOD_MOVES]
+			* p->obj_k->modifiers[OBJ_MOD_MOVES];
+
+		/* Apply element info, noting vulnerabilites for later processing */
+		for (j = 0; j < ELEM_MAX; j++) {
+			if (!known_only || obj->known->el_info[j].res_level) {
+				if (obj->el_info[j].res_level == -1)
+					sb->vuln = true;
+
+				/* OK because res_level hasn't included vulnerability yet */
+				if (obj->el_info[j].res_level > sb->res_level[j])
+					sb->res_level[j] = obj->el_info[j].res_level;
+			}
+		}
+
+		/* Apply combat bonuses */
+		sb->ac += obj->ac;
+		if (!known_only || obj->known->to_a)
+			sb->to_a += obj->to_a;
+		if (!slot_type_is(slot, EQUIP_WEAPON) &&
+			!slot_type_is(slot, EQUIP_BOW)) {
+			if (!known_only || obj->known->to_h) {
+				sb->to_h += obj->to_h;
+			}
+			if (!known_only || obj->known->to_d) {
+				sb->to_d += obj->to_d;
+			}
+		}
+
+		/* Move to any unprocessed curse object */
+		if (curse) {
+			index++;
+			obj = NULL;
+			while (index < z_info->curse_max) {
+				if (curse[index].power) {
+					obj = curses[index].obj;
+					break;
+				} else {
+					index++;
+				}
+			}
+		} else {
+			obj = NULL;
+		}
+	}
+}
+
+/**
+ * Get the remembered contribution of a slot, working it out again if the
+ * slot now holds a different object.
+ *
+ * Entries are only dropped by calc_bonuses_flush(), so anything which
+ * changes an equipped object (or the player's knowledge of it) in place
+ * must ask for PU_BONUS; timed effects, which leave the equipment alone,
+ * ask for PU_TIMED instead and keep the cache.  Hypothetical equipment,
+ * which may be made and thrown away at the same address over and over,
+ * never goes through the cache.
+ */
+static const struct slot_bonus *slot_bonus_cached(struct player *p, int slot,
+												  bool known_only)
+{
+	struct object *obj = slot_object(p, slot);
+	struct slot_bonus *sb;
+
+	if (!p->upkeep->slot_bonus)
+		p->upkeep->slot_bonus = mem_zalloc(2 * z_info->equip_slots_max *
+										   sizeof(struct slot_bonus));
+
+	sb = &p->upkeep->slot_bonus[2 * slot + (known_only ? 1 : 0)];
+	if (!sb->valid || sb->obj != obj) {
+		calc_slot_bonus(p, slot, obj, known_only, sb);
+		sb->valid = true;
+		sb->obj = obj;
+	}
+
+	return sb;
+}
+
+/**
+ * Forget all remembered equipment contributions
+ */
+void calc_bonuses_flush(struct player *p)
+{
+	mem_free(p->upkeep->slot_bonus);
+	p->upkeep->slot_bonus = NULL;
+}
+
 /**
  * Calculate the players current "state", taking into account
  * not only race/class intrinsics, but also objects being worn
@@ -1763,9 +1944,12 @@ static void calc_shapechange(struct player_state *state,
  * If known_only is true, calc_bonuses() will only use the known
  * information of objects; thus it returns what the player _knows_
  * the character state to be.
+ *
+ * If use_cache is true, each equipment slot's contribution is taken from
+ * the cache kept in the player's upkeep rather than worked out afresh.
  */
-void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
-				  bool update)
+static void calc_bonuses_aux(struct player *p, struct player_state *state,
+							 bool known_only, bool update, bool use_cache)
 {
 	int i, j, hold;
 	int extra_blows = 0;
@@ -1774,7 +1958,6 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	int extra_moves = 0;
 	struct object *launcher = equipped_item_by_slot_name(p, "shooting");
 	struct object *weapon = equipped_item_by_slot_name(p, "weapon");
-	bitflag f[OF_SIZE];
 	bitflag collect_f[OF_SIZE];
 	bool vuln[ELEM_MAX];
 
@@ -1817,104 +2000,40 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 
 	/* Analyze equipment */
 	for (i = 0; i < p->body.count; i++) {
-		int index = 0;
-		struct object *obj = slot_object(p, i);
-		struct curse_data *curse = obj ? obj->curses : NULL;
-
-		while (obj) {
-			int dig = 0;
+		struct slot_bonus uncached;
+		const struct slot_bonus *sb;
 
-			/* Extract the item flags */
-			if (known_only) {
-				object_flags_known(obj, f);
-			} else {
-				object_flags(obj, f);
-			}
-			of_union(collect_f, f);
-
-			/* Apply modifiers */
-			state->stat_add[STAT_STR] += obj->modifiers[OBJ_MOD_STR]
-				* p->obj_k->modifiers[OBJ_MOD_STR];
-			state->stat_add[STAT_INT] += obj->modifiers[OBJ_MOD_INT]
-				* p->obj_k->modifiers[OBJ_MOD_INT];
-			state->stat_add[STAT_WIS] += obj->modifiers[OBJ_MOD_WIS]
-				* p->obj_k->modifiers[OBJ_MOD_WIS];
-			state->stat_add[STAT_DEX] += obj->modifiers[OBJ_MOD_DEX]
-				* p->obj_k->modifiers[OBJ_MOD_DEX];
-			state->stat_add[STAT_CON] += obj->modifiers[OBJ_MOD_CON]
-				* p->obj_k->modifiers[OBJ_MOD_CON];
-			state->skills[SKILL_STEALTH] += obj->modifiers[OBJ_MOD_STEALTH]
-				* p->obj_k->modifiers[OBJ_MOD_STEALTH];
-			state->skills[SKILL_SEARCH] += (obj->modifiers[OBJ_MOD_SEARCH] * 5)
-				* p->obj_k->modifiers[OBJ_MOD_SEARCH];
-
-			state->see_infra += obj->modifiers[OBJ_MOD_INFRA]
-				* p->obj_k->modifiers[OBJ_MOD_INFRA];
-			if (tval_is_digger(obj)) {
-				if (of_has(obj->flags, OF_DIG_1))
-					dig = 1;
-				else if (of_has(obj->flags, OF_DIG_2))
-					dig = 2;
-				else if (of_has(obj->flags, OF_DIG_3))
-					dig = 3;
-			}
-			dig += obj->modifiers[OBJ_MOD_TUNNEL]
-				* p->obj_k->modifiers[OBJ_MOD_TUNNEL];
-			state->skills[SKILL_DIGGING] += (dig * 20);
-			state->speed += obj->modifiers[OBJ_MOD_SPEED]
-				* p->obj_k->modifiers[OBJ_MOD_SPEED];
-			state->dam_red += obj->modifiers[OBJ_MOD_DAM_RED]
-				* p->obj_k->modifiers[OBJ_MOD_DAM_RED];
-			extra_blows += obj->modifiers[OBJ_MOD_BLOWS]
-				* p->obj_k->modifiers[OBJ_MOD_BLOWS];
-			extra_shots += obj->modifiers[OBJ_MOD_SHOTS]
-				* p->obj_k->modifiers[OBJ_MOD_SHOTS];
-			extra_might += obj->modifiers[OBJ_MOD_MIGHT]
-				* p->obj_k->modifiers[OBJ_MOD_MIGHT];
-			extra_moves += obj->modifiers[OBJ_MOD_MOVES]
-				* p->obj_k->modifiers[OBJ_MOD_MOVES];
-
-			/* Apply element info, noting vulnerabilites for later processing */
-			for (j = 0; j < ELEM_MAX; j++) {
-				if (!known_only || obj->known->el_info[j].res_level) {
-					if (obj->el_info[j].res_level == -1)
-						vuln[i] = true;
-
-					/* OK because res_level hasn't included vulnerability yet */
-					if (obj->el_info[j].res_level > state->el_info[j].res_level)
-						state->el_info[j].res_level = obj->el_info[j].res_level;
-				}
-			}
+		if (use_cache) {
+			sb = slot_bonus_cached(p, i, known_only);
+		} else {
+			calc_slot_bonus(p, i, slot_object(p, i), known_only, &uncached);
+			sb = &uncached;
+		}
 
-			/* Apply combat bonuses */
-			state->ac += obj->ac;
-			if (!known_only || obj->known->to_a)
-				state->to_a += obj->to_a;
-			if (!slot_type_is(i, EQUIP_WEAPON) && !slot_type_is(i, EQUIP_BOW)) {
-				if (!known_only || obj->known->to_h) {
-					state->to_h += obj->to_h;
-				}
-				if (!known_only || obj->known->to_d) {
-					state->to_d += obj->to_d;
-				}
-			}
+		of_union(collect_f, sb->flags);
+		for (j = 0; j < STAT_MAX; j++)
+			state->stat_add[j] += sb->stat_add[j];
+		for (j = 0; j < SKILL_MAX; j++)
+			state->skills[j] += sb->skills[j];
+		state->see_infra += sb->see_infra;
+		state->speed += sb->speed;
+		state->dam_red += sb->dam_red;
+		extra_blows += sb->extra_blows;
+		extra_shots += sb->extra_shots;
+		extra_might += sb->extra_might;
+		extra_moves += sb->extra_moves;
+
+		/* Note that vulnerability is recorded by slot (sic) */
+		if (sb->vuln)
+			vuln[i] = true;
+		for (j = 0; j < ELEM_MAX; j++)
+			if (sb->res_level[j] > state->el_info[j].res_level)
+				state->el_info[j].res_level = sb->res_level[j];
 
-			/* Move to any unprocessed curse object */
-			if (curse) {
-				index++;
-				obj = NULL;
-				while (index < z_info->curse_max) {
-					if (curse[index].power) {
-						obj = curses[index].obj;
-						break;
-					} else {
-						index++;
-					}
-				}
-			} else {
-				obj = NULL;
-			}
-		}
+		state->ac += sb->ac;
+		state->to_a += sb->to_a;
+		state->to_h += sb->to_h;
+		state->to_d += sb->to_d;
 	}
 
 	/* Apply the collected flags */
@@ -2185,6 +2304,43 @@ void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 	return;
 }
 
+/**
+ * Calculate the player's current state; see calc_bonuses_aux().  If update
+ * is false the equipment may be hypothetical, so the cache isn't used.
+ *
+ * Build with BONUS_DEBUG defined to check every result against one made
+ * without the equipment cache.
+ */
+void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
+				  bool update)
+{
+#ifdef BONUS_DEBUG
+	struct player_state check;
+	s16b msp = p->msp, csp = p->csp;
+	u16b csp_frac = p->csp_frac;
+
+	memcpy(&check, state, sizeof(check));
+#endif
+
+	/* Anything pending may have changed the equipment */
+	if (p->upkeep->update & (PU_BONUS))
+		calc_bonuses_flush(p);
+
+	/* Only the real equipment is cached; see slot_bonus_cached() */
+	calc_bonuses_aux(p, state, known_only, update, update);
+
+#ifdef BONUS_DEBUG
+	/* Rerun from the same mana, since calc_mana() may have changed it */
+	p->msp = msp;
+	p->csp = csp;
+	p->csp_frac = csp_frac;
+	calc_bonuses_aux(p, &check, known_only, update, false);
+	if (memcmp(&check, state, sizeof(check)))
+		quit_fmt("Cached bonuses differ from full calculation (%s state)",
+				 known_only ? "known" : "full");
+#endif
+}
+
 /**
  * Calculate bonuses, and print various things on changes.
  */
@@ -2423,8 +2579,11 @@ void update_stuff(struct player *p)
 		update_inventory(p);
 	}
 
-	if (p->upkeep->update & (PU_BONUS)) {
-		p->upkeep->update &= ~(PU_BONUS);
+	if (p->upkeep->update & (PU_BONUS | PU_TIMED)) {
+		/* Only timed effects leave the equipment cache valid */
+		if (p->upkeep->update & (PU_BONUS))
+			calc_bonuses_flush(p);
+		p->upkeep->update &= ~(PU_BONUS | PU_TIMED);
 		update_bonuses(p);
 	}
 
@@ -2459,6 +2618,11 @@ void update_stuff(struct player *p)
 	if (p->upkeep->update & (PU_UPDATE_VIEW)) {
 		p->upkeep->update &= ~(PU_UPDATE_VIEW);
 		update_view(cave, p);
+
+		/* Unless they're all about to be updated, update the monsters whose
+		 * grids changed */
+		if (!(p->upkeep->update & (PU_DISTANCE | PU_MONSTERS)))
+			update_monsters_view(cave);
 	}
 
 	if (p->upkeep->update & (PU_DISTANCE)) {
@@ -2472,6 +2636,10 @@ void update_stuff(struct player *p)
 		update_monsters(false);
 	}
 
+	/* Check no monster was left out */
+	if (update_monsters_debug)
+		update_monsters_missed += update_monsters_check();
+
 
 	if (p->upkeep->update & (PU_PANEL)) {
 		p->upkeep->update &= ~(PU_PANEL);
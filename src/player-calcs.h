@@ -43,6 +43,7 @@
 #define PU_DISTANCE		0x00000080L	/* Update distances */
 #define PU_PANEL		0x00000100L	/* Update panel */
 #define PU_INVEN		0x00000200L	/* Update inventory */
+#define PU_TIMED		0x00000400L	/* Calculate bonuses, equipment unchanged */
 
 
 /**
@@ -108,6 +109,7 @@ void calc_inventory(struct player_upkeep *upkeep, struct object *gear,
 					struct player_body body);
 void calc_bonuses(struct player *p, struct player_state *state, bool known_only,
 				  bool update);
+void calc_bonuses_flush(struct player *p);
 void calc_digging_chances(struct player_state *state, int chances[DIGGING_MAX]);
 int calc_blows(struct player *p, const struct object *obj,
 			   struct player_state *state, int extra_blows);
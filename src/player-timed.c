@@ -264,6 +264,7 @@ static void cleanup_player_timed(void)
 		if (effect->on_decrease)
 			string_free(effect->on_decrease);
 
+		effect->grade       = NULL;
 		effect->desc        = NULL;
 		effect->on_end      = NULL;
 		effect->on_increase = NULL;
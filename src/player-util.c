@@ -98,7 +98,6 @@ bool player_get_recall_depth(struct player *p)
 
 	while (!level_ok) {
 		char *prompt = "Which level do you wish to return to (0 to cancel)? ";
-		int i;
 
 		/* Choose the level */
 		new = get_quantity(prompt, p->max_depth);
@@ -107,12 +106,7 @@ bool player_get_recall_depth(struct player *p)
 		}
 
 		/* Is that level valid? */
-		for (i = 0; i < chunk_list_max; i++) {
-			if (chunk_list[i]->depth == new) {
-				level_ok = true;
-				break;
-			}
-		}
+		level_ok = chunk_list_has_depth(new);
 		if (!level_ok) {
 			msg("You must choose a level you have previously visited.");
 		}
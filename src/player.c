@@ -418,6 +418,7 @@ static void cleanup_player(void) {
 	mem_free(player->timed);
 	mem_free(player->upkeep->quiver);
 	mem_free(player->upkeep->inven);
+	mem_free(player->upkeep->slot_bonus);
 	mem_free(player->upkeep);
 	player->upkeep = NULL;
 
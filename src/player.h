@@ -473,6 +473,9 @@ struct player_upkeep {
 	int equip_cnt;			/* Number of items in equipment */
 	int quiver_cnt;			/* Number of items in the quiver */
 	int recharge_pow;		/* Power of recharge effect */
+
+	struct slot_bonus *slot_bonus;	/* Cached equipment contributions
+									 * to bonuses; see calc_bonuses() */
 };
 
 /**
@@ -219,7 +219,7 @@ void thrust_away(struct loc centre, struct loc target, int grids_away)
 	}
 
 	/* Clear the projection mark. */
-	sqinfo_off(square(cave, grid).info, SQUARE_PROJECT);
+	sqinfo_off(cave, grid, SQUARE_PROJECT);
 }
 
 /**
@@ -637,7 +637,7 @@ bool project(struct source origin, int rad, struct loc finish,
 		blast_grid[num_grids] =  finish;
 		centre = finish;
 		distance_to_grid[num_grids] = 0;
-		sqinfo_on(square(cave, finish).info, SQUARE_PROJECT);
+		sqinfo_on(cave, finish, SQUARE_PROJECT);
 		num_grids++;
 	} else {
 		/* Start from caster */
@@ -680,13 +680,13 @@ bool project(struct source origin, int rad, struct loc finish,
 					blast_grid[num_grids].y = y;
 					blast_grid[num_grids].x = x;
 					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y)).info, SQUARE_PROJECT);
+					sqinfo_on(cave, loc(x, y), SQUARE_PROJECT);
 					num_grids++;
 				} else if (i == num_path_grids - 1) {
 					blast_grid[num_grids].y = y;
 					blast_grid[num_grids].x = x;
 					distance_to_grid[num_grids] = 0;
-					sqinfo_on(square(cave, loc(x, y)).info, SQUARE_PROJECT);
+					sqinfo_on(cave, loc(x, y), SQUARE_PROJECT);
 					num_grids++;
 				}
 
@@ -737,7 +737,7 @@ bool project(struct source origin, int rad, struct loc finish,
 		if (num_grids == 0) {
 			blast_grid[num_grids] = centre;
 			distance_to_grid[num_grids] = 0;
-			sqinfo_on(square(cave, centre).info, SQUARE_PROJECT);
+			sqinfo_on(cave, centre, SQUARE_PROJECT);
 			num_grids++;
 		}
 
@@ -818,7 +818,7 @@ bool project(struct source origin, int rad, struct loc finish,
 							blast_grid[num_grids].y = y;
 							blast_grid[num_grids].x = x;
 							distance_to_grid[num_grids] = dist_from_centre;
-							sqinfo_on(square(cave, grid).info, SQUARE_PROJECT);
+							sqinfo_on(cave, grid, SQUARE_PROJECT);
 							num_grids++;
 						}
 					}
@@ -828,7 +828,7 @@ bool project(struct source origin, int rad, struct loc finish,
 						blast_grid[num_grids].y = y;
 						blast_grid[num_grids].x = x;
 						distance_to_grid[num_grids] = dist_from_centre;
-						sqinfo_on(square(cave, grid).info, SQUARE_PROJECT);
+						sqinfo_on(cave, grid, SQUARE_PROJECT);
 						num_grids++;
 					}
 				}
@@ -997,7 +997,7 @@ bool project(struct source origin, int rad, struct loc finish,
 	/* Clear all the processing marks. */
 	for (i = 0; i < num_grids; i++) {
 		/* Clear the mark */
-		sqinfo_off(square(cave, blast_grid[i]).info, SQUARE_PROJECT);
+		sqinfo_off(cave, blast_grid[i], SQUARE_PROJECT);
 	}
 
 	/* Update stuff if needed */
@@ -19,6 +19,7 @@
 #include "angband.h"
 #include "cave.h"
 #include "game-world.h"
+#include "generate.h"
 #include "init.h"
 #include "mon-group.h"
 #include "mon-lore.h"
@@ -276,34 +277,33 @@ static void wr_trap(struct trap *trap)
 }
 
 /**
- * Write RNG state
- *
- * There were originally 64 bytes of randomizer saved. Now we only need
- * 32 + 5 bytes saved, so we'll write an extra 27 bytes at the end which won't
- * be used.
+ * Write RNG state, for each stream of the complex RNG
  */
 void wr_randomizer(void)
 {
-	int i;
+	int i, j;
 
 	/* current value for the simple RNG */
 	wr_u32b(Rand_value);
 
-	/* state index */
-	wr_u32b(state_i);
+	wr_byte(RNG_MAX);
+	for (j = 0; j < RNG_MAX; j++) {
+		struct rand_stream_state s;
 
-	/* RNG variables */
-	wr_u32b(z0);
-	wr_u32b(z1);
-	wr_u32b(z2);
+		Rand_stream_get(j, &s);
 
-	/* RNG state */
-	for (i = 0; i < RAND_DEG; i++)
-		wr_u32b(STATE[i]);
+		/* state index */
+		wr_u32b(s.state_i);
 
-	/* NULL padding */
-	for (i = 0; i < 59 - RAND_DEG; i++)
-		wr_u32b(0);
+		/* RNG variables */
+		wr_u32b(s.z0);
+		wr_u32b(s.z1);
+		wr_u32b(s.z2);
+
+		/* RNG state */
+		for (i = 0; i < RAND_DEG; i++)
+			wr_u32b(s.state[i]);
+	}
 }
 
 
@@ -777,7 +777,7 @@ static void wr_dungeon_aux(struct chunk *c)
 	wr_u16b(c->height);
 	wr_u16b(c->width);
 
-	/* Run length encoding of c->squares[y][x].info */
+	/* Run length encoding of the square flags, a flag byte at a time */
 	for (i = 0; i < SQUARE_SIZE; i++) {
 		count = 0;
 		prev_char = 0;
@@ -785,8 +785,11 @@ static void wr_dungeon_aux(struct chunk *c)
 		/* Dump for each grid */
 		for (y = 0; y < c->height; y++) {
 			for (x = 0; x < c->width; x++) {
-				/* Extract the important c->squares[y][x].info flags */
-				tmp8u = square(c, loc(x, y)).info[i];
+				bitflag info[SQUARE_SIZE];
+
+				/* Extract the important square flags */
+				sqinfo_get(c, loc(x, y), info);
+				tmp8u = info[i];
 
 				/* If the run is broken, or too full, flush it */
 				if ((tmp8u != prev_char) || (count == UCHAR_MAX)) {
@@ -986,52 +989,66 @@ void wr_traps(void)
 	wr_traps_aux(player->cave);
 }
 
-/*
- * Write the chunk list
+/**
+ * Write one chunk of the chunk list
  */
-void wr_chunks(void)
+void wr_chunk(struct chunk *c)
 {
-	int j;
+	/* Write the terrain and info */
+	wr_dungeon_aux(c);
 
-	if (player->is_dead)
-		return;
+	/* Write the objects */
+	wr_objects_aux(c);
 
-	wr_u16b(chunk_list_max);
+	/* Write the monsters */
+	wr_monsters_aux(c);
 
-	/* Now write each chunk */
-	for (j = 0; j < chunk_list_max; j++) {
-		struct chunk *c = chunk_list[j];
+	/* Write the traps */
+	wr_traps_aux(c);
 
-		/* Write the terrain and info */
-		wr_dungeon_aux(c);
+	/* Write other chunk info */
+	if (OPT(player, birth_levels_persist)) {
+		int i;
+
+		wr_string(c->name);
+		wr_s32b(c->turn);
+		wr_u16b(c->depth);
+		wr_byte(c->feeling);
+		wr_u32b(c->obj_rating);
+		wr_u32b(c->mon_rating);
+		wr_byte(c->good_item ? 1 : 0);
+		wr_u16b(c->height);
+		wr_u16b(c->width);
+		wr_u16b(c->feeling_squares);
+		for (i = 0; i < z_info->f_max + 1; i++) {
+			wr_u16b(c->feat_count[i]);
+		}
+	}
+}
 
-		/* Write the objects */
-		wr_objects_aux(c);
+/*
+ * Write the chunk list, each chunk with its name, depth and length first so
+ * it can be loaded without being rebuilt
+ */
+void wr_chunks(void)
+{
+	int j;
 
-		/* Write the monsters */
-		wr_monsters_aux(c);
+	if (player->is_dead)
+		return;
 
-		/* Write the traps */
-		wr_traps_aux(c);
+	wr_u16b(chunk_list_count());
 
-		/* Write other chunk info */
-		if (OPT(player, birth_levels_persist)) {
-			int i;
+	/* Stored chunks are already in savefile form */
+	for (j = 0; j < chunk_list_count(); j++) {
+		u32b len;
+		byte *data = chunk_list_data(j, &len);
 
-			wr_string(c->name);
-			wr_s32b(c->turn);
-			wr_u16b(c->depth);
-			wr_byte(c->feeling);
-			wr_u32b(c->obj_rating);
-			wr_u32b(c->mon_rating);
-			wr_byte(c->good_item ? 1 : 0);
-			wr_u16b(c->height);
-			wr_u16b(c->width);
-			wr_u16b(c->feeling_squares);
-			for (i = 0; i < z_info->f_max + 1; i++) {
-				wr_u16b(c->feat_count[i]);
-			}
-		}
+		wr_string(chunk_list_name(j));
+		wr_u16b(chunk_list_depth(j));
+		wr_u32b(len);
+		wr_bytes(data, len);
+		chunk_list_data_done(j, data);
 	}
 }
 
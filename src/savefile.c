@@ -17,8 +17,11 @@
  */
 #include <errno.h>
 #include "angband.h"
+#include "cave.h"
 #include "game-world.h"
 #include "init.h"
+#include "mon-make.h"
+#include "monster.h"
 #include "savefile.h"
 
 /**
@@ -103,7 +106,7 @@ static const struct {
 	u32b version;	
 } savers[] = {
 	{ "description", wr_description, 1 },
-	{ "rng", wr_randomizer, 1 },
+	{ "rng", wr_randomizer, 2 },
 	{ "options", wr_options, 1 },
 	{ "messages", wr_messages, 1 },
 	{ "monster memory", wr_monster_memory, 1 },
@@ -121,7 +124,7 @@ static const struct {
 	{ "objects", wr_objects, 1 },
 	{ "monsters", wr_monsters, 1 },
 	{ "traps", wr_traps, 1 },
-	{ "chunks", wr_chunks, 1 },
+	{ "chunks", wr_chunks, 2 },
 	{ "history", wr_history, 1 },
 };
 
@@ -130,7 +133,8 @@ static const struct {
  */
 static const struct blockinfo loaders[] = {
 	{ "description", rd_null, 1 },
-	{ "rng", rd_randomizer, 1 },
+	{ "rng", rd_randomizer_1, 1 },
+	{ "rng", rd_randomizer, 2 },
 	{ "options", rd_options, 1 },
 	{ "messages", rd_messages, 1 },
 	{ "monster memory", rd_monster_memory, 1 },
@@ -148,7 +152,8 @@ static const struct blockinfo loaders[] = {
 	{ "objects", rd_objects, 1 },	
 	{ "monsters", rd_monsters, 1 },
 	{ "traps", rd_traps, 1 },
-	{ "chunks", rd_chunks, 1 },
+	{ "chunks", rd_chunks_1, 1 },
+	{ "chunks", rd_chunks, 2 },
 	{ "history", rd_history, 1 },
 };
 
@@ -302,6 +307,11 @@ void rd_string(char *str, int max)
 	str[max - 1] = '\0';
 }
 
+void rd_bytes(byte *data, u32b len)
+{
+	while (len--) *data++ = sf_get();
+}
+
 void strip_bytes(int n)
 {
 	byte tmp8u;
@@ -313,6 +323,97 @@ void pad_bytes(int n)
 	while (n--) wr_byte(0);
 }
 
+void wr_bytes(const byte *data, u32b len)
+{
+	while (len--) sf_put(*data++);
+}
+
+
+/**
+ * ------------------------------------------------------------------------
+ * Stored chunks
+ * ------------------------------------------------------------------------ */
+
+
+/**
+ * Write a chunk into a buffer of its own, in the same form as its record in
+ * the savefile chunk list, and return the buffer and its length.  This can
+ * be called in the middle of saving; the savefile's buffer is put aside.
+ */
+byte *savefile_pack_chunk(struct chunk *c, u32b *len)
+{
+	byte *old_buffer = buffer, *data;
+	u32b old_size = buffer_size, old_pos = buffer_pos;
+	u32b old_check = buffer_check;
+
+	buffer = mem_alloc(BUFFER_INITIAL_SIZE);
+	buffer_size = BUFFER_INITIAL_SIZE;
+	buffer_pos = 0;
+	buffer_check = 0;
+
+	wr_chunk(c);
+	wr_u32b(buffer_check);
+	data = mem_realloc(buffer, buffer_pos);
+	*len = buffer_pos;
+
+	buffer = old_buffer;
+	buffer_size = old_size;
+	buffer_pos = old_pos;
+	buffer_check = old_check;
+	return data;
+}
+
+/**
+ * Rebuild a chunk from a record made by savefile_pack_chunk(); return NULL
+ * if the record is broken, so the caller can do without the level.  The
+ * record ends with the sum of its bytes, which is checked before anything is
+ * read, as reading a damaged record can go wrong in too many places.
+ */
+struct chunk *savefile_unpack_chunk(const byte *data, u32b len)
+{
+	byte *old_buffer = buffer;
+	u32b old_size = buffer_size, old_pos = buffer_pos;
+	u32b old_check = buffer_check;
+	struct chunk *c = NULL;
+	u32b check = 0, n;
+
+	if (len < 4) return NULL;
+	len -= 4;
+	for (n = 0; n < len; n++)
+		check += data[n];
+	if (check != (data[len] | (data[len + 1] << 8) | (data[len + 2] << 16) |
+				  ((u32b) data[len + 3] << 24)))
+		return NULL;
+
+	buffer = (byte *) data;
+	buffer_size = len;
+	buffer_pos = 0;
+	buffer_check = 0;
+
+	if (rd_packed_chunk(&c) || (buffer_pos != len)) {
+		if (c) {
+			wipe_mon_list(c, player);
+			cave_free(c);
+			c = NULL;
+		}
+	} else {
+		int i;
+
+		/* The monsters were counted while their level was stored */
+		for (i = 1; i < cave_monster_max(c); i++) {
+			struct monster *mon = cave_monster(c, i);
+			if (mon->race)
+				mon->race->cur_num--;
+		}
+	}
+
+	buffer = old_buffer;
+	buffer_size = old_size;
+	buffer_pos = old_pos;
+	buffer_check = old_check;
+	return c;
+}
+
 
 /**
  * ------------------------------------------------------------------------
@@ -626,6 +727,10 @@ bool savefile_load(const char *path, bool cheat_death)
 		return false;
 	}
 
+	/* A level built ahead of time belongs to the game being replaced */
+	if (player && player->upkeep)
+		discard_speculative_level(player);
+
 	ok = try_load(f, loaders);
 	file_close(f);
 
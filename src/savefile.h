@@ -42,6 +42,13 @@ bool savefile_save(const char *path);
  */
 bool savefile_load(const char *path, bool cheat_death);
 
+/**
+ * Turn a chunk into a savefile record and back, for storing inactive levels
+ */
+struct chunk;
+byte *savefile_pack_chunk(struct chunk *c, u32b *len);
+struct chunk *savefile_unpack_chunk(const byte *data, u32b len);
+
 /**
  * Try to get a description for this savefile.
  */
@@ -65,6 +72,7 @@ void wr_u32b(u32b v);
 void wr_s32b(s32b v);
 void wr_string(const char *str);
 void pad_bytes(int n);
+void wr_bytes(const byte *data, u32b len);
 
 /* Reading bits */
 void rd_byte(byte *ip);
@@ -73,11 +81,13 @@ void rd_s16b(s16b *ip);
 void rd_u32b(u32b *ip);
 void rd_s32b(s32b *ip);
 void rd_string(char *str, int max);
+void rd_bytes(byte *data, u32b len);
 void strip_bytes(int n);
 
 
 
 /* load.c */
+int rd_randomizer_1(void);
 int rd_randomizer(void);
 int rd_options(void);
 int rd_messages(void);
@@ -93,7 +103,9 @@ int rd_player_spells(void);
 int rd_gear(void);
 int rd_stores(void);
 int rd_dungeon(void);
+int rd_chunks_1(void);
 int rd_chunks(void);
+int rd_packed_chunk(struct chunk **c);
 int rd_objects(void);
 int rd_monsters(void);
 int rd_monster_groups(void);
@@ -120,6 +132,7 @@ void wr_gear(void);
 void wr_stores(void);
 void wr_dungeon(void);
 void wr_chunks(void);
+void wr_chunk(struct chunk *c);
 void wr_objects(void);
 void wr_monsters(void);
 void wr_monster_groups(void);
@@ -1278,10 +1278,15 @@ static struct object *store_create_item(struct store *store,
  */
 static void store_maint(struct store *s)
 {
+	int old_stream;
+
 	/* Ignore home */
 	if (s->sidx == STORE_HOME)
 		return;
 
+	/* Stock comes from its own stream of random numbers */
+	old_stream = Rand_stream_select(RNG_STORE);
+
 	/* Destroy crappy black market items */
 	if (s->sidx == STORE_B_MARKET) {
 		struct object *obj = s->stock;
@@ -1389,6 +1394,8 @@ static void store_maint(struct store *s)
 			quit_fmt("Unable to (re-)stock store %d. Please report this bug",
 					 s->sidx + 1);
 	}
+
+	Rand_stream_select(old_stream);
 }
 
 /**
@@ -1459,11 +1466,13 @@ static struct owner *store_choose_owner(struct store *s) {
 void store_shuffle(struct store *store)
 {
 	struct owner *o = store->owner;
+	int old_stream = Rand_stream_select(RNG_STORE);
 
 	while (o == store->owner)
 	    o = store_choose_owner(store);
 
 	store->owner = o;
+	Rand_stream_select(old_stream);
 }
 
 
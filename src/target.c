@@ -188,6 +188,24 @@ bool target_is_set(void)
 	return target_set;
 }
 
+/**
+ * Get the whole of the target, and whether it is set
+ */
+bool target_get_state(struct target *t)
+{
+	*t = target;
+	return target_set;
+}
+
+/**
+ * Put the target back as target_get_state() gave it
+ */
+void target_set_state(const struct target *t, bool set)
+{
+	target = *t;
+	target_set = set;
+}
+
 /**
  * Sorting hook -- comp function -- by "distance to player"
  *
@@ -0,0 +1,135 @@
+/* cave/bench */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-util.h"
+#include "player.h"
+#include "project.h"
+#include "z-rand.h"
+
+/* Depth of the level the timings are taken on */
+#define BENCH_DEPTH 20
+
+/* Empty floor grids to look between and stand on */
+#define BENCH_GRIDS 64
+static struct loc grids[BENCH_GRIDS];
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	int i;
+
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	/* The same level, and the same grids on it, every time */
+	Rand_quick = false;
+	Rand_state_init(0x5eed);
+	player->depth = BENCH_DEPTH;
+	prepare_next_level(&cave, player);
+	on_new_level();
+	for (i = 0; i < BENCH_GRIDS; i++)
+		if (!cave_find(cave, &grids[i], square_isempty)) return 1;
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+int bench_distance(void *state, int iters) {
+	long total = 0;
+	int i;
+
+	for (i = 0; i < iters; i++)
+		total += distance(grids[i % BENCH_GRIDS],
+						  grids[(i * 7 + 3) % BENCH_GRIDS]);
+	require(total >= 0);
+	return 0;
+}
+
+int bench_los(void *state, int iters) {
+	int i, seen = 0;
+
+	for (i = 0; i < iters; i++)
+		if (los(cave, grids[i % BENCH_GRIDS],
+				grids[(i * 7 + 3) % BENCH_GRIDS]))
+			seen++;
+	require(seen <= iters);
+	return 0;
+}
+
+int bench_project_path(void *state, int iters) {
+	struct loc path[256];
+	int i;
+
+	for (i = 0; i < iters; i++) {
+		int n = project_path(path, z_info->max_range, grids[i % BENCH_GRIDS],
+							 grids[(i * 7 + 3) % BENCH_GRIDS], PROJECT_NONE);
+
+		require(n >= 0 && n <= z_info->max_range);
+	}
+	return 0;
+}
+
+int bench_make_noise(void *state, int iters) {
+	int i, heard = 0;
+
+	for (i = 0; i < iters; i++)
+		make_noise(player);
+	for (i = 0; i < BENCH_GRIDS; i++)
+		if (cave->noise.grids[grids[i].y][grids[i].x]) heard++;
+	require(heard > 0);
+	return 0;
+}
+
+/**
+ * Recompute the view from a different grid each time, as walking about does
+ */
+int bench_update_view(void *state, int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++) {
+		monster_swap(player->grid, grids[i % BENCH_GRIDS]);
+		update_view(cave, player);
+	}
+	require(square_isview(cave, player->grid));
+	return 0;
+}
+
+const char *suite_name = "cave/bench";
+struct test tests[] = {
+	{ "distance", BENCH(bench_distance) },
+	{ "los", BENCH(bench_los) },
+	{ "project_path", BENCH(bench_project_path) },
+	{ "make_noise", BENCH(bench_make_noise) },
+	{ "update_view", BENCH(bench_update_view) },
+	{ NULL, NULL }
+};
@@ -0,0 +1,191 @@
+/* game/cavern.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "generate.h"
+#include "init.h"
+#include "player.h"
+#include "z-rand.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	Rand_quick = false;
+	Rand_state_init(0x5eed);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Mark the floors reachable from a grid in the given number of directions
+ * (4 for north, south, east or west, 8 to add the diagonals), and count them
+ */
+static int flood_floors(struct chunk *c, struct loc start, int dirs,
+						bool *seen) {
+	int size = c->height * c->width, head = 0, tail = 0, count = 0;
+	int *queue = mem_zalloc(size * sizeof(int));
+
+	memset(seen, 0, size * sizeof(bool));
+	queue[tail++] = grid_to_i(start, c->width);
+	seen[queue[0]] = true;
+	while (head < tail) {
+		struct loc grid;
+		int d;
+
+		i_to_grid(queue[head++], c->width, &grid);
+		count++;
+		for (d = 0; d < dirs; d++) {
+			struct loc next = loc_sum(grid, ddgrid_ddd[d]);
+			int i = grid_to_i(next, c->width);
+
+			if (!square_in_bounds(c, next) || seen[i]) continue;
+			if (!square_isfloor(c, next)) continue;
+			seen[i] = true;
+			queue[tail++] = i;
+		}
+	}
+
+	mem_free(queue);
+	return count;
+}
+
+int test_shape(void *state) {
+	int n;
+
+	for (n = 0; n < 10; n++) {
+		struct chunk *c = cavern_chunk(30, 50, 120);
+		bool *seen;
+		struct loc grid, first = loc(-1, -1);
+		int floors = 0;
+
+		if (!c) continue;
+		for (grid.y = 0; grid.y < c->height; grid.y++) {
+			for (grid.x = 0; grid.x < c->width; grid.x++) {
+				bool edge = !square_in_bounds_fully(c, grid);
+
+				/* Only rock and floor, with rock all round the edge */
+				if (square_isfloor(c, grid)) {
+					require(!edge);
+					require(!square_iswall_solid(c, grid));
+					if (!floors++) first = grid;
+				} else {
+					require(square_isgranite(c, grid));
+				}
+				if (edge) require(square_iswall_solid(c, grid));
+			}
+		}
+
+		/* The feature counts agree, and the cavern is all one piece */
+		eq(c->feat_count[FEAT_FLOOR], floors);
+		eq(c->feat_count[FEAT_GRANITE], c->height * c->width - floors);
+		require(floors > 0);
+		seen = mem_zalloc(c->height * c->width * sizeof(bool));
+		eq(flood_floors(c, first, 4, seen), floors);
+		mem_free(seen);
+		cave_free(c);
+	}
+	ok;
+}
+
+int test_regions(void *state) {
+	int n, dirs;
+
+	for (n = 0; n < 20; n++) {
+		struct chunk *c = cave_new(20 + n, 40 + 3 * n);
+		int size = c->height * c->width;
+		bool *seen = mem_zalloc(size * sizeof(bool));
+		struct loc grid;
+
+		/* Scatter floors thickly enough to give some big, ragged areas */
+		for (grid.y = 0; grid.y < c->height; grid.y++)
+			for (grid.x = 0; grid.x < c->width; grid.x++)
+				square_set_feat(c, grid, randint0(100) < 55 ?
+								FEAT_FLOOR : FEAT_GRANITE);
+
+		for (dirs = 4; dirs <= 8; dirs += 4) {
+			struct cave_regions *r = cave_regions_new(c, square_isfloor,
+													  dirs == 8);
+			int next = 1;
+
+			for (grid.y = 0; grid.y < c->height; grid.y++) {
+				for (grid.x = 0; grid.x < c->width; grid.x++) {
+					int label = cave_region(r, grid);
+					struct loc other;
+
+					/* Only floors are labelled */
+					if (!square_isfloor(c, grid)) {
+						eq(label, 0);
+						continue;
+					}
+
+					/* Regions are numbered as they are first met */
+					require(label > 0 && label <= next);
+					if (label < next) continue;
+					next++;
+
+					/* A new region holds exactly what a flood fill reaches */
+					eq(flood_floors(c, grid, dirs, seen), r->size[label]);
+					for (other.y = 0; other.y < c->height; other.y++)
+						for (other.x = 0; other.x < c->width; other.x++)
+							eq(cave_region(r, other) == label,
+							   seen[grid_to_i(other, c->width)]);
+				}
+			}
+			eq(r->count, next - 1);
+			cave_regions_free(r);
+		}
+
+		mem_free(seen);
+		cave_free(c);
+	}
+	ok;
+}
+
+int test_find(void *state) {
+	int n;
+
+	for (n = 0; n < 6; n++) {
+		struct chunk *c = cave_new(10 + 10 * (n % 3), 30 + 20 * (n % 3));
+		struct loc grid, floor = loc(randint1(c->width - 2),
+									 randint1(c->height - 2));
+
+		/* A lone floor is always found, however the squares are shuffled */
+		for (grid.y = 0; grid.y < c->height; grid.y++)
+			for (grid.x = 0; grid.x < c->width; grid.x++)
+				square_set_feat(c, grid, FEAT_GRANITE);
+		square_set_feat(c, floor, FEAT_FLOOR);
+		require(cave_find(c, &grid, square_isfloor));
+		require(loc_eq(grid, floor));
+
+		/* Without one, every square is tried and the search fails */
+		square_set_feat(c, floor, FEAT_GRANITE);
+		require(!cave_find(c, &grid, square_isfloor));
+		cave_free(c);
+	}
+	ok;
+}
+
+const char *suite_name = "game/cavern";
+struct test tests[] = {
+	{ "shape", test_shape },
+	{ "regions", test_regions },
+	{ "find", test_find },
+	{ NULL, NULL }
+};
@@ -0,0 +1,140 @@
+/* game/effect.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "effects.h"
+#include "game-world.h"
+#include "init.h"
+#include "obj-tval.h"
+#include "obj-util.h"
+#include "player.h"
+#include "player-spell.h"
+#include "source.h"
+#include "trap.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a mage and put them in the town */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 1);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	prepare_next_level(&cave, player);
+	on_new_level();
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Check that an effect chain is laid out in order in one block
+ */
+static bool chain_packed(const struct effect *effect)
+{
+	if (!effect || !effect->next) return true;
+	if (!effect->packed) return false;
+	for (; effect->next; effect++)
+		if (effect->next != effect + 1 || !effect->next->packed)
+			return false;
+	return true;
+}
+
+int test_packed(void *state) {
+	int i;
+
+	for (i = 0; i < z_info->k_max; i++)
+		require(chain_packed(k_info[i].effect));
+	for (i = 0; i < z_info->act_max; i++)
+		require(chain_packed(activations[i].effect));
+	for (i = 0; i < z_info->trap_max; i++) {
+		require(chain_packed(trap_info[i].effect));
+		require(chain_packed(trap_info[i].effect_xtra));
+	}
+	ok;
+}
+
+/**
+ * Get the effect of an object kind by tval and name
+ */
+static struct effect *kind_effect(int tval, const char *name)
+{
+	struct object_kind *kind = lookup_kind(tval, lookup_sval(tval, name));
+	return kind ? kind->effect : NULL;
+}
+
+/**
+ * Run an effect over and over
+ */
+static int run_effect(struct effect *effect, int iters)
+{
+	bool ident;
+	int i;
+
+	notnull(effect);
+	for (i = 0; i < iters; i++) {
+		ident = false;
+		effect_do(effect, source_player(), NULL, &ident, true, DIR_N, 0, 0);
+	}
+	eq(player->is_dead, false);
+	return 0;
+}
+
+int bench_staff(void *state, int iters) {
+	return run_effect(kind_effect(TV_STAFF, "Cure Light Wounds"), iters);
+}
+
+int bench_wand(void *state, int iters) {
+	return run_effect(kind_effect(TV_WAND, "Stinking Cloud"), iters);
+}
+
+int bench_spell(void *state, int iters) {
+	notnull(spell_by_index(0));
+	return run_effect(spell_by_index(0)->effect, iters);
+}
+
+/* Simple effects get their dice from a string each time */
+int bench_simple(void *state, int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++)
+		effect_simple(EF_HEAL_HP, source_player(), "15+1d10", 0, 0, 0, 0, 0,
+					  NULL);
+	eq(player->is_dead, false);
+	return 0;
+}
+
+const char *suite_name = "game/effect";
+struct test tests[] = {
+	{ "packed", test_packed },
+	{ "bench_staff", BENCH(bench_staff) },
+	{ "bench_wand", BENCH(bench_wand) },
+	{ "bench_spell", BENCH(bench_spell) },
+	{ "bench_simple", BENCH(bench_simple) },
+	{ NULL, NULL }
+};
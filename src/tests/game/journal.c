@@ -0,0 +1,166 @@
+/* game/journal.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "cmd-journal.h"
+#include "game-world.h"
+#include "init.h"
+#include "player.h"
+#include "z-file.h"
+#include "z-util.h"
+#include "z-virt.h"
+
+#define TEST_JOURNAL "Test-journal"
+
+/* Times the game asks for commands while the journal is recorded */
+#define JOURNAL_FILLS 300
+
+static int fills;
+static u32b final_hash;
+static s32b final_turn;
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character and put them in the town */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	player->upkeep->autosave = false;
+	prepare_next_level(&cave, player);
+	on_new_level();
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete(TEST_JOURNAL);
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Stand in for the UI: go down the stairs, then wander about, sometimes
+ * asking for a few turns at once
+ */
+static errr scripted_get_cmd(cmd_context c)
+{
+	static const int dirs[] = { 2, 6, 6, 8, 3, 4, 7, 9, 1, 2, 8, 4 };
+
+	if (!fills++) {
+		cmdq_push(CMD_GO_DOWN);
+	} else if (!(fills % 7)) {
+		cmdq_push_repeat(CMD_HOLD, 3);
+	} else {
+		cmdq_push(CMD_WALK);
+		cmd_set_arg_direction(cmdq_peek(), "direction",
+							  dirs[fills % N_ELEMENTS(dirs)]);
+	}
+	return 0;
+}
+
+int test_record(void *state) {
+	errr (*old_hook)(cmd_context c) = cmd_get_hook;
+	s32b start = turn;
+	bool opened;
+
+	square_set_feat(cave, player->grid, FEAT_MORE);
+	cmd_get_hook = scripted_get_cmd;
+
+	opened = journal_open(TEST_JOURNAL);
+	require(opened);
+	require(journal_recording());
+	while (fills < JOURNAL_FILLS && !player->is_dead &&
+		   player->upkeep->playing) {
+		cmdq_fill(CMD_GAME);
+		run_game_loop();
+	}
+	final_hash = journal_state_hash();
+	final_turn = turn;
+	journal_close();
+
+	cmd_get_hook = old_hook;
+	require(!journal_recording());
+	require(player->depth > 0);
+	require(turn > start);
+	ok;
+}
+
+int test_replay(void *state) {
+	struct journal_report report;
+	bool replayed;
+	u32b hash;
+
+	/* Replaying puts the game back as it was, and plays it out again */
+	replayed = journal_replay(TEST_JOURNAL, &report);
+	if (!replayed) printf("%s\n", report.error);
+	require(replayed);
+	require(!journal_replaying());
+	eq(report.passed, true);
+	eq(report.commands, (u32b) fills);
+	eq(report.runs, (u32b) fills);
+	require(report.checkpoints > 1);
+	require(report.turns > 0);
+	eq(turn, final_turn);
+	hash = journal_state_hash();
+	eq(hash, final_hash);
+	ok;
+}
+
+int test_tamper(void *state) {
+	struct journal_report report;
+	ang_file *f = file_open(TEST_JOURNAL, MODE_READ, FTYPE_RAW);
+	char *buf = mem_alloc(1 << 20);
+	int len;
+	bool replayed;
+	const char *why;
+
+	/* Spoil the hash in the last checkpoint, just before the end */
+	notnull(f);
+	len = file_read(f, buf, 1 << 20);
+	file_close(f);
+	require(len > 6);
+	eq(buf[len - 1], 'E');
+	buf[len - 2] ^= 0x5a;
+	f = file_open(TEST_JOURNAL, MODE_WRITE, FTYPE_RAW);
+	notnull(f);
+	require(file_write(f, buf, len));
+	file_close(f);
+	mem_free(buf);
+
+	replayed = journal_replay(TEST_JOURNAL, &report);
+	require(!replayed);
+	eq(report.passed, false);
+	why = strstr(report.error, "doesn't match");
+	notnull(why);
+	ok;
+}
+
+const char *suite_name = "game/journal";
+struct test tests[] = {
+	{ "record", test_record },
+	{ "replay", test_replay },
+	{ "tamper", test_tamper },
+	{ NULL, NULL }
+};
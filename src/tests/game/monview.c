@@ -0,0 +1,104 @@
+/* game/monview.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "mon-util.h"
+#include "monster.h"
+#include "player.h"
+#include "z-util.h"
+
+/* Player turns to take on each level */
+#define TURNS 200
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Wander about a level, checking that the monsters always look as they
+ * would after a full update
+ */
+static int wander(int depth) {
+	int i;
+
+	player->depth = depth;
+	prepare_next_level(&cave, player);
+	on_new_level();
+	update_monsters_debug = true;
+	update_monsters_missed = 0;
+
+	for (i = 0; i < TURNS && !player->is_dead; i++) {
+		/* Keep the player going */
+		player->chp = player->mhp;
+
+		if (i % 3) {
+			cmdq_push(CMD_WALK);
+			cmd_set_arg_direction(cmdq_peek(), "direction",
+								  ddd[randint0(8)]);
+		} else {
+			cmdq_push(CMD_HOLD);
+		}
+		run_game_loop();
+		if (player->depth != depth) break;
+	}
+
+	update_monsters_debug = false;
+	return update_monsters_missed;
+}
+
+int test_town(void *state) {
+	int missed = wander(0);
+	eq(missed, 0);
+	ok;
+}
+
+int test_dungeon(void *state) {
+	int missed = wander(5);
+	eq(missed, 0);
+	missed = wander(15);
+	eq(missed, 0);
+	ok;
+}
+
+const char *suite_name = "game/monview";
+struct test tests[] = {
+	{ "town", test_town },
+	{ "dungeon", test_dungeon },
+	{ NULL, NULL }
+};
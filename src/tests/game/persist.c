@@ -0,0 +1,299 @@
+/* game/persist.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "generate.h"
+#include "init.h"
+#include "message.h"
+#include "monster.h"
+#include "player.h"
+#include "savefile.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game, with somewhere to spill stored levels */
+	set_file_paths();
+	create_needed_dirs();
+	init_angband();
+
+	/* Make a character who keeps their levels, and put them in the town */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	OPT(player, birth_levels_persist) = true;
+	prepare_next_level(&cave, player);
+	on_new_level();
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete("Test-persist");
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Total of the live monster counts of all races
+ */
+static int total_cur_num(void) {
+	int i, n = 0;
+
+	for (i = 1; i < z_info->r_max; i++)
+		n += r_info[i].cur_num;
+
+	return n;
+}
+
+/**
+ * Something to tell levels apart by: their terrain, monsters and objects
+ */
+static u32b level_print(struct chunk *c) {
+	struct loc grid;
+	u32b print = c->height * 256 + c->width;
+	int i;
+
+	for (grid.y = 0; grid.y < c->height; grid.y++)
+		for (grid.x = 0; grid.x < c->width; grid.x++)
+			print = print * 31 + square(c, grid).feat;
+	for (i = 1; i < cave_monster_max(c); i++) {
+		struct monster *mon = cave_monster(c, i);
+		if (mon->race)
+			print = print * 31 + mon->race->ridx + mon->grid.x;
+	}
+	for (i = 1; i < c->obj_max; i++)
+		if (c->objects[i])
+			print = print * 31 + c->objects[i]->kind->kidx;
+
+	return print;
+}
+
+/**
+ * Where the stored levels go when they are spilled, and how much is there
+ */
+static void spill_path(char *path, size_t len) {
+	char name[80];
+
+	player_safe_name(name, sizeof(name), player->full_name, true);
+	my_strcat(name, ".levels", sizeof(name));
+	path_build(path, len, ANGBAND_DIR_SAVE, name);
+}
+
+static long spill_size(const char *path) {
+	ang_file *f = file_open(path, MODE_READ, FTYPE_RAW);
+	char buf[4096];
+	long size = 0;
+	int n;
+
+	if (!f) return 0;
+	while ((n = file_read(f, buf, sizeof(buf))) > 0)
+		size += n;
+	file_close(f);
+	return size;
+}
+
+static void take_stairs(bool down) {
+	square_set_feat(cave, player->grid, down ? FEAT_MORE : FEAT_LESS);
+	cmdq_push(down ? CMD_GO_DOWN : CMD_GO_UP);
+	run_game_loop();
+}
+
+int test_store(void *state) {
+	char *name = level_by_depth(1)->name;
+	struct chunk *town, *stored;
+	u32b print;
+
+	/* Leave the town, and come back to it */
+	take_stairs(true);
+	eq(player->depth, 1);
+	eq(chunk_list_count(), 2);
+	require(chunk_list_memory() > 0);
+	town = chunk_find_name("Town");
+	notnull(town);
+	eq(total_cur_num(), cave_monster_count(cave) + cave_monster_count(town));
+	print = level_print(cave);
+
+	take_stairs(false);
+	eq(player->depth, 0);
+	eq(chunk_list_count(), 2);
+	require(chunk_list_has_depth(1));
+	require(!chunk_list_has_depth(0));
+
+	/* The stored level can be looked at, and is what was left */
+	stored = chunk_find_name(name);
+	notnull(stored);
+	eq(level_print(stored), print);
+	eq(total_cur_num(), cave_monster_count(cave) +
+	   cave_monster_count(stored));
+	chunk_list_pack();
+
+	/* Make it go out to disk; it can be looked for without reading it in */
+	chunk_list_set_memory(1);
+	eq(chunk_list_memory(), 0);
+	require(chunk_exists_name(name));
+	require(!chunk_exists_name("Town"));
+	require(chunk_exists_adjacent(player, false));
+	require(!chunk_exists_adjacent(player, true));
+	eq(chunk_list_memory(), 0);
+
+	/* Go back to it */
+	take_stairs(true);
+	eq(player->depth, 1);
+	eq(level_print(cave), print);
+	town = chunk_find_name("Town");
+	notnull(town);
+	eq(total_cur_num(), cave_monster_count(cave) + cave_monster_count(town));
+	chunk_list_pack();
+	chunk_list_set_memory(0);
+	ok;
+}
+
+int test_save(void *state) {
+	char *name = level_by_depth(1)->name;
+	u32b print;
+	int i;
+
+	/* A spilled level saves and loads like any other */
+	take_stairs(false);
+	eq(player->depth, 0);
+	print = level_print(chunk_find_name(name));
+	chunk_list_pack();
+	chunk_list_set_memory(1);
+	eq(savefile_save("Test-persist"), true);
+	chunk_list_set_memory(0);
+
+	eq(savefile_load("Test-persist", false), true);
+	eq(player->depth, 0);
+	eq(chunk_list_count(), 2);
+	i = streq(chunk_list_name(0), name) ? 0 : 1;
+	require(streq(chunk_list_name(i), name));
+	eq(chunk_list_depth(i), 1);
+
+	/* Loading leaves it as a record, only rebuilt when it is wanted */
+	require(chunk_list_memory() > 0);
+	eq(level_print(chunk_find_name(name)), print);
+	chunk_list_pack();
+
+	/* An untouched level saves as it was loaded */
+	eq(savefile_save("Test-persist"), true);
+	eq(savefile_load("Test-persist", false), true);
+	eq(level_print(chunk_find_name(name)), print);
+	chunk_list_pack();
+	ok;
+}
+
+int test_reclaim(void *state) {
+	char path[1024];
+	long size;
+	int i;
+
+	/* Going back and forth leaves the records of the levels gone back to
+	 * dead in the spill file, which mustn't just keep growing */
+	eq(player->depth, 0);
+	chunk_list_set_memory(1);
+	spill_path(path, sizeof(path));
+	take_stairs(true);
+	take_stairs(false);
+	size = spill_size(path);
+	require(size > 0);
+	for (i = 0; i < 10; i++) {
+		take_stairs(true);
+		take_stairs(false);
+	}
+	eq(player->depth, 0);
+	require(spill_size(path) <= 3 * size);
+
+	/* The spilled levels are still good */
+	notnull(chunk_find_name(level_by_depth(1)->name));
+	chunk_list_pack();
+	chunk_list_set_memory(0);
+	ok;
+}
+
+int test_broken(void *state) {
+	char *name = level_by_depth(1)->name;
+	char known_name[80], path[1024];
+	int cur_num = total_cur_num();
+	bool warned = false;
+	int i;
+	byte *data;
+	u32b len;
+	ang_file *f;
+
+	/* A cut short or overlong record gives nothing, and counts nothing */
+	data = savefile_pack_chunk(cave, &len);
+	null(savefile_unpack_chunk(data, len / 2));
+	eq(total_cur_num(), cur_num);
+	data = mem_realloc(data, len + 1);
+	data[len] = 0;
+	null(savefile_unpack_chunk(data, len + 1));
+	eq(total_cur_num(), cur_num);
+	mem_free(data);
+
+	/* A stored level which can't be read back is made anew */
+	eq(player->depth, 0);
+	require(chunk_exists_name(name));
+	chunk_list_set_memory(1);
+	eq(chunk_list_memory(), 0);
+	spill_path(path, sizeof(path));
+	f = file_open(path, MODE_WRITE, FTYPE_RAW);
+	notnull(f);
+	file_close(f);
+
+	take_stairs(true);
+	eq(player->depth, 1);
+	notnull(cave);
+	for (i = 0; i < messages_num(); i++)
+		if (strstr(message_str(i), "is broken")) warned = true;
+	require(warned);
+	strnfmt(known_name, sizeof(known_name), "%s known", name);
+	require(!chunk_exists_name(name));
+	require(!chunk_exists_name(known_name));
+	require(chunk_exists_name("Town"));
+	chunk_list_set_memory(0);
+	ok;
+}
+
+int test_free(void *state) {
+	char path[1024];
+
+	/* Freeing the stored levels takes the spill file with them */
+	chunk_list_set_memory(1);
+	spill_path(path, sizeof(path));
+	require(file_exists(path));
+	chunk_list_free();
+	require(!file_exists(path));
+	eq(chunk_list_count(), 0);
+	chunk_list_set_memory(0);
+	ok;
+}
+
+const char *suite_name = "game/persist";
+struct test tests[] = {
+	{ "store", test_store },
+	{ "save", test_save },
+	{ "reclaim", test_reclaim },
+	{ "broken", test_broken },
+	{ "free", test_free },
+	{ NULL, NULL }
+};
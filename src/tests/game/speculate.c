@@ -0,0 +1,119 @@
+/* game/speculate.c */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cave.h"
+#include "cmd-core.h"
+#include "game-world.h"
+#include "init.h"
+#include "monster.h"
+#include "player.h"
+#include "z-rand.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character and put them in the town */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+	prepare_next_level(&cave, player);
+	on_new_level();
+
+	OPT(player, speculative_levels) = true;
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Total of the live monster counts of all races
+ */
+static int total_cur_num(void) {
+	int i, n = 0;
+
+	for (i = 1; i < z_info->r_max; i++)
+		n += r_info[i].cur_num;
+
+	return n;
+}
+
+int test_adopt(void *state) {
+	struct rand_state before, after;
+	struct chunk *next;
+	int counted = total_cur_num();
+
+	square_set_feat(cave, player->grid, FEAT_MORE);
+
+	/* Building the level leaves the game's RNG and monster counts alone */
+	memset(&before, 0, sizeof(before));
+	memset(&after, 0, sizeof(after));
+	Rand_state_save(&before);
+	next = speculate_next_level(player);
+	Rand_state_save(&after);
+	notnull(next);
+	eq(memcmp(&before, &after, sizeof(before)), 0);
+	eq(total_cur_num(), counted);
+	eq(player->depth, 0);
+
+	/* Asking again finds the same level */
+	ptreq(speculate_next_level(player), next);
+
+	/* Taking the stairs adopts it, claiming its monsters */
+	cmdq_push(CMD_GO_DOWN);
+	run_game_loop();
+	eq(player->depth, 1);
+	ptreq(cave, next);
+	eq(square(cave, player->grid).mon, -1);
+	eq(total_cur_num(), cave_monster_count(cave));
+	ok;
+}
+
+int test_discard(void *state) {
+	struct chunk *next;
+
+	/* Build the level below, then leave by the up stairs instead */
+	square_set_feat(cave, player->grid, FEAT_MORE);
+	next = speculate_next_level(player);
+	notnull(next);
+	eq(total_cur_num(), cave_monster_count(cave));
+
+	square_set_feat(cave, player->grid, FEAT_LESS);
+	cmdq_push(CMD_GO_UP);
+	run_game_loop();
+	eq(player->depth, 0);
+	eq(cave->depth, 0);
+	eq(total_cur_num(), cave_monster_count(cave));
+	ok;
+}
+
+const char *suite_name = "game/speculate";
+struct test tests[] = {
+	{ "adopt", test_adopt },
+	{ "discard", test_discard },
+	{ NULL, NULL }
+};
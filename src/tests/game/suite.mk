@@ -1,2 +1,8 @@
 TESTPROGS += game/basic \
-	game/mage
+	game/cavern \
+	game/effect \
+	game/journal \
+	game/mage \
+	game/monview \
+	game/persist \
+	game/speculate
@@ -9,6 +9,7 @@
 #include "unit-test.h"
 #include "unit-test-data.h"
 #include "test-utils.h"
+#include "mon-spell.h"
 #include "mon-util.h"
 
 int setup_tests(void **state) {
@@ -43,8 +44,52 @@ int test_match_monster_bases(void *state) {
 	ok;
 }
 
+int test_spell_tables(void *state) {
+	int i, j, half, cat;
+
+	for (i = 0; i < z_info->r_max; i++) {
+		struct monster_race *race = &r_info[i];
+		int num = 0;
+
+		if (!race->name) continue;
+
+		/* Every spell in the flags is in the table once, innate first */
+		for (j = 0; j < race->num_spells; j++) {
+			require(rsf_has(race->spell_flags, race->spells[j]));
+			eq(mon_spell_is_innate(race->spells[j]), j < race->num_innate);
+		}
+
+		/* Each half is split by category, each in spell index order */
+		eq(race->spell_cat[0][0], 0);
+		eq(race->spell_cat[0][MSC_MAX], race->num_innate);
+		eq(race->spell_cat[1][0], race->num_innate);
+		eq(race->spell_cat[1][MSC_MAX], race->num_spells);
+		for (half = 0; half < 2; half++) {
+			for (cat = 0; cat < MSC_MAX; cat++) {
+				int start = race->spell_cat[half][cat];
+				int end = race->spell_cat[half][cat + 1];
+
+				require(start <= end);
+				for (j = start; j < end; j++) {
+					eq(mon_spell_category(race->spells[j]), cat);
+					if (j != start)
+						require(race->spells[j] > race->spells[j - 1]);
+				}
+			}
+		}
+		for (j = rsf_next(race->spell_flags, FLAG_START); j != FLAG_END;
+			 j = rsf_next(race->spell_flags, j + 1))
+			num++;
+		eq(race->num_spells, num);
+		eq(race->spell_types == 0, num == 0);
+	}
+
+	ok;
+}
+
 const char *suite_name = "monster/monster";
 struct test tests[] = {
 	{ "match_monster_bases", test_match_monster_bases },
+	{ "spell_tables", test_spell_tables },
 	{ NULL, NULL }
 };
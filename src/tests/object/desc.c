@@ -0,0 +1,118 @@
+/* object/desc */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cmd-core.h"
+#include "init.h"
+#include "obj-desc.h"
+#include "obj-knowledge.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "object.h"
+#include "player.h"
+#include "z-virt.h"
+
+/* One object of each kind that is generated, half of them flavour-aware */
+static struct object **objects;
+static int n_objects;
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	int i;
+
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a character */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	objects = mem_zalloc(z_info->k_max * sizeof(*objects));
+	for (i = 0; i < z_info->k_max; i++) {
+		struct object_kind *kind = &k_info[i];
+		struct object *obj;
+
+		if (!kind->name || !kind->alloc_prob) continue;
+		obj = object_new();
+		object_prep(obj, kind, 30, RANDOMISE);
+		obj->known = object_new();
+		object_set_base_known(obj);
+		if (n_objects % 2) object_flavor_aware(obj);
+		objects[n_objects++] = obj;
+	}
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	int i;
+
+	for (i = 0; i < n_objects; i++) {
+		object_delete(&objects[i]->known);
+		object_delete(&objects[i]);
+	}
+	mem_free(objects);
+	cleanup_angband();
+	return 0;
+}
+
+int test_describe(void *state) {
+	char buf[80];
+	int i;
+
+	require(n_objects > 0);
+	for (i = 0; i < n_objects; i++) {
+		size_t len = object_desc(buf, sizeof(buf), objects[i],
+								 ODESC_PREFIX | ODESC_FULL);
+
+		require(len > 0);
+		eq(len, strlen(buf));
+		require(strcmp(buf, "(nothing)"));
+	}
+	ok;
+}
+
+int bench_describe(void *state, int iters) {
+	char buf[80];
+	int i;
+
+	for (i = 0; i < iters; i++)
+		require(object_desc(buf, sizeof(buf), objects[i % n_objects],
+							ODESC_PREFIX | ODESC_FULL) > 0);
+	return 0;
+}
+
+int bench_store(void *state, int iters) {
+	char buf[80];
+	int i;
+
+	for (i = 0; i < iters; i++)
+		require(object_desc(buf, sizeof(buf), objects[i % n_objects],
+							ODESC_PREFIX | ODESC_FULL | ODESC_STORE) > 0);
+	return 0;
+}
+
+const char *suite_name = "object/desc";
+struct test tests[] = {
+	{ "describe", test_describe },
+	{ "bench-describe", BENCH(bench_describe) },
+	{ "bench-store", BENCH(bench_store) },
+	{ NULL, NULL }
+};
@@ -7,8 +7,18 @@
 
 #include "object.h"
 #include "obj-pile.h"
+#include "obj-tval.h"
+#include "z-util.h"
+
+static char report[1024];
+
+static void report_line(const char *str) {
+	my_strcat(report, str, sizeof(report));
+	my_strcat(report, "\n", sizeof(report));
+}
 
 int setup_tests(void **state) {
+	plog_aux = report_line;
 	return 0;
 }
 
@@ -91,8 +101,85 @@ int test_obj_piles(void *state) {
 	ok;
 }
 
+/* Objects are reused from the slabs and counted as they come and go */
+int test_obj_slabs(void *state) {
+	struct object_alloc_stats stats;
+	struct object *objs[300];
+	struct object *obj;
+	long live;
+	int i;
+
+	object_alloc_stats(&stats);
+	live = stats.live;
+	object_alloc_reset_peak();
+
+	/* Enough objects to need a second slab */
+	for (i = 0; i < 300; i++) {
+		objs[i] = object_new();
+		eq(objs[i]->number, 0);
+		objs[i]->number = 1;
+	}
+	object_alloc_stats(&stats);
+	eq(stats.live, live + 300);
+	eq(stats.peak, live + 300);
+	require(stats.slabs >= 2);
+
+	/* The last object freed is the next one made, wiped clean */
+	object_free(objs[150]);
+	obj = object_new();
+	ptreq(obj, objs[150]);
+	eq(obj->number, 0);
+	null(obj->next);
+
+	for (i = 0; i < 300; i++)
+		object_free(objs[i]);
+	object_alloc_stats(&stats);
+	eq(stats.live, live);
+	eq(stats.peak, live + 300);
+
+	/* Freed objects go before any new slab */
+	i = stats.slabs;
+	for (live = 0; live < 300; live++)
+		objs[live] = object_new();
+	object_alloc_stats(&stats);
+	eq(stats.slabs, i);
+	for (live = 0; live < 300; live++)
+		object_free(objs[live]);
+
+	ok;
+}
+
+/* Objects never freed are reported when the slabs are given back */
+int test_obj_leaks(void *state) {
+	struct object_alloc_stats stats;
+	struct object *obj;
+
+	object_alloc_stats(&stats);
+	eq(stats.live, 0);
+	eq(object_slabs_free(), 0);
+	require(!report[0]);
+
+	obj = object_new();
+	obj->tval = TV_SWORD;
+	obj->sval = 3;
+	obj->origin = ORIGIN_FLOOR;
+	obj->origin_depth = 5;
+	object_free(object_new());
+	eq(object_slabs_free(), 1);
+	require(strstr(report, "1 object never freed"));
+	require(strstr(report, "sword (sval 3), origin FLOOR at depth 5"));
+
+	/* Everything went with the slabs */
+	object_alloc_stats(&stats);
+	eq(stats.live, 0);
+	eq(stats.slabs, 0);
+	ok;
+}
+
 const char *suite_name = "object/pile";
 struct test tests[] = {
 	{ "pile checking", test_obj_piles },
+	{ "slabs", test_obj_slabs },
+	{ "leaks", test_obj_leaks },
 	{ NULL, NULL }
 };
@@ -1 +1 @@
-TESTPROGS += object/attack object/util object/pile
+TESTPROGS += object/attack object/desc object/util object/pile
@@ -0,0 +1,84 @@
+/* parse/bench */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include "cmd-core.h"
+#include "datafile.h"
+#include "init.h"
+#include "mon-init.h"
+#include "obj-init.h"
+#include "ui-prefs.h"
+
+/* Number of object kinds from a plain parse of object.txt */
+static int k_max;
+
+int setup_tests(void **state) {
+	set_file_paths();
+	init_angband();
+	textui_prefs_init();
+
+	/* Pref files can depend on the player's race and class */
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_execute(CMD_BIRTH);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	textui_prefs_free();
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Parse a gamedata file over again, replacing what was there
+ */
+static bool reparse(struct file_parser *fp)
+{
+	cleanup_parser(fp);
+	return run_parser(fp) == 0;
+}
+
+int bench_monster(void *state, int iters) {
+	int r_max = z_info->r_max;
+	int i;
+
+	for (i = 0; i < iters; i++)
+		require(reparse(&monster_parser));
+	eq(z_info->r_max, r_max);
+	return 0;
+}
+
+/* Setup adds kinds after parsing, so compare against a plain parse */
+static int object_setup(void *state) {
+	require(reparse(&object_parser));
+	k_max = z_info->k_max;
+	return 0;
+}
+
+int bench_object(void *state, int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++)
+		require(reparse(&object_parser));
+	eq(z_info->k_max, k_max);
+	return 0;
+}
+
+int bench_prefs(void *state, int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++) {
+		require(process_pref_file("pref.prf", false, false));
+		require(process_pref_file("font.prf", false, false));
+	}
+	return 0;
+}
+
+const char *suite_name = "parse/bench";
+struct test tests[] = {
+	{ "monster", BENCH(bench_monster) },
+	{ "object", BENCH_SETUP(object_setup, bench_object, NULL) },
+	{ "prefs", BENCH(bench_prefs) },
+	{ NULL, NULL }
+};
@@ -1,4 +1,5 @@
 TESTPROGS += parse/a-info \
+	parse/bench \
 	parse/c-info \
 	parse/e-info \
 	parse/f-info \
@@ -11,5 +12,6 @@ TESTPROGS += parse/a-info \
 	parse/parse \
 	parse/r-info \
 	parse/readstore \
+	parse/threads \
 	parse/v-info \
 	parse/z-info
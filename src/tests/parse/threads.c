@@ -0,0 +1,164 @@
+/* parse/threads */
+
+#include "unit-test.h"
+#include "test-utils.h"
+
+#include "datafile.h"
+#include "init.h"
+#include "monster.h"
+#include "object.h"
+
+/**
+ * Parsers which only note when they are parsed and finished
+ */
+#define TEST_PARSERS 6
+
+static struct parser_list tl[TEST_PARSERS];
+static bool finished[TEST_PARSERS];
+static bool early[TEST_PARSERS];
+static int order[TEST_PARSERS];
+static int order_num;
+static int threads;
+
+static struct parser *init_test_parser(void) {
+	return parser_new();
+}
+
+static errr run_test_parser(int n) {
+	size_t i, j;
+
+	/* Everything this one needs has to have been finished already */
+	for (i = 0; i < PARSER_NEEDS_MAX && tl[n].needs[i]; i++)
+		for (j = 0; j < TEST_PARSERS; j++)
+			if (streq(tl[j].name, tl[n].needs[i]) && !finished[j])
+				early[n] = true;
+	return 0;
+}
+
+static errr finish_test_parser(struct parser *p, int n) {
+	finished[n] = true;
+	order[order_num++] = n;
+	parser_destroy(p);
+	return 0;
+}
+
+static void cleanup_test_parser(void) {
+}
+
+#define TEST_PARSER(n) \
+	static errr run_##n(struct parser *p) { \
+		return run_test_parser(n); \
+	} \
+	static errr finish_##n(struct parser *p) { \
+		return finish_test_parser(p, n); \
+	} \
+	static struct file_parser parser_##n = { \
+		"test", init_test_parser, run_##n, finish_##n, \
+		cleanup_test_parser \
+	};
+
+TEST_PARSER(0)
+TEST_PARSER(1)
+TEST_PARSER(2)
+TEST_PARSER(3)
+TEST_PARSER(4)
+TEST_PARSER(5)
+
+static struct parser_list tl[TEST_PARSERS] = {
+	{ "a", &parser_0, { NULL } },
+	{ "b", &parser_1, { NULL } },
+	{ "c", &parser_2, { "a" } },
+	{ "d", &parser_3, { NULL } },
+	{ "e", &parser_4, { "b", "c" } },
+	{ "f", &parser_5, { "e", "a" } }
+};
+
+int setup_tests(void **state) {
+	threads = parser_threads;
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	parser_threads = threads;
+	return 0;
+}
+
+/**
+ * Run the test parsers, checking they were finished in the order of the list
+ * and none was parsed before what it needs
+ */
+static bool run_test_parsers(void) {
+	int i;
+
+	memset(finished, 0, sizeof(finished));
+	memset(early, 0, sizeof(early));
+	order_num = 0;
+	run_parser_list(tl, TEST_PARSERS);
+
+	if (order_num != TEST_PARSERS) return false;
+	for (i = 0; i < TEST_PARSERS; i++)
+		if (order[i] != i || early[i]) return false;
+	return true;
+}
+
+int test_order(void *state) {
+	int i;
+
+	parser_threads = 0;
+	require(run_test_parsers());
+	for (i = 1; i <= TEST_PARSERS + 1; i++) {
+		parser_threads = i;
+		require(run_test_parsers());
+	}
+	ok;
+}
+
+/**
+ * The gamedata read on threads is the same as that read in turn
+ */
+int test_gamedata(void *state) {
+	struct angband_constants z;
+	char **kinds, **races;
+	int i, run;
+
+	parser_threads = 0;
+	set_file_paths();
+	init_angband();
+	memcpy(&z, z_info, sizeof(z));
+	kinds = mem_zalloc(z.k_max * sizeof(*kinds));
+	for (i = 0; i < z.k_max; i++)
+		kinds[i] = string_make(k_info[i].name);
+	races = mem_zalloc(z.r_max * sizeof(*races));
+	for (i = 0; i < z.r_max; i++)
+		races[i] = string_make(r_info[i].name);
+	cleanup_angband();
+
+	for (run = 0; run < 5; run++) {
+		parser_threads = 4;
+		set_file_paths();
+		init_angband();
+		require(!memcmp(&z, z_info, sizeof(z)));
+		for (i = 0; i < z.k_max; i++)
+			require(streq(kinds[i] ? kinds[i] : "",
+						  k_info[i].name ? k_info[i].name : ""));
+		for (i = 0; i < z.r_max; i++)
+			require(streq(races[i] ? races[i] : "",
+						  r_info[i].name ? r_info[i].name : ""));
+		cleanup_angband();
+	}
+
+	for (i = 0; i < z.k_max; i++)
+		string_free(kinds[i]);
+	mem_free(kinds);
+	for (i = 0; i < z.r_max; i++)
+		string_free(races[i]);
+	mem_free(races);
+	ok;
+}
+
+const char *suite_name = "parse/threads";
+struct test tests[] = {
+	{ "order", test_order },
+	{ "gamedata", test_gamedata },
+	{ NULL, NULL }
+};
@@ -112,6 +112,32 @@ int test_d0(void *state) {
 	ok;
 }
 
+int test_layout0(void *state) {
+	enum parser_error r = parser_parse(state, "D:o9 To$");
+	struct vault *v = parser_priv(state);
+	struct template_layout *layout;
+
+	eq(r, PARSE_ERROR_NONE);
+	layout = template_layout_new(v->text, v->hgt, v->wid, vault_contents);
+	eq(layout->n_squares, 9);
+	eq(layout->squares[0].y, 0);
+	eq(layout->squares[0].x, 2);
+	eq(layout->squares[8].code, '$');
+
+	/* Contents and monsters are listed apart, in the order they appear */
+	eq(layout->n_contents, 2);
+	eq(layout->contents[0].code, '9');
+	eq(layout->contents[1].y, 2);
+	eq(layout->contents[1].x, 5);
+	require(streq(layout->races, "oT"));
+	eq(layout->race_start[1], 2);
+	eq(layout->race_start[2], 3);
+	eq(layout->racial[1].x, 4);
+	eq(layout->racial[2].code, 'T');
+	template_layout_free(layout);
+	ok;
+}
+
 const char *suite_name = "parse/v-info";
 struct test tests[] = {
 	{ "name0", test_name0 },
@@ -122,5 +148,6 @@ struct test tests[] = {
 	{ "min_lev0", test_min_lev0 },
 	{ "max_lev0", test_max_lev0 },
 	{ "d0", test_d0 },
+	{ "layout0", test_layout0 },
 	{ NULL, NULL }
 };
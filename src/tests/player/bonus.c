@@ -0,0 +1,162 @@
+/* player/bonus */
+
+#include "unit-test.h"
+#include "unit-test-data.h"
+#include "test-utils.h"
+
+#include <stdio.h>
+#include "cmd-core.h"
+#include "game-event.h"
+#include "init.h"
+#include "obj-gear.h"
+#include "obj-make.h"
+#include "obj-pile.h"
+#include "player.h"
+#include "player-calcs.h"
+#include "player-timed.h"
+#include "z-util.h"
+
+static void println(const char *str) {
+	printf("%s\n", str);
+}
+
+int setup_tests(void **state) {
+	plog_aux = println;
+
+	/* Init the game */
+	set_file_paths();
+	init_angband();
+
+	/* Make a warrior, who starts out wielding things */
+	cmdq_push(CMD_BIRTH_INIT);
+	cmdq_push(CMD_BIRTH_RESET);
+	cmdq_push(CMD_CHOOSE_RACE);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_CHOOSE_CLASS);
+	cmd_set_arg_choice(cmdq_peek(), "choice", 0);
+	cmdq_push(CMD_ROLL_STATS);
+	cmdq_push(CMD_NAME_CHOICE);
+	cmd_set_arg_string(cmdq_peek(), "name", "Tester");
+	cmdq_push(CMD_ACCEPT_CHARACTER);
+	cmdq_execute(CMD_BIRTH);
+
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	cleanup_angband();
+	return 0;
+}
+
+/**
+ * Check the player's states against ones worked out from scratch
+ */
+static bool states_match(struct player *p) {
+	struct player_state full = p->state, known = p->known_state;
+
+	calc_bonuses_flush(p);
+	calc_bonuses(p, &full, false, true);
+	calc_bonuses(p, &known, true, true);
+	return !memcmp(&full, &p->state, sizeof(full)) &&
+		!memcmp(&known, &p->known_state, sizeof(known));
+}
+
+int test_timed_effects(void *state) {
+	player->upkeep->update |= (PU_BONUS);
+	update_stuff(player);
+	require(states_match(player));
+
+	/* Timed effects keep the cached equipment */
+	player_inc_timed(player, TMD_HERO, 10, true, false);
+	player_inc_timed(player, TMD_STUN, 60, true, false);
+	player_inc_timed(player, TMD_OPP_FIRE, 10, true, false);
+	require(player->upkeep->slot_bonus != NULL);
+	update_stuff(player);
+	require(states_match(player));
+
+	player_clear_timed(player, TMD_STUN, false);
+	player_inc_timed(player, TMD_BLESSED, 10, true, false);
+	update_stuff(player);
+	require(states_match(player));
+	ok;
+}
+
+int test_gear_change(void *state) {
+	struct object *weapon = equipped_item_by_slot_name(player, "weapon");
+	int slot = slot_by_name(player, "weapon");
+	int to_a = player->state.to_a;
+	struct player_state hypothetical = player->state;
+
+	notnull(weapon);
+
+	/* A hypothetical empty weapon slot is noticed without a flush */
+	player->body.slots[slot].obj = NULL;
+	calc_bonuses(player, &hypothetical, true, false);
+	player->body.slots[slot].obj = weapon;
+	player->upkeep->update |= (PU_TIMED);
+	update_stuff(player);
+	require(states_match(player));
+
+	/* Changes in place are picked up once PU_BONUS is asked for */
+	weapon->to_a += 3;
+	player->upkeep->update |= (PU_BONUS);
+	update_stuff(player);
+	eq(player->state.to_a, to_a + 3);
+	require(states_match(player));
+	weapon->to_a -= 3;
+	player->upkeep->update |= (PU_BONUS);
+	update_stuff(player);
+	eq(player->state.to_a, to_a);
+	ok;
+}
+
+int test_hypothetical(void *state) {
+	struct object *weapon = equipped_item_by_slot_name(player, "weapon");
+	int slot = slot_by_name(player, "weapon");
+	struct player_state hypothetical;
+	struct object *obj;
+	int to_a;
+
+	notnull(weapon);
+	player->upkeep->update |= (PU_BONUS);
+	update_stuff(player);
+	require(player->upkeep->slot_bonus != NULL);
+
+	/* What the slot adds when it's empty */
+	player->body.slots[slot].obj = NULL;
+	hypothetical = player->state;
+	calc_bonuses(player, &hypothetical, false, false);
+	to_a = hypothetical.to_a;
+
+	/* Two different objects, made in turn at the same address, in the slot */
+	obj = object_new();
+	object_prep(obj, weapon->kind, 0, MINIMISE);
+	obj->to_a = 2;
+	player->body.slots[slot].obj = obj;
+	hypothetical = player->state;
+	calc_bonuses(player, &hypothetical, false, false);
+	eq(hypothetical.to_a, to_a + 2);
+
+	object_wipe(obj);
+	object_prep(obj, weapon->kind, 0, MINIMISE);
+	obj->to_a = 5;
+	hypothetical = player->state;
+	calc_bonuses(player, &hypothetical, false, false);
+	eq(hypothetical.to_a, to_a + 5);
+
+	/* The real equipment is as it was */
+	player->body.slots[slot].obj = weapon;
+	object_delete(&obj);
+	player->upkeep->update |= (PU_TIMED);
+	update_stuff(player);
+	require(states_match(player));
+	ok;
+}
+
+const char *suite_name = "player/bonus";
+struct test tests[] = {
+	{ "timed_effects", test_timed_effects },
+	{ "gear_change", test_gear_change },
+	{ "hypothetical", test_hypothetical },
+	{ NULL, NULL }
+};
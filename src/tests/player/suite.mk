@@ -1,4 +1,5 @@
 TESTPROGS += player/birth \
+             player/bonus \
              player/history \
              player/pathfind \
              player/playerstat
@@ -7,9 +7,26 @@
 #ifndef UNIT_TEST_TYPES_H
 #define UNIT_TEST_TYPES_H
 
+/**
+ * A benchmark: func runs the code being measured `iters` times.  The
+ * optional setup and teardown run around each batch of iterations, untimed,
+ * with the random number generator given a fixed seed before setup.
+ * Each returns 0 on success.
+ */
+struct bench {
+	int (*setup)(void *data);
+	int (*func)(void *data, int iters);
+	int (*teardown)(void *data);
+};
+
+/**
+ * A test case: either func, which passes or fails, or bench, which passes
+ * as long as the benchmark runs
+ */
 struct test {
 	const char *name;
 	int (*func)(void *data);
+	const struct bench *bench;
 };
 
 #endif /* !UNIT_TEST_TYPES_H */
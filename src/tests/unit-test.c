@@ -6,16 +6,116 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 #include "unit-test-types.h"
+#include "z-rand.h"
 #include "z-util.h"
 
+/* Seed for the random numbers each batch of benchmark iterations sees */
+#define BENCH_SEED 0x5eed
+
+/* Time a batch of iterations must take for its timing to be trusted */
+#define BENCH_MIN_MSECS 20.0
+
+/* Batches timed for each benchmark, and the most iterations in a batch */
+#define BENCH_SAMPLES 7
+#define BENCH_MAX_ITERS (1 << 24)
+
 int verbose = 0;
+int benching = 0;
 
 extern const char *suite_name;
 extern struct test tests[];
 extern int setup_tests(void **data);
 extern int teardown_tests(void **data);
 
+int showpass(void) {
+	if (verbose) printf("\033[01;32mPassed\033[00m\n");
+	return 0;
+}
+int showfail(void) {
+	if (verbose) printf("\033[01;31mFailed\033[00m\n");
+	return 1;
+}
+
+/**
+ * Run a batch of benchmark iterations from a fixed seed, timing only the
+ * iterations themselves
+ */
+static int bench_batch(const struct bench *b, void *state, int iters,
+					   double *msecs)
+{
+	clock_t start;
+	int result;
+
+	Rand_quick = false;
+	Rand_state_init(BENCH_SEED);
+	if (b->setup && b->setup(state)) return 1;
+
+	start = clock();
+	result = b->func(state, iters);
+	*msecs = (double) (clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+
+	if (b->teardown && b->teardown(state)) return 1;
+	return result;
+}
+
+static int compare_times(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * Run a benchmark.  Unless benchmarks were asked for, it runs once only, to
+ * check it still works; otherwise, after that warm-up, the batch size is
+ * doubled until a batch takes long enough to time, and the time per
+ * iteration of several such batches is reported.
+ */
+static int run_bench(const struct test *t, void *state)
+{
+	const struct bench *b = t->bench;
+	double nsecs[BENCH_SAMPLES];
+	double msecs, median, mean = 0.0, scale = 1.0;
+	const char *unit = "ns";
+	int iters = 1;
+	int i;
+
+	if (bench_batch(b, state, 1, &msecs)) return 1;
+	if (!benching) return showpass();
+
+	while (1) {
+		if (bench_batch(b, state, iters, &msecs)) return 1;
+		if (msecs >= BENCH_MIN_MSECS || iters >= BENCH_MAX_ITERS) break;
+		iters *= 2;
+	}
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		if (bench_batch(b, state, iters, &msecs)) return 1;
+		nsecs[i] = msecs * 1000000.0 / iters;
+		mean += nsecs[i] / BENCH_SAMPLES;
+	}
+	qsort(nsecs, BENCH_SAMPLES, sizeof(nsecs[0]), compare_times);
+
+	/* Report in whichever unit suits the median */
+	median = nsecs[BENCH_SAMPLES / 2];
+	if (median >= 1000000.0) {
+		scale = 1000000.0;
+		unit = "ms";
+	} else if (median >= 1000.0) {
+		scale = 1000.0;
+		unit = "us";
+	}
+
+	if (!verbose) printf("  %-16s  ", t->name);
+	printf("%8.1f%s/iter (min %.1f, mean %.1f, max %.1f; %dx%d)%s",
+		   median / scale, unit, nsecs[0] / scale, mean / scale,
+		   nsecs[BENCH_SAMPLES - 1] / scale, BENCH_SAMPLES, iters,
+		   verbose ? " " : "\n");
+	return showpass();
+}
+
 int main(int argc, char *argv[]) {
 	void *state;
 	int i;
@@ -23,10 +123,12 @@ int main(int argc, char *argv[]) {
 	int total = 0;
 
 	char *s = getenv("VERBOSE");
-	if (s && s[0]) {
-		verbose = 1;
-	} else if (argc > 1 && !strncmp(argv[1], "-v", 2)) {
-		verbose = 1;
+	if (s && s[0]) verbose = 1;
+	s = getenv("BENCH");
+	if (s && s[0]) benching = 1;
+	for (i = 1; i < argc; i++) {
+		if (!strncmp(argv[i], "-v", 2)) verbose = 1;
+		if (!strncmp(argv[i], "-b", 2)) benching = 1;
 	}
 
 	if (verbose) {
@@ -42,7 +144,11 @@ int main(int argc, char *argv[]) {
 	for (i = 0; tests[i].name; i++) {
 		if (verbose) printf("  %-16s  ", tests[i].name);
 		fflush(stdout);
-		if (tests[i].func(state) == 0) passed++;
+		if (tests[i].bench) {
+			if (run_bench(&tests[i], state) == 0) passed++;
+		} else if (tests[i].func(state) == 0) {
+			passed++;
+		}
 		total++;
 		fflush(stdout);
 	}
@@ -55,12 +161,3 @@ int main(int argc, char *argv[]) {
 	printf("%s finished: %d/%d passed\n", suite_name, passed, total);
 	return 0;
 }
-
-int showpass(void) {
-	if (verbose) printf("\033[01;32mPassed\033[00m\n");
-	return 0;
-}
-int showfail(void) {
-	if (verbose) printf("\033[01;31mFailed\033[00m\n");
-	return 1;
-}
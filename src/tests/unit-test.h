@@ -9,6 +9,7 @@
 #define TEST
 
 extern int verbose;
+extern int benching;
 
 extern int showpass(void);
 extern int showfail(void);
@@ -23,6 +24,11 @@ const char *suite_name;
 
 #define ok return showpass();
 
+/* Entries for benchmarks in the tests[] array, as { "name", BENCH(func) } */
+#define BENCH(func) NULL, &(const struct bench) { NULL, (func), NULL }
+#define BENCH_SETUP(setup, func, teardown) \
+	NULL, &(const struct bench) { (setup), (func), (teardown) }
+
 #define eq(x,y) \
 	if ((x) != (y)) { \
 		if (verbose) { \
@@ -0,0 +1,155 @@
+/* z-bitflag/bitflag.c */
+
+#include "unit-test.h"
+#include "z-bitflag.h"
+
+/* Big enough to use the word-wide paths, with a byte-wise tail */
+#define TEST_SIZE 19
+#define TEST_MAX FLAG_MAX(TEST_SIZE)
+
+NOSETUP
+NOTEARDOWN
+
+int test_next(void *state) {
+	bitflag f[TEST_SIZE];
+	int flag, n = 0;
+
+	flag_wipe(f, TEST_SIZE);
+	eq(flag_next(f, TEST_SIZE, FLAG_START), FLAG_END);
+
+	flags_init(f, TEST_SIZE, 1, 8, 9, 64, 65, 100, TEST_MAX - 1, FLAG_END);
+	eq(flag_next(f, TEST_SIZE, FLAG_END), 1);
+	eq(flag_next(f, TEST_SIZE, 2), 8);
+	eq(flag_next(f, TEST_SIZE, 10), 64);
+	eq(flag_next(f, TEST_SIZE, 66), 100);
+	eq(flag_next(f, TEST_SIZE, 101), TEST_MAX - 1);
+	eq(flag_next(f, TEST_SIZE, TEST_MAX), FLAG_END);
+
+	for (flag = flag_next(f, TEST_SIZE, FLAG_START); flag != FLAG_END;
+		 flag = flag_next(f, TEST_SIZE, flag + 1)) {
+		require(flag_has(f, TEST_SIZE, flag));
+		n++;
+	}
+	eq(n, 7);
+	ok;
+}
+
+int test_count(void *state) {
+	bitflag f[TEST_SIZE];
+	int flag;
+
+	flag_wipe(f, TEST_SIZE);
+	eq(flag_count(f, TEST_SIZE), 0);
+	require(flag_is_empty(f, TEST_SIZE));
+
+	flag_setall(f, TEST_SIZE);
+	eq(flag_count(f, TEST_SIZE), TEST_SIZE * FLAG_WIDTH);
+	require(flag_is_full(f, TEST_SIZE));
+
+	flag_off(f, TEST_SIZE, TEST_MAX - 1);
+	require(!flag_is_full(f, TEST_SIZE));
+
+	flag_wipe(f, TEST_SIZE);
+	for (flag = FLAG_START; flag < TEST_MAX; flag += 3)
+		flag_on(f, TEST_SIZE, flag);
+	eq(flag_count(f, TEST_SIZE), (TEST_MAX - FLAG_START + 2) / 3);
+	require(!flag_is_empty(f, TEST_SIZE));
+	ok;
+}
+
+int test_ops(void *state) {
+	bitflag f1[TEST_SIZE], f2[TEST_SIZE];
+
+	flags_init(f1, TEST_SIZE, 3, 70, 150, FLAG_END);
+	flags_init(f2, TEST_SIZE, 70, 150, FLAG_END);
+	require(flag_is_inter(f1, f2, TEST_SIZE));
+	require(flag_is_subset(f1, f2, TEST_SIZE));
+	require(!flag_is_subset(f2, f1, TEST_SIZE));
+
+	require(flag_diff(f1, f2, TEST_SIZE));
+	eq(flag_count(f1, TEST_SIZE), 1);
+	require(!flag_is_inter(f1, f2, TEST_SIZE));
+	require(!flag_diff(f1, f2, TEST_SIZE));
+
+	require(flag_union(f1, f2, TEST_SIZE));
+	require(!flag_union(f1, f2, TEST_SIZE));
+	eq(flag_count(f1, TEST_SIZE), 3);
+
+	require(flag_inter(f1, f2, TEST_SIZE));
+	require(flag_is_equal(f1, f2, TEST_SIZE));
+	require(!flag_inter(f1, f2, TEST_SIZE));
+
+	flag_negate(f1, TEST_SIZE);
+	eq(flag_count(f1, TEST_SIZE), TEST_SIZE * FLAG_WIDTH - 2);
+	require(!flag_has(f1, TEST_SIZE, 70));
+	require(flag_has(f1, TEST_SIZE, 71));
+	ok;
+}
+
+int bench_count(void *state, int iters) {
+	bitflag f[TEST_SIZE];
+	int i, total = 0;
+
+	flags_init(f, TEST_SIZE, 5, 77, 140, FLAG_END);
+	for (i = 0; i < iters; i++) {
+		f[i % TEST_SIZE] ^= 1;
+		total += flag_count(f, TEST_SIZE);
+	}
+	require(total > 0);
+	return 0;
+}
+
+int bench_next(void *state, int iters) {
+	bitflag f[TEST_SIZE];
+	int i, flag, total = 0;
+
+	flags_init(f, TEST_SIZE, 5, 77, 140, FLAG_END);
+	for (i = 0; i < iters; i++)
+		for (flag = flag_next(f, TEST_SIZE, FLAG_START); flag != FLAG_END;
+			 flag = flag_next(f, TEST_SIZE, flag + 1))
+			total++;
+	eq(total, 3 * iters);
+	return 0;
+}
+
+int bench_union(void *state, int iters) {
+	bitflag f1[TEST_SIZE], f2[TEST_SIZE];
+	int i, changed = 0;
+
+	flag_wipe(f1, TEST_SIZE);
+	flags_init(f2, TEST_SIZE, 5, 77, 140, FLAG_END);
+	for (i = 0; i < iters; i++) {
+		if (flag_union(f1, f2, TEST_SIZE)) changed++;
+		if (flag_is_subset(f1, f2, TEST_SIZE)) flag_diff(f1, f2, TEST_SIZE);
+	}
+	eq(changed, iters);
+	return 0;
+}
+
+int bench_has(void *state, int iters) {
+	bitflag f[TEST_SIZE];
+	int i, total = 0;
+
+	flags_init(f, TEST_SIZE, 5, 77, 140, FLAG_END);
+	for (i = 0; i < iters; i++) {
+		int flag = FLAG_START + i % (TEST_MAX - FLAG_START);
+
+		if (flag_has(f, TEST_SIZE, flag)) total++;
+		flag_on(f, TEST_SIZE, flag);
+		flag_off(f, TEST_SIZE, flag);
+	}
+	require(total <= iters);
+	return 0;
+}
+
+const char *suite_name = "z-bitflag/bitflag";
+struct test tests[] = {
+	{ "next", test_next },
+	{ "count", test_count },
+	{ "ops", test_ops },
+	{ "bench_count", BENCH(bench_count) },
+	{ "bench_next", BENCH(bench_next) },
+	{ "bench_union", BENCH(bench_union) },
+	{ "bench_has", BENCH(bench_has) },
+	{ NULL, NULL }
+};
@@ -0,0 +1,127 @@
+/* z-bitmap/bitmap.c */
+
+#include "unit-test.h"
+#include "z-bitmap.h"
+
+int setup_tests(void **state) {
+	*state = bitmap_new(5, 150);
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	bitmap_free(state);
+	return 0;
+}
+
+int test_on_off(void *state) {
+	struct bitmap *b = state;
+
+	bitmap_wipe(b);
+	require(bitmap_is_empty(b));
+	bitmap_on(b, loc(63, 2));
+	bitmap_on(b, loc(64, 2));
+	bitmap_on(b, loc(149, 4));
+	require(bitmap_has(b, loc(63, 2)));
+	require(bitmap_has(b, loc(64, 2)));
+	require(!bitmap_has(b, loc(65, 2)));
+	require(!bitmap_has(b, loc(63, 1)));
+	eq(bitmap_count(b), 3);
+	bitmap_off(b, loc(64, 2));
+	require(!bitmap_has(b, loc(64, 2)));
+	eq(bitmap_count(b), 2);
+	ok;
+}
+
+int test_setall(void *state) {
+	struct bitmap *b = state;
+
+	/* Row padding must stay clear */
+	bitmap_setall(b);
+	eq(bitmap_count(b), 5 * 150);
+	bitmap_wipe(b);
+	eq(bitmap_count(b), 0);
+	ok;
+}
+
+int test_rect(void *state) {
+	struct bitmap *b = state;
+
+	bitmap_wipe(b);
+	bitmap_rect_setall(b, loc(10, 1), loc(140, 3));
+	eq(bitmap_count(b), 131 * 3);
+	eq(bitmap_rect_count(b, loc(0, 0), loc(149, 4)), 131 * 3);
+	eq(bitmap_row_count(b, 2, 60, 70), 11);
+	require(!bitmap_has(b, loc(9, 2)));
+	require(bitmap_has(b, loc(10, 2)));
+	require(bitmap_has(b, loc(140, 2)));
+	require(!bitmap_has(b, loc(141, 2)));
+
+	bitmap_rect_wipe(b, loc(64, 2), loc(64, 2));
+	eq(bitmap_count(b), 131 * 3 - 1);
+	bitmap_row_wipe(b, 1, 0, 149);
+	eq(bitmap_count(b), 131 * 2 - 1);
+	bitmap_row_setall(b, 0, 63, 64);
+	eq(bitmap_row_count(b, 0, 0, 149), 2);
+	ok;
+}
+
+int test_combine(void *state) {
+	struct bitmap *b = state;
+	struct bitmap *c = bitmap_new(5, 150);
+
+	bitmap_wipe(b);
+	bitmap_rect_setall(b, loc(0, 0), loc(99, 4));
+	bitmap_rect_setall(c, loc(50, 0), loc(149, 4));
+
+	bitmap_inter(b, c);
+	eq(bitmap_count(b), 50 * 5);
+	bitmap_union(b, c);
+	eq(bitmap_count(b), 100 * 5);
+	bitmap_diff(b, c);
+	require(bitmap_is_empty(b));
+
+	bitmap_rect_copy(b, c, loc(0, 1), loc(75, 1));
+	eq(bitmap_count(b), 26);
+	bitmap_copy(b, c);
+	eq(bitmap_count(b), 100 * 5);
+	bitmap_rect_diff(b, c, loc(0, 0), loc(149, 3));
+	eq(bitmap_count(b), 100);
+	bitmap_rect_union(b, c, loc(140, 0), loc(149, 0));
+	eq(bitmap_count(b), 110);
+	bitmap_rect_inter(b, c, loc(0, 4), loc(60, 4));
+	eq(bitmap_count(b), 110);
+	bitmap_row_copy(b, c, 0, 0, 149);
+	eq(bitmap_count(b), 200);
+
+	bitmap_free(c);
+	ok;
+}
+
+int test_next(void *state) {
+	struct bitmap *b = state;
+
+	bitmap_wipe(b);
+	eq(bitmap_row_next(b, 1, 0, true), 150);
+	eq(bitmap_row_next(b, 1, 10, false), 10);
+	bitmap_row_setall(b, 1, 60, 130);
+	eq(bitmap_row_next(b, 1, 0, true), 60);
+	eq(bitmap_row_next(b, 1, 64, true), 64);
+	eq(bitmap_row_next(b, 1, 60, false), 131);
+	eq(bitmap_row_next(b, 1, 131, true), 150);
+
+	/* The padding after the last column is never found */
+	bitmap_row_setall(b, 1, 0, 149);
+	eq(bitmap_row_next(b, 1, 0, false), 150);
+	eq(bitmap_row_next(b, 1, 149, true), 149);
+	ok;
+}
+
+const char *suite_name = "z-bitmap/bitmap";
+struct test tests[] = {
+	{ "on_off", test_on_off },
+	{ "setall", test_setall },
+	{ "rect", test_rect },
+	{ "combine", test_combine },
+	{ "next", test_next },
+	{ NULL, NULL }
+};
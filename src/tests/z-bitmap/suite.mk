@@ -0,0 +1 @@
+TESTPROGS += z-bitmap/bitmap
@@ -195,11 +195,112 @@ int test_evaluate(void *state)
 	ok;
 }
 
+static s32b fold_base = 0;
+
+s32b test_fold_base(void)
+{
+	return fold_base;
+}
+
+int test_fold(void *state)
+{
+	expression_t *constant = expression_new();
+	expression_t *variable = expression_new();
+	dice_t *new = dice_new();
+	random_value v;
+
+	/* Constant expressions give their value, others are evaluated anew */
+	require(expression_add_operations_string(constant, "+ 4") > 0);
+	expression_set_base_value(variable, test_fold_base);
+	require(expression_add_operations_string(variable, "* 2") > 0);
+	require(dice_parse_string(new, "$B + $Xd6M$U"));
+	require(dice_bind_expression(new, "B", constant) >= 0);
+	require(dice_bind_expression(new, "X", variable) >= 0);
+
+	fold_base = 1;
+	dice_random_value(new, &v);
+	require(v.base == 4);
+	require(v.dice == 2);
+	require(v.sides == 6);
+	require(v.m_bonus == 0);
+
+	fold_base = 5;
+	dice_random_value(new, &v);
+	require(v.base == 4);
+	require(v.dice == 10);
+
+	/* Reparsing forgets the expressions */
+	require(dice_parse_string(new, "7"));
+	dice_random_value(new, &v);
+	require(v.base == 7);
+	require(v.dice == 0);
+
+	dice_free(new);
+	expression_free(constant);
+	expression_free(variable);
+	ok;
+}
+
+/* Dice for the timing tests, as a monster spell's damage might be given */
+static dice_t *bench_dice;
+static expression_t *bench_expression;
+
+static s32b bench_base(void)
+{
+	return 30;
+}
+
+static int bench_setup(void *state)
+{
+	bench_dice = dice_new();
+	bench_expression = expression_new();
+	expression_set_base_value(bench_expression, bench_base);
+	require(expression_add_operations_string(bench_expression, "* 3 / 2") > 0);
+	require(dice_parse_string(bench_dice, "$B+3d8M4"));
+	require(dice_bind_expression(bench_dice, "B", bench_expression) >= 0);
+	return 0;
+}
+
+static int bench_teardown(void *state)
+{
+	dice_free(bench_dice);
+	expression_free(bench_expression);
+	return 0;
+}
+
+int bench_roll(void *state, int iters)
+{
+	random_value v;
+	long total = 0;
+	int i;
+
+	for (i = 0; i < iters; i++)
+		total += dice_roll(bench_dice, &v);
+	require(total >= 48L * iters);
+	return 0;
+}
+
+int bench_evaluate(void *state, int iters)
+{
+	random_value v;
+	long total = 0;
+	int i;
+
+	for (i = 0; i < iters; i++)
+		total += dice_evaluate(bench_dice, i % 100, RANDOMISE, &v);
+	require(total >= 48L * iters);
+	return 0;
+}
+
 const char *suite_name = "z-dice/dice";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "parse-success", test_parse_success },
 	{ "parse-failure", test_parse_failure },
 	{ "evaluate", test_evaluate },
+	{ "fold", test_fold },
+	{ "bench-roll", BENCH_SETUP(bench_setup, bench_roll, bench_teardown) },
+	{ "bench-evaluate",
+	  BENCH_SETUP(bench_setup, bench_evaluate, bench_teardown) },
 	{ NULL, NULL },
 };
@@ -150,11 +150,29 @@ int test_evaluate(void *state)
 	ok;
 }
 
+int bench_evaluate(void *state, int iters)
+{
+	expression_t *new = expression_new();
+	long total = 0;
+	int i;
+
+	expression_set_base_value(new, base_value_2);
+	require(expression_add_operations_string(new, "* 3 - 1") > 0);
+	for (i = 0; i < iters; i++)
+		total += expression_evaluate(new);
+	expression_free(new);
+
+	/* 9 * 3 - 1 */
+	eq(total, 26L * iters);
+	return 0;
+}
+
 const char *suite_name = "z-expression/expression";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "parse-success", test_parse_success },
 	{ "parse-failure", test_parse_failure },
 	{ "evaluate", test_evaluate },
+	{ "bench-evaluate", BENCH(bench_evaluate) },
 	{ NULL, NULL },
 };
@@ -0,0 +1,204 @@
+/* z-file/file.c */
+
+#include "unit-test.h"
+#include "test-utils.h"
+#include "init.h"
+#include "z-file.h"
+
+#define TEST_FILE "Test-zfile"
+
+int setup_tests(void **state) {
+	set_file_paths();
+	return 0;
+}
+
+int teardown_tests(void *state) {
+	file_delete(TEST_FILE);
+	return 0;
+}
+
+/**
+ * Make the test file with the given contents, and open it for reading
+ */
+static ang_file *test_file(const char *contents, size_t len)
+{
+	ang_file *f = file_open(TEST_FILE, MODE_WRITE, FTYPE_TEXT);
+
+	if (!f) return NULL;
+	file_write(f, contents, len);
+	file_close(f);
+	return file_open(TEST_FILE, MODE_READ, FTYPE_TEXT);
+}
+
+int test_getline(void *state) {
+	const char text[] = "one\ntwo\r\nthree\rfour\n\nfive";
+	ang_file *f = test_file(text, sizeof(text) - 1);
+	const char *line;
+	size_t len;
+
+	notnull(f);
+	require(file_getline(f, &line, &len));
+	require(streq(line, "one"));
+	eq(len, 3);
+	require(file_getline(f, &line, &len));
+	require(streq(line, "two"));
+	require(file_getline(f, &line, &len));
+	require(streq(line, "three"));
+	require(file_getline(f, &line, &len));
+	require(streq(line, "four"));
+	require(file_getline(f, &line, &len));
+	eq(len, 0);
+	require(file_getline(f, &line, &len));
+	require(streq(line, "five"));
+	eq(len, 4);
+	require(!file_getline(f, &line, &len));
+	file_close(f);
+	ok;
+}
+
+int test_long(void *state) {
+	size_t size = 100000, i;
+	char *text = mem_alloc(size);
+	ang_file *f;
+	const char *line;
+	size_t len;
+
+	/* One line much longer than the read-ahead, and a short one */
+	for (i = 0; i < size; i++)
+		text[i] = 'a' + i % 26;
+	text[size - 3] = '\r';
+	text[size - 2] = '\n';
+	text[size - 1] = 'z';
+	f = test_file(text, size);
+	notnull(f);
+	require(file_getline(f, &line, &len));
+	eq(len, size - 3);
+	eq(memcmp(line, text, len), 0);
+	require(file_getline(f, &line, &len));
+	require(streq(line, "z"));
+	require(!file_getline(f, &line, &len));
+	file_close(f);
+	mem_free(text);
+	ok;
+}
+
+int test_getl(void *state) {
+	const char text[] = "a\tb\r\nabcdefghij\nlast";
+	ang_file *f = test_file(text, sizeof(text) - 1);
+	char buf[8];
+	byte b;
+
+	/* Tabs are expanded, and long lines split */
+	notnull(f);
+	require(file_getl(f, buf, sizeof(buf)));
+	require(streq(buf, "a   b"));
+	require(file_getl(f, buf, sizeof(buf)));
+	require(streq(buf, "abcdefg"));
+	require(file_getl(f, buf, sizeof(buf)));
+	require(streq(buf, "hij"));
+
+	/* Byte reads and skips carry on from where lines left off */
+	require(file_readc(f, &b));
+	eq(b, 'l');
+	require(file_skip(f, 1));
+	require(file_getl(f, buf, sizeof(buf)));
+	require(streq(buf, "st"));
+	require(!file_getl(f, buf, sizeof(buf)));
+	file_close(f);
+	ok;
+}
+
+/**
+ * Count the lines of the text files in a lib directory, by one of three ways:
+ * a byte at a time as file_getl() used to, with file_getl(), or with
+ * file_getline()
+ */
+static int count_lines(const char *dir, int how)
+{
+	ang_dir *d = my_dopen(dir);
+	char name[1024], path[1024], buf[1024];
+	int lines = 0;
+
+	if (!d) return 0;
+	while (my_dread(d, name, sizeof(name))) {
+		ang_file *f;
+
+		if (!suffix(name, ".txt") && !suffix(name, ".prf")) continue;
+		path_build(path, sizeof(path), dir, name);
+		f = file_open(path, MODE_READ, FTYPE_TEXT);
+		if (!f) continue;
+
+		if (how == 0) {
+			byte b;
+			while (file_readc(f, &b))
+				if (b == '\n') lines++;
+		} else if (how == 1) {
+			while (file_getl(f, buf, sizeof(buf)))
+				lines++;
+		} else {
+			const char *line;
+			while (file_getline(f, &line, NULL))
+				lines++;
+		}
+		file_close(f);
+	}
+	my_dclose(d);
+	return lines;
+}
+
+/**
+ * Count the lines of the text files in all the lib directories read
+ */
+static int count_lib_lines(int how)
+{
+	const char *dirs[] = { ANGBAND_DIR_GAMEDATA, ANGBAND_DIR_CUSTOMIZE,
+						   ANGBAND_DIR_HELP, ANGBAND_DIR_SCREENS };
+	int i, lines = 0;
+
+	for (i = 0; i < (int) N_ELEMENTS(dirs); i++)
+		lines += count_lines(dirs[i], how);
+	return lines;
+}
+
+int test_lib(void *state) {
+	int lines = count_lib_lines(0);
+
+	/* The lib files all end their lines, and none are too long */
+	require(lines > 0);
+	eq(count_lib_lines(1), lines);
+	eq(count_lib_lines(2), lines);
+	ok;
+}
+
+static int bench_lib(int how, int iters) {
+	int i, lines = 0;
+
+	for (i = 0; i < iters; i++)
+		lines += count_lib_lines(how);
+	require(lines > 0);
+	return 0;
+}
+
+int bench_readc(void *state, int iters) {
+	return bench_lib(0, iters);
+}
+
+int bench_getl(void *state, int iters) {
+	return bench_lib(1, iters);
+}
+
+int bench_getline(void *state, int iters) {
+	return bench_lib(2, iters);
+}
+
+const char *suite_name = "z-file/file";
+struct test tests[] = {
+	{ "getline", test_getline },
+	{ "long", test_long },
+	{ "getl", test_getl },
+	{ "lib", test_lib },
+	{ "bench_readc", BENCH(bench_readc) },
+	{ "bench_getl", BENCH(bench_getl) },
+	{ "bench_getline", BENCH(bench_getline) },
+	{ NULL, NULL }
+};
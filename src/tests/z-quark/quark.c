@@ -1,6 +1,7 @@
 /* z-quark/quark.c */
 
 #include "unit-test.h"
+#include "z-form.h"
 #include "z-quark.h"
 
 int setup_tests(void **state) {
@@ -46,9 +47,36 @@ int test_dedup(void *state) {
 	ok;
 }
 
+/* Names looked up over and over by the timing test */
+#define BENCH_NAMES 64
+static char bench_names[BENCH_NAMES][16];
+
+static int bench_setup(void *state) {
+	int i;
+
+	for (i = 0; i < BENCH_NAMES; i++)
+		strnfmt(bench_names[i], sizeof(bench_names[i]), "bench-%d", i);
+	return 0;
+}
+
+int bench_add(void *state, int iters) {
+	quark_t first = quark_add(bench_names[0]);
+	int i;
+
+	/* Past the first round, every name is already there */
+	for (i = 0; i < iters; i++) {
+		quark_t q = quark_add(bench_names[i % BENCH_NAMES]);
+
+		require(quark_str(q));
+	}
+	eq(quark_add(bench_names[0]), first);
+	return 0;
+}
+
 const char *suite_name = "z-quark/quark";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "dedup", test_dedup },
+	{ "bench-add", BENCH_SETUP(bench_setup, bench_add, NULL) },
 	{ NULL, NULL }
 };
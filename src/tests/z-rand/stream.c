@@ -0,0 +1,127 @@
+/* z-rand/stream */
+
+#include "unit-test.h"
+#include "z-rand.h"
+
+NOSETUP
+NOTEARDOWN
+
+/* Numbers filled in at a time for the fill benchmark */
+#define BENCH_FILL 1024
+
+int test_independent(void *state) {
+	u32b a[8], b[8];
+	int i, old;
+
+	/* Draws from one stream don't change what another gives */
+	Rand_state_init(0x5eed);
+	Rand_quick = false;
+	for (i = 0; i < 8; i++)
+		a[i] = Rand_div(1000);
+
+	Rand_state_init(0x5eed);
+	old = Rand_stream_select(RNG_COMBAT);
+	eq(old, RNG_GAME);
+	for (i = 0; i < 100; i++)
+		Rand_div(1000);
+	eq(Rand_stream_select(old), RNG_COMBAT);
+	for (i = 0; i < 8; i++)
+		b[i] = Rand_div(1000);
+	eq(memcmp(a, b, sizeof(a)), 0);
+
+	/* Different streams give different numbers */
+	Rand_state_init(0x5eed);
+	Rand_stream_select(RNG_GEN);
+	for (i = 0; i < 8; i++)
+		b[i] = Rand_div(1000);
+	Rand_stream_select(RNG_GAME);
+	require(memcmp(a, b, sizeof(a)) != 0);
+	ok;
+}
+
+int test_fill(void *state) {
+	u32b a[64], b[64];
+	int i;
+
+	/* Filling gives what drawing one at a time would */
+	Rand_state_init(0x5eed);
+	Rand_quick = false;
+	Rand_stream_select(RNG_STORE);
+	for (i = 0; i < 64; i++)
+		a[i] = Rand_div(37);
+	Rand_stream_select(RNG_GAME);
+
+	Rand_state_init(0x5eed);
+	Rand_stream_fill(RNG_STORE, b, 64, 37);
+	eq(memcmp(a, b, sizeof(a)), 0);
+	for (i = 0; i < 64; i++)
+		require(b[i] < 37);
+	ok;
+}
+
+int test_save(void *state) {
+	struct rand_state s;
+	struct rand_stream_state st;
+	u32b a[8], b[8];
+	int i;
+
+	/* A saved state gives the same numbers from every stream again */
+	Rand_state_init(0x5eed);
+	Rand_quick = false;
+	Rand_stream_select(RNG_MONSTER);
+	Rand_state_save(&s);
+	for (i = 0; i < 8; i++)
+		a[i] = Rand_div(1000);
+	Rand_stream_fill(RNG_COSMETIC, a, 4, 1000);
+
+	Rand_state_restore(&s);
+	for (i = 0; i < 8; i++)
+		b[i] = Rand_div(1000);
+	Rand_stream_fill(RNG_COSMETIC, b, 4, 1000);
+	eq(memcmp(a, b, sizeof(a)), 0);
+
+	/* One stream can be copied out and put back, selected or not */
+	Rand_stream_get(RNG_MONSTER, &st);
+	a[0] = Rand_div(1000);
+	Rand_stream_set(RNG_MONSTER, &st);
+	eq(Rand_div(1000), a[0]);
+	Rand_stream_select(RNG_GAME);
+	Rand_stream_set(RNG_MONSTER, &st);
+	Rand_stream_select(RNG_MONSTER);
+	eq(Rand_div(1000), a[0]);
+	Rand_stream_select(RNG_GAME);
+	ok;
+}
+
+int bench_div(void *state, int iters) {
+	u32b total = 0;
+	int i;
+
+	for (i = 0; i < iters; i++)
+		total += Rand_div(100);
+	require(total <= 99 * (u32b) iters);
+	return 0;
+}
+
+int bench_fill(void *state, int iters) {
+	u32b buf[BENCH_FILL];
+	int i, n;
+
+	for (i = 0; i < iters; i += n) {
+		n = MIN(BENCH_FILL, iters - i);
+		Rand_stream_fill(RNG_COMBAT, buf, n, 100);
+	}
+	for (i = 0; i < n; i++)
+		require(buf[i] < 100);
+	return 0;
+}
+
+const char *suite_name = "z-rand/stream";
+struct test tests[] = {
+	{ "independent", test_independent },
+	{ "fill", test_fill },
+	{ "save", test_save },
+	{ "bench_div", BENCH(bench_div) },
+	{ "bench_fill", BENCH(bench_fill) },
+	{ NULL, NULL }
+};
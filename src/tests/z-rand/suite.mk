@@ -0,0 +1 @@
+TESTPROGS += z-rand/stream
@@ -3,6 +3,7 @@
 #include "unit-test.h"
 #include "z-color.h"
 #include "z-textblock.h"
+#include "z-virt.h"
 
 int setup_tests(void **state) {
 	ok;
@@ -81,11 +82,49 @@ int test_length(void *state) {
 	ok;
 }
 
+/* A description to wrap, about as long as a monster's recall */
+static textblock *bench_tb;
+
+static int bench_setup(void *state) {
+	int i;
+
+	bench_tb = textblock_new();
+	for (i = 0; i < 12; i++) {
+		textblock_append(bench_tb, "It can breathe ");
+		textblock_append_c(bench_tb, COLOUR_L_RED, "fire");
+		textblock_append(bench_tb, ", and is resistant to cold and "
+						 "poison.  It may carry one or two good objects.  ");
+	}
+	textblock_append(bench_tb, "\nIt is worth 350 points.\n");
+	return 0;
+}
+
+static int bench_teardown(void *state) {
+	textblock_free(bench_tb);
+	return 0;
+}
+
+int bench_wrap(void *state, int iters) {
+	int i;
+
+	for (i = 0; i < iters; i++) {
+		size_t *line_starts = NULL, *line_lengths = NULL;
+		size_t lines = textblock_calculate_lines(bench_tb, &line_starts,
+												 &line_lengths, 40 + i % 40);
+
+		mem_free(line_starts);
+		mem_free(line_lengths);
+		require(lines > 2);
+	}
+	return 0;
+}
+
 const char *suite_name = "z-textblock/textblock";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "append", test_append },
 	{ "colour", test_colour },
 	{ "length", test_length },
+	{ "bench-wrap", BENCH_SETUP(bench_setup, bench_wrap, bench_teardown) },
 	{ NULL, NULL }
 };
@@ -25,9 +25,130 @@ int test_realloc(void *state) {
 	return 0;
 }
 
+int test_tally(void *state) {
+	void *old = mem_alloc(100);
+	void *p1, *p2;
+
+	mem_tally_reset();
+	mem_flags |= MEM_TALLY;
+
+	/* Freeing older memory first doesn't hide the later rise */
+	mem_free(old);
+	p1 = mem_alloc(40);
+	p2 = mem_realloc(NULL, 10);
+	p2 = mem_realloc(p2, 30);
+	eq(mem_tally_peak(), 70);
+	mem_free(p1);
+	mem_free(p2);
+	p1 = mem_alloc(20);
+	eq(mem_tally_peak(), 70);
+
+	mem_flags &= ~MEM_TALLY;
+	mem_free(p1);
+	eq(mem_tally_peak(), 70);
+	return 0;
+}
+
+int test_arena(void *state) {
+	struct mem_arena *a = mem_arena_new(256);
+	char *p1, *p2, *big;
+	size_t held;
+
+	/* Small pieces share a block, zeroed and aligned */
+	p1 = mem_arena_alloc(a, 3);
+	p2 = mem_arena_alloc(a, 10);
+	require(p1 && p2);
+	require(!p1[0] && !p1[2] && !p2[9]);
+	eq(((size_t) p2) % sizeof(size_t), 0);
+	require(p2 >= p1 + 3);
+	held = mem_arena_held(a);
+	eq(held, 256);
+	memset(p2, 1, 10);
+
+	/* A big piece gets a block of its own, and the small block carries on */
+	big = mem_arena_alloc(a, 1000);
+	eq(mem_arena_held(a), held + 1000);
+	p1 = mem_arena_alloc(a, 8);
+	eq(mem_arena_held(a), held + 1000);
+	require(p1 >= p2 + 10 && p1 < p2 + 256);
+	require(big[0] == 0 && big[999] == 0);
+
+	require(mem_arena_alloc(a, 0) == NULL);
+	mem_arena_free(a);
+	return 0;
+}
+
+/* Count the report's lines, and those that mention this file */
+static int report_lines, report_here;
+
+static void report_line(const char *line, void *data) {
+	report_lines++;
+	if (strstr(line, (const char *) data))
+		report_here++;
+}
+
+int test_track(void *state) {
+	struct mem_track_stats stats;
+	void *p[10];
+	int zline, line, i;
+
+	mem_flags |= MEM_TRACK;
+	mem_track_sample(1);
+
+	/* Allocations are counted against where they are made */
+	for (i = 0; i < 10; i++) {
+		zline = __LINE__ + 1;
+		p[i] = mem_zalloc(10 + i);
+	}
+	require(mem_track_lookup(__FILE__, zline, &stats));
+	eq(stats.allocs, 10);
+	eq(stats.bytes, 145);
+	eq(stats.live_blocks, 10);
+	eq(stats.peak_bytes, 145);
+
+	/* A realloc moves the block to the new place */
+	line = __LINE__ + 1;
+	p[0] = mem_realloc(p[0], 100);
+	for (i = 1; i < 10; i++)
+		mem_free(p[i]);
+	require(mem_track_lookup(__FILE__, zline, &stats));
+	eq(stats.live_blocks, 0);
+	eq(stats.live_bytes, 0);
+	eq(stats.peak_bytes, 145);
+	require(mem_track_lookup(__FILE__, line, &stats));
+	eq(stats.live_bytes, 100);
+
+	/* Frees are still followed once tracking stops; reports list both */
+	mem_flags &= ~MEM_TRACK;
+	report_lines = report_here = 0;
+	mem_track_report(report_line, (void *) __FILE__, 1000);
+	require(report_here >= 3);
+	mem_free(p[0]);
+	require(mem_track_lookup(__FILE__, line, &stats));
+	eq(stats.live_blocks, 0);
+
+	/* Sampling tracks some allocations but not all */
+	mem_flags |= MEM_TRACK;
+	mem_track_sample(4);
+	mem_track_reset();
+	for (i = 0; i < 1000; i++) {
+		line = __LINE__ + 1;
+		mem_free(mem_alloc(8));
+	}
+	mem_flags &= ~MEM_TRACK;
+	mem_track_sample(1);
+	require(mem_track_lookup(__FILE__, line, &stats));
+	require(stats.allocs > 100 && stats.allocs < 500);
+	eq(stats.live_blocks, 0);
+	return 0;
+}
+
 const char *suite_name = "z-virt/mem";
 struct test tests[] = {
 	{ "alloc", test_alloc },
 	{ "realloc", test_realloc },
+	{ "tally", test_tally },
+	{ "arena", test_arena },
+	{ "track", test_track },
 	{ NULL, NULL }
 };
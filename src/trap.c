@@ -135,7 +135,7 @@ static bool square_verify_trap(struct chunk *c, struct loc grid, int vis)
     /* No traps in this location. */
     if (!trap_exists) {
 		/* No traps */
-		sqinfo_off(square(c, grid).info, SQUARE_TRAP);
+		sqinfo_off(c, grid, SQUARE_TRAP);
 
 		/* Take note */
 		square_note_spot(c, grid);
@@ -240,6 +240,32 @@ static int pick_trap(struct chunk *c, int feat, int trap_level)
     return i < z_info->trap_max ? i : -1;
 }
 
+/**
+ * Get a blank trap for a chunk.  Traps come out of the chunk's arena, so they
+ * last as long as the chunk unless they are handed back with trap_free().
+ */
+struct trap *trap_new(struct chunk *c)
+{
+	struct trap *trap = c->spare_traps;
+
+	if (trap) {
+		c->spare_traps = trap->next;
+		memset(trap, 0, sizeof(*trap));
+	} else {
+		trap = mem_arena_alloc(c->arena, sizeof(*trap));
+	}
+	return trap;
+}
+
+/**
+ * Hand back a trap which has been taken off a chunk, so it can be reused
+ */
+void trap_free(struct chunk *c, struct trap *trap)
+{
+	trap->next = c->spare_traps;
+	c->spare_traps = trap;
+}
+
 /**
  * Make a new trap of the given type.  Return true if successful.
  *
@@ -265,7 +291,7 @@ void place_trap(struct chunk *c, struct loc grid, int t_idx, int trap_level)
     if (t_idx < 0) return;
 
 	/* Allocate a new trap for this grid (at the front of the list) */
-	new_trap = mem_zalloc(sizeof(*new_trap));
+	new_trap = trap_new(c);
 	new_trap->next = square_trap(c, grid);
 	square_set_trap(c, grid, new_trap);
 
@@ -277,7 +303,7 @@ void place_trap(struct chunk *c, struct loc grid, int t_idx, int trap_level)
 	trf_copy(new_trap->flags, trap_info[t_idx].flags);
 
 	/* Toggle on the trap marker */
-	sqinfo_on(square(c, grid).info, SQUARE_TRAP);
+	sqinfo_on(c, grid, SQUARE_TRAP);
 
 	/* Redraw the grid */
 	square_light_spot(c, grid);
@@ -292,7 +318,7 @@ void square_free_trap(struct chunk *c, struct loc grid)
 
 	while (trap) {
 		next = trap->next;
-		mem_free(trap);
+		trap_free(c, trap);
 		trap = next;
 	}
 }
@@ -476,7 +502,7 @@ bool square_remove_all_traps(struct chunk *c, struct loc grid)
 	assert(square_in_bounds(c, grid));
 	while (trap) {
 		struct trap *next_trap = trap->next;
-		mem_free(trap);
+		trap_free(c, trap);
 		trap = next_trap;
 	}
 
@@ -513,7 +539,7 @@ bool square_remove_trap(struct chunk *c, struct loc grid, int t_idx_remove)
 		struct trap *next_trap = trap->next;
 
 		if (t_idx_remove == trap->t_idx) {
-			mem_free(trap);
+			trap_free(c, trap);
 			removed = true;
 
 			if (prev_trap) {
@@ -101,6 +101,8 @@ bool square_reveal_trap(struct chunk *c, struct loc grid, bool always,
 bool trap_check_hit(int power);
 void hit_trap(struct loc grid, int delayed);
 bool square_player_trap_allowed(struct chunk *c, struct loc grid);
+struct trap *trap_new(struct chunk *c);
+void trap_free(struct chunk *c, struct trap *trap);
 void place_trap(struct chunk *c, struct loc grid, int t_idx, int trap_level);
 void square_free_trap(struct chunk *c, struct loc grid);
 void wipe_trap_list(struct chunk *c);
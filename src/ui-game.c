@@ -19,6 +19,7 @@
 
 #include "angband.h"
 #include "cmds.h"
+#include "cmd-journal.h"
 #include "datafile.h"
 #include "game-world.h"
 #include "grafmode.h"
@@ -55,6 +56,7 @@
 
 
 bool arg_wizard;			/* Command arg -- Request wizard mode */
+char arg_journal[1024];		/* Command arg -- Record a journal to this file */
 
 /**
  * Buffer to hold the current savefile name
@@ -352,6 +354,7 @@ void check_for_player_interrupt(game_event_type type, game_event_data *data,
 			/* Flush and disturb */
 			event_signal(EVENT_INPUT_FLUSH);
 			disturb(player, 0);
+			journal_interrupt();
 			msg("Cancelled.");
 		}
 	}
@@ -427,15 +430,20 @@ void play_game(bool new_game)
 	/* Load a savefile or birth a character, or both */
 	start_game(new_game);
 
+	/* Keep a journal of the game if asked to */
+	if (arg_journal[0] && !journal_open(arg_journal))
+		plog_fmt("Couldn't start a journal in %s.", arg_journal);
+
 	/* Get commands from the user, then process the game world until the
 	 * command queue is empty and a new player command is needed */
 	while (!player->is_dead && player->upkeep->playing) {
 		pre_turn_refresh();
-		cmd_get_hook(CMD_GAME);
+		cmdq_fill(CMD_GAME);
 		run_game_loop();
 	}
 
 	/* Close game on death or quitting */
+	journal_close();
 	close_game();
 }
 
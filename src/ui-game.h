@@ -24,6 +24,7 @@
 #include "game-event.h"
 
 extern bool arg_wizard;
+extern char arg_journal[1024];
 extern char savefile[1024];
 
 void cmd_init(void);
@@ -245,18 +245,20 @@ bool show_file(const char *name, const char *what, int line, int mode)
 
 		/* Goto the selected line */
 		while (next < line) {
-			/* Get a line */
-			if (!file_getl(fff, buf, sizeof(buf))) break;
+			const char *skipped;
+
+			/* Get a line, without copying it */
+			if (!file_getline(fff, &skipped, NULL)) break;
 
 			/* Skip lines if we are inside a RST directive*/
 			if (skip_lines) {
-				if (contains_only_spaces(buf))
+				if (contains_only_spaces(skipped))
 					skip_lines=false;
 				continue;
 			}
 
 			/* Skip RST directives */
-			if (prefix(buf, ".. ")) {
+			if (prefix(skipped, ".. ")) {
 				skip_lines=true;
 				continue;
 			}
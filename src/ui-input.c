@@ -245,6 +245,10 @@ ui_event inkey_ex(void)
 			/* Mega-Hack -- reset signal counter */
 			signal_count = 0;
 
+			/* Use the wait for a command to build the next level */
+			if (inkey_flag && character_dungeon)
+				speculate_next_level(player);
+
 			/* Only once */
 			done = true;
 		}
@@ -40,6 +40,8 @@
  */
 static void hallucinatory_monster(int *a, wchar_t *c)
 {
+	int old_stream = Rand_stream_select(RNG_COSMETIC);
+
 	while (1) {
 		/* Select a random monster */
 		struct monster_race *race = &r_info[randint0(z_info->r_max)];
@@ -50,6 +52,7 @@ static void hallucinatory_monster(int *a, wchar_t *c)
 		/* Retrieve attr/char */
 		*a = monster_x_attr[race->ridx];
 		*c = monster_x_char[race->ridx];
+		Rand_stream_select(old_stream);
 		return;
 	}
 }
@@ -60,7 +63,8 @@ static void hallucinatory_monster(int *a, wchar_t *c)
  */
 static void hallucinatory_object(int *a, wchar_t *c)
 {
-	
+	int old_stream = Rand_stream_select(RNG_COSMETIC);
+
 	while (1) {
 		/* Select a random object */
 		struct object_kind *kind = &k_info[randint0(z_info->k_max - 1) + 1];
@@ -75,6 +79,7 @@ static void hallucinatory_object(int *a, wchar_t *c)
 		/* HACK - Skip empty entries */
 		if (*a == 0 || *c == 0) continue;
 
+		Rand_stream_select(old_stream);
 		return;
 	}
 }
@@ -269,8 +274,8 @@ void grid_data_as_text(struct grid_data *g, int *ap, wchar_t *cp, int *tap,
 				/* Multi-hued monster */
 				a = mon->attr ? mon->attr : da;
 				c = dc;
-			} else if (!flags_test(mon->race->flags, RF_SIZE,
-								   RF_ATTR_CLEAR, RF_CHAR_CLEAR, FLAG_END)) {
+			} else if (!rf_has(mon->race->flags, RF_ATTR_CLEAR) &&
+					   !rf_has(mon->race->flags, RF_CHAR_CLEAR)) {
 				/* Normal monster (not "clear" in any way) */
 				a = da;
 				/* Desired attr & char. da is not used, should a be set to it?*/
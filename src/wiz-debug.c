@@ -1686,7 +1686,7 @@ static void do_cmd_wiz_query(void)
 			if (!square_in_bounds_fully(cave, grid)) continue;
 
 			/* Given flag, show only those grids */
-			if (flag && !sqinfo_has(square(cave, grid).info, flag)) continue;
+			if (flag && !sqinfo_has(cave, grid, flag)) continue;
 
 			/* Given no flag, show known grids */
 			if (!flag && (!square_isknown(cave, grid))) continue;
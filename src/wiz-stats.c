@@ -1694,86 +1694,6 @@ void stats_collect(void)
 	}
 }
 
-#define DIST_MAX 10000
-
-void calc_cave_distances(int **cave_dist)
-{
-	int dist, i;
-	int oy, ox, ty, tx, d;
-
-	/* Squares with distance from player of n - 1 */
-	int d_x_old[DIST_MAX];
-	int d_y_old[DIST_MAX];
-	int d_old_max;
-
-	/* Squares with distance from player of n */
-	int d_x_new[DIST_MAX];
-	int d_y_new[DIST_MAX];
-	int d_new_max;
-
-	/* Get player location */
-	oy = d_y_old[0] = player->grid.y;
-	ox = d_x_old[0] = player->grid.x;
-	d_old_max = 1;
-
-	/* Distance from player starts at 0 */
-	dist = 0;
-
-	/* Assign the distance value to the first square (player) */
-	cave_dist[oy][ox] = dist;
-
-	do {
-		d_new_max = 0;
-		dist++;
-
-		/* Loop over all visited squares of the previous iteration */
-		for (i = 0; i < d_old_max; i++){
-
-			/* Get the square we want to look at */
-			oy = d_y_old[i];
-			ox = d_x_old[i];
-
-			/* debug
-			msg("x: %d y: %d dist: %d %d ",ox,oy,dist-1,i); */
-
-			/* Get all adjacent squares */
-			for (d = 0; d < 8; d++) {
-				/* Adjacent square location */
-				ty = oy + ddy_ddd[d];
-				tx = ox + ddx_ddd[d];
-
-				if (!(square_in_bounds_fully(cave, loc(tx, ty)))) continue;
-
-				/* Have we been here before? */
-				if (cave_dist[ty][tx] >= 0) continue;
-
-				/* Is it a wall? */
-				if (square_iswall(cave, loc(tx, ty))) continue;
-
-				/* Add the new location */
-				d_y_new[d_new_max] = ty;
-				d_x_new[d_new_max] = tx;
-
-				/* Assign the distance to that spot */
-				cave_dist[ty][tx] = dist;
-
-				d_new_max++;
-
-				/* debug
-				msg("x: %d y: %d dist: %d ",tx,ty,dist); */
-			}
-		}
-
-		/* Copy the new distance list to the old one */
-		for (i = 0; i < d_new_max; i++) {
-			d_y_old[i] = d_y_new[i];
-			d_x_old[i] = d_x_new[i];
-		}
-		d_old_max = d_new_max;
-
-	} while ((d_old_max > 0) || dist == DIST_MAX);
-}
-
 void pit_stats(void)
 {
 	int tries = 1000;
@@ -1851,6 +1771,14 @@ void pit_stats(void)
 }
 
 
+/**
+ * Squares the player can walk through without digging
+ */
+static bool square_isunwalled(struct chunk *c, struct loc grid)
+{
+	return !square_iswall(c, grid);
+}
+
 /**
  * Gather whether the dungeon has disconnects in it and whether the player
  * is disconnected from the stairs
@@ -1859,7 +1787,7 @@ void disconnect_stats(void)
 {
 	int i, y, x;
 
-	int **cave_dist;
+	struct cave_regions *regions;
 
 	bool has_dsc, has_dsc_from_stairs;
 
@@ -1889,6 +1817,8 @@ void disconnect_stats(void)
 	tries = temp;
 
 	for (i = 1; i <= tries; i++) {
+		int home;
+
 		/* Assume no disconnected areas */
 		has_dsc = false;
 
@@ -1898,18 +1828,9 @@ void disconnect_stats(void)
 		/* Make a new cave */
 		prepare_next_level(&cave, player);
 
-		/* Allocate the distance array */
-		cave_dist = mem_zalloc(cave->height * sizeof(int*));
-		for (y = 0; y < cave->height; y++)
-			cave_dist[y] = mem_zalloc(cave->width * sizeof(int));
-
-		/* Set all cave spots to inaccessible */
-		for (y = 0; y < cave->height; y++)
-			for (x = 1; x < cave->width; x++)
-				cave_dist[y][x] = -1;
-
-		/* Fill the distance array with the correct distances */
-		calc_cave_distances(cave_dist);
+		/* Label the open areas, and find the player's */
+		regions = cave_regions_new(cave, square_isunwalled, true);
+		home = cave_region(regions, player->grid);
 
 		/* Cycle through the dungeon */
 		for (y = 1; y < cave->height - 1; y++) {
@@ -1920,16 +1841,11 @@ void disconnect_stats(void)
 				if (square_iswall(cave, grid)) continue;
 
 				/* Can we get there? */
-				if (cave_dist[y][x] >= 0) {
+				if (cave_region(regions, grid) == home) {
 
 					/* Is it a  down stairs? */
-					if (square_isdownstairs(cave, grid)) {
-
+					if (square_isdownstairs(cave, grid))
 						has_dsc_from_stairs = false;
-
-						/* debug
-						msg("dist to stairs: %d",cave_dist[y][x]); */
-					}
 					continue;
 				}
 
@@ -1947,10 +1863,7 @@ void disconnect_stats(void)
 
 		msg("Iteration: %d",i); 
 
-		/* Free arrays */
-		for (y = 0; x < cave->height; x++)
-			mem_free(cave_dist[y]);
-		mem_free(cave_dist);
+		cave_regions_free(regions);
 	}
 
 	msg("Total levels with disconnected areas: %ld",dsc_area);
@@ -18,6 +18,60 @@
 
 #include "z-bitflag.h"
 
+/**
+ * Flag sets are stored as arrays of bytes, but the bulk operations below
+ * work a machine word at a time where the set is large enough.  Words are
+ * assembled with memcpy(), so no alignment is assumed, and nothing depends
+ * on byte order: words are only used for whole-word tests and counts, and
+ * individual flags are always located within a byte.
+ */
+typedef u64b flag_word;
+#define FLAG_WORD_SIZE    sizeof(flag_word)
+
+static flag_word flag_load(const bitflag *flags)
+{
+	flag_word w;
+	memcpy(&w, flags, FLAG_WORD_SIZE);
+	return w;
+}
+
+static void flag_store(bitflag *flags, flag_word w)
+{
+	memcpy(flags, &w, FLAG_WORD_SIZE);
+}
+
+/**
+ * Count the bits which are on in a word
+ */
+static int flag_word_count(flag_word w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(w);
+#else
+	w = w - ((w >> 1) & 0x5555555555555555ULL);
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+	w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (int) ((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * Find the lowest bit which is on in a non-zero byte
+ */
+static int flag_byte_first(bitflag b)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(b);
+#else
+	int i = 0;
+	while (!(b & 1)) {
+		b >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
 
 /**
  * Tests if a flag is "on" in a bitflag set.
@@ -70,15 +124,24 @@ bool flag_has_dbg(const bitflag *flags, const size_t size, const int flag,
  */
 int flag_next(const bitflag *flags, const size_t size, const int flag)
 {
-	const int max_flags = FLAG_MAX(size);
-	int f, flag_offset, flag_binary;
+	int f = MAX(flag, FLAG_START);
+	size_t i = FLAG_OFFSET(f);
+	bitflag first;
 
-	for (f = flag; f < max_flags; f++) {
-		flag_offset = FLAG_OFFSET(f);
-		flag_binary = FLAG_BINARY(f);
+	if (i >= size) return FLAG_END;
 
-		if (flags[flag_offset] & flag_binary) return f;
-	}
+	/* The flags at and after `flag` in its own byte */
+	first = flags[i] & (bitflag) (0xff << ((f - FLAG_START) % FLAG_WIDTH));
+	if (first)
+		return FLAG_START + (int) (i * FLAG_WIDTH) + flag_byte_first(first);
+
+	/* Skip empty words, then find the byte */
+	for (i++; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_load(flags + i)) break;
+	for (; i < size; i++)
+		if (flags[i])
+			return FLAG_START + (int) (i * FLAG_WIDTH) +
+				flag_byte_first(flags[i]);
 
 	return FLAG_END;
 }
@@ -91,16 +154,13 @@ int flag_next(const bitflag *flags, const size_t size, const int flag)
  */
 int flag_count(const bitflag *flags, const size_t size)
 {
-	size_t i, j;
+	size_t i = 0;
 	int count = 0;
 
-	for (i = 0; i < size; i++) {
-		for (j = 0; j < FLAG_WIDTH; j++) {
-			if (flags[i] & FLAG_BINARY(j)) {
-				count++;
-			}
-		}
-	}
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		count += flag_word_count(flag_load(flags + i));
+	for (; i < size; i++)
+		count += flag_word_count(flags[i]);
 
 	return count;
 }
@@ -114,9 +174,11 @@ int flag_count(const bitflag *flags, const size_t size)
  */
 bool flag_is_empty(const bitflag *flags, const size_t size)
 {
-	size_t i;
+	size_t i = 0;
 
-	for (i = 0; i < size; i++)
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_load(flags + i)) return false;
+	for (; i < size; i++)
 		if (flags[i] > 0) return false;
 
 	return true;
@@ -131,9 +193,11 @@ bool flag_is_empty(const bitflag *flags, const size_t size)
  */
 bool flag_is_full(const bitflag *flags, const size_t size)
 {
-	size_t i;
+	size_t i = 0;
 
-	for (i = 0; i < size; i++)
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_load(flags + i) != (flag_word) -1) return false;
+	for (; i < size; i++)
 		if (flags[i] != (bitflag) -1) return false;
 
 	return true;
@@ -149,9 +213,11 @@ bool flag_is_full(const bitflag *flags, const size_t size)
 bool flag_is_inter(const bitflag *flags1, const bitflag *flags2,
 				   const size_t size)
 {
-	size_t i;
+	size_t i = 0;
 
-	for (i = 0; i < size; i++)
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (flag_load(flags1 + i) & flag_load(flags2 + i)) return true;
+	for (; i < size; i++)
 		if (flags1[i] & flags2[i]) return true;
 
 	return false;
@@ -167,9 +233,11 @@ bool flag_is_inter(const bitflag *flags1, const bitflag *flags2,
 bool flag_is_subset(const bitflag *flags1, const bitflag *flags2,
 					const size_t size)
 {
-	size_t i;
+	size_t i = 0;
 
-	for (i = 0; i < size; i++)
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		if (~flag_load(flags1 + i) & flag_load(flags2 + i)) return false;
+	for (; i < size; i++)
 		if (~flags1[i] & flags2[i]) return false;
 
 	return true;
@@ -282,9 +350,11 @@ void flag_setall(bitflag *flags, const size_t size)
  */
 void flag_negate(bitflag *flags, const size_t size)
 {
-	size_t i;
-	
-	for (i = 0; i < size; i++)
+	size_t i = 0;
+
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE)
+		flag_store(flags + i, ~flag_load(flags + i));
+	for (; i < size; i++)
 		flags[i] = ~flags[i];
 }
 
@@ -310,11 +380,18 @@ void flag_copy(bitflag *flags1, const bitflag *flags2, const size_t size)
  */
 bool flag_union(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
-	size_t i;
+	size_t i = 0;
 	bool delta = false;
 
-	for (i = 0; i < size; i++) {
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE) {
+		flag_word w1 = flag_load(flags1 + i), w2 = flag_load(flags2 + i);
+
 		/* !flag_is_subset() */
+		if (~w1 & w2) delta = true;
+
+		flag_store(flags1 + i, w1 | w2);
+	}
+	for (; i < size; i++) {
 		if (~flags1[i] & flags2[i]) delta = true;
 
 		flags1[i] |= flags2[i];
@@ -333,18 +410,24 @@ bool flag_union(bitflag *flags1, const bitflag *flags2, const size_t size)
  */
 bool flag_inter(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
-	size_t i;
+	size_t i = 0;
 	bool delta = false;
 
-	for (i = 0; i < size; i++) {
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE) {
+		flag_word w1 = flag_load(flags1 + i), w2 = flag_load(flags2 + i);
+
 		/* !flag_is_equal() */
+		if (w1 != w2) delta = true;
+
+		flag_store(flags1 + i, w1 & w2);
+	}
+	for (; i < size; i++) {
 		if (!(flags1[i] == flags2[i])) delta = true;
 
 		flags1[i] &= flags2[i];
 	}
 
 	return delta;
-
 }
 
 
@@ -357,11 +440,18 @@ bool flag_inter(bitflag *flags1, const bitflag *flags2, const size_t size)
  */
 bool flag_diff(bitflag *flags1, const bitflag *flags2, const size_t size)
 {
-	size_t i;
+	size_t i = 0;
 	bool delta = false;
 
-	for (i = 0; i < size; i++) {
+	for (; i + FLAG_WORD_SIZE <= size; i += FLAG_WORD_SIZE) {
+		flag_word w1 = flag_load(flags1 + i), w2 = flag_load(flags2 + i);
+
 		/* flag_is_inter() */
+		if (w1 & w2) delta = true;
+
+		flag_store(flags1 + i, w1 & ~w2);
+	}
+	for (; i < size; i++) {
 		if (flags1[i] & flags2[i]) delta = true;
 
 		flags1[i] &= ~flags2[i];
@@ -0,0 +1,411 @@
+/**
+ * \file z-bitmap.c
+ * \brief Two-dimensional bit planes with word-wide bulk operations
+ *
+ * Copyright (c) 2026 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#include "z-bitmap.h"
+
+/**
+ * The ways the bulk operations combine a destination word with a source
+ */
+enum bitmap_op {
+	BITMAP_OP_WIPE,
+	BITMAP_OP_SET,
+	BITMAP_OP_COPY,
+	BITMAP_OP_UNION,
+	BITMAP_OP_INTER,
+	BITMAP_OP_DIFF
+};
+
+/**
+ * Allocate a new, empty bitmap
+ */
+struct bitmap *bitmap_new(int height, int width)
+{
+	struct bitmap *b = mem_zalloc(sizeof(*b));
+
+	b->height = height;
+	b->width = width;
+	b->stride = BITMAP_STRIDE(width);
+	b->words = mem_zalloc((size_t) height * b->stride * sizeof(bitmap_word));
+	return b;
+}
+
+/**
+ * Free a bitmap
+ */
+void bitmap_free(struct bitmap *b)
+{
+	if (!b) return;
+	mem_free(b->words);
+	mem_free(b);
+}
+
+/**
+ * Count the bits which are on in a single word
+ */
+int bitmap_word_count(bitmap_word w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_popcountll(w);
+#else
+	w = w - ((w >> 1) & 0x5555555555555555ULL);
+	w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+	w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (int) ((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * Find the position of the lowest bit which is on in a non-zero word
+ */
+int bitmap_word_first(bitmap_word w)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(w);
+#else
+	return bitmap_word_count((w & -w) - 1);
+#endif
+}
+
+/**
+ * Tests if the bit for a grid is on
+ */
+bool bitmap_has(const struct bitmap *b, struct loc grid)
+{
+	assert(grid.y >= 0 && grid.y < b->height);
+	assert(grid.x >= 0 && grid.x < b->width);
+	return (bitmap_row(b, grid.y)[BITMAP_OFFSET(grid.x)] &
+			BITMAP_BINARY(grid.x)) != 0;
+}
+
+/**
+ * Turns the bit for a grid on
+ */
+void bitmap_on(struct bitmap *b, struct loc grid)
+{
+	assert(grid.y >= 0 && grid.y < b->height);
+	assert(grid.x >= 0 && grid.x < b->width);
+	bitmap_row(b, grid.y)[BITMAP_OFFSET(grid.x)] |= BITMAP_BINARY(grid.x);
+}
+
+/**
+ * Turns the bit for a grid off
+ */
+void bitmap_off(struct bitmap *b, struct loc grid)
+{
+	assert(grid.y >= 0 && grid.y < b->height);
+	assert(grid.x >= 0 && grid.x < b->width);
+	bitmap_row(b, grid.y)[BITMAP_OFFSET(grid.x)] &= ~BITMAP_BINARY(grid.x);
+}
+
+/**
+ * Combine one destination word with a source word, touching only the bits
+ * in `mask`
+ */
+static void word_op(bitmap_word *d, bitmap_word s, bitmap_word mask,
+					enum bitmap_op op)
+{
+	bitmap_word result;
+
+	switch (op) {
+		case BITMAP_OP_WIPE: result = 0; break;
+		case BITMAP_OP_SET: result = ~(bitmap_word) 0; break;
+		case BITMAP_OP_COPY: result = s; break;
+		case BITMAP_OP_UNION: result = *d | s; break;
+		case BITMAP_OP_INTER: result = *d & s; break;
+		case BITMAP_OP_DIFF: result = *d & ~s; break;
+		default: return;
+	}
+
+	*d = (*d & ~mask) | (result & mask);
+}
+
+/**
+ * Combine whole words d[0..n-1] with s[0..n-1].
+ *
+ * Each case is a plain loop over words so the compiler can unroll and
+ * vectorise it.
+ */
+static void words_op(bitmap_word *d, const bitmap_word *s, size_t n,
+					 enum bitmap_op op)
+{
+	size_t i;
+
+	switch (op) {
+		case BITMAP_OP_WIPE:
+			memset(d, 0, n * sizeof(*d));
+			break;
+		case BITMAP_OP_SET:
+			for (i = 0; i < n; i++) d[i] = ~(bitmap_word) 0;
+			break;
+		case BITMAP_OP_COPY:
+			memcpy(d, s, n * sizeof(*d));
+			break;
+		case BITMAP_OP_UNION:
+			for (i = 0; i < n; i++) d[i] |= s[i];
+			break;
+		case BITMAP_OP_INTER:
+			for (i = 0; i < n; i++) d[i] &= s[i];
+			break;
+		case BITMAP_OP_DIFF:
+			for (i = 0; i < n; i++) d[i] &= ~s[i];
+			break;
+	}
+}
+
+/**
+ * Apply an operation to columns x1..x2 (inclusive) of one row
+ */
+static void row_op(bitmap_word *d, const bitmap_word *s, int x1, int x2,
+				   enum bitmap_op op)
+{
+	int w1 = BITMAP_OFFSET(x1), w2 = BITMAP_OFFSET(x2);
+	bitmap_word first = ~(bitmap_word) 0 << (x1 % BITMAP_WORD_BITS);
+	bitmap_word last = ~(bitmap_word) 0 >>
+		(BITMAP_WORD_BITS - 1 - x2 % BITMAP_WORD_BITS);
+
+	if (w1 == w2) {
+		word_op(d + w1, s ? s[w1] : 0, first & last, op);
+		return;
+	}
+
+	word_op(d + w1, s ? s[w1] : 0, first, op);
+	if (w2 > w1 + 1)
+		words_op(d + w1 + 1, s ? s + w1 + 1 : NULL, w2 - w1 - 1, op);
+	word_op(d + w2, s ? s[w2] : 0, last, op);
+}
+
+/**
+ * Apply an operation to a rectangle, corners inclusive
+ */
+static void rect_op(struct bitmap *dest, const struct bitmap *src,
+					struct loc top_left, struct loc bottom_right,
+					enum bitmap_op op)
+{
+	int y;
+
+	assert(top_left.y >= 0 && bottom_right.y < dest->height);
+	assert(top_left.x >= 0 && bottom_right.x < dest->width);
+	assert(!src || (src->height == dest->height && src->width == dest->width));
+
+	if (top_left.x > bottom_right.x) return;
+	for (y = top_left.y; y <= bottom_right.y; y++)
+		row_op(bitmap_row(dest, y), src ? bitmap_row(src, y) : NULL,
+			   top_left.x, bottom_right.x, op);
+}
+
+/**
+ * Apply an operation to every word of a bitmap
+ */
+static void whole_op(struct bitmap *dest, const struct bitmap *src,
+					 enum bitmap_op op)
+{
+	assert(src->height == dest->height && src->width == dest->width);
+	words_op(dest->words, src->words, (size_t) dest->height * dest->stride, op);
+}
+
+/**
+ * Turn every bit off
+ */
+void bitmap_wipe(struct bitmap *b)
+{
+	memset(b->words, 0, (size_t) b->height * b->stride * sizeof(bitmap_word));
+}
+
+/**
+ * Turn every bit on
+ */
+void bitmap_setall(struct bitmap *b)
+{
+	if (!b->height || !b->width) return;
+	rect_op(b, NULL, loc(0, 0), loc(b->width - 1, b->height - 1),
+			BITMAP_OP_SET);
+}
+
+/**
+ * Copy all bits of `src` into `dest`; both must be the same size
+ */
+void bitmap_copy(struct bitmap *dest, const struct bitmap *src)
+{
+	whole_op(dest, src, BITMAP_OP_COPY);
+}
+
+/**
+ * Turn on in `dest` every bit which is on in `src`
+ */
+void bitmap_union(struct bitmap *dest, const struct bitmap *src)
+{
+	whole_op(dest, src, BITMAP_OP_UNION);
+}
+
+/**
+ * Turn off in `dest` every bit which is off in `src`
+ */
+void bitmap_inter(struct bitmap *dest, const struct bitmap *src)
+{
+	whole_op(dest, src, BITMAP_OP_INTER);
+}
+
+/**
+ * Turn off in `dest` every bit which is on in `src`
+ */
+void bitmap_diff(struct bitmap *dest, const struct bitmap *src)
+{
+	whole_op(dest, src, BITMAP_OP_DIFF);
+}
+
+/**
+ * Count the bits which are on
+ */
+int bitmap_count(const struct bitmap *b)
+{
+	size_t i, n = (size_t) b->height * b->stride;
+	int count = 0;
+
+	for (i = 0; i < n; i++)
+		count += bitmap_word_count(b->words[i]);
+
+	return count;
+}
+
+/**
+ * Tests a bitmap for emptiness
+ */
+bool bitmap_is_empty(const struct bitmap *b)
+{
+	size_t i, n = (size_t) b->height * b->stride;
+
+	for (i = 0; i < n; i++)
+		if (b->words[i]) return false;
+
+	return true;
+}
+
+/**
+ * Rectangle versions of the bulk operations; the corners are inclusive
+ * and must lie inside the bitmap
+ */
+void bitmap_rect_wipe(struct bitmap *b, struct loc top_left,
+					  struct loc bottom_right)
+{
+	rect_op(b, NULL, top_left, bottom_right, BITMAP_OP_WIPE);
+}
+
+void bitmap_rect_setall(struct bitmap *b, struct loc top_left,
+						struct loc bottom_right)
+{
+	rect_op(b, NULL, top_left, bottom_right, BITMAP_OP_SET);
+}
+
+void bitmap_rect_copy(struct bitmap *dest, const struct bitmap *src,
+					  struct loc top_left, struct loc bottom_right)
+{
+	rect_op(dest, src, top_left, bottom_right, BITMAP_OP_COPY);
+}
+
+void bitmap_rect_union(struct bitmap *dest, const struct bitmap *src,
+					   struct loc top_left, struct loc bottom_right)
+{
+	rect_op(dest, src, top_left, bottom_right, BITMAP_OP_UNION);
+}
+
+void bitmap_rect_inter(struct bitmap *dest, const struct bitmap *src,
+					   struct loc top_left, struct loc bottom_right)
+{
+	rect_op(dest, src, top_left, bottom_right, BITMAP_OP_INTER);
+}
+
+void bitmap_rect_diff(struct bitmap *dest, const struct bitmap *src,
+					  struct loc top_left, struct loc bottom_right)
+{
+	rect_op(dest, src, top_left, bottom_right, BITMAP_OP_DIFF);
+}
+
+int bitmap_rect_count(const struct bitmap *b, struct loc top_left,
+					  struct loc bottom_right)
+{
+	int y, count = 0;
+
+	for (y = top_left.y; y <= bottom_right.y; y++)
+		count += bitmap_row_count(b, y, top_left.x, bottom_right.x);
+
+	return count;
+}
+
+/**
+ * Row versions of the bulk operations, covering columns x1..x2 inclusive
+ */
+void bitmap_row_wipe(struct bitmap *b, int y, int x1, int x2)
+{
+	rect_op(b, NULL, loc(x1, y), loc(x2, y), BITMAP_OP_WIPE);
+}
+
+void bitmap_row_setall(struct bitmap *b, int y, int x1, int x2)
+{
+	rect_op(b, NULL, loc(x1, y), loc(x2, y), BITMAP_OP_SET);
+}
+
+void bitmap_row_copy(struct bitmap *dest, const struct bitmap *src, int y,
+					 int x1, int x2)
+{
+	rect_op(dest, src, loc(x1, y), loc(x2, y), BITMAP_OP_COPY);
+}
+
+/**
+ * Find the first column at or after x in row y whose bit is `on` (or off,
+ * if `on` is false); returns the bitmap width if there is none
+ */
+int bitmap_row_next(const struct bitmap *b, int y, int x, bool on)
+{
+	const bitmap_word *row = bitmap_row(b, y);
+	int k = BITMAP_OFFSET(x);
+	bitmap_word w;
+
+	assert(y >= 0 && y < b->height);
+	if (x >= b->width) return b->width;
+
+	/* Look at the rest of the first word, then whole words */
+	w = (on ? row[k] : ~row[k]) & (~(bitmap_word) 0 << (x % BITMAP_WORD_BITS));
+	while (!w) {
+		if (++k >= b->stride) return b->width;
+		w = on ? row[k] : ~row[k];
+	}
+
+	return MIN(k * BITMAP_WORD_BITS + bitmap_word_first(w), b->width);
+}
+
+int bitmap_row_count(const struct bitmap *b, int y, int x1, int x2)
+{
+	const bitmap_word *row = bitmap_row(b, y);
+	int w1 = BITMAP_OFFSET(x1), w2 = BITMAP_OFFSET(x2), i, count;
+	bitmap_word first = ~(bitmap_word) 0 << (x1 % BITMAP_WORD_BITS);
+	bitmap_word last = ~(bitmap_word) 0 >>
+		(BITMAP_WORD_BITS - 1 - x2 % BITMAP_WORD_BITS);
+
+	assert(y >= 0 && y < b->height);
+	assert(x1 >= 0 && x2 < b->width);
+
+	if (x1 > x2) return 0;
+	if (w1 == w2) return bitmap_word_count(row[w1] & first & last);
+
+	count = bitmap_word_count(row[w1] & first);
+	for (i = w1 + 1; i < w2; i++)
+		count += bitmap_word_count(row[i]);
+	count += bitmap_word_count(row[w2] & last);
+
+	return count;
+}
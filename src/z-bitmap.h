@@ -0,0 +1,105 @@
+/**
+ * \file z-bitmap.h
+ * \brief Two-dimensional bit planes with word-wide bulk operations
+ *
+ * Copyright (c) 2026 Angband developers
+ *
+ * This work is free software; you can redistribute it and/or modify it
+ * under the terms of either:
+ *
+ * a) the GNU General Public License as published by the Free Software
+ *    Foundation, version 2, or
+ *
+ * b) the "Angband licence":
+ *    This software may be copied and distributed for educational, research,
+ *    and not for profit purposes provided that this copyright and statement
+ *    are included in all such copies.  Other copyrights may also apply.
+ */
+
+#ifndef INCLUDED_Z_BITMAP_H
+#define INCLUDED_Z_BITMAP_H
+
+#include "h-basic.h"
+#include "z-type.h"
+#include "z-virt.h"
+
+/* The basic datatype of bitmaps */
+typedef u64b bitmap_word;
+#define BITMAP_WORD_BITS  64
+
+/**
+ * The number of words needed to hold a row of "n" bits
+ */
+#define BITMAP_STRIDE(n)  (((n) + BITMAP_WORD_BITS - 1) / BITMAP_WORD_BITS)
+
+/**
+ * Convert a column to the index of the word holding it
+ */
+#define BITMAP_OFFSET(x)  ((x) / BITMAP_WORD_BITS)
+
+/**
+ * Convert a column to its bit within its word
+ */
+#define BITMAP_BINARY(x)  ((bitmap_word) 1 << ((x) % BITMAP_WORD_BITS))
+
+/**
+ * A height x width plane of bits.
+ *
+ * Each row starts on a word boundary and is padded to a whole number of
+ * words; the padding bits are always zero, so whole rows can be combined
+ * and counted a word at a time.
+ */
+struct bitmap {
+	int height;
+	int width;
+	int stride;				/**< Words per row */
+	bitmap_word *words;		/**< height * stride words, row by row */
+};
+
+/**
+ * The words of row "y" of bitmap "b"
+ */
+#define bitmap_row(b, y)  ((b)->words + (size_t) (y) * (b)->stride)
+
+struct bitmap *bitmap_new(int height, int width);
+void bitmap_free(struct bitmap *b);
+
+bool bitmap_has(const struct bitmap *b, struct loc grid);
+void bitmap_on(struct bitmap *b, struct loc grid);
+void bitmap_off(struct bitmap *b, struct loc grid);
+
+void bitmap_wipe(struct bitmap *b);
+void bitmap_setall(struct bitmap *b);
+void bitmap_copy(struct bitmap *dest, const struct bitmap *src);
+void bitmap_union(struct bitmap *dest, const struct bitmap *src);
+void bitmap_inter(struct bitmap *dest, const struct bitmap *src);
+void bitmap_diff(struct bitmap *dest, const struct bitmap *src);
+int bitmap_count(const struct bitmap *b);
+bool bitmap_is_empty(const struct bitmap *b);
+
+void bitmap_rect_wipe(struct bitmap *b, struct loc top_left,
+					  struct loc bottom_right);
+void bitmap_rect_setall(struct bitmap *b, struct loc top_left,
+						struct loc bottom_right);
+void bitmap_rect_copy(struct bitmap *dest, const struct bitmap *src,
+					  struct loc top_left, struct loc bottom_right);
+void bitmap_rect_union(struct bitmap *dest, const struct bitmap *src,
+					   struct loc top_left, struct loc bottom_right);
+void bitmap_rect_inter(struct bitmap *dest, const struct bitmap *src,
+					   struct loc top_left, struct loc bottom_right);
+void bitmap_rect_diff(struct bitmap *dest, const struct bitmap *src,
+					  struct loc top_left, struct loc bottom_right);
+int bitmap_rect_count(const struct bitmap *b, struct loc top_left,
+					  struct loc bottom_right);
+
+void bitmap_row_wipe(struct bitmap *b, int y, int x1, int x2);
+void bitmap_row_setall(struct bitmap *b, int y, int x1, int x2);
+void bitmap_row_copy(struct bitmap *dest, const struct bitmap *src, int y,
+					 int x1, int x2);
+int bitmap_row_count(const struct bitmap *b, int y, int x1, int x2);
+int bitmap_row_next(const struct bitmap *b, int y, int x, bool on);
+
+int bitmap_word_count(bitmap_word w);
+int bitmap_word_first(bitmap_word w);
+
+#endif /* !INCLUDED_Z_BITMAP_H */
@@ -31,6 +31,12 @@ struct dice_s {
 	int b, x, y, m;
 	bool ex_b, ex_x, ex_y, ex_m;
 	dice_expression_entry_t *expressions;
+
+	/* Everything that is known before rolling, with constant expressions
+	 * folded in, and the expressions for base, dice, sides and bonus that
+	 * are left to evaluate each time */
+	random_value value;
+	const expression_t *bound[4];
 };
 
 /**
@@ -172,6 +178,9 @@ static void dice_reset(dice_t *dice)
 	dice->ex_y = false;
 	dice->ex_m = false;
 
+	memset(&dice->value, 0, sizeof(dice->value));
+	memset(dice->bound, 0, sizeof(dice->bound));
+
 	if (dice->expressions == NULL)
 		return;
 
@@ -188,6 +197,49 @@ static void dice_reset(dice_t *dice)
 	}
 }
 
+/**
+ * Work out one part of the dice ahead of rolling, giving its value if that
+ * is fixed and leaving its expression in `bound` if not.
+ */
+static int dice_fold_part(const dice_t *dice, int value, bool is_variable,
+						  const expression_t **bound)
+{
+	const expression_t *expression;
+
+	*bound = NULL;
+	if (!is_variable)
+		return value;
+
+	/* Unbound variables are zero */
+	if (value < 0 || dice->expressions == NULL)
+		return 0;
+	expression = dice->expressions[value].expression;
+	if (expression == NULL)
+		return 0;
+
+	if (expression_is_constant(expression))
+		return expression_evaluate(expression);
+
+	*bound = expression;
+	return 0;
+}
+
+/**
+ * Work out all that can be known of the dice before rolling, so that
+ * dice_random_value() only has to evaluate what depends on the game.
+ */
+static void dice_fold(dice_t *dice)
+{
+	dice->value.base = dice_fold_part(dice, dice->b, dice->ex_b,
+									  &dice->bound[0]);
+	dice->value.dice = dice_fold_part(dice, dice->x, dice->ex_x,
+									  &dice->bound[1]);
+	dice->value.sides = dice_fold_part(dice, dice->y, dice->ex_y,
+									   &dice->bound[2]);
+	dice->value.m_bonus = dice_fold_part(dice, dice->m, dice->ex_m,
+										 &dice->bound[3]);
+}
+
 /**
  * Allocate and initialize a new dice object. Returns NULL if it was unable to
  * be created.
@@ -283,6 +335,7 @@ int dice_bind_expression(dice_t *dice, const char *name,
 			if (dice->expressions[i].expression == NULL)
 				return -1;
 
+			dice_fold(dice);
 			return i;
 		}
 	}
@@ -494,6 +547,7 @@ bool dice_parse_string(dice_t *dice, const char *string)
 		}
 	}
 
+	dice_fold(dice);
 	return true;
 }
 
@@ -508,41 +562,16 @@ void dice_random_value(dice_t *dice, random_value *v)
 	if (v == NULL)
 		return;
 
-	if (dice->ex_b) {
-		if (dice->expressions != NULL && dice->expressions[dice->b].expression != NULL)
-			v->base = expression_evaluate(dice->expressions[dice->b].expression);
-		else
-			v->base = 0;
-	}
-	else
-		v->base = dice->b;
-
-	if (dice->ex_x) {
-		if (dice->expressions != NULL && dice->expressions[dice->x].expression != NULL)
-			v->dice = expression_evaluate(dice->expressions[dice->x].expression);
-		else
-			v->dice = 0;
-	}
-	else
-		v->dice = dice->x;
-
-	if (dice->ex_y) {
-		if (dice->expressions != NULL && dice->expressions[dice->y].expression != NULL)
-			v->sides = expression_evaluate(dice->expressions[dice->y].expression);
-		else
-			v->sides = 0;
-	}
-	else
-		v->sides = dice->y;
-
-	if (dice->ex_m) {
-		if (dice->expressions != NULL && dice->expressions[dice->m].expression != NULL)
-			v->m_bonus = expression_evaluate(dice->expressions[dice->m].expression);
-		else
-			v->m_bonus = 0;
-	}
-	else
-		v->m_bonus = dice->m;
+	/* Only the parts that depend on the game need working out */
+	*v = dice->value;
+	if (dice->bound[0])
+		v->base = expression_evaluate(dice->bound[0]);
+	if (dice->bound[1])
+		v->dice = expression_evaluate(dice->bound[1]);
+	if (dice->bound[2])
+		v->sides = expression_evaluate(dice->bound[2]);
+	if (dice->bound[3])
+		v->m_bonus = expression_evaluate(dice->bound[3]);
 }
 
 /**
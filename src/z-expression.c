@@ -209,6 +209,15 @@ void expression_set_base_value(expression_t *expression,
 	expression->base_value = function;
 }
 
+/**
+ * Return whether the expression always evaluates to the same value, which
+ * is so when it has no base value function.
+ */
+bool expression_is_constant(const expression_t *expression)
+{
+	return expression->base_value == NULL;
+}
+
 /**
  * Evaluate the given expression. If the base value function is NULL,
  * expression is evaluated from zero.
@@ -283,7 +292,7 @@ s16b expression_add_operations_string(expression_t *expression,
 	char *parse_string;
 	expression_operation_t operations[EXPRESSION_MAX_OPERATIONS];
 	size_t count = 0, i = 0;
-	char *token = NULL;
+	char *token = NULL, *tok_state;
 	expression_operator_t parsed_operator = OPERATOR_NONE;
 	expression_operator_t current_operator = OPERATOR_NONE;
 	expression_input_t current_input = EXPRESSION_INPUT_INVALID;
@@ -324,7 +333,7 @@ s16b expression_add_operations_string(expression_t *expression,
 		return 0;
 
 	parse_string = string_make(string);
-	token = strtok(parse_string, EXPRESSION_DELIMITER);
+	token = my_strtok(parse_string, EXPRESSION_DELIMITER, &tok_state);
 
 	while (token != NULL) {
 		char *end = NULL;
@@ -374,7 +383,7 @@ s16b expression_add_operations_string(expression_t *expression,
 		if (count >= N_ELEMENTS(operations))
 			break;
 
-		token = strtok(NULL, EXPRESSION_DELIMITER);
+		token = my_strtok(NULL, EXPRESSION_DELIMITER, &tok_state);
 	}
 
 	for (i = 0; i < count; i++) {
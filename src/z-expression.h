@@ -38,6 +38,7 @@ void expression_free(expression_t *expression);
 expression_t *expression_copy(const expression_t *source);
 void expression_set_base_value(expression_t *expression,
 							   expression_base_value_f function);
+bool expression_is_constant(const expression_t *expression);
 s32b expression_evaluate(expression_t const * const expression);
 s16b expression_add_operations_string(expression_t *expression,
 									  const char *string);
@@ -263,8 +263,17 @@ struct ang_file
 	FILE *fh;
 	char *fname;
 	file_mode mode;
+
+	/* Read-ahead for line reading; bytes rpos to rlen are still unread */
+	char *rbuf;
+	size_t rbuf_size;
+	size_t rpos;
+	size_t rlen;
 };
 
+/* Starting size of the read-ahead buffer; it grows to fit long lines */
+#define FILE_RBUF_SIZE 8192
+
 
 
 /** Utility functions **/
@@ -431,6 +440,7 @@ bool file_close(ang_file *f)
 	if (fclose(f->fh) != 0)
 		return false;
 
+	mem_free(f->rbuf);
 	mem_free(f->fname);
 	mem_free(f);
 
@@ -476,12 +486,62 @@ void file_unlock(ang_file *f)
 
 /** Byte-based IO and functions **/
 
+/**
+ * Read more of file 'f' into its read-ahead buffer, keeping the unread part.
+ * Returns false if there was nothing more to read.
+ */
+static bool file_fill(ang_file *f)
+{
+	size_t n;
+
+	if (!f->rbuf) {
+		f->rbuf_size = FILE_RBUF_SIZE;
+		f->rbuf = mem_alloc(f->rbuf_size);
+		f->rpos = f->rlen = 0;
+	}
+
+	/* Move the unread part to the front, or make room for a long line;
+	 * one byte is always kept spare to terminate the last line */
+	if (f->rpos > 0) {
+		memmove(f->rbuf, f->rbuf + f->rpos, f->rlen - f->rpos);
+		f->rlen -= f->rpos;
+		f->rpos = 0;
+	} else if (f->rlen == f->rbuf_size - 1) {
+		f->rbuf_size *= 2;
+		f->rbuf = mem_realloc(f->rbuf, f->rbuf_size);
+	}
+
+	n = fread(f->rbuf + f->rlen, 1, f->rbuf_size - 1 - f->rlen, f->fh);
+	f->rlen += n;
+	return n > 0;
+}
+
+/**
+ * Look at the next byte of file 'f' without reading it, or EOF.
+ */
+static int file_peekc(ang_file *f)
+{
+	if (f->rpos == f->rlen && !file_fill(f))
+		return EOF;
+	return (byte) f->rbuf[f->rpos];
+}
+
 /**
  * Seek to location 'pos' in file 'f'.
  */
 bool file_skip(ang_file *f, int bytes)
 {
-	return (fseek(f->fh, bytes, SEEK_CUR) == 0);
+	long unread = (long) (f->rlen - f->rpos);
+
+	/* Skip within what has been read ahead if possible */
+	if (bytes >= 0 && bytes <= unread) {
+		f->rpos += bytes;
+		return true;
+	}
+
+	/* The file itself is ahead by whatever hasn't been read yet */
+	f->rpos = f->rlen = 0;
+	return (fseek(f->fh, bytes - unread, SEEK_CUR) == 0);
 }
 
 /**
@@ -489,7 +549,14 @@ bool file_skip(ang_file *f, int bytes)
  */
 bool file_readc(ang_file *f, byte *b)
 {
-	int i = fgetc(f->fh);
+	int i;
+
+	if (f->rpos < f->rlen) {
+		*b = (byte) f->rbuf[f->rpos++];
+		return true;
+	}
+
+	i = fgetc(f->fh);
 
 	if (i == EOF)
 		return false;
@@ -511,12 +578,20 @@ bool file_writec(ang_file *f, byte b)
  */
 int file_read(ang_file *f, char *buf, size_t n)
 {
-	size_t read = fread(buf, 1, n, f->fh);
+	size_t ahead = MIN(n, f->rlen - f->rpos);
+	size_t read;
+
+	/* Use up anything read ahead first */
+	if (ahead) {
+		memcpy(buf, f->rbuf + f->rpos, ahead);
+		f->rpos += ahead;
+	}
 
-	if (read == 0 && ferror(f->fh))
+	read = fread(buf + ahead, 1, n - ahead, f->fh);
+	if (read == 0 && !ahead && ferror(f->fh))
 		return -1;
 	else
-		return read;
+		return ahead + read;
 }
 
 /**
@@ -539,37 +614,53 @@ bool file_write(ang_file *f, const char *buf, size_t n)
 
 bool file_getl(ang_file *f, char *buf, size_t len)
 {
-	bool seen_cr = false;
-	byte b;
 	size_t i = 0;
 
 	/* Leave a byte for the terminating 0 */
 	size_t max_len = len - 1;
 
 	while (i < max_len) {
+		char *from, *stop;
+		size_t avail, n;
 		char c;
 
-		if (!file_readc(f, &b)) {
+		if (f->rpos == f->rlen && !file_fill(f)) {
 			buf[i] = '\0';
 			return (i == 0) ? false : true;
 		}
 
-		c = (char) b;
+		/* Find the next line ending or tab, looking no further than the
+		 * end of the line */
+		from = f->rbuf + f->rpos;
+		avail = MIN(f->rlen - f->rpos, max_len - i);
+		stop = memchr(from, '\n', avail);
+		n = stop ? (size_t) (stop - from) : avail;
+		stop = memchr(from, '\r', n);
+		if (stop) n = stop - from;
+		stop = memchr(from, '\t', n);
+		if (stop) n = stop - from;
+
+		/* Copy everything before it */
+		memcpy(buf + i, from, n);
+		i += n;
+		f->rpos += n;
+		if (n == avail) continue;
+
+		c = f->rbuf[f->rpos++];
 
-		if (c == '\r') {
-			seen_cr = true;
-			continue;
-		}
-
-		if (seen_cr && c != '\n') {
-			fseek(f->fh, -1, SEEK_CUR);
+		if (c == '\n') {
 			buf[i] = '\0';
 			return true;
 		}
 
-		if (c == '\n') {
+		/* A \r, possibly followed by a \n */
+		if (c == '\r') {
+			int next = file_peekc(f);
+
+			if (next == '\n')
+				f->rpos++;
 			buf[i] = '\0';
-			return true;
+			return (next == EOF && i == 0) ? false : true;
 		}
 
 		/* Expand tabs */
@@ -581,14 +672,69 @@ bool file_getl(ang_file *f, char *buf, size_t len)
 			/* Convert to spaces */
 			while (i < tabstop)
 				buf[i++] = ' ';
+		}
+	}
 
+	buf[i] = '\0';
+	return true;
+}
+
+/**
+ * Read a line of text from file 'f' without copying it, as file_getl() does
+ * but with tabs and long lines left as they are.
+ */
+bool file_getline(ang_file *f, const char **line, size_t *len)
+{
+	size_t i = 0, end, next;
+	char *start;
+
+	/* Find the end of the line, reading more as needed */
+	while (true) {
+		char *from = f->rbuf + f->rpos + i, *stop;
+		size_t avail = f->rlen - f->rpos - i;
+
+		if (!avail) {
+			if (!file_fill(f)) {
+				if (i == 0) return false;
+				end = next = i;
+				break;
+			}
 			continue;
 		}
 
-		buf[i++] = c;
+		stop = memchr(from, '\n', avail);
+		if (stop) {
+			char *cr = memchr(from, '\r', stop - from);
+			if (!cr) {
+				end = i + (stop - from);
+				next = end + 1;
+				break;
+			}
+			stop = cr;
+		} else {
+			stop = memchr(from, '\r', avail);
+		}
+
+		/* A \r, possibly followed by a \n */
+		if (stop) {
+			end = i + (stop - from);
+			i = end + 1;
+			if (f->rpos + i < f->rlen || file_fill(f))
+				if (f->rbuf[f->rpos + i] == '\n')
+					i++;
+			next = i;
+			break;
+		}
+		i += avail;
 	}
 
-	buf[i] = '\0';
+	/* Terminate the line where its line ending was */
+	start = f->rbuf + f->rpos;
+	start[end] = '\0';
+	f->rpos += next;
+
+	*line = start;
+	if (len) *len = end;
 	return true;
 }
 
@@ -191,6 +191,18 @@ void file_unlock(ang_file *f);
  */
 bool file_getl(ang_file *f, char *buf, size_t n);
 
+/**
+ * Get a line of text from the file represented by `f` without copying it;
+ * `line` is set to the line, and `len` (if not NULL) to its length.
+ *
+ * Line endings are dealt with as for file_getl(), but tabs are not expanded
+ * and lines are never split.  The line is only valid until the next read from
+ * `f`.
+ *
+ * Returns true when data is returned; false otherwise.
+ */
+bool file_getline(ang_file *f, const char **line, size_t *len);
+
 /**
  * Write the string pointed to by `buf` to the file represented by `f`.
  *
@@ -96,32 +96,147 @@ static bool rand_fixed = false;
 static u32b rand_fixval = 0;
 
 /**
- * Initialize the complex RNG using a new seed.
+ * The streams of the complex RNG; the selected one lives in the variables
+ * above instead, and its entry here is out of date
  */
-void Rand_state_init(u32b seed)
+static struct rand_stream_state rand_streams[RNG_MAX];
+static int rand_stream = RNG_GAME;
+
+/**
+ * Copy the complex RNG variables out to, or in from, a stream
+ */
+static void rand_stream_out(struct rand_stream_state *s)
+{
+	s->state_i = state_i;
+	memcpy(s->state, STATE, sizeof(STATE));
+	s->z0 = z0;
+	s->z1 = z1;
+	s->z2 = z2;
+}
+
+static void rand_stream_in(const struct rand_stream_state *s)
+{
+	state_i = s->state_i;
+	memcpy(STATE, s->state, sizeof(STATE));
+	z0 = s->z0;
+	z1 = s->z1;
+	z2 = s->z2;
+}
+
+/**
+ * Seed one stream of the complex RNG
+ */
+static void rand_stream_seed(struct rand_stream_state *s, u32b seed)
 {
 	int i, j;
 
-	/* Seed the table */
-	STATE[0] = seed;
+	/* Seed the table, from the start so the seed alone says what comes */
+	s->state_i = 0;
+	s->state[0] = seed;
 
 	/* Propagate the seed */
 	for (i = 1; i < RAND_DEG; i++)
-		STATE[i] = LCRNG(STATE[i - 1]);
+		s->state[i] = LCRNG(s->state[i - 1]);
 
 	/* Cycle the table ten times per degree */
 	for (i = 0; i < RAND_DEG * 10; i++) {
 		/* Acquire the next index */
-		j = (state_i + 1) % RAND_DEG;
+		j = (s->state_i + 1) % RAND_DEG;
 
 		/* Update the table, extract an entry */
-		STATE[j] += STATE[state_i];
+		s->state[j] += s->state[s->state_i];
 
 		/* Advance the index */
-		state_i = j;
+		s->state_i = j;
 	}
 }
 
+/**
+ * Initialize the complex RNG using a new seed.
+ *
+ * The game's own stream is seeded just as it was before there were other
+ * streams, so the same seed still gives the same game.
+ */
+void Rand_state_init(u32b seed)
+{
+	int i;
+
+	for (i = 0; i < RNG_MAX; i++)
+		Rand_stream_init(i, seed ^ ((u32b) i * 0x9E3779B9U));
+}
+
+/**
+ * Initialize one stream of the complex RNG using a new seed.
+ */
+void Rand_stream_init(int stream, u32b seed)
+{
+	rand_stream_out(&rand_streams[rand_stream]);
+	rand_stream_seed(&rand_streams[stream], seed);
+	rand_stream_in(&rand_streams[rand_stream]);
+}
+
+/**
+ * Copy out the RNG state
+ */
+void Rand_state_save(struct rand_state *s)
+{
+	s->quick = Rand_quick;
+	s->value = Rand_value;
+	s->stream = rand_stream;
+	rand_stream_out(&rand_streams[rand_stream]);
+	memcpy(s->streams, rand_streams, sizeof(rand_streams));
+}
+
+/**
+ * Put back an RNG state copied out by Rand_state_save()
+ */
+void Rand_state_restore(const struct rand_state *s)
+{
+	Rand_quick = s->quick;
+	Rand_value = s->value;
+	rand_stream = s->stream;
+	memcpy(rand_streams, s->streams, sizeof(rand_streams));
+	rand_stream_in(&rand_streams[rand_stream]);
+}
+
+/**
+ * Select a stream of the complex RNG, returning the one that was selected
+ */
+int Rand_stream_select(int stream)
+{
+	int old = rand_stream;
+
+	assert(stream >= 0 && stream < RNG_MAX);
+	if (stream == old) return old;
+
+	rand_stream_out(&rand_streams[old]);
+	rand_stream_in(&rand_streams[stream]);
+	rand_stream = stream;
+	return old;
+}
+
+/**
+ * Get the state of one stream of the complex RNG
+ */
+void Rand_stream_get(int stream, struct rand_stream_state *s)
+{
+	if (stream == rand_stream)
+		rand_stream_out(s);
+	else
+		memcpy(s, &rand_streams[stream], sizeof(*s));
+}
+
+/**
+ * Set the state of one stream of the complex RNG
+ */
+void Rand_stream_set(int stream, const struct rand_stream_state *s)
+{
+	if (stream == rand_stream)
+		rand_stream_in(s);
+	else
+		memcpy(&rand_streams[stream], s, sizeof(*s));
+}
+
 /**
  * Initialise the RNG
  */
@@ -208,6 +323,37 @@ u32b Rand_div(u32b m)
 	return (r);
 }
 
+/**
+ * Fill `buf` with `n` numbers from 0 to m - 1 from the given stream, just as
+ * that many calls to Rand_div() with the stream selected would
+ */
+void Rand_stream_fill(int stream, u32b *buf, size_t n, u32b m)
+{
+	int old = Rand_stream_select(stream);
+	u32b part;
+	size_t i;
+
+	assert(m <= 0x10000000);
+
+	if ((m <= 1) || Rand_quick || rand_fixed) {
+		for (i = 0; i < n; i++)
+			buf[i] = Rand_div(m);
+	} else {
+		/* As Rand_div(), without the checks for each number */
+		part = 0x10000000 / m;
+		for (i = 0; i < n; i++) {
+			u32b r;
+
+			do {
+				r = ((WELLRNG1024a() >> 4) & 0x0FFFFFFF) / part;
+			} while (r >= m);
+			buf[i] = r;
+		}
+	}
+
+	Rand_stream_select(old);
+}
+
 
 /**
  * The number of entries in the "Rand_normal_table"
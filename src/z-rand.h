@@ -108,12 +108,77 @@ extern u32b z0;
 extern u32b z1;
 extern u32b z2;
 
+/**
+ * The complex RNG has separate streams of numbers for the parts of the game
+ * that use a lot of them, so that extra rolls in one part don't change what
+ * happens in the others.  Whichever stream is selected is the one held in
+ * the variables above.
+ */
+enum rand_stream {
+	RNG_GAME = 0,		/* everything without its own stream */
+	RNG_GEN,			/* level generation */
+	RNG_MONSTER,		/* monster movement and spell choice */
+	RNG_COMBAT,			/* melee and missile attacks */
+	RNG_STORE,			/* store stock */
+	RNG_COSMETIC,		/* display only, like hallucination */
+
+	RNG_MAX
+};
+
+/**
+ * The state of one stream of the complex RNG.
+ */
+struct rand_stream_state {
+	u32b state_i;
+	u32b state[RAND_DEG];
+	u32b z0, z1, z2;
+};
+
+/**
+ * A copy of the whole state of the RNG, so that a separate stream of
+ * numbers can be drawn and the game's own stream carried on afterwards.
+ */
+struct rand_state {
+	bool quick;
+	u32b value;
+	int stream;
+	struct rand_stream_state streams[RNG_MAX];
+};
+
+/**
+ * Save and restore the RNG state.
+ */
+void Rand_state_save(struct rand_state *s);
+void Rand_state_restore(const struct rand_state *s);
 
 /**
- * Initialise the RNG state with the given seed.
+ * Initialise the RNG state with the given seed; each stream gets its own
+ * seed made from it.
  */
 void Rand_state_init(u32b seed);
 
+/**
+ * Initialise just one stream of the complex RNG with the given seed.
+ */
+void Rand_stream_init(int stream, u32b seed);
+
+/**
+ * Select a stream of the complex RNG, returning the one that was selected.
+ */
+int Rand_stream_select(int stream);
+
+/**
+ * Get or set the state of one stream of the complex RNG.
+ */
+void Rand_stream_get(int stream, struct rand_stream_state *s);
+void Rand_stream_set(int stream, const struct rand_stream_state *s);
+
+/**
+ * Fill `buf` with `n` numbers X where "0 <= X < M" holds, from the given
+ * stream of the complex RNG.
+ */
+void Rand_stream_fill(int stream, u32b *buf, size_t n, u32b m);
+
 /**
  * Initialise the RNG
  */
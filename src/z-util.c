@@ -215,6 +215,35 @@ size_t my_strcat(char *buf, const char *src, size_t bufsize)
 	}
 }
 
+/**
+ * Split a string into tokens separated by any of the characters in 'delim',
+ * starting on 'str', or if that is NULL carrying on from where 'state' says
+ * the last call stopped.
+ *
+ * This function should be equivalent to the strtok_r() function in POSIX.
+ */
+char *my_strtok(char *str, const char *delim, char **state)
+{
+	char *tok;
+
+	if (!str) str = *state;
+
+	/* Skip leading separators */
+	str += strspn(str, delim);
+	if (!*str) {
+		*state = str;
+		return NULL;
+	}
+
+	/* Cut the token off at the next separator */
+	tok = str;
+	str += strcspn(str, delim);
+	if (*str) *str++ = '\0';
+	*state = str;
+
+	return tok;
+}
+
 /**
  * Capitalise the first letter of string 'str'.
  */
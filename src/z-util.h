@@ -110,6 +110,15 @@ extern size_t my_strcpy(char *buf, const char *src, size_t bufsize);
  */
 extern size_t my_strcat(char *buf, const char *src, size_t bufsize);
 
+/**
+ * Split a string into tokens like strtok(), but keeping the place reached in
+ * 'state' rather than in a static, so that several strings can be split at
+ * once, or on several threads.
+ *
+ * This function should be equivalent to the strtok_r() function in POSIX.
+ */
+extern char *my_strtok(char *str, const char *delim, char **state);
+
 /**
  * Capitalise string 'buf'
  */
@@ -16,11 +16,123 @@
  *    are included in all such copies.  Other copyrights may also apply.
  */
 #include "z-virt.h"
+#include "z-form.h"
 #include "z-util.h"
 
 unsigned int mem_flags = 0;
 
-#define SZ(uptr)	*((size_t *)((char *)(uptr) - sizeof(size_t)))
+/**
+ * Every block from mem_alloc() starts with its size and the MEM_TRACK place
+ * it was allocated from (0 if it isn't tracked).  Two size_t keep the memory
+ * handed out as well aligned as malloc()'s.
+ */
+struct mem_header {
+	size_t len;
+	size_t site;
+};
+
+#define HEADER(uptr) \
+	((struct mem_header *)((char *)(uptr) - sizeof(struct mem_header)))
+
+/**
+ * Bytes allocated less bytes freed while MEM_TALLY is on, the lowest that
+ * has been, and the biggest rise from a low point; all since the last
+ * mem_tally_reset()
+ */
+static long mem_tally_live = 0;
+static long mem_tally_low = 0;
+static long mem_tally_high = 0;
+
+static void mem_tally(long change)
+{
+	mem_tally_live += change;
+	if (mem_tally_live < mem_tally_low)
+		mem_tally_low = mem_tally_live;
+	if (mem_tally_live - mem_tally_low > mem_tally_high)
+		mem_tally_high = mem_tally_live - mem_tally_low;
+}
+
+/**
+ * MEM_TRACK keeps counts for each place in the code that allocates memory,
+ * in a hash table keyed on the file and line.  The table uses plain malloc()
+ * so as not to count itself, and blocks remember their place by its index
+ * plus one.  With sampling on, only about one allocation in `mem_track_rate`
+ * is tracked, at random intervals so regular patterns don't hide.
+ */
+#define MEM_SITES_MAX	4096
+
+static struct mem_track_stats *mem_sites;
+static int mem_sites_used = 0;
+static int mem_track_rate = 1;
+static int mem_track_countdown = 1;
+static u32b mem_track_seed = 0x2545F491;
+
+static size_t mem_track_site(const char *file, int line)
+{
+	size_t h;
+
+	/* Skip allocations between samples */
+	if (--mem_track_countdown > 0)
+		return 0;
+	if (mem_track_rate > 1) {
+		mem_track_seed ^= mem_track_seed << 13;
+		mem_track_seed ^= mem_track_seed >> 17;
+		mem_track_seed ^= mem_track_seed << 5;
+		mem_track_countdown = 1 + mem_track_seed % (2 * mem_track_rate - 1);
+	} else {
+		mem_track_countdown = 1;
+	}
+
+	if (!mem_sites) {
+		mem_sites = calloc(MEM_SITES_MAX, sizeof(*mem_sites));
+		if (!mem_sites)
+			quit("Out of Memory!");
+	}
+
+	h = (((size_t) file >> 3) ^ ((size_t) line * 2654435761u)) %
+		MEM_SITES_MAX;
+	while (mem_sites[h].file) {
+		if (mem_sites[h].file == file && mem_sites[h].line == line)
+			return h + 1;
+		h = (h + 1) % MEM_SITES_MAX;
+	}
+
+	/* Give up on new places once the table gets crowded */
+	if (mem_sites_used >= MEM_SITES_MAX / 4 * 3)
+		return 0;
+	mem_sites_used++;
+	mem_sites[h].file = file;
+	mem_sites[h].line = line;
+	return h + 1;
+}
+
+static void mem_track_alloc(struct mem_header *h, const char *file, int line)
+{
+	struct mem_track_stats *site;
+
+	h->site = (mem_flags & MEM_TRACK) ? mem_track_site(file, line) : 0;
+	if (!h->site) return;
+
+	site = &mem_sites[h->site - 1];
+	site->allocs++;
+	site->bytes += h->len;
+	site->live_blocks++;
+	site->live_bytes += h->len;
+	if (site->live_bytes > site->peak_bytes)
+		site->peak_bytes = site->live_bytes;
+}
+
+static void mem_track_free(struct mem_header *h)
+{
+	struct mem_track_stats *site;
+
+	/* Tracked blocks are followed even after tracking is turned off */
+	if (!h->site) return;
+
+	site = &mem_sites[h->site - 1];
+	site->live_blocks--;
+	site->live_bytes -= h->len;
+}
 
 /**
  * Allocate `len` bytes of memory.
@@ -31,27 +143,31 @@ unsigned int mem_flags = 0;
  *
  * Doesn't return on out of memory.
  */
-void *mem_alloc(size_t len)
+void *mem_alloc_at(size_t len, const char *file, int line)
 {
+	struct mem_header *h;
 	char *mem;
 
 	/* Allow allocation of "zero bytes" */
 	if (len == 0) return (NULL);
 
-	mem = malloc(len + sizeof(size_t));
-	if (!mem)
+	h = malloc(len + sizeof(*h));
+	if (!h)
 		quit("Out of Memory!");
-	mem += sizeof(size_t);
+	mem = (char *) (h + 1);
 	if (mem_flags & MEM_POISON_ALLOC)
 		memset(mem, 0xCC, len);
-	SZ(mem) = len;
+	if (mem_flags & MEM_TALLY)
+		mem_tally((long) len);
+	h->len = len;
+	mem_track_alloc(h, file, line);
 
 	return mem;
 }
 
-void *mem_zalloc(size_t len)
+void *mem_zalloc_at(size_t len, const char *file, int line)
 {
-	void *mem = mem_alloc(len);
+	void *mem = mem_alloc_at(len, file, line);
 	if (len) {
 		memset(mem, 0, len);
 	}
@@ -60,34 +176,292 @@ void *mem_zalloc(size_t len)
 
 void mem_free(void *p)
 {
+	struct mem_header *h;
+
 	if (!p) return;
 
+	h = HEADER(p);
 	if (mem_flags & MEM_POISON_FREE)
-		memset(p, 0xCD, SZ(p));
-	free((char *)p - sizeof(size_t));
+		memset(p, 0xCD, h->len);
+	if (mem_flags & MEM_TALLY)
+		mem_tally(-(long) h->len);
+	mem_track_free(h);
+	free(h);
 }
 
-void *mem_realloc(void *p, size_t len)
+void *mem_realloc_at(void *p, size_t len, const char *file, int line)
 {
-	char *m = p;
+	struct mem_header *h = p ? HEADER(p) : NULL;
 
 	/* Fail gracefully */
 	if (len == 0) return (NULL);
 
-	m = realloc(m ? m - sizeof(size_t) : NULL, len + sizeof(size_t));
-	m += sizeof(size_t);
+	if (h) {
+		if (mem_flags & MEM_TALLY)
+			mem_tally(-(long) h->len);
+		mem_track_free(h);
+	}
+	h = realloc(h, len + sizeof(*h));
 
 	/* Handle OOM */
-	if (!m) quit("Out of Memory!");
-	SZ(m) = len;
+	if (!h) quit("Out of Memory!");
+	if (mem_flags & MEM_TALLY)
+		mem_tally((long) len);
+	h->len = len;
+	mem_track_alloc(h, file, line);
+
+	return h + 1;
+}
+
+/**
+ * Start the MEM_TALLY count afresh from the current moment
+ */
+void mem_tally_reset(void)
+{
+	mem_tally_live = 0;
+	mem_tally_low = 0;
+	mem_tally_high = 0;
+}
+
+/**
+ * Get the most extra bytes held at once since the last mem_tally_reset(),
+ * counting only allocations and frees made while MEM_TALLY is on.  Memory
+ * freed first (such as an old level) doesn't hide what is allocated later.
+ */
+long mem_tally_peak(void)
+{
+	return mem_tally_high;
+}
+
+/**
+ * Track only about one allocation in `rate` from now on; 1 tracks them all.
+ * Counts in the report are scaled up by the rate.
+ */
+void mem_track_sample(int rate)
+{
+	mem_track_rate = MAX(rate, 1);
+	mem_track_countdown = 1;
+}
+
+/**
+ * Get what MEM_TRACK has counted for the allocations made at `file`:`line`
+ */
+bool mem_track_lookup(const char *file, int line,
+					  struct mem_track_stats *stats)
+{
+	int i;
+
+	for (i = 0; mem_sites && i < MEM_SITES_MAX; i++) {
+		if (!mem_sites[i].file || mem_sites[i].line != line) continue;
+		if (!streq(mem_sites[i].file, file)) continue;
+		*stats = mem_sites[i];
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Start the counts of allocations afresh; memory not yet freed is still
+ * counted as live, so later frees match up
+ */
+void mem_track_reset(void)
+{
+	int i;
 
-	return m;
+	for (i = 0; mem_sites && i < MEM_SITES_MAX; i++) {
+		mem_sites[i].allocs = 0;
+		mem_sites[i].bytes = 0;
+		mem_sites[i].peak_bytes = mem_sites[i].live_bytes;
+	}
+}
+
+static int mem_track_cmp_live(const void *a, const void *b)
+{
+	const struct mem_track_stats *sa = *(const struct mem_track_stats **) a;
+	const struct mem_track_stats *sb = *(const struct mem_track_stats **) b;
+
+	if (sa->live_bytes != sb->live_bytes)
+		return sa->live_bytes < sb->live_bytes ? 1 : -1;
+	return sb->live_blocks < sa->live_blocks ? -1 :
+		sb->live_blocks > sa->live_blocks;
+}
+
+static int mem_track_cmp_allocs(const void *a, const void *b)
+{
+	const struct mem_track_stats *sa = *(const struct mem_track_stats **) a;
+	const struct mem_track_stats *sb = *(const struct mem_track_stats **) b;
+
+	if (sa->allocs != sb->allocs)
+		return sa->allocs < sb->allocs ? 1 : -1;
+	return sb->bytes < sa->bytes ? -1 : sb->bytes > sa->bytes;
+}
+
+/**
+ * Report on what MEM_TRACK has seen, one line at a time to `out`: every
+ * place with memory still allocated (leaks, if called once everything should
+ * have been freed), then the `top` places that allocated most often
+ */
+void mem_track_report(void (*out)(const char *line, void *data), void *data,
+					  int top)
+{
+	struct mem_track_stats **sites;
+	char buf[1024];
+	long blocks = 0, bytes = 0, r = mem_track_rate;
+	int i, n = 0, leaks = 0;
+
+	if (!mem_sites) {
+		out("No memory allocations were tracked.", data);
+		return;
+	}
+
+	sites = malloc(mem_sites_used * sizeof(*sites));
+	if (!sites)
+		quit("Out of Memory!");
+	for (i = 0; i < MEM_SITES_MAX; i++) {
+		if (!mem_sites[i].file) continue;
+		sites[n++] = &mem_sites[i];
+		if (mem_sites[i].live_blocks) {
+			leaks++;
+			blocks += mem_sites[i].live_blocks;
+			bytes += mem_sites[i].live_bytes;
+		}
+	}
+
+	if (r > 1) {
+		strnfmt(buf, sizeof(buf), "Sampled one allocation in %ld; "
+				"counts are scaled up to match.", r);
+		out(buf, data);
+	}
+
+	strnfmt(buf, sizeof(buf), "Still allocated: %ld blocks, %ld bytes, "
+			"from %d places", blocks * r, bytes * r, leaks);
+	out(buf, data);
+	qsort(sites, n, sizeof(*sites), mem_track_cmp_live);
+	for (i = 0; i < leaks; i++) {
+		strnfmt(buf, sizeof(buf), "%10ld %12ld  %s:%d",
+				sites[i]->live_blocks * r, sites[i]->live_bytes * r,
+				sites[i]->file, sites[i]->line);
+		out(buf, data);
+	}
+
+	out("Most allocations (allocs, bytes, peak bytes):", data);
+	qsort(sites, n, sizeof(*sites), mem_track_cmp_allocs);
+	for (i = 0; i < MIN(top, n) && sites[i]->allocs; i++) {
+		strnfmt(buf, sizeof(buf), "%10ld %12ld %12ld  %s:%d",
+				sites[i]->allocs * r, sites[i]->bytes * r,
+				sites[i]->peak_bytes * r, sites[i]->file, sites[i]->line);
+		out(buf, data);
+	}
+
+	free(sites);
+}
+
+/**
+ * Memory arenas hand out pieces of big blocks, and give them all back at once
+ * when the arena is freed.  Pieces are aligned to a size_t, and allocations
+ * too big to share a block get a block of their own.
+ */
+#define ARENA_ALIGN		sizeof(size_t)
+#define ARENA_ROUND(len)	(((len) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+struct mem_arena_block {
+	struct mem_arena_block *next;
+	size_t size;
+	size_t used;
+};
+
+struct mem_arena {
+	struct mem_arena_block *blocks;
+	size_t block_size;
+	size_t held;
+	size_t used;
+};
+
+#define ARENA_HEADER	ARENA_ROUND(sizeof(struct mem_arena_block))
+
+/**
+ * Make a new arena, which gets memory from the heap `block_size` bytes at a
+ * time
+ */
+struct mem_arena *mem_arena_new(size_t block_size)
+{
+	struct mem_arena *a = mem_zalloc(sizeof(*a));
+
+	a->block_size = ARENA_ROUND(MAX(block_size, ARENA_ALIGN));
+	return a;
+}
+
+/**
+ * Get `len` bytes of zeroed memory from an arena; they stay valid until the
+ * arena is freed, and can't be freed on their own
+ */
+void *mem_arena_alloc(struct mem_arena *a, size_t len)
+{
+	struct mem_arena_block *block = a->blocks;
+	char *mem;
+
+	if (len == 0) return NULL;
+	len = ARENA_ROUND(len);
+
+	if (!block || (block->used + len > block->size)) {
+		size_t size = len > a->block_size / 4 ? len : a->block_size;
+		struct mem_arena_block *fresh = mem_alloc(ARENA_HEADER + size);
+
+		fresh->size = size;
+		fresh->used = 0;
+		a->held += size;
+
+		/* Keep filling the current block if the new one is a one-off */
+		if (block && (size != a->block_size)) {
+			fresh->next = block->next;
+			block->next = fresh;
+		} else {
+			fresh->next = block;
+			a->blocks = fresh;
+		}
+		block = fresh;
+	}
+
+	mem = (char *) block + ARENA_HEADER + block->used;
+	block->used += len;
+	a->used += len;
+	memset(mem, 0, len);
+	return mem;
+}
+
+/**
+ * Get how many bytes an arena has taken from the heap, and how many of them
+ * it has handed out
+ */
+size_t mem_arena_held(const struct mem_arena *a)
+{
+	return a ? a->held : 0;
+}
+
+size_t mem_arena_used(const struct mem_arena *a)
+{
+	return a ? a->used : 0;
+}
+
+/**
+ * Free an arena and everything allocated from it
+ */
+void mem_arena_free(struct mem_arena *a)
+{
+	struct mem_arena_block *block, *next;
+
+	if (!a) return;
+	for (block = a->blocks; block; block = next) {
+		next = block->next;
+		mem_free(block);
+	}
+	mem_free(a);
 }
 
 /**
  * Duplicates an existing string `str`, allocating as much memory as necessary.
  */
-char *string_make(const char *str)
+char *string_make_at(const char *str, const char *file, int line)
 {
 	char *res;
 	size_t siz;
@@ -97,7 +471,7 @@ char *string_make(const char *str)
 
 	/* Allocate space for the string (including terminator) */
 	siz = strlen(str) + 1;
-	res = mem_alloc(siz);
+	res = mem_alloc_at(siz, file, line);
 
 	/* Copy the string (with terminator) */
 	my_strcpy(res, str, siz);
@@ -110,7 +484,7 @@ void string_free(char *str)
 	mem_free(str);
 }
 
-char *string_append(char *s1, const char *s2)
+char *string_append_at(char *s1, const char *s2, const char *file, int line)
 {
 	u32b len;
 	if (!s1 && !s2) {
@@ -118,10 +492,10 @@ char *string_append(char *s1, const char *s2)
 	} else if (s1 && !s2) {
 		return s1;
 	} else if (!s1 && s2) {
-		return string_make(s2);
+		return string_make_at(s2, file, line);
 	}
 	len = strlen(s1);
-	s1 = mem_realloc(s1, len + strlen(s2) + 1);
+	s1 = mem_realloc_at(s1, len + strlen(s2) + 1, file, line);
 	my_strcpy(s1 + len, s2, strlen(s2) + 1);
 	return s1;
 }
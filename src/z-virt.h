@@ -17,21 +17,67 @@
 
 /**
  * Replacements for malloc() and friends that die on failure.
+ *
+ * The macros pass on where they were called from, for MEM_TRACK.
  */
-void *mem_alloc(size_t len);
-void *mem_zalloc(size_t len);
+void *mem_alloc_at(size_t len, const char *file, int line);
+void *mem_zalloc_at(size_t len, const char *file, int line);
 void mem_free(void *p);
-void *mem_realloc(void *p, size_t len);
+void *mem_realloc_at(void *p, size_t len, const char *file, int line);
+
+#define mem_alloc(len)			mem_alloc_at((len), __FILE__, __LINE__)
+#define mem_zalloc(len)			mem_zalloc_at((len), __FILE__, __LINE__)
+#define mem_realloc(p, len)		mem_realloc_at((p), (len), __FILE__, __LINE__)
 
-char *string_make(const char *str);
+char *string_make_at(const char *str, const char *file, int line);
 void string_free(char *str);
-char *string_append(char *s1, const char *s2);
+char *string_append_at(char *s1, const char *s2, const char *file, int line);
+
+#define string_make(str)		string_make_at((str), __FILE__, __LINE__)
+#define string_append(s1, s2) \
+	string_append_at((s1), (s2), __FILE__, __LINE__)
 
 enum {
 	MEM_POISON_ALLOC = 0x00000001,
-	MEM_POISON_FREE  = 0x00000002
+	MEM_POISON_FREE  = 0x00000002,
+	MEM_TALLY        = 0x00000004,
+	MEM_TRACK        = 0x00000008
 };
 
 extern unsigned int mem_flags;
 
+void mem_tally_reset(void);
+long mem_tally_peak(void);
+
+/**
+ * What MEM_TRACK has seen of the allocations made at one place in the code
+ */
+struct mem_track_stats {
+	const char *file;
+	int line;
+	long allocs;		/* Allocations made */
+	long bytes;			/* Bytes allocated, all told */
+	long live_blocks;	/* Allocations not yet freed */
+	long live_bytes;	/* Bytes not yet freed */
+	long peak_bytes;	/* Most bytes not yet freed at once */
+};
+
+void mem_track_sample(int rate);
+bool mem_track_lookup(const char *file, int line,
+					  struct mem_track_stats *stats);
+void mem_track_report(void (*out)(const char *line, void *data), void *data,
+					  int top);
+void mem_track_reset(void);
+
+/**
+ * Arenas, for lots of allocations which are all freed together
+ */
+struct mem_arena;
+
+struct mem_arena *mem_arena_new(size_t block_size);
+void *mem_arena_alloc(struct mem_arena *a, size_t len);
+size_t mem_arena_held(const struct mem_arena *a);
+size_t mem_arena_used(const struct mem_arena *a);
+void mem_arena_free(struct mem_arena *a);
+
 #endif /* INCLUDED_Z_VIRT_H */